@@ -6,6 +6,7 @@ layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec4 inColor;
 layout(location = 2) in vec2 inTexCoord;
 layout(location = 3) in vec3 inNormal;
+layout(location = 4) flat in int inTextureLayer;
 
 out vec4 fragColor;
 
@@ -22,10 +23,17 @@ struct DirectionalLight
 	vec3 color;
 };
 
-uniform AmbientLight ambientLight;
-uniform DirectionalLight directionalLight;
+//t[Pʂ̃f[^(CPUFrameUniformƓ)
+layout(std140) uniform FrameData
+{
+	mat4 matView;
+	mat4 matProj;
+	mat4 matViewProj;
+	AmbientLight ambientLight;
+	DirectionalLight directionalLight;
+};
 
-uniform sampler2D texColor;
+uniform sampler2DArray texColor;
 
 /**
 * tOgVF[_[
@@ -41,6 +49,6 @@ void main()
 	//̖邳vZ
 	lightColor += ambientLight.color;
 
-	fragColor = inColor * texture(texColor, inTexCoord);
+	fragColor = inColor * texture(texColor, vec3(inTexCoord, inTextureLayer));
 	fragColor.rgb *= lightColor;
 }
@@ -7,22 +7,93 @@ layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec4 vColor;
 layout(location = 2) in vec2 vTexCoord;
 layout(location = 3) in vec3 vNormal;
+layout(location = 4) in vec2 vPackedNormal;
+layout(location = 5) in uint vObjectIndex;
 
 layout(location = 0) out vec3 outPosition;
 layout(location = 1) out vec4 outColor;
 layout(location = 2) out vec2 outTexCoord;
 layout(location = 3) out vec3 outNormal;
+layout(location = 4) flat out int outTextureLayer;
 
-uniform mat4x4 matMVP;
+//
+struct AmbientLight
+{
+	vec3 color;
+};
+
+//wCg
+struct DirectionalLight
+{
+	vec3 direction;
+	vec3 color;
+};
+
+//t[Pʂ̃f[^(CPUFrameUniformƓ)
+layout(std140) uniform FrameData
+{
+	mat4 matView;
+	mat4 matProj;
+	mat4 matViewProj;
+	AmbientLight ambientLight;
+	DirectionalLight directionalLight;
+};
+
+//̒Pʂ̃f[^(CPUObjectUniformƓ)
+struct ObjectParameter
+{
+	mat4 matModel;
+	mat3 matNormal;
+	int textureLayer;
+};
+
+//maxObjectsPerBlockƓ
+layout(std140) uniform ObjectData
+{
+	ObjectParameter objects[128];
+};
+
+/**
+* ʑ̎ʑ2ɂ@𕜌
+*
+* @param e kꂽ@(-1`1)
+*
+* @return @
+*/
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
+/**
+* _f[^@擾
+*
+* PackedVertex`ł3Ԃ̖@(0)ɂȂ̂ŁA4Ԃ畜
+*/
+vec3 GetNormal()
+{
+	if (dot(vNormal, vNormal) > 0.0)
+	{
+		return vNormal;
+	}
+	return DecodeOctahedral(vPackedNormal);
+}
 
 /**
 * _VF[_[
 */
 void main()
 {
-	outPosition = vPosition;
+	vec4 worldPosition = objects[vObjectIndex].matModel * vec4(vPosition, 1.0);
+	outPosition = worldPosition.xyz;
 	outColor = vColor;
 	outTexCoord = vTexCoord;
-	outNormal = vNormal;
-	gl_Position = matMVP * vec4(vPosition,1.0);
+	outNormal = objects[vObjectIndex].matNormal * GetNormal();
+	outTextureLayer = objects[vObjectIndex].textureLayer;
+	gl_Position = matViewProj * worldPosition;
 }
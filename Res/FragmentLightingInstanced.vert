@@ -0,0 +1,91 @@
+/**
+* @file FragmentLightingInstanced.vert
+*/
+#version 410
+
+layout(location = 0) in vec3 vPosition;
+layout(location = 1) in vec4 vColor;
+layout(location = 2) in vec2 vTexCoord;
+layout(location = 3) in vec3 vNormal;
+layout(location = 4) in vec2 vPackedNormal;
+
+//CX^XƂ̃f[^(CPUInstanceDataƓ)
+layout(location = 6) in mat4 vMatModel;
+layout(location = 10) in mat3 vMatNormal;
+layout(location = 13) in int vTextureLayer;
+
+layout(location = 0) out vec3 outPosition;
+layout(location = 1) out vec4 outColor;
+layout(location = 2) out vec2 outTexCoord;
+layout(location = 3) out vec3 outNormal;
+layout(location = 4) flat out int outTextureLayer;
+
+//
+struct AmbientLight
+{
+	vec3 color;
+};
+
+//wCg
+struct DirectionalLight
+{
+	vec3 direction;
+	vec3 color;
+};
+
+//t[Pʂ̃f[^(CPUFrameUniformƓ)
+layout(std140) uniform FrameData
+{
+	mat4 matView;
+	mat4 matProj;
+	mat4 matViewProj;
+	AmbientLight ambientLight;
+	DirectionalLight directionalLight;
+};
+
+/**
+* ʑ̎ʑ2ɂ@𕜌
+*
+* @param e kꂽ@(-1`1)
+*
+* @return @
+*/
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
+/**
+* _f[^@擾
+*
+* PackedVertex`ł3Ԃ̖@(0)ɂȂ̂ŁA4Ԃ畜
+*/
+vec3 GetNormal()
+{
+	if (dot(vNormal, vNormal) > 0.0)
+	{
+		return vNormal;
+	}
+	return DecodeOctahedral(vPackedNormal);
+}
+
+/**
+* _VF[_[
+*
+* ̂̃f[^uniformubNł͂ȂCX^Xǂݎ
+*/
+void main()
+{
+	vec4 worldPosition = vMatModel * vec4(vPosition, 1.0);
+	outPosition = worldPosition.xyz;
+	outColor = vColor;
+	outTexCoord = vTexCoord;
+	outNormal = vMatNormal * GetNormal();
+	outTextureLayer = vTextureLayer;
+	gl_Position = matViewProj * worldPosition;
+}
@@ -7,6 +7,7 @@ layout(location = 0) in vec3 vPosition;
 layout(location = 1) in vec4 vColor;
 layout(location = 2) in vec2 vTexCoord;
 layout(location = 3) in vec3 vNormal;
+layout(location = 4) in vec2 vPackedNormal;
 
 layout(location = 0) out vec4 outColor;
 layout(location = 1) out vec2 outTexCoord;
@@ -29,13 +30,44 @@ uniform DirectionalLight directionalLight;
 
 uniform mat4x4 matMVP;
 
+/**
+* ʑ̎ʑ2ɂ@𕜌
+*
+* @param e kꂽ@(-1`1)
+*
+* @return @
+*/
+vec3 DecodeOctahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	if (n.z < 0.0)
+	{
+		n.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+	}
+	return normalize(n);
+}
+
+/**
+* _f[^@擾
+*
+* PackedVertex`ł3Ԃ̖@(0)ɂȂ̂ŁA4Ԃ畜
+*/
+vec3 GetNormal()
+{
+	if (dot(vNormal, vNormal) > 0.0)
+	{
+		return vNormal;
+	}
+	return DecodeOctahedral(vPackedNormal);
+}
+
 /**
 * _VF[_[
 */
 void main()
 {
 	//o[g˂ɂgUˌ̌vZ
-	float cosTheta = clamp(dot(vNormal, -directionalLight.direction),0.0,1.0);
+	float cosTheta = clamp(dot(GetNormal(), -directionalLight.direction),0.0,1.0);
 	vec3 lightColor = directionalLight.color * cosTheta;
 
 	//̌vZ
@@ -2,21 +2,106 @@
 * @file Actor.cpp
 */
 #include "Actor.h"
+#include "TransformBatch.h"
 #include <algorithm>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+/**
+* `Ɠŉ]EgkEsړs쐬
+*
+* @param translate sړ
+* @param rotate    ]px(WA)
+* @param scale     gk
+*
+* @return fs
+*/
+glm::mat4 MakeModelMatrix(
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale)
+{
+	const glm::mat4 matScale = glm::scale(glm::mat4(1), scale);
+	const glm::mat4 matRotateZ = glm::rotate(glm::mat4(1), rotate.z, glm::vec3(0, 0, -1));
+	const glm::mat4 matRotateXZ = glm::rotate(matRotateZ, rotate.x, glm::vec3(1, 0, 0));
+	const glm::mat4 matRotateYXZ = glm::rotate(matRotateXZ, rotate.y, glm::vec3(0, 1, 0));
+	const glm::mat4 matTranslate = glm::translate(glm::mat4(1), translate);
+	return matTranslate * matRotateYXZ * matScale;
+}
+
+/**
+* E{bNX𒼕̂ɕϊ
+*
+* @param box ϊ鋫E{bNX
+*
+* @return boxƓ͈͂\
+*/
+Rect ToRect(const BoundingBox& box)
+{
+	const glm::vec3 min(box.min.x, box.min.y, box.min.z);
+	const glm::vec3 max(box.max.x, box.max.y, box.max.z);
+	return { min, max - min };
+}
+
+/**
+* ̂WϊAϊ̒̂͂ގsȒ̂߂
+*
+* @param rect      ϊ钼
+* @param translate sړ
+* @param rotate    ]px(WA)
+* @param scale     gk
+*
+* @return ϊ̂͂ޒ
+*/
+Rect TransformRect(const Rect& rect,
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale)
+{
+	const glm::mat4 matModel = MakeModelMatrix(translate, rotate, scale);
+
+	//SϊAe̔a͍s̐ΒlōL
+	const glm::vec3 halfSize = rect.size * 0.5f;
+	const glm::vec3 center = glm::vec3(matModel * glm::vec4(rect.origin + halfSize, 1));
+	glm::vec3 extent(0);
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			extent[i] += std::abs(matModel[axis][i]) * halfSize[axis];
+		}
+	}
+	return { center - extent, extent * 2.0f };
+}
+
+/**
+* EWϊ
+*
+* @param sphere    ϊ鋫E
+* @param translate sړ
+* @param rotate    ]px(WA)
+* @param scale     gk
+*
+* @return ϊE(a͍ő̊g嗦ōL)
+*/
+BoundingSphere TransformSphere(const BoundingSphere& sphere,
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale)
+{
+	const glm::mat4 matModel = MakeModelMatrix(translate, rotate, scale);
+	const glm::vec3 center = glm::vec3(matModel *
+		glm::vec4(sphere.center.x, sphere.center.y, sphere.center.z, 1));
+	const float maxScale =
+		std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+	return { { center.x, center.y, center.z }, sphere.radius * maxScale };
+}
+
 /**
 * AN^[
 *
 * @param mesh AN^[Ƃĕ\郁bVID
-* @param tex bVɓ\eNX`ID
+* @param tex bVɓ\eNX`(eNX`z̑wԍ)
 * @param hp AN^[̑ϋv
 * @param pos bV\W
 * @param rot bV\]px
 * @param scale bV\傫
 */
-void Actor::Initialize(int mesh, GLuint tex, int hp,
+void Actor::Initialize(int mesh, int tex, int hp,
 	const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scale)
 {
 	this->mesh = mesh;
@@ -43,8 +128,18 @@ void Actor::Finalize()
 void Actor::Update(float deltaTime)
 {
 	position += velocity * deltaTime;
-	colWorld.origin += colLocal.origin + position;
-	colWorld.size = colLocal.size;
+	colWorld = TransformRect(colLocal, position, rotation, scale);
+}
+
+/**
+* bV̋E{bNXՓ˔Ɏg
+*
+* @param mesh Փ˔̌`Ƃ郁bV
+*/
+void Actor::SetCollisionFromMesh(const Mesh& mesh)
+{
+	colLocal = ToRect(mesh.bounds);
+	colWorld = TransformRect(colLocal, position, rotation, scale);
 }
 
 /**
@@ -90,19 +185,79 @@ void UpdateActorList(std::vector<Actor*>& actorList, float deltaTime)
 * @param actorList `悷AN^[Xg
 * @param shader `ɎgpVF[_[ IuWFNg
 * @param meshList `Ɏgp郁bVXg
+* @param buffer Ɨp̔z(ĂяoŕێĎg)
+* @param viewPos _̍W(ڍדx̑IɎg)
+* @param projectionScale 1̈ʒuɂ钷1̂̕ʏŉsNZɂȂ邩
+* @param culler ̊OɂAN^[JO IuWFNg(nullptrȂSĕ`悷)
+*
+* eNX`z͌ĂяoŌĂ.
+* r[ vWFNVsƃCǵAshaderɐݒ肳Ă̂g
 */
 void RenderActorList(std::vector<Actor*>& actorList,
-	Shader::Program& shader, MeshList& meshList)
+	Shader::Program& shader, MeshList& meshList, ActorRenderBuffer& buffer,
+	const glm::vec3& viewPos, float projectionScale, FrustumCuller* culler)
 {
+	//ĂAN^[̃fsAMVPsAfWñCǧ܂Ƃ߂ČvZ
+	TransformBatch::Arrays& transforms = buffer.transforms;
+	std::vector<Actor*>& liveActors = buffer.liveActors;
+	std::vector<glm::mat4>& matModels = buffer.matModels;
+	SphereArrays& spheres = buffer.spheres;
+	std::vector<uint32_t>& visibleIndices = buffer.visibleIndices;
+	transforms.Clear();
+	liveActors.clear();
 	for (auto& actor : actorList)
 	{
 		if (actor && actor->health > 0)
 		{
-			shader.BindTexture(0, actor->texture);
-			shader.Draw(meshList.Get(actor->mesh),
-				actor->position, actor->rotation, actor->scale);
+			transforms.Push(actor->position, actor->rotation, actor->scale);
+			liveActors.push_back(actor);
 		}
 	}
+	matModels.resize(liveActors.size());
+	buffer.matMVPs.resize(liveActors.size());
+	buffer.lightDirections.resize(liveActors.size());
+	TransformBatch::Output output;
+	output.matModel = matModels.data();
+	output.matMVP = buffer.matMVPs.data();
+	output.lightDirection = buffer.lightDirections.data();
+	TransformBatch::Compute(transforms, shader.GetViewProjectionMatrix(),
+		shader.GetLightList().directional.direction, output);
+
+	//fsŋE[hWnɈڂAƏdȂAN^[I
+	spheres.Clear();
+	visibleIndices.clear();
+	for (size_t i = 0; i < liveActors.size(); ++i)
+	{
+		const Actor& actor = *liveActors[i];
+		if (culler)
+		{
+			const BoundingSphere& sphere = meshList.Get(actor.mesh).sphere;
+			const glm::vec3 center = glm::vec3(matModels[i] *
+				glm::vec4(sphere.center.x, sphere.center.y, sphere.center.z, 1));
+			const float maxScale = std::max({ std::abs(actor.scale.x),
+				std::abs(actor.scale.y), std::abs(actor.scale.z) });
+			spheres.Push(center, sphere.radius * maxScale);
+		}
+		else
+		{
+			visibleIndices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	if (culler)
+	{
+		culler->Cull(spheres, visibleIndices);
+	}
+
+	for (const uint32_t i : visibleIndices)
+	{
+		const Actor& actor = *liveActors[i];
+		const Mesh& mesh = meshList.Get(actor.mesh);
+		const float scale = std::max({ actor.scale.x, actor.scale.y, actor.scale.z });
+		const int lod = SelectMeshLod(mesh,
+			glm::length(actor.position - viewPos), scale, projectionScale);
+		shader.SetTextureLayer(actor.texture);
+		shader.Draw(mesh, matModels[i], buffer.matMVPs[i], buffer.lightDirections[i], lod);
+	}
 }
 
 /**
@@ -6,7 +6,10 @@
 #include <GL/glew.h>
 #include "Shader.h"
 #include "MeshList.h"
+#include "FrustumCuller.h"
+#include "TransformBatch.h"
 #include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #include <vector>
 
 /**
@@ -18,6 +21,14 @@ struct Rect
 	glm::vec3 size;
 };
 
+glm::mat4 MakeModelMatrix(
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale);
+Rect ToRect(const BoundingBox&);
+Rect TransformRect(const Rect&,
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale);
+BoundingSphere TransformSphere(const BoundingSphere&,
+	const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale);
+
 /**
 * V[ɔzuIuWFNg
 */
@@ -27,14 +38,15 @@ public:
 	Actor() = default;
 	virtual ~Actor() = default;
 
-	void Initialize(int mesh, GLuint tex, int hp,
+	void Initialize(int mesh, int tex, int hp,
 		const glm::vec3& pos, const glm::vec3& rot, const glm::vec3& scale);
 	void Finalize();
 	virtual void Update(float deltaTime);
+	void SetCollisionFromMesh(const Mesh&);
 
 public:
 	int mesh = 0;
-	GLuint texture = 0;
+	int texture = 0;//eNX`z̑wԍ
 
 	glm::vec3 position;
 	glm::vec3 rotation;
@@ -46,9 +58,26 @@ public:
 	Rect colWorld;
 };
 
+/**
+* RenderActorListt[gƗp̔z
+*
+* ĂяoŕێĎg񂷂ƂŁAt[̃mۂ
+*/
+struct ActorRenderBuffer
+{
+	TransformBatch::Arrays transforms;//ĂAN^[̈ʒuA]Ag嗦
+	std::vector<Actor*> liveActors;//transformsƓ
+	std::vector<glm::mat4> matModels;
+	std::vector<glm::mat4> matMVPs;
+	std::vector<glm::vec3> lightDirections;//fWñCǧ
+	SphereArrays spheres;
+	std::vector<uint32_t> visibleIndices;
+};
+
 Actor* FindAvailableActor(std::vector<Actor*>&);
 void UpdateActorList(std::vector<Actor*>&, float);
-void RenderActorList(std::vector<Actor*>&, Shader::Program&, MeshList&);
+void RenderActorList(std::vector<Actor*>&, Shader::Program&, MeshList&, ActorRenderBuffer&,
+	const glm::vec3&, float, FrustumCuller* = nullptr);
 void ClearActorList(std::vector<Actor*>&);
 
 #endif //ACTOR_H_INCLUDED
\ No newline at end of file
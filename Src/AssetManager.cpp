@@ -0,0 +1,850 @@
+/**
+* @file AssetManager.cpp
+*/
+#include "AssetManager.h"
+#include "MipmapGenerator.h"
+#include "AssetPack.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+/**
+* 񓯊ǂݍ݂̒P
+*/
+struct AssetManager::Job
+{
+	enum class Type { meshList, texture, program };
+
+	Type type;
+	std::string key;//AZbgo^Ƃ̃L[(t@C)
+	VertexFormat format = VertexFormat::Float;
+	std::string vsPath;
+	std::string fsPath;
+
+	std::atomic<bool> isDecoded{ false };//[J[Xbhł̉͂Itrue
+	bool isSucceeded = false;
+
+	//[J[Xbhŗpӂf[^
+	std::shared_ptr<MeshList> meshList;
+	Texture::SamplerState sampler;
+	std::vector<std::string> layerPaths;//eNX`z̊ew̉摜t@C(2DeNX`Ȃ)
+	std::vector<std::vector<Texture::ImageData>> images;//[w][~bv}bv̒i]̉摜
+	AssetFile compressedFile;//ubNkeNX` t@C
+	Texture::CompressedImage compressedImage;//compressedFilẻ͌
+	std::vector<GLchar> vsCode;
+	std::vector<GLchar> fsCode;
+
+	//eNX`̓]
+	GLuint texture = 0;
+	GLint uploadingLayer = 0;
+	GLint uploadingLevel = 0;
+	GLsizei uploadedRows = 0;
+
+	bool DecodeImages();
+};
+
+/**
+* eNX`̉摜ǂݍ݁A~bv}bv쐬
+*
+* @retval true  ǂݍݐ
+* @retval false ǂݍݎs
+*
+* [J[XbhĂяo
+*/
+bool AssetManager::Job::DecodeImages()
+{
+	std::vector<Texture::ImageData> layers;
+	if (layerPaths.empty())
+	{
+		layers.resize(1);
+		if (!Texture::LoadImageData(key.c_str(), layers[0]))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		std::vector<const char*> paths;
+		for (const std::string& e : layerPaths)
+		{
+			paths.push_back(e.c_str());
+		}
+		if (!Texture::LoadImageArrayData(paths.data(), paths.size(), layers))
+		{
+			return false;
+		}
+	}
+
+	images.resize(layers.size());
+	for (size_t i = 0; i < layers.size(); ++i)
+	{
+		images[i].push_back(std::move(layers[i]));
+		if (Texture::UsesMipmap(sampler))
+		{
+			std::vector<Texture::ImageData> mipLevels;
+			MipmapGenerator::Generate(images[i][0], mipLevels);
+			for (Texture::ImageData& e : mipLevels)
+			{
+				images[i].push_back(std::move(e));
+			}
+		}
+	}
+	return true;
+}
+
+//eNX`1̓]őőoCg
+const size_t textureUploadChunkSize = 256 * 1024;
+
+/**
+* ubNkeNX` t@C}bvĉ͂
+*
+* @param path  KTXt@C
+* @param file  }bvt@C̊i[
+* @param image ͌ʂ̊i[
+*
+* @retval true  ͐
+* @retval false ͎s
+*
+* ]ɃfBXN҂Ȃ悤A[J[XbhőSy[WɐGēǂݍ܂Ă
+*/
+bool LoadCompressedFile(const char* path, AssetFile& file, Texture::CompressedImage& image)
+{
+	if (!file.Open(path) || !Texture::ParseCompressedImage(file.Data(), file.Size(), image))
+	{
+		std::cerr << "ERROR:" << path << "ǂݍ߂܂\n";
+		file.Close();
+		return false;
+	}
+	volatile uint8_t sum = 0;
+	for (size_t i = 0; i < file.Size(); i += 4096)
+	{
+		sum += file.Data()[i];
+	}
+	return true;
+}
+
+/**
+* ǂQƂĂȂAZbg폜
+*
+* @param assets 폜ΏۂTAZbg̘Azz
+*
+* @return 폜AZbg̐
+*/
+template<typename Map>
+size_t EraseUnusedAssets(Map& assets)
+{
+	size_t count = 0;
+	for (auto itr = assets.begin(); itr != assets.end();)
+	{
+		if (itr->second.use_count() <= 1)
+		{
+			itr = assets.erase(itr);
+			++count;
+		}
+		else
+		{
+			++itr;
+		}
+	}
+	return count;
+}
+
+/**
+* bVXg̔񓯊ǂݍ݃WũL[쐬
+*
+* @param format _f[^̌`
+*
+* @return WũL[
+*/
+std::string GetMeshListKey(VertexFormat format)
+{
+	return "MeshList:" + std::to_string(static_cast<int>(format));
+}
+
+/**
+* VF[_[ vOo^Ƃ̃L[쐬
+*
+* @param vsPath _VF[_[ t@C
+* @param fsPath tOgVF[_[ t@C
+*
+* @return vÕL[
+*/
+std::string GetProgramKey(const char* vsPath, const char* fsPath)
+{
+	return std::string(vsPath) + '|' + fsPath;
+}
+
+/**
+* VOgCX^X擾
+*
+* @return AssetManager̃VOgCX^X
+*/
+AssetManager& AssetManager::Instance()
+{
+	static AssetManager instance;
+	return instance;
+}
+
+/**
+* fXgN^
+*/
+AssetManager::~AssetManager()
+{
+	StopWorkers();
+}
+
+/**
+* bVXg擾
+*
+* @param format _f[^̌`
+*
+* @return bVXgւ̃|C^. ǂݍ݂Ɏsꍇnullptr
+*
+* `̃bVXgǂݍݍς݂ȂAL.
+* 񓯊ǂݍݒȂAǂݍ݂I܂ő҂
+*/
+std::shared_ptr<MeshList> AssetManager::GetMeshList(VertexFormat format)
+{
+	FinishJob(GetMeshListKey(format));
+	const auto itr = meshLists.find(static_cast<int>(format));
+	if (itr != meshLists.end())
+	{
+		return itr->second;
+	}
+
+	std::shared_ptr<MeshList> meshList = std::make_shared<MeshList>();
+	if (!meshList->Allcate(format))
+	{
+		return nullptr;
+	}
+	meshLists.emplace(static_cast<int>(format), meshList);
+	return meshList;
+}
+
+/**
+* eNX`擾
+*
+* @param path    摜t@C
+* @param sampler eNX`̓ǂݎ@
+*
+* @return eNX`ւ̃|C^
+*
+* t@C̃eNX`ǂݍݍς݂ȂAL(ǂݎ@͍ŏ̐ݒ̂܂).
+* 񓯊ǂݍݒȂAǂݍ݂I܂ő҂.
+* ǂݍ݂ɎseNX`͋LAIsNulltrueԂeNX`Ԃ
+*/
+std::shared_ptr<Texture::Image2D> AssetManager::GetTexture(const char* path,
+	const Texture::SamplerState& sampler)
+{
+	FinishJob(path);
+	const auto itr = textures.find(path);
+	if (itr != textures.end())
+	{
+		return itr->second;
+	}
+
+	std::shared_ptr<Texture::Image2D> texture =
+		std::make_shared<Texture::Image2D>(Texture::LoadImage2D(path, sampler));
+	if (!texture->IsNull())
+	{
+		textures.emplace(path, texture);
+	}
+	return texture;
+}
+
+/**
+* eNX`z擾
+*
+* @param name    eNX`z̖O(LƂ̃L[)
+* @param paths   ew̉摜t@C̔z(z̏Ԃw̔ԍɂȂ)
+* @param count   paths̗vf
+* @param sampler eNX`̓ǂݎ@
+*
+* @return eNX`zւ̃|C^
+*
+* ÕeNX`z񂪍쐬ς݂ȂAL.
+* 񓯊ǂݍݒȂAǂݍ݂I܂ő҂
+*/
+std::shared_ptr<Texture::Image2D> AssetManager::GetTextureArray(const char* name,
+	const char* const* paths, size_t count, const Texture::SamplerState& sampler)
+{
+	FinishJob(name);
+	const auto itr = textures.find(name);
+	if (itr != textures.end())
+	{
+		return itr->second;
+	}
+
+	std::shared_ptr<Texture::Image2D> texture = std::make_shared<Texture::Image2D>(
+		Texture::LoadImage2DArray(paths, count, sampler), GL_TEXTURE_2D_ARRAY);
+	if (!texture->IsNull())
+	{
+		textures.emplace(name, texture);
+	}
+	return texture;
+}
+
+/**
+* VF[_[ vO擾
+*
+* @param vsPath _VF[_[ t@C
+* @param fsPath tOgVF[_[ t@C
+*
+* @return VF[_[ vOւ̃|C^
+*
+* t@C̑gݍ킹A\[X̃vO쐬ς݂ȂAL.
+* 񓯊ǂݍݒȂAǂݍ݂I܂ő҂.
+* 쐬ɎsvO͋LAIsNulltrueԂvOԂ
+*/
+std::shared_ptr<Shader::Program> AssetManager::GetProgram(
+	const char* vsPath, const char* fsPath)
+{
+	const std::string key = GetProgramKey(vsPath, fsPath);
+	FinishJob(key);
+	const auto itrKey = programKeys.find(key);
+	if (itrKey != programKeys.end())
+	{
+		const auto itr = programs.find(itrKey->second);
+		if (itr != programs.end())
+		{
+			return itr->second;
+		}
+	}
+	return CreateProgram(key, Shader::ReadFile(vsPath), Shader::ReadFile(fsPath));
+}
+
+/**
+* VF[_[ vO쐬ēo^
+*
+* @param key    t@C쐬vÕL[
+* @param vsCode _VF[_[ vO
+* @param fsCode tOgVF[_[ vO
+*
+* @return VF[_[ vOւ̃|C^
+*
+* t@CĂA\[XvO쐬ς݂Ȃ炻L.
+* nbVlł\[XႤꍇ́A󂢂Ă鎟̃L[ɓo^
+*/
+std::shared_ptr<Shader::Program> AssetManager::CreateProgram(const std::string& key,
+	const std::vector<GLchar>& vsCode, const std::vector<GLchar>& fsCode)
+{
+	if (vsCode.empty() || fsCode.empty())
+	{
+		return std::make_shared<Shader::Program>();
+	}
+	std::string source(vsCode.begin(), vsCode.end());
+	source.push_back('\0');
+	source.append(fsCode.begin(), fsCode.end());
+	uint64_t hash = Shader::HashSource(vsCode.data(), fsCode.data());
+	for (auto itr = programs.find(hash); itr != programs.end(); itr = programs.find(++hash))
+	{
+		if (programSources[hash] == source)
+		{
+			programKeys[key] = hash;
+			return itr->second;
+		}
+	}
+
+	std::shared_ptr<Shader::Program> program = std::make_shared<Shader::Program>(
+		Shader::BuildWithCache(vsCode.data(), fsCode.data()));
+	if (!program->IsNull())
+	{
+		programs.emplace(hash, program);
+		programSources[hash] = std::move(source);
+		programKeys[key] = hash;
+	}
+	return program;
+}
+
+/**
+* ǂ̃V[QƂĂȂAZbg폜
+*
+* @return 폜AZbg̐
+*
+* V[؂ւƂ́ÃV[ĂĂяo.
+* ΁ÃV[ŎgAZbgǂݍݒɍς
+*/
+size_t AssetManager::CollectGarbage()
+{
+	const size_t count = EraseUnusedAssets(meshLists) +
+		EraseUnusedAssets(textures) + EraseUnusedAssets(programs);
+	for (auto itr = programKeys.begin(); itr != programKeys.end();)
+	{
+		if (programs.count(itr->second))
+		{
+			++itr;
+		}
+		else
+		{
+			itr = programKeys.erase(itr);
+		}
+	}
+	for (auto itr = programSources.begin(); itr != programSources.end();)
+	{
+		if (programs.count(itr->first))
+		{
+			++itr;
+		}
+		else
+		{
+			itr = programSources.erase(itr);
+		}
+	}
+	std::cout << "INFO: gpAZbg폜 [폜=" << count <<
+		" c=" << meshLists.size() + textures.size() + programs.size() << "]\n";
+	return count;
+}
+
+/**
+* ׂẴAZbg폜
+*
+* OpenGLReLXgjOɌĂяo
+*/
+void AssetManager::Clear()
+{
+	StopWorkers();
+	for (auto& job : pendingJobs)
+	{
+		GLStateCache::Instance().DeleteTexture(job->texture);
+	}
+	pendingJobs.clear();
+	decodeQueue.clear();
+	requestedJobCount = finishedJobCount = 0;
+	glDeleteBuffers(1, &uploadPbo);
+	uploadPbo = 0;
+
+	meshLists.clear();
+	textures.clear();
+	programs.clear();
+	programSources.clear();
+	programKeys.clear();
+}
+
+/**
+* bVXg̔񓯊ǂݍ݂v
+*
+* @param format _f[^̌`
+*/
+void AssetManager::LoadMeshListAsync(VertexFormat format)
+{
+	if (meshLists.count(static_cast<int>(format)))
+	{
+		return;
+	}
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->type = Job::Type::meshList;
+	job->key = GetMeshListKey(format);
+	job->format = format;
+	AddJob(job);
+}
+
+/**
+* eNX`̔񓯊ǂݍ݂v
+*
+* @param path    摜t@C
+* @param sampler eNX`̓ǂݎ@
+*
+* ~bv}bv̍쐬[J[Xbhōs
+*/
+void AssetManager::LoadTextureAsync(const char* path, const Texture::SamplerState& sampler)
+{
+	if (textures.count(path))
+	{
+		return;
+	}
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->type = Job::Type::texture;
+	job->key = path;
+	job->sampler = sampler;
+	AddJob(job);
+}
+
+/**
+* eNX`z̔񓯊ǂݍ݂v
+*
+* @param name    eNX`z̖O(LƂ̃L[)
+* @param paths   ew̉摜t@C̔z(z̏Ԃw̔ԍɂȂ)
+* @param count   paths̗vf
+* @param sampler eNX`̓ǂݎ@
+*
+* 摜̓ǂݍ݁A傫̒A~bv}bv̍쐬[J[Xbhōs
+*/
+void AssetManager::LoadTextureArrayAsync(const char* name,
+	const char* const* paths, size_t count, const Texture::SamplerState& sampler)
+{
+	if (textures.count(name) || count == 0)
+	{
+		return;
+	}
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->type = Job::Type::texture;
+	job->key = name;
+	job->layerPaths.assign(paths, paths + count);
+	job->sampler = sampler;
+	AddJob(job);
+}
+
+/**
+* VF[_[ vO̔񓯊ǂݍ݂v
+*
+* @param vsPath _VF[_[ t@C
+* @param fsPath tOgVF[_[ t@C
+*
+* t@C̓ǂݍ݂[J[XbhōsARpCUpdate֐ōs
+*/
+void AssetManager::LoadProgramAsync(const char* vsPath, const char* fsPath)
+{
+	const std::string key = GetProgramKey(vsPath, fsPath);
+	if (programKeys.count(key))
+	{
+		return;
+	}
+	std::shared_ptr<Job> job = std::make_shared<Job>();
+	job->type = Job::Type::program;
+	job->key = key;
+	job->vsPath = vsPath;
+	job->fsPath = fsPath;
+	AddJob(job);
+}
+
+/**
+* 񓯊ǂݍ݂̃Wuǉ
+*
+* @param job ǉWu
+*
+* L[̃WuɂΉȂ
+*/
+void AssetManager::AddJob(const std::shared_ptr<Job>& job)
+{
+	for (const auto& e : pendingJobs)
+	{
+		if (e->key == job->key)
+		{
+			return;
+		}
+	}
+
+	//ŏ̗vŃ[J[XbhN
+	if (workers.empty())
+	{
+		isStopping = false;
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		const unsigned int workerCount =
+			std::max(1u, std::min(2u, hardwareThreads > 1 ? hardwareThreads - 1 : 1u));
+		for (unsigned int i = 0; i < workerCount; ++i)
+		{
+			workers.emplace_back(&AssetManager::WorkerMain, this);
+		}
+	}
+
+	pendingJobs.push_back(job);
+	++requestedJobCount;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		decodeQueue.push_back(job);
+	}
+	cvDecode.notify_one();
+}
+
+/**
+* [J[Xbh̏
+*
+* t@C̓ǂݍ݂Ɖ͂sAOpenGL̊֐͌Ă΂Ȃ
+*/
+void AssetManager::WorkerMain()
+{
+	for (;;)
+	{
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cvDecode.wait(lock, [this] { return isStopping || !decodeQueue.empty(); });
+			if (isStopping)
+			{
+				return;
+			}
+			job = decodeQueue.front();
+			decodeQueue.pop_front();
+		}
+
+		switch (job->type)
+		{
+		case Job::Type::meshList:
+			job->meshList = std::make_shared<MeshList>();
+			job->isSucceeded = job->meshList->Prepare(job->format);
+			break;
+		case Job::Type::texture:
+			if (job->layerPaths.empty() && Texture::IsCompressedImagePath(job->key.c_str()))
+			{
+				job->isSucceeded = LoadCompressedFile(job->key.c_str(),
+					job->compressedFile, job->compressedImage);
+				break;
+			}
+			job->isSucceeded = job->DecodeImages();
+			break;
+		case Job::Type::program:
+			job->vsCode = Shader::ReadFile(job->vsPath.c_str());
+			job->fsCode = Shader::ReadFile(job->fsPath.c_str());
+			job->isSucceeded = !job->vsCode.empty() && !job->fsCode.empty();
+			break;
+		}
+
+		//bVXg̃fXgN^[J[XbhŎsȂ悤ɁA
+		//ʒmOɎQƂĂ
+		Job* p = job.get();
+		job.reset();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			p->isDecoded = true;
+		}
+		cvDecoded.notify_all();
+	}
+}
+
+/**
+* ͂̏IWũf[^1iKGPUɓ]
+*
+* @param job ]Wu
+*
+* @retval true  ]
+* @retval false ]ׂf[^cĂ
+*/
+bool AssetManager::UploadStep(Job& job)
+{
+	if (!job.isSucceeded)
+	{
+		return true;
+	}
+
+	switch (job.type)
+	{
+	case Job::Type::meshList:
+		if (job.meshList->Upload())
+		{
+			meshLists.emplace(static_cast<int>(job.format), job.meshList);
+		}
+		return true;
+
+	case Job::Type::program: {
+		CreateProgram(job.key, job.vsCode, job.fsCode);
+		return true;
+	}
+
+	case Job::Type::texture: {
+		//ubNkeNX`͏̂ŁA1œ]
+		if (!job.compressedImage.levels.empty())
+		{
+			const GLuint id = Texture::CreateCompressedImage2D(job.compressedImage, job.sampler);
+			if (id)
+			{
+				textures.emplace(job.key, std::make_shared<Texture::Image2D>(id));
+			}
+			job.compressedImage.levels.clear();
+			job.compressedFile.Close();
+			return true;
+		}
+		const bool isArray = !job.layerPaths.empty();
+		if (job.texture == 0)
+		{
+			const Texture::ImageData& base = job.images[0][0];
+			const GLsizei levelCount = static_cast<GLsizei>(job.images[0].size());
+			if (isArray)
+			{
+				job.texture = Texture::CreateImage2DArray(base.width, base.height,
+					static_cast<GLsizei>(job.images.size()), base.format, base.type,
+					levelCount, job.sampler);
+			}
+			else
+			{
+				job.texture = Texture::CreateImage2D(base.width, base.height, nullptr,
+					base.format, base.type, levelCount, job.sampler);
+			}
+			if (job.texture == 0)
+			{
+				return true;
+			}
+			if (uploadPbo == 0)
+			{
+				glGenBuffers(1, &uploadPbo);
+			}
+		}
+
+		//PBOoRāAwƂɑ傫i珇ɐs]
+		const Texture::ImageData& image = job.images[job.uploadingLayer][job.uploadingLevel];
+		const size_t lineSize =
+			(size_t)image.width * Texture::GetBytesPerPixel(image.format, image.type);
+		const GLsizei rows = std::min<GLsizei>(image.height - job.uploadedRows,
+			(GLsizei)std::max<size_t>(1, textureUploadChunkSize / std::max<size_t>(1, lineSize)));
+		Texture::UploadImage2DRows(job.texture, uploadPbo, image,
+			job.uploadedRows, rows, job.uploadingLevel, isArray ? job.uploadingLayer : -1);
+		job.uploadedRows += rows;
+		if (job.uploadedRows < image.height)
+		{
+			return false;
+		}
+		job.uploadedRows = 0;
+		++job.uploadingLevel;
+		if (job.uploadingLevel < static_cast<GLint>(job.images[job.uploadingLayer].size()))
+		{
+			return false;
+		}
+		job.uploadingLevel = 0;
+		++job.uploadingLayer;
+		if (job.uploadingLayer < static_cast<GLint>(job.images.size()))
+		{
+			return false;
+		}
+		textures.emplace(job.key, std::make_shared<Texture::Image2D>(job.texture,
+			isArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D));
+		job.texture = 0;
+		std::vector<std::vector<Texture::ImageData>>().swap(job.images);
+		return true;
+	}
+	}
+	return true;
+}
+
+/**
+* ͂̏IAZbgGPUɓ]
+*
+* @param budget ]ɎgĂ悢(b)
+*
+* CXbh疈t[Ăяo.
+* ȂƂ1iK͓]̂ŁAbudget𒴂ꍇ
+*/
+void AssetManager::Update(double budget)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const auto isOverBudget = [start, budget]() {
+		const std::chrono::duration<double> elapsed =
+			std::chrono::steady_clock::now() - start;
+		return elapsed.count() >= budget;
+	};
+
+	bool hasUploaded = false;
+	for (auto itr = pendingJobs.begin(); itr != pendingJobs.end();)
+	{
+		Job& job = **itr;
+		if (!job.isDecoded)
+		{
+			++itr;
+			continue;
+		}
+
+		bool isFinished = false;
+		while (!(hasUploaded && isOverBudget()))
+		{
+			hasUploaded = true;
+			isFinished = UploadStep(job);
+			if (isFinished)
+			{
+				break;
+			}
+		}
+		if (!isFinished)
+		{
+			break;
+		}
+		itr = pendingJobs.erase(itr);
+		++finishedJobCount;
+	}
+
+	if (pendingJobs.empty() && requestedJobCount > 0)
+	{
+		std::cout << "INFO: 񓯊ǂݍ݊ [AZbg=" << requestedJobCount << "]\n";
+		requestedJobCount = finishedJobCount = 0;
+	}
+}
+
+/**
+* 񓯊ǂݍݒ̃AZbg邩ׂ
+*
+* @retval true  ǂݍݒ̃AZbg
+* @retval false ׂēǂݍݏI
+*/
+bool AssetManager::IsLoading() const
+{
+	return !pendingJobs.empty();
+}
+
+/**
+* 񓯊ǂݍ݂̐i݋擾
+*
+* @return i݋(0.0`1.0). ǂݍݒ̃AZbgȂ1.0
+*
+* ]r̃eNX`͓]ς݂̍s̊Ő
+*/
+float AssetManager::GetProgress() const
+{
+	if (requestedJobCount == 0)
+	{
+		return 1.0f;
+	}
+	float progress = static_cast<float>(finishedJobCount);
+	for (const auto& job : pendingJobs)
+	{
+		if (job->isDecoded)
+		{
+			progress += 0.5f;
+			if (job->type == Job::Type::texture && !job->images.empty())
+			{
+				//~bv}bv2iڈȍ~͏̂ŁAew̍ł傫i̓]ʂŐi݋߂
+				const float layerProgress = job->uploadingLevel > 0 ? 1.0f :
+					static_cast<float>(job->uploadedRows) / job->images[0][0].height;
+				progress += 0.5f * (job->uploadingLayer + layerProgress) / job->images.size();
+			}
+		}
+	}
+	return progress / requestedJobCount;
+}
+
+/**
+* w肵L[̃Wu҂A]܂ōς܂
+*
+* @param key WũL[
+*/
+void AssetManager::FinishJob(const std::string& key)
+{
+	const auto itr = std::find_if(pendingJobs.begin(), pendingJobs.end(),
+		[&key](const std::shared_ptr<Job>& job) { return job->key == key; });
+	if (itr == pendingJobs.end())
+	{
+		return;
+	}
+
+	const std::shared_ptr<Job> job = *itr;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cvDecoded.wait(lock, [&job] { return job->isDecoded.load(); });
+	}
+	while (!UploadStep(*job))
+	{
+	}
+	pendingJobs.erase(std::find(pendingJobs.begin(), pendingJobs.end(), job));
+	++finishedJobCount;
+	if (pendingJobs.empty())
+	{
+		requestedJobCount = finishedJobCount = 0;
+	}
+}
+
+/**
+* [J[Xbh~
+*
+* ͒̃Wu͍Ō܂ŎsĂ~
+*/
+void AssetManager::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	cvDecode.notify_all();
+	for (auto& e : workers)
+	{
+		e.join();
+	}
+	workers.clear();
+}
@@ -0,0 +1,89 @@
+/**
+* @file AssetManager.h
+*/
+#ifndef ASSETMANAGER_H_INCLUDED
+#define ASSETMANAGER_H_INCLUDED
+#include <GL/glew.h>
+#include "MeshList.h"
+#include "Texture.h"
+#include "Shader.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+* V[ԂŋLAZbg̊ǗNX
+*
+* bVAeNX`AVF[_[ vOpXL[ɂĕێ.
+* 擾AZbgshared_ptr̎QƃJEgŎǗA
+* CollectGarbageĂԂ܂ł͂ǂ̃V[QƂĂȂĂێ.
+*
+* Load`Async֐ŗvAZbǵA[J[XbhŃt@C̉͂sA
+* Update֐̒GPUւ̓]s.
+*/
+class AssetManager
+{
+public:
+	static AssetManager& Instance();
+
+	std::shared_ptr<MeshList> GetMeshList(VertexFormat format = VertexFormat::Float);
+	std::shared_ptr<Texture::Image2D> GetTexture(const char* path,
+		const Texture::SamplerState& sampler = Texture::SamplerState());
+	std::shared_ptr<Texture::Image2D> GetTextureArray(const char* name,
+		const char* const* paths, size_t count,
+		const Texture::SamplerState& sampler = Texture::SamplerState());
+	std::shared_ptr<Shader::Program> GetProgram(const char* vsPath, const char* fsPath);
+
+	void LoadMeshListAsync(VertexFormat format = VertexFormat::Float);
+	void LoadTextureAsync(const char* path,
+		const Texture::SamplerState& sampler = Texture::SamplerState());
+	void LoadTextureArrayAsync(const char* name, const char* const* paths, size_t count,
+		const Texture::SamplerState& sampler = Texture::SamplerState());
+	void LoadProgramAsync(const char* vsPath, const char* fsPath);
+	void Update(double budget);
+	bool IsLoading() const;
+	float GetProgress() const;
+
+	size_t CollectGarbage();
+	void Clear();
+
+private:
+	AssetManager() = default;
+	~AssetManager();
+	AssetManager(const AssetManager&) = delete;
+	AssetManager& operator=(const AssetManager&) = delete;
+
+	struct Job;
+	void AddJob(const std::shared_ptr<Job>&);
+	void WorkerMain();
+	bool UploadStep(Job&);
+	void FinishJob(const std::string& key);
+	void StopWorkers();
+	std::shared_ptr<Shader::Program> CreateProgram(const std::string& key,
+		const std::vector<GLchar>& vsCode, const std::vector<GLchar>& fsCode);
+
+	std::unordered_map<int, std::shared_ptr<MeshList>> meshLists;
+	std::unordered_map<std::string, std::shared_ptr<Texture::Image2D>> textures;
+	std::unordered_map<uint64_t, std::shared_ptr<Shader::Program>> programs;//L[=\[X̃nbVl
+	std::unordered_map<uint64_t, std::string> programSources;//programsƓL[. Փ˂̊mFɎg
+	std::unordered_map<std::string, uint64_t> programKeys;//t@C\[X̃nbVl
+
+	//񓯊ǂݍ݂̏
+	std::vector<std::shared_ptr<Job>> pendingJobs;//]҂̃Wu(CXbhp)
+	std::deque<std::shared_ptr<Job>> decodeQueue;//͑҂̃Wu
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable cvDecode;//͑҂̃WuǉꂽƂʒm
+	std::condition_variable cvDecoded;//Wủ͂IƂʒm
+	bool isStopping = false;
+	GLuint uploadPbo = 0;//eNX`̓]ɎgsNZ obt@ IuWFNg
+	size_t requestedJobCount = 0;
+	size_t finishedJobCount = 0;
+};
+
+#endif //ASSETMANAGER_H_INCLUDED
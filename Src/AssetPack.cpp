@@ -0,0 +1,430 @@
+/**
+* @file AssetPack.cpp
+*/
+#include "AssetPack.h"
+#include "Lz4.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+//AZbg pbŇ`. \ςo[Wグ邱
+const char assetPackMagic[4] = { 'A','P','A','K' };
+const uint32_t assetPackVersion = 1;
+
+//ڎ64oCg(LbVC)Af[^16oCgEɑ
+const uint64_t assetPackTocAlignment = 64;
+const uint64_t assetPackDataAlignment = 16;
+
+//Gg̈k`
+const uint32_t assetPackRaw = 0;
+const uint32_t assetPackLz4 = 1;
+
+//AZbg pbÑwb_
+struct AssetPackHeader
+{
+	char magic[4];//ʎq
+	uint32_t version;//`̃o[W
+	uint32_t entryCount;//Gg̐
+	uint32_t entrySize;//ڎ̃Gg1̃oCg
+	uint64_t tocOffset;//ڎ̃t@C擪̈ʒu
+	uint64_t fileSize;//pbNŜ̃oCg
+};
+
+/**
+* pbN̈ʒuw肵oCgEɐ؂グ
+*
+* @param offset    ؂グʒu
+* @param alignment ẼoCg(2ׂ̂)
+*
+* @return Eɑʒu
+*/
+uint64_t AlignPackOffset(uint64_t offset, uint64_t alignment)
+{
+	return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+* Q[ŎgpbN擾
+*
+* @return pbNւ̎Q
+*
+* [J[XbhǂݍޑOɁACXbhŊJĂ
+*/
+AssetPack& AssetPack::Instance()
+{
+	static AssetPack instance;
+	return instance;
+}
+
+/**
+* t@C̃nbVlvZ(FNV-1a)
+*
+* @param name t@C
+*
+* @return nbVl
+*
+* ؂蕶'\''/'Ƃ݂Ȃ
+*/
+uint64_t AssetPack::HashName(const char* name)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (const char* p = name; *p; ++p)
+	{
+		const uint8_t c = *p == '\\' ? '/' : static_cast<uint8_t>(*p);
+		hash = (hash ^ c) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+* t@C܂Ƃ߂ăpbN쐬
+*
+* @param packPath 쐬pbÑt@C
+* @param paths    i[t@C̔z. ǂݍނƂ̖OŒT
+* @param count    paths̗vf
+* @param useLz4   trueȂLZ4ňk. k܂Ȃt@C͈kɊi[
+*
+* @retval true  쐬
+* @retval false 쐬s
+*
+* f[^paths̏Ԃɕׂ̂ŁAǂݍޏԂɎw肷ƃfBXNǂ݂₷Ȃ
+*/
+bool AssetPack::Build(const char* packPath, const char* const* paths, size_t count, bool useLz4)
+{
+	std::vector<Entry> toc(count);
+	std::vector<std::vector<uint8_t>> payloads(count);
+	const uint64_t tocOffset = AlignPackOffset(sizeof(AssetPackHeader), assetPackTocAlignment);
+	uint64_t offset = tocOffset + sizeof(Entry) * count;
+	for (size_t i = 0; i < count; ++i)
+	{
+		MappedFile src(paths[i]);
+		if (src.IsNull())
+		{
+			std::cerr << "ERROR: " << paths[i] << "J܂\n";
+			return false;
+		}
+		Entry& e = toc[i];
+		e = {};
+		e.nameHash = HashName(paths[i]);
+		e.size = src.Size();
+		e.compression = assetPackRaw;
+		std::vector<uint8_t>& payload = payloads[i];
+		if (useLz4)
+		{
+			//1/8ȏk܂ȂȂAWJ̎ԂȂ߈kȂ
+			payload.resize(Lz4::CompressBound(src.Size()));
+			const size_t compressedSize =
+				Lz4::Compress(src.Data(), src.Size(), payload.data(), payload.size());
+			if (compressedSize > 0 && compressedSize < src.Size() - src.Size() / 8)
+			{
+				payload.resize(compressedSize);
+				e.compression = assetPackLz4;
+			}
+		}
+		if (e.compression == assetPackRaw)
+		{
+			payload.assign(src.Data(), src.Data() + src.Size());
+		}
+		e.storedSize = payload.size();
+		offset = AlignPackOffset(offset, assetPackDataAlignment);
+		e.offset = offset;
+		offset += e.storedSize;
+	}
+
+	//ڎ̓nbVl̓񕪒Tň悤ɏɕׂ
+	std::vector<Entry> sortedToc = toc;
+	std::sort(sortedToc.begin(), sortedToc.end(),
+		[](const Entry& a, const Entry& b) { return a.nameHash < b.nameHash; });
+	for (size_t i = 1; i < count; ++i)
+	{
+		if (sortedToc[i - 1].nameHash == sortedToc[i].nameHash)
+		{
+			std::cerr << "ERROR: t@C̃nbVldĂ܂\n";
+			return false;
+		}
+	}
+
+	std::ofstream ofs(packPath, std::ios_base::binary | std::ios_base::trunc);
+	if (!ofs.is_open())
+	{
+		std::cerr << "ERROR: " << packPath << "쐬ł܂\n";
+		return false;
+	}
+	AssetPackHeader header = {};
+	memcpy(header.magic, assetPackMagic, sizeof(header.magic));
+	header.version = assetPackVersion;
+	header.entryCount = static_cast<uint32_t>(count);
+	header.entrySize = sizeof(Entry);
+	header.tocOffset = tocOffset;
+	header.fileSize = offset;
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	const char padding[assetPackTocAlignment] = {};
+	ofs.write(padding, tocOffset - sizeof(header));
+	ofs.write(reinterpret_cast<const char*>(sortedToc.data()), sizeof(Entry) * count);
+	uint64_t written = tocOffset + sizeof(Entry) * count;
+	uint64_t rawBytes = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		ofs.write(padding, toc[i].offset - written);
+		ofs.write(reinterpret_cast<const char*>(payloads[i].data()), payloads[i].size());
+		written = toc[i].offset + toc[i].storedSize;
+		rawBytes += toc[i].size;
+	}
+
+	if (!ofs)
+	{
+		std::cerr << "ERROR: " << packPath << "݂̏Ɏs\n";
+		ofs.close();
+		remove(packPath);
+		return false;
+	}
+	std::cout << "INFO: " << packPath << "쐬 [t@C=" << count <<
+		" e=" << rawBytes << "->" << written << "oCg]\n";
+	return true;
+}
+
+/**
+* pbNJ
+*
+* @param path pbÑt@C
+*
+* @retval true  JƂł
+* @retval false t@CA܂͌`Ȃ
+*/
+bool AssetPack::Open(const char* path)
+{
+	Close();
+	if (!file.Open(path))
+	{
+		return false;
+	}
+
+	//`v邩ׂ
+	const uint8_t* p = file.Data();
+	const size_t size = file.Size();
+	AssetPackHeader header;
+	if (size < sizeof(header))
+	{
+		std::cerr << "WARNING: " << path << "̓AZbg pbNł͂܂\n";
+		Close();
+		return false;
+	}
+	memcpy(&header, p, sizeof(header));
+	if (memcmp(header.magic, assetPackMagic, sizeof(header.magic)) != 0 ||
+		header.version != assetPackVersion ||
+		header.entrySize != sizeof(Entry) ||
+		header.fileSize != size ||
+		header.tocOffset % alignof(Entry) != 0 ||
+		header.tocOffset + sizeof(Entry) * uint64_t(header.entryCount) > size)
+	{
+		std::cerr << "WARNING: " << path << "̓AZbg pbNł͂ȂA`Âł\n";
+		Close();
+		return false;
+	}
+
+	//ڎ͈̔͂ƕяm߂ĂAǂݍݎ̌Ȃ
+	const Entry* toc = reinterpret_cast<const Entry*>(p + header.tocOffset);
+	for (size_t i = 0; i < header.entryCount; ++i)
+	{
+		const Entry& e = toc[i];
+		if (e.offset > size || e.storedSize > size - e.offset ||
+			(e.compression != assetPackRaw && e.compression != assetPackLz4) ||
+			(e.compression == assetPackRaw && e.storedSize != e.size) ||
+			(i > 0 && toc[i - 1].nameHash >= e.nameHash))
+		{
+			std::cerr << "WARNING: " << path << "̖ڎĂ܂\n";
+			Close();
+			return false;
+		}
+	}
+	entries = toc;
+	entryCount = header.entryCount;
+	return true;
+}
+
+/**
+* pbN
+*/
+void AssetPack::Close()
+{
+	file.Close();
+	entries = nullptr;
+	entryCount = 0;
+}
+
+/**
+* pbNJĂ邩ׂ
+*
+* @retval true  JĂȂ
+* @retval false JĂ
+*/
+bool AssetPack::IsNull() const
+{
+	return entries == nullptr;
+}
+
+/**
+* pbNɊi[ĂGg̐擾
+*
+* @return Gg̐
+*/
+size_t AssetPack::EntryCount() const
+{
+	return entryCount;
+}
+
+/**
+* t@CɑΉGgT
+*
+* @param name t@C
+*
+* @return Ggւ̃|C^. Ȃnullptr
+*/
+const AssetPack::Entry* AssetPack::Find(const char* name) const
+{
+	if (!entries)
+	{
+		return nullptr;
+	}
+	const uint64_t hash = HashName(name);
+	const Entry* end = entries + entryCount;
+	const Entry* itr = std::lower_bound(entries, end, hash,
+		[](const Entry& e, uint64_t h) { return e.nameHash < h; });
+	if (itr == end || itr->nameHash != hash)
+	{
+		return nullptr;
+	}
+	return itr;
+}
+
+/**
+* Gg̃f[^擾
+*
+* @param entry  FindŎ擾Gg
+* @param data   f[^̐擪AhX̊i[
+* @param buffer kꂽGg̓WJ
+*
+* @retval true  擾
+* @retval false WJs(f[^Ă)
+*
+* kĂȂGǵA}bv̈Rs[ɎQƂ.
+* pbN͓ǂݎpȂ̂ŁÃXbh瓯ɌĂяoƂł
+*/
+bool AssetPack::Read(const Entry& entry, const uint8_t*& data, std::vector<uint8_t>& buffer) const
+{
+	const uint8_t* stored = file.Data() + entry.offset;
+	if (entry.compression == assetPackRaw)
+	{
+		data = stored;
+		return true;
+	}
+	buffer.resize(static_cast<size_t>(entry.size));
+	if (!Lz4::Decompress(stored, static_cast<size_t>(entry.storedSize),
+		buffer.data(), buffer.size()))
+	{
+		return false;
+	}
+	data = buffer.data();
+	return true;
+}
+
+/**
+* RXgN^
+*
+* @param path Jt@C
+*/
+AssetFile::AssetFile(const char* path)
+{
+	Open(path);
+}
+
+/**
+* t@CJ
+*
+* @param path Jt@C
+*
+* @retval true  JƂł
+* @retval false t@CA܂͋
+*
+* pbNɓÕt@C΁AD悷
+*/
+bool AssetFile::Open(const char* path)
+{
+	Close();
+	const AssetPack& pack = AssetPack::Instance();
+	if (const AssetPack::Entry* entry = pack.Find(path))
+	{
+		if (!pack.Read(*entry, data, buffer))
+		{
+			std::cerr << "ERROR: pbN" << path << "Ă܂\n";
+			return false;
+		}
+		size = static_cast<size_t>(entry->size);
+		isPacked = true;
+		return true;
+	}
+	if (!file.Open(path))
+	{
+		return false;
+	}
+	data = file.Data();
+	size = file.Size();
+	return true;
+}
+
+/**
+* t@C
+*/
+void AssetFile::Close()
+{
+	file.Close();
+	std::vector<uint8_t>().swap(buffer);
+	data = nullptr;
+	size = 0;
+	isPacked = false;
+}
+
+/**
+* t@CJĂ邩ׂ
+*
+* @retval true  JĂȂ
+* @retval false JĂ
+*/
+bool AssetFile::IsNull() const
+{
+	return data == nullptr;
+}
+
+/**
+* pbNǂݍ񂾂ׂ
+*
+* @retval true  pbNǂݍ
+* @retval false t@Cǂݍ񂾁A܂͊JĂȂ
+*/
+bool AssetFile::IsPacked() const
+{
+	return isPacked;
+}
+
+/**
+* f[^̐擪擾
+*
+* @return f[^̐擪AhX
+*/
+const uint8_t* AssetFile::Data() const
+{
+	return data;
+}
+
+/**
+* f[^̃oCg擾
+*
+* @return f[^̃oCg
+*/
+size_t AssetFile::Size() const
+{
+	return size;
+}
@@ -0,0 +1,83 @@
+/**
+* @file AssetPack.h
+*/
+#ifndef ASSETPACK_H_INCLUDED
+#define ASSETPACK_H_INCLUDED
+#include "MappedFile.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+* ̃AZbg t@C1ɂ܂Ƃ߂ǂݎp̃pbN
+*
+* pbNŜ1xɃ}bvAeGg̓}bv̈𒼐ڎQƂ.
+* Gg̓t@C̃nbVlŒT̂ŁApbNɃt@C͊i[Ȃ.
+*/
+class AssetPack
+{
+public:
+	//ڎɊi[Gg̏
+	struct Entry
+	{
+		uint64_t nameHash;//t@C̃nbVl
+		uint64_t offset;//f[^̃t@C擪̈ʒu
+		uint64_t storedSize;//pbNɊi[oCg
+		uint64_t size;//̃t@C̃oCg
+		uint32_t compression;//k`(0=Ȃ, 1=LZ4)
+		uint32_t reserved;
+	};
+
+	static AssetPack& Instance();
+	static uint64_t HashName(const char* name);
+	static bool Build(const char* packPath, const char* const* paths, size_t count, bool useLz4);
+
+	AssetPack() = default;
+	~AssetPack() = default;
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+	bool IsNull() const;
+	size_t EntryCount() const;
+	const Entry* Find(const char* name) const;
+	bool Read(const Entry& entry, const uint8_t*& data, std::vector<uint8_t>& buffer) const;
+
+private:
+	MappedFile file;
+	const Entry* entries = nullptr;//nbVl̏ɕ񂾖ڎ
+	size_t entryCount = 0;
+};
+
+/**
+* ǂݍݐp̃AZbg t@C
+*
+* JĂpbNɃt@C΃pbN̗̈A΃t@Ĉ}bv.
+* kĂȂGg̓Rs[ɎQƂ.
+*/
+class AssetFile
+{
+public:
+	AssetFile() = default;
+	explicit AssetFile(const char* path);
+	~AssetFile() = default;
+	AssetFile(const AssetFile&) = delete;
+	AssetFile& operator=(const AssetFile&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+	bool IsNull() const;
+	bool IsPacked() const;
+	const uint8_t* Data() const;
+	size_t Size() const;
+
+private:
+	MappedFile file;//pbNɖt@C}bvIuWFNg
+	std::vector<uint8_t> buffer;//kꂽGg̓WJ
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	bool isPacked = false;
+};
+
+#endif //ASSETPACK_H_INCLUDED
@@ -0,0 +1,1099 @@
+/**
+* @file Benchmark.cpp
+*/
+#include "Benchmark.h"
+#include "Texture.h"
+#include "PixelConverter.h"
+#include "MipmapGenerator.h"
+#include "BlockCompressor.h"
+#include "AssetPack.h"
+#include "GLStateCache.h"
+#include "TransformBatch.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "Bvh.h"
+#include "OcclusionCuller.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//\v֐i[閼O
+namespace Benchmark {
+
+/**
+* ֐̎sԂv
+*
+* @param func       v֐
+* @param iterations s
+*
+* @return 1񂠂̎s(~b)
+*/
+	template<typename Func>
+	double MeasureTime(Func func, int iterations)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i)
+		{
+			func();
+		}
+		const std::chrono::duration<double, std::milli> elapsed =
+			std::chrono::steady_clock::now() - start;
+		return elapsed.count() / iterations;
+	}
+
+/**
+* R}hCŎw肳ꂽvs
+*
+* @param argc ̐
+* @param argv ̔z
+*
+* @retval true  vs(Q[͋NȂ)
+* @retval false v̎w肪Ȃ
+*
+* u--benchmark OvŎw肵vAu--benchmarkvȂSĂ̌vs
+*/
+	bool Run(int argc, char** argv)
+	{
+		if (argc < 2 || strcmp(argv[1], "--benchmark") != 0)
+		{
+			return false;
+		}
+		const char* name = argc >= 3 ? argv[2] : "";
+		const auto isSelected = [name](const char* s) {
+			return name[0] == '\0' || strcmp(name, s) == 0;
+		};
+		if (isSelected("texture-decode"))
+		{
+			TextureDecode();
+		}
+		if (isSelected("mipmap"))
+		{
+			Mipmap();
+		}
+		if (isSelected("texture-compress"))
+		{
+			TextureCompress();
+		}
+		if (isSelected("asset-pack"))
+		{
+			AssetPackIo();
+		}
+		if (isSelected("gl-state"))
+		{
+			GLState();
+		}
+		if (isSelected("transform"))
+		{
+			Transform();
+		}
+		if (isSelected("render-queue"))
+		{
+			RenderQueueSort();
+		}
+		if (isSelected("frustum-cull"))
+		{
+			FrustumCull();
+		}
+		if (isSelected("bvh"))
+		{
+			BvhQuery();
+		}
+		if (isSelected("occlusion"))
+		{
+			OcclusionCull();
+		}
+		return true;
+	}
+
+/**
+* TGA̓ǂݍ݂Ɖfϊ̑xv
+*/
+	void TextureDecode()
+	{
+		static const char* const paths[] = {
+			"Res/Ground.tga",
+			"Res/Human.tga",
+			"Res/TitleBack.tga",//ʐ^Ȃ̂RLEł͖5%k܂Ȃ. 񈳏k̓ǂݍݑx̔rpɎcĂ
+			"Res/TitleLogo.tga",
+			"Res/wallHeight.tga",
+			"Res/wallWidth.tga",
+		};
+		const int iterations = 20;
+
+		//t@CƂ̓ǂݍݑx
+		std::cout << "[texture-decode] TGAǂݍ(" << iterations << "̕)\n";
+		for (const char* path : paths)
+		{
+			Texture::ImageData image;
+			if (!Texture::LoadImageData(path, image))
+			{
+				continue;
+			}
+			const double ms = MeasureTime([path]() {
+				Texture::ImageData tmp;
+				Texture::LoadImageData(path, tmp);
+			}, iterations);
+			const double megaBytes = image.data.size() / (1024.0 * 1024.0);
+			std::cout << "  " << path << " " << image.width << "x" << image.height <<
+				" " << ms << "ms " << megaBytes / (ms / 1000.0) << "MB/s\n";
+		}
+
+		//fϊ̑xSIMDłSIMDȂłŔׂ
+		const size_t pixelCount = 1024 * 1024;
+		std::vector<uint8_t> src(pixelCount * 4);
+		std::mt19937 rand(1);
+		for (auto& e : src)
+		{
+			e = (uint8_t)rand();
+		}
+		std::vector<uint8_t> dstSimd(pixelCount * 4);
+		std::vector<uint8_t> dstScalar(pixelCount * 4);
+		struct Kernel
+		{
+			const char* name;
+			void(*simd)(const uint8_t*, uint8_t*, size_t);
+			void(*scalar)(const uint8_t*, uint8_t*, size_t);
+		};
+		const Kernel kernels[] = {
+			{ "BGR8->RGBA8", PixelConverter::BgrToRgba, PixelConverter::BgrToRgbaScalar },
+			{ "BGRA8->RGBA8", PixelConverter::BgraToRgba, PixelConverter::BgraToRgbaScalar },
+			{ "A1RGB5->RGBA8",
+				[](const uint8_t* s, uint8_t* d, size_t n) { PixelConverter::Bgra5551ToRgba(s, d, n, true); },
+				[](const uint8_t* s, uint8_t* d, size_t n) { PixelConverter::Bgra5551ToRgbaScalar(s, d, n, true); } },
+		};
+		std::cout << "[texture-decode] fϊ(" << pixelCount << "f, SIMD=" <<
+			(PixelConverter::IsSimdEnabled() ? "SSSE3" : "SSE2̂") << ")\n";
+		for (const Kernel& k : kernels)
+		{
+			const double simdMs = MeasureTime([&]() {
+				k.simd(src.data(), dstSimd.data(), pixelCount);
+			}, iterations);
+			const double scalarMs = MeasureTime([&]() {
+				k.scalar(src.data(), dstScalar.data(), pixelCount);
+			}, iterations);
+			const bool isSame = dstSimd == dstScalar;
+			std::cout << "  " << k.name << " SIMD=" << simdMs << "ms XJ[=" <<
+				scalarMs << "ms (" << scalarMs / simdMs << "{) " <<
+				(isSame ? "v" : "sv") << "\n";
+		}
+	}
+
+/**
+* ~bv}bv̍쐬xv
+*
+* ̎s͗lkʂŁA`ԂŕςĂ邱ƂmF
+*/
+	void Mipmap()
+	{
+		static const char* const paths[] = {
+			"Res/Ground.tga",
+			"Res/Human.tga",
+			"Res/wallHeight.tga",
+			"Res/wallWidth.tga",
+		};
+		const int iterations = 20;
+
+		std::cout << "[mipmap] ~bv}bv쐬(" << iterations << "̕)\n";
+		for (const char* path : paths)
+		{
+			Texture::ImageData image;
+			if (!Texture::LoadImageData(path, image))
+			{
+				continue;
+			}
+			std::vector<Texture::ImageData> mipLevels;
+			const double ms = MeasureTime([&]() {
+				MipmapGenerator::Generate(image, mipLevels);
+			}, iterations);
+			std::cout << "  " << path << " " << image.width << "x" << image.height <<
+				" i=" << mipLevels.size() + 1 << " " << ms << "ms " <<
+				(image.data.size() / (1024.0 * 1024.0)) / (ms / 1000.0) << "MB/s\n";
+		}
+
+		//Ɣ̕ς́AsRGBł128ł͂Ȃ188ɂȂ
+		Texture::ImageData checker;
+		checker.width = 2;
+		checker.height = 2;
+		checker.format = GL_RGBA;
+		checker.data = {
+			0, 0, 0, 255,  255, 255, 255, 255,
+			255, 255, 255, 255,  0, 0, 0, 255,
+		};
+		Texture::ImageData reduced;
+		MipmapGenerator::Downsample(checker, reduced, true);
+		std::cout << "[mipmap] s͗l̏k=" << static_cast<int>(reduced.data[0]) <<
+			"(Ғl188)\n";
+	}
+
+/**
+* ubNk̑xƉ掿(PSNR)v
+*/
+	void TextureCompress()
+	{
+		static const char* const paths[] = {
+			"Res/Ground.tga",
+			"Res/Human.tga",
+			"Res/TitleLogo.tga",
+			"Res/wallHeight.tga",
+			"Res/wallWidth.tga",
+		};
+		struct Format
+		{
+			const char* name;
+			BlockCompressor::BlockFormat format;
+			bool hasAlpha;
+		};
+		static const Format formats[] = {
+			{ "BC1", BlockCompressor::BlockFormat::BC1, false },
+			{ "BC3", BlockCompressor::BlockFormat::BC3, true },
+			{ "BC7", BlockCompressor::BlockFormat::BC7, true },
+		};
+		const int iterations = 3;
+
+		std::cout << "[texture-compress] ubNk(" << iterations << "̕)\n";
+		for (const char* path : paths)
+		{
+			Texture::ImageData image;
+			if (!Texture::LoadImageData(path, image))
+			{
+				continue;
+			}
+			const double pixelCount = static_cast<double>(image.width) * image.height;
+			for (const Format& f : formats)
+			{
+				std::vector<uint8_t> blocks;
+				const double ms = MeasureTime([&]() {
+					BlockCompressor::Compress(image, f.format, blocks);
+				}, iterations);
+				Texture::ImageData decoded;
+				BlockCompressor::Decompress(blocks.data(), image.width, image.height, f.format, decoded);
+				std::cout << "  " << path << " " << f.name << " " << ms << "ms " <<
+					pixelCount / (ms * 1000.0) << "Mf/s PSNR=" <<
+					BlockCompressor::ComputePsnr(image, decoded, f.hasAlpha) << "dB " <<
+					image.data.size() / 1024 << "KiB->" << blocks.size() / 1024 << "KiB\n";
+			}
+		}
+	}
+
+/**
+* OS̃t@C LbVt@Cj
+*
+* @param path jt@C
+*
+* @retval true  jvł
+* @retval false vłȂ
+*/
+	bool DropFileCache(const char* path)
+	{
+#ifdef _WIN32
+		//LbVg킸ɊJƁÃt@C̃LbV͔j
+		HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+			nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		CloseHandle(file);
+		return true;
+#else
+		const int fd = open(path, O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+		//ݒ̃y[W͔jłȂ̂ŁAɃfBXN֏o
+		fdatasync(fd);
+		const bool result = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(fd);
+		return result;
+#endif
+	}
+
+/**
+* AZbgSēǂݍ
+*
+* @param paths ǂݍރt@C̔z
+*
+* @return ǂݍ񂾃oCg
+*
+* SẴy[WɐGāAۂɃfBXNǂݍ܂
+*/
+	size_t ReadAssets(const std::vector<const char*>& paths)
+	{
+		size_t totalBytes = 0;
+		volatile uint8_t sum = 0;
+		for (const char* path : paths)
+		{
+			AssetFile file(path);
+			for (size_t i = 0; i < file.Size(); i += 4096)
+			{
+				sum += file.Data()[i];
+			}
+			totalBytes += file.Size();
+		}
+		return totalBytes;
+	}
+
+/**
+* t@CPʂƃAZbg pbNŁAN̓ǂݍݎԂׂ
+*
+* OS̃t@C LbVjāAN(R[h)̓ǂݍ݂Č.
+* LbVɍڂĂ(EH[)̎Ԃ킹ĕ\
+*/
+	void AssetPackIo()
+	{
+		static const char* const candidates[] = {
+			"Res/Simple.vert",
+			"Res/Simple.frag",
+			"Res/FragmentLighting.vert",
+			"Res/FragmentLighting.frag",
+			"Res/MeshListPacked.cache",
+			"Res/MeshList.cache",
+			"Res/TitleBack.tga",
+			"Res/TitleLogo.tga",
+			"Res/Ground.tga",
+			"Res/Human.tga",
+			"Res/wallWidth.tga",
+			"Res/wallHeight.tga",
+		};
+		std::vector<const char*> paths;
+		for (const char* path : candidates)
+		{
+			if (!MappedFile(path).IsNull())
+			{
+				paths.push_back(path);
+			}
+		}
+		const char* const rawPackPath = "Res/Benchmark.pak";
+		const char* const lz4PackPath = "Res/BenchmarkLz4.pak";
+		AssetPack& pack = AssetPack::Instance();
+		pack.Close();
+		if (!AssetPack::Build(rawPackPath, paths.data(), paths.size(), false) ||
+			!AssetPack::Build(lz4PackPath, paths.data(), paths.size(), true))
+		{
+			return;
+		}
+
+		//pbNǂݍ񂾓ẽt@Cƈv邩m߂
+		struct Mode
+		{
+			const char* name;
+			const char* packPath;
+		};
+		const Mode modes[] = {
+			{ "t@CP", nullptr },
+			{ "pbN", rawPackPath },
+			{ "pbN(LZ4)", lz4PackPath },
+		};
+		bool isSame = true;
+		for (const Mode& mode : modes)
+		{
+			if (!mode.packPath || !pack.Open(mode.packPath))
+			{
+				continue;
+			}
+			for (const char* path : paths)
+			{
+				const MappedFile original(path);
+				const AssetFile packed(path);
+				isSame &= packed.IsPacked() && packed.Size() == original.Size() &&
+					memcmp(packed.Data(), original.Data(), original.Size()) == 0;
+			}
+			pack.Close();
+		}
+
+		const int iterations = 5;
+		std::cout << "[asset-pack] N̓ǂݍ(t@C=" << paths.size() <<
+			", " << iterations << "̕) e" << (isSame ? "v" : "sv") << "\n";
+		for (const Mode& mode : modes)
+		{
+			bool isDropped = true;
+			double coldMs = 0;
+			size_t totalBytes = 0;
+			for (int i = 0; i < iterations; ++i)
+			{
+				for (const char* path : paths)
+				{
+					isDropped &= DropFileCache(path);
+				}
+				isDropped &= DropFileCache(rawPackPath);
+				isDropped &= DropFileCache(lz4PackPath);
+				coldMs += MeasureTime([&]() {
+					if (mode.packPath)
+					{
+						pack.Open(mode.packPath);
+					}
+					totalBytes = ReadAssets(paths);
+					pack.Close();
+				}, 1);
+			}
+			coldMs /= iterations;
+			const double warmMs = MeasureTime([&]() {
+				if (mode.packPath)
+				{
+					pack.Open(mode.packPath);
+				}
+				ReadAssets(paths);
+				pack.Close();
+			}, iterations);
+			const size_t fileBytes = mode.packPath ? MappedFile(mode.packPath).Size() : totalBytes;
+			std::cout << "  " << mode.name << " R[h=" << coldMs << "ms" <<
+				(isDropped ? "" : "(LbVjɎs)") << " EH[=" << warmMs <<
+				"ms ǂݍݗ=" << fileBytes / 1024 << "KiB\n";
+		}
+		remove(rawPackPath);
+		remove(lz4PackPath);
+	}
+
+/**
+* OpenGL̏ԃLbVȗłĂяo̐v
+*
+* CQ[ʂƓ菇̕`AOpenGL̑RecordingGLBackend֑.
+* `̓eNX`z̑wƂɂ܂Ƃ܂ĂāA唼͉̂̕]ĂȂ
+*/
+	void GLState()
+	{
+		RecordingGLBackend recorder;
+		GLStateCache& cache = GLStateCache::Instance();
+		cache.SetBackend(&recorder);
+
+		const GLuint program = 1;
+		const GLuint vao = 1;
+		const GLuint texArray = 1;
+		const GLint locMatMVP = 0;
+		const GLint locDirLightDir = 1;
+		const GLint locDirLightCol = 2;
+		const GLint locAmbLightCol = 3;
+		const GLint locTextureLayer = 4;
+
+		struct Object
+		{
+			GLint layer;
+			glm::mat4 matModel;
+			glm::mat3 matInvRotate;
+		};
+		const int objectCount = 1000;
+		std::mt19937 rand(1);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> angle(0.0f, glm::radians(360.0f));
+		std::vector<Object> objects(objectCount);
+		for (int i = 0; i < objectCount; ++i)
+		{
+			Object& e = objects[i];
+			e.layer = static_cast<GLint>(rand() % 4);
+			const glm::mat4 matRotate = glm::rotate(glm::mat4(1),
+				i % 10 == 0 ? angle(rand) : 0.0f, glm::vec3(0, 1, 0));
+			e.matModel = glm::translate(glm::mat4(1),
+				glm::vec3(position(rand), 0, position(rand))) * matRotate;
+			e.matInvRotate = glm::inverse(glm::mat3(matRotate));
+		}
+		std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {
+			return a.layer < b.layer;
+		});
+		const glm::mat4 matVP = glm::perspective(glm::radians(45.0f), 1000.0f / 600.0f, 0.1f, 500.0f);
+		const glm::vec3 dirLightDir = glm::normalize(glm::vec3(-5, -50, -15));
+
+		const int frameCount = 60;
+		const GLStateCache::Statistics before = cache.GetTotalStatistics();
+		const double ms = MeasureTime([&]() {
+			cache.BeginFrame();
+			cache.UseProgram(program);
+			cache.BindVertexArray(vao);
+			cache.SetUniform(program, locAmbLightCol, glm::vec3(0.7f, 1.4f, 1.4f));
+			cache.SetUniform(program, locDirLightCol, glm::vec3(1));
+			cache.BindTexture(0, GL_TEXTURE_2D_ARRAY, texArray);
+			for (const Object& e : objects)
+			{
+				cache.SetUniform(program, locTextureLayer, e.layer);
+				cache.SetUniform(program, locMatMVP, matVP * e.matModel);
+				cache.SetUniform(program, locDirLightDir, e.matInvRotate * dirLightDir);
+			}
+		}, frameCount);
+		cache.BeginFrame();
+		const GLStateCache::Statistics frame = cache.GetFrameStatistics();
+		const GLStateCache::Statistics total = cache.GetTotalStatistics();
+		const size_t issuedCalls = total.issuedCalls - before.issuedCalls;
+
+		std::cout << "[gl-state] " << objectCount << "̕`(" << frameCount <<
+			"t[) L^" << (recorder.Calls().size() == issuedCalls ? "v" : "sv") << "\n";
+		std::cout << "  Ō̃t[ v=" << frame.issuedCalls + frame.redundantCalls <<
+			" s=" << frame.issuedCalls << " ȗ=" << frame.redundantCalls << "\n";
+		std::cout << "  ֐(St[) glUseProgram=" << recorder.Count("glUseProgram") <<
+			" glBindTexture=" << recorder.Count("glBindTexture") <<
+			" glBindVertexArray=" << recorder.Count("glBindVertexArray") <<
+			" glProgramUniform1i=" << recorder.Count("glProgramUniform1i") <<
+			" glProgramUniform3fv=" << recorder.Count("glProgramUniform3fv") <<
+			" glProgramUniformMatrix4fv=" << recorder.Count("glProgramUniformMatrix4fv") << "\n";
+		std::cout << "  1t[̏=" << ms << "ms\n";
+
+		cache.SetBackend(nullptr);
+	}
+
+
+/**
+* AN^[̃fsAMVPsACǧ̌vZxv
+*
+* `悲ƂglmŌvZ]̕@ƁATransformBatchł܂Ƃ߂ČvZ@ׂ
+*/
+	void Transform()
+	{
+		const int objectCount = 10000;
+		std::mt19937 rand(1);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> angle(-glm::radians(360.0f), glm::radians(360.0f));
+		std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+		TransformBatch::Arrays input;
+		for (int i = 0; i < objectCount; ++i)
+		{
+			input.Push(glm::vec3(position(rand), position(rand), position(rand)),
+				glm::vec3(angle(rand), angle(rand), angle(rand)),
+				glm::vec3(scale(rand), scale(rand), scale(rand)));
+		}
+		const glm::mat4 matVP =
+			glm::perspective(glm::radians(45.0f), 1000.0f / 600.0f, 0.1f, 500.0f) *
+			glm::lookAt(glm::vec3(0, 20, 50), glm::vec3(0), glm::vec3(0, 1, 0));
+		const glm::vec3 dirLightDir = glm::normalize(glm::vec3(-5, -50, -15));
+
+		std::vector<glm::mat4> matModel(objectCount);
+		std::vector<glm::mat4> matMVP(objectCount);
+		std::vector<glm::vec3> lightDir(objectCount);
+		TransformBatch::Output output;
+		output.matModel = matModel.data();
+		output.matMVP = matMVP.data();
+		output.lightDirection = lightDir.data();
+
+		//Program::DrawƓA`悲ƂglmŌvZ@
+		const int iterations = 100;
+		const double glmMs = MeasureTime([&]() {
+			for (int i = 0; i < objectCount; ++i)
+			{
+				const glm::vec3 t(input.positionX[i], input.positionY[i], input.positionZ[i]);
+				const glm::vec3 r(input.rotationX[i], input.rotationY[i], input.rotationZ[i]);
+				const glm::vec3 s(input.scaleX[i], input.scaleY[i], input.scaleZ[i]);
+				const glm::mat4 matRotateZ = glm::rotate(glm::mat4(1), r.z, glm::vec3(0, 0, -1));
+				const glm::mat4 matRotateXZ = glm::rotate(matRotateZ, r.x, glm::vec3(1, 0, 0));
+				const glm::mat4 matRotateYXZ = glm::rotate(matRotateXZ, r.y, glm::vec3(0, 1, 0));
+				matModel[i] = glm::translate(glm::mat4(1), t) * matRotateYXZ *
+					glm::scale(glm::mat4(1), s);
+				matMVP[i] = matVP * matModel[i];
+				lightDir[i] = glm::inverse(glm::mat3(matRotateYXZ)) * dirLightDir;
+			}
+		}, iterations);
+		const std::vector<glm::mat4> expectedModel = matModel;
+		const std::vector<glm::mat4> expectedMVP = matMVP;
+		const std::vector<glm::vec3> expectedLightDir = lightDir;
+
+		//ҒlƂ̍ő덷߂(MVPs͒l傫̂őΌ덷)
+		const auto maxError = [&]() {
+			float error = 0;
+			for (int i = 0; i < objectCount; ++i)
+			{
+				for (int col = 0; col < 4; ++col)
+				{
+					for (int row = 0; row < 4; ++row)
+					{
+						const float e = expectedMVP[i][col][row];
+						error = std::max(error, std::abs(matModel[i][col][row] -
+							expectedModel[i][col][row]));
+						error = std::max(error,
+							std::abs(matMVP[i][col][row] - e) / std::max(std::abs(e), 1.0f));
+					}
+				}
+				for (int k = 0; k < 3; ++k)
+				{
+					error = std::max(error, std::abs(lightDir[i][k] - expectedLightDir[i][k]));
+				}
+			}
+			return error;
+		};
+
+		const double scalarMs = MeasureTime([&]() {
+			TransformBatch::ComputeScalar(input, matVP, dirLightDir, output);
+		}, iterations);
+		const float scalarError = maxError();
+		const double simdMs = MeasureTime([&]() {
+			TransformBatch::Compute(input, matVP, dirLightDir, output);
+		}, iterations);
+		const float simdError = maxError();
+
+		const char* const simdName = TransformBatch::IsAvxEnabled() ? "AVX" :
+			(TransformBatch::IsSimdEnabled() ? "SSE" : "");
+		const double nsPerObject = 1000000.0 / objectCount;
+		std::cout << "[transform] " << objectCount << " SIMD=" << simdName << "\n";
+		std::cout << "  `悲Ƃglm    " << glmMs * nsPerObject << "ns/\n";
+		std::cout << "  ܂Ƃ߂(XJ) " << scalarMs * nsPerObject << "ns/ (" <<
+			glmMs / scalarMs << "{) ő덷=" << scalarError << "\n";
+		std::cout << "  ܂Ƃ߂(SIMD)   " << simdMs * nsPerObject << "ns/ (" <<
+			glmMs / simdMs << "{) ő덷=" << simdError << "\n";
+	}
+
+
+/**
+* `L[̕בւƕ`施߂̍쐬ɂ鎞Ԃv
+*
+* vO8ށAeNX`32AbV64ނ_ɑgݍ킹`g.
+* OpenGL͎gȂ̂ŁAFlush̕`施߂̔s͊܂܂Ȃ
+*/
+	void RenderQueueSort()
+	{
+		const int programCount = 8;
+		const int textureCount = 32;
+		const int meshCount = 64;
+		std::vector<Shader::Program> programs(programCount);
+		std::vector<Mesh> meshes(meshCount);
+		for (int i = 0; i < meshCount; ++i)
+		{
+			Mesh& mesh = meshes[i];
+			mesh = Mesh();
+			mesh.mode = GL_TRIANGLES;
+			mesh.indexType = i % 2 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+			mesh.baseVertex = i * 1000;
+			mesh.positionScale = { 1, 1, 1 };
+			mesh.lodCount = 1;
+			mesh.lods[0].count = 36 + i * 3;
+			mesh.lods[0].indices = reinterpret_cast<const GLvoid*>(static_cast<uintptr_t>(i * 4096));
+		}
+
+		const size_t packetCounts[] = { 10000, 100000, 1000000 };
+		for (const size_t packetCount : packetCounts)
+		{
+			std::mt19937 rand(1);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			std::uniform_real_distribution<float> depth(0.1f, 500.0f);
+			RenderQueue queue;
+			const auto submitAll = [&]() {
+				queue.Clear();
+				for (size_t i = 0; i < packetCount; ++i)
+				{
+					const int mesh = static_cast<int>(rand() % meshCount);
+					queue.Submit(rand() % 10 ? RenderPass::Opaque : RenderPass::Transparent,
+						programs[rand() % programCount], static_cast<GLuint>(rand() % textureCount + 1),
+						GL_TEXTURE_2D_ARRAY, meshes[mesh], mesh, 0,
+						glm::translate(glm::mat4(1), glm::vec3(position(rand), 0, position(rand))),
+						static_cast<GLint>(rand() % 4), depth(rand));
+				}
+			};
+			const int iterations = std::max(1, static_cast<int>(1000000 / packetCount));
+			const double submitMs = MeasureTime(submitAll, 1);
+			const double sortMs = MeasureTime([&]() { queue.Sort(); }, iterations);
+			const double buildMs = MeasureTime([&]() { queue.Build(); }, iterations);
+
+			//r̂߁AL[WCu̔r\[gŕבւ
+			std::vector<uint64_t> keys = queue.SortedKeys();
+			std::shuffle(keys.begin(), keys.end(), rand);
+			std::vector<uint64_t> tmp;
+			const double stdSortMs = MeasureTime([&]() {
+				tmp = keys;
+				std::stable_sort(tmp.begin(), tmp.end());
+			}, iterations);
+			const bool isSorted = std::is_sorted(queue.SortedKeys().begin(), queue.SortedKeys().end());
+
+			std::cout << "[render-queue] `" << packetCount << " я" <<
+				(isSorted ? "" : "ُ") << "\n";
+			std::cout << "  ǉ=" << submitMs << "ms \[g=" << sortMs <<
+				"ms (std::stable_sort=" << stdSortMs << "ms) `施߂̍쐬=" << buildMs << "ms\n";
+			std::cout << "  `施=" << queue.Commands().size() <<
+				" ܂Ƃ܂(glMultiDrawElementsIndirect̉)=" << queue.Batches().size() << "\n";
+		}
+	}
+
+/**
+* JȎxv
+*
+* _ɔzuEASIMDłSIMDȂłŔ肵Čʂv邱ƂmF
+*/
+	void FrustumCull()
+	{
+		const int objectCount = 100000;
+		std::mt19937 rand(1);
+		std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+		std::uniform_real_distribution<float> radius(0.5f, 3.0f);
+		SphereArrays spheres;
+		for (int i = 0; i < objectCount; ++i)
+		{
+			spheres.Push(glm::vec3(position(rand), position(rand), position(rand)), radius(rand));
+		}
+		FrustumCuller culler;
+		culler.SetViewProjectionMatrix(
+			glm::perspective(glm::radians(45.0f), 1000.0f / 600.0f, 0.1f, 500.0f) *
+			glm::lookAt(glm::vec3(0, 20, 50), glm::vec3(0), glm::vec3(0, 1, 0)));
+
+		const int iterations = 100;
+		std::vector<uint32_t> scalarIndices;
+		std::vector<uint32_t> simdIndices;
+		const double scalarMs = MeasureTime([&]() {
+			culler.CullScalar(spheres, scalarIndices);
+		}, iterations);
+		const double simdMs = MeasureTime([&]() {
+			culler.Cull(spheres, simdIndices);
+		}, iterations);
+		const bool isSame = scalarIndices == simdIndices;
+
+		const double nsPerObject = 1000000.0 / objectCount;
+		std::cout << "[frustum-cull] E" << objectCount << " SIMD=" <<
+			(FrustumCuller::IsSimdEnabled() ? "SSE" : "") << " \=" <<
+			simdIndices.size() << " O=" << objectCount - simdIndices.size() << "\n";
+		std::cout << "  XJ " << scalarMs << "ms (" << scalarMs * nsPerObject << "ns/)\n";
+		std::cout << "  SIMD   " << simdMs << "ms (" << simdMs * nsPerObject << "ns/, " <<
+			scalarMs / simdMs << "{) " << (isSame ? "v" : "sv") << "\n";
+	}
+
+/**
+* BVH̍쐬Ɩ₢킹̑xv
+*
+* SĂ̂̕1ׂʂƔׂāA₢킹̌ʂƂmF.
+* ۑēǂݍݒBVHʂԂƂmF
+*/
+	void BvhQuery()
+	{
+		const int objectCount = 100000;
+		std::mt19937 rand(1);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> size(0.5f, 8.0f);
+		std::vector<Aabb> boxes(objectCount);
+		for (Aabb& box : boxes)
+		{
+			box.min = glm::vec3(position(rand), position(rand) * 0.1f, position(rand));
+			box.max = box.min + glm::vec3(size(rand), size(rand), size(rand));
+		}
+
+		//쐬̑xXbhƂɔׂ. ʂ̓Xbhɂ炸ɂȂ
+		Bvh bvh;
+		const double singleMs = MeasureTime([&]() { bvh.Build(boxes, 1); }, 5);
+		const std::vector<Bvh::Node> singleNodes = bvh.Nodes();
+		const double parallelMs = MeasureTime([&]() { bvh.Build(boxes); }, 5);
+		const bool isSameTree = singleNodes.size() == bvh.Nodes().size() &&
+			memcmp(singleNodes.data(), bvh.Nodes().data(), singleNodes.size() * sizeof(Bvh::Node)) == 0;
+		const Bvh::Statistics stats = bvh.GetStatistics();
+		std::cout << "[bvh] " << objectCount << " m[h=" << stats.nodeCount <<
+			" t=" << stats.leafCount << " [=" << stats.maxDepth <<
+			" SAHRXg=" << stats.sahCost << "\n";
+		std::cout << "  쐬 1Xbh=" << singleMs << "ms =" << parallelMs <<
+			"ms (" << singleMs / parallelMs << "{) " << (isSameTree ? "v" : "sv") << "\n";
+
+		//̖₢킹
+		const Frustum frustum = Frustum::FromMatrix(
+			glm::perspective(glm::radians(45.0f), 1000.0f / 600.0f, 0.1f, 500.0f) *
+			glm::lookAt(glm::vec3(0, 20, 0), glm::vec3(100, 0, 100), glm::vec3(0, 1, 0)));
+		std::vector<uint32_t> linearResult, bvhResult;
+		const int iterations = 100;
+		const double linearFrustumMs = MeasureTime([&]() {
+			linearResult.clear();
+			for (int i = 0; i < objectCount; ++i)
+			{
+				if (frustum.TestBox(boxes[i].min, boxes[i].max))
+				{
+					linearResult.push_back(i);
+				}
+			}
+		}, iterations);
+		const double bvhFrustumMs = MeasureTime([&]() {
+			bvh.QueryFrustum(frustum, bvhResult);
+		}, iterations);
+		std::sort(bvhResult.begin(), bvhResult.end());
+		std::cout << "   S=" << linearFrustumMs << "ms BVH=" << bvhFrustumMs <<
+			"ms (" << linearFrustumMs / bvhFrustumMs << "{) Y=" << bvhResult.size() <<
+			" " << (linearResult == bvhResult ? "v" : "sv") << "\n";
+
+		//E{bNX̖₢킹
+		const int boxQueryCount = 1000;
+		std::vector<Aabb> queries(boxQueryCount);
+		for (Aabb& q : queries)
+		{
+			q.min = glm::vec3(position(rand), -50, position(rand));
+			q.max = q.min + glm::vec3(20, 100, 20);
+		}
+		size_t linearHits = 0, bvhHits = 0;
+		const double linearBoxMs = MeasureTime([&]() {
+			linearHits = 0;
+			for (const Aabb& q : queries)
+			{
+				for (const Aabb& box : boxes)
+				{
+					linearHits += box.min.x <= q.max.x && box.max.x >= q.min.x &&
+						box.min.y <= q.max.y && box.max.y >= q.min.y &&
+						box.min.z <= q.max.z && box.max.z >= q.min.z;
+				}
+			}
+		}, 1);
+		const double bvhBoxMs = MeasureTime([&]() {
+			bvhHits = 0;
+			for (const Aabb& q : queries)
+			{
+				bvhHits += bvh.QueryBox(q.min, q.max, bvhResult);
+			}
+		}, 1);
+		std::cout << "  {bNX" << boxQueryCount << " S=" << linearBoxMs << "ms BVH=" <<
+			bvhBoxMs << "ms (" << linearBoxMs / bvhBoxMs << "{) " <<
+			(linearHits == bvhHits ? "v" : "sv") << "\n";
+
+		//Op`BVHɃC΂. n`̂悤ȋN̂iqg
+		const int gridSize = 256;
+		std::vector<glm::vec3> positions;
+		positions.reserve((gridSize + 1) * (gridSize + 1));
+		for (int z = 0; z <= gridSize; ++z)
+		{
+			for (int x = 0; x <= gridSize; ++x)
+			{
+				const float height = std::sin(x * 0.1f) * std::cos(z * 0.13f) * 5.0f;
+				positions.push_back(glm::vec3(x - gridSize * 0.5f, height, z - gridSize * 0.5f));
+			}
+		}
+		std::vector<uint32_t> indices;
+		for (int z = 0; z < gridSize; ++z)
+		{
+			for (int x = 0; x < gridSize; ++x)
+			{
+				const uint32_t i = z * (gridSize + 1) + x;
+				const uint32_t quad[] = { i, i + gridSize + 1, i + 1, i + 1, i + gridSize + 1, i + gridSize + 2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		const size_t triangleCount = indices.size() / 3;
+		Bvh triangleBvh;
+		const double triangleBuildMs = MeasureTime([&]() {
+			triangleBvh.BuildFromTriangles(positions.data(), positions.size(),
+				indices.data(), triangleCount);
+		}, 1);
+
+		const int rayCount = 10000;
+		std::vector<glm::vec3> rayOrigins(rayCount), rayDirections(rayCount);
+		std::uniform_real_distribution<float> rayPosition(-gridSize * 0.5f, gridSize * 0.5f);
+		for (int i = 0; i < rayCount; ++i)
+		{
+			rayOrigins[i] = glm::vec3(rayPosition(rand), 30, rayPosition(rand));
+			rayDirections[i] = glm::vec3(rayPosition(rand), -30, rayPosition(rand)) * 0.01f;
+		}
+		int rayHitCount = 0;
+		std::vector<Bvh::RayHit> hits(rayCount);
+		const double rayMs = MeasureTime([&]() {
+			rayHitCount = 0;
+			for (int i = 0; i < rayCount; ++i)
+			{
+				if (!triangleBvh.Raycast(rayOrigins[i], rayDirections[i], FLT_MAX, hits[i]))
+				{
+					hits[i].index = UINT32_MAX;
+				}
+				else
+				{
+					++rayHitCount;
+				}
+			}
+		}, 1);
+
+		//SĂ̎Op`𒲂ׂʂƔׂ(Ԃ̂ňꕔ̃C).
+		//͎Op`܂ޕʂƂ̌_A3ӂ̓ɂ邩Œׂ
+		const auto intersect = [](const glm::vec3& o, const glm::vec3& d, const glm::vec3* v) {
+			const glm::vec3 n = glm::cross(v[1] - v[0], v[2] - v[0]);
+			const float dn = glm::dot(d, n);
+			if (dn == 0)
+			{
+				return FLT_MAX;
+			}
+			const float t = glm::dot(v[0] - o, n) / dn;
+			const glm::vec3 p = o + d * t;
+			for (int k = 0; k < 3; ++k)
+			{
+				if (glm::dot(glm::cross(v[(k + 1) % 3] - v[k], p - v[k]), n) < 0)
+				{
+					return FLT_MAX;
+				}
+			}
+			return t >= 0 ? t : FLT_MAX;
+		};
+		int rayMismatchCount = 0;
+		const int checkRayCount = 100;
+		for (int i = 0; i < checkRayCount; ++i)
+		{
+			float expected = FLT_MAX;
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				const glm::vec3 v[] = { positions[indices[t * 3]],
+					positions[indices[t * 3 + 1]], positions[indices[t * 3 + 2]] };
+				expected = std::min(expected, intersect(rayOrigins[i], rayDirections[i], v));
+			}
+			const float actual = hits[i].index == UINT32_MAX ? FLT_MAX : hits[i].distance;
+			if (std::abs(expected - actual) > 1e-4f * std::max(1.0f, expected))
+			{
+				++rayMismatchCount;
+			}
+		}
+		std::cout << "  Op`" << triangleCount << " 쐬=" << triangleBuildMs <<
+			"ms C" << rayCount << "{=" << rayMs << "ms (" <<
+			rayMs * 1000000.0 / rayCount << "ns/{) =" << rayHitCount <<
+			" SƂ̕sv=" << rayMismatchCount << "/" << checkRayCount << "\n";
+
+		//ۑēǂݍݒ
+		const char* const path = "bvh_benchmark.tmp";
+		Bvh loaded;
+		const bool isSaved = triangleBvh.Save(path) && loaded.Load(path);
+		remove(path);
+		bool isSameResult = isSaved;
+		for (int i = 0; i < rayCount && isSameResult; ++i)
+		{
+			Bvh::RayHit hit;
+			const bool isHit = loaded.Raycast(rayOrigins[i], rayDirections[i], FLT_MAX, hit);
+			isSameResult = isHit == (hits[i].index != UINT32_MAX) &&
+				(!isHit || (hit.index == hits[i].index && hit.distance == hits[i].distance));
+		}
+		std::cout << "  ۑƓǂݍ" << (isSameResult ? "" : "s") << "\n";
+	}
+
+/**
+* IN[WJȎxv
+*
+* ̕ԊX𓹘H̍猩āẢAɉB镨̂𔻒肷.
+* SIMDłSIMDȂłŐ[xobt@v邱ƂƁAÔ{ɉBĂ邱ƂmF
+*/
+	void OcclusionCull()
+	{
+		//(Օ)iqɕׂ. ̊Ԃ͕4̓HɂȂ
+		const int blockCount = 16;
+		const float blockPitch = 20.0f;
+		const float roadWidth = 4.0f;
+		std::mt19937 rand(1);
+		std::uniform_real_distribution<float> buildingHeight(8.0f, 40.0f);
+		std::vector<Aabb> buildings;
+		for (int z = 0; z < blockCount; ++z)
+		{
+			for (int x = 0; x < blockCount; ++x)
+			{
+				const glm::vec3 origin((x - blockCount / 2) * blockPitch, 0, (z - blockCount / 2) * blockPitch);
+				buildings.push_back({ origin + glm::vec3(roadWidth * 0.5f, 0, roadWidth * 0.5f),
+					origin + glm::vec3(blockPitch - roadWidth * 0.5f, buildingHeight(rand), blockPitch - roadWidth * 0.5f) });
+			}
+		}
+
+		//肷镨͓̂HƉɒu
+		const int objectCount = 20000;
+		std::uniform_int_distribution<int> blockIndex(0, blockCount * blockCount - 1);
+		std::uniform_real_distribution<float> offset(0.0f, blockPitch);
+		std::uniform_real_distribution<float> size(0.2f, 1.2f);
+		std::vector<Aabb> objects(objectCount);
+		for (int i = 0; i < objectCount; ++i)
+		{
+			const Aabb& building = buildings[blockIndex(rand)];
+			const float s = size(rand);
+			glm::vec3 min;
+			if (i % 4 == 0)
+			{
+				min = glm::vec3(building.min.x + offset(rand) * 0.5f, building.max.y, building.min.z + offset(rand) * 0.5f);
+			}
+			else
+			{
+				//̎O̓H(ƏdȂȂ悤ɁAH̒t߂ɒu)
+				min = glm::vec3(building.min.x - roadWidth * 0.5f - s * 0.5f, 0, building.min.z + offset(rand) * 0.5f);
+			}
+			objects[i] = { min, min + glm::vec3(s) };
+		}
+
+		//_͓H̏ɒuAHɉĊX̉
+		const glm::vec3 eye(0, 1.7f, -170);
+		const glm::mat4 matVP =
+			glm::perspective(glm::radians(60.0f), 1000.0f / 600.0f, 0.1f, 500.0f) *
+			glm::lookAt(eye, glm::vec3(40, 6, 160), glm::vec3(0, 1, 0));
+		const Frustum frustum = Frustum::FromMatrix(matVP);
+
+		OcclusionCuller culler;
+		if (!culler.Init(320, 192))
+		{
+			return;
+		}
+		culler.BeginFrame(matVP);
+		for (const Aabb& e : buildings)
+		{
+			culler.AddOccluderBox(e.min, e.max);
+		}
+		const int iterations = 100;
+		const double scalarMs = MeasureTime([&]() { culler.RasterizeScalar(); }, iterations);
+		const std::vector<float> scalarDepth = culler.DepthBuffer();
+		const double simdMs = MeasureTime([&]() { culler.Rasterize(); }, iterations);
+		const bool isSameDepth = scalarDepth == culler.DepthBuffer();
+
+		//ƏdȂ镨̂𔻒肷
+		std::vector<uint32_t> frustumIndices;
+		for (int i = 0; i < objectCount; ++i)
+		{
+			if (frustum.TestBox(objects[i].min, objects[i].max))
+			{
+				frustumIndices.push_back(i);
+			}
+		}
+		std::vector<uint32_t> visibleIndices;
+		const double testMs = MeasureTime([&]() {
+			visibleIndices = frustumIndices;
+			culler.Cull(objects, visibleIndices);
+		}, iterations);
+
+		//Ô̒_ƒSɌāABVHŃC΂.
+		//ʓɂāAǂ̌ɂՂȂ_ΌďOĂ
+		Bvh buildingBvh;
+		buildingBvh.Build(buildings);
+		std::vector<bool> isVisible(objectCount, false);
+		for (const uint32_t i : visibleIndices)
+		{
+			isVisible[i] = true;
+		}
+		int falseCullCount = 0;
+		for (const uint32_t i : frustumIndices)
+		{
+			if (isVisible[i])
+			{
+				continue;
+			}
+			const Aabb& box = objects[i];
+			glm::vec3 points[9];
+			for (int k = 0; k < 8; ++k)
+			{
+				points[k] = glm::vec3(k & 1 ? box.max.x : box.min.x,
+					k & 2 ? box.max.y : box.min.y, k & 4 ? box.max.z : box.min.z);
+			}
+			points[8] = (box.min + box.max) * 0.5f;
+			for (const glm::vec3& p : points)
+			{
+				const glm::vec4 clip = matVP * glm::vec4(p, 1);
+				if (clip.w <= 0 || std::abs(clip.x) > clip.w || std::abs(clip.y) > clip.w)
+				{
+					continue;
+				}
+				const glm::vec3 toPoint = p - eye;
+				const float distance = glm::length(toPoint);
+				Bvh::RayHit hit;
+				if (!buildingBvh.Raycast(eye, toPoint / distance, distance * 0.999f, hit))
+				{
+					++falseCullCount;
+					break;
+				}
+			}
+		}
+
+		culler.BeginFrame(matVP);//Wṽt[߂āA`Op`̐擾
+		const OcclusionCuller::Statistics frameStats = culler.GetFrameStatistics();
+		const size_t culledCount = frustumIndices.size() - visibleIndices.size();
+		std::cout << "[occlusion] " << buildings.size() << " " << objectCount <<
+			" [xobt@=" << culler.Width() << "x" << culler.Height() << " SIMD=" <<
+			(OcclusionCuller::IsSimdEnabled() ? "SSE" : "") << "\n";
+		std::cout << "  Օ̕`(Op`" << frameStats.occluderTriangleCount << ") XJ=" <<
+			scalarMs << "ms SIMD=" << simdMs << "ms (" << scalarMs / simdMs << "{) [x" <<
+			(isSameDepth ? "v" : "sv") << "\n";
+		std::cout << "   =" << frustumIndices.size() << " O=" << culledCount <<
+			" (" << (frustumIndices.empty() ? 0.0 : 100.0 * culledCount / frustumIndices.size()) <<
+			"%) " << testMs << "ms (" << testMs * 1000000.0 / std::max<size_t>(1, frustumIndices.size()) <<
+			"ns/) ďO=" << falseCullCount << "\n";
+	}
+
+}//namespace Benchmark
@@ -0,0 +1,23 @@
+/**
+* @file Benchmark.h
+*/
+#ifndef BENCHMARK_H_INCLUDED
+#define BENCHMARK_H_INCLUDED
+
+//\v֐i[閼O
+namespace Benchmark {
+
+	bool Run(int argc, char** argv);
+	void TextureDecode();
+	void Mipmap();
+	void TextureCompress();
+	void AssetPackIo();
+	void GLState();
+	void Transform();
+	void RenderQueueSort();
+	void FrustumCull();
+	void BvhQuery();
+	void OcclusionCull();
+
+}//namespace Benchmark
+#endif //BENCHMARK_H_INCLUDED
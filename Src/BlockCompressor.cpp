@@ -0,0 +1,922 @@
+/**
+* @file BlockCompressor.cpp
+*/
+#include "BlockCompressor.h"
+#include "MipmapGenerator.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+//eNX`ubNk`ɕϊ֐i[閼O
+namespace BlockCompressor {
+
+	//BC7[h6̕Ԃ̏d(64)
+	const int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/**
+* ŏ@Œ[_߂Ƃ̍Ɨ̈
+*
+* efɂāu[_0̏d(w0)ƒ[_1̏d(w1)vݐςA
+* w0*a + w1*b ̐Fɍł߂Ȃa, b߂
+*/
+	struct LeastSquares
+	{
+		double aa = 0, ab = 0, bb = 0;
+		double ax[4] = {};
+		double bx[4] = {};
+
+		void Add(double w0, double w1, const uint8_t* x, int channels)
+		{
+			aa += w0 * w0;
+			ab += w0 * w1;
+			bb += w1 * w1;
+			for (int c = 0; c < channels; ++c)
+			{
+				ax[c] += w0 * x[c];
+				bx[c] += w1 * x[c];
+			}
+		}
+
+		bool Solve(float* a, float* b, int channels) const
+		{
+			const double det = aa * bb - ab * ab;
+			if (fabs(det) < 1e-8)
+			{
+				return false;
+			}
+			for (int c = 0; c < channels; ++c)
+			{
+				a[c] = static_cast<float>((ax[c] * bb - bx[c] * ab) / det);
+				b[c] = static_cast<float>((bx[c] * aa - ax[c] * ab) / det);
+			}
+			return true;
+		}
+	};
+
+/**
+* F̕z̎厲߁A厲̗[̐F߂
+*
+* @param rgba     4x4f̐F(RGBA8)
+* @param channels lvf(3܂4)
+* @param minColor 厲ōł[̐F
+* @param maxColor 厲ōł傫[̐F
+*
+* Uŝׂ@Ŏ厲߁Aef厲Ɏˉe͈͂[_Ƃ
+*/
+	void FindEndpoints(const uint8_t* rgba, int channels, float* minColor, float* maxColor)
+	{
+		float mean[4] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			for (int c = 0; c < channels; ++c)
+			{
+				mean[c] += rgba[i * 4 + c];
+			}
+		}
+		for (int c = 0; c < channels; ++c)
+		{
+			mean[c] /= 16.0f;
+		}
+		float cov[4][4] = {};
+		for (int i = 0; i < 16; ++i)
+		{
+			float d[4];
+			for (int c = 0; c < channels; ++c)
+			{
+				d[c] = rgba[i * 4 + c] - mean[c];
+			}
+			for (int r = 0; r < channels; ++r)
+			{
+				for (int c = 0; c < channels; ++c)
+				{
+					cov[r][c] += d[r] * d[c];
+				}
+			}
+		}
+
+		float axis[4] = { 1, 1, 1, 1 };
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			float next[4] = {};
+			float length = 0;
+			for (int r = 0; r < channels; ++r)
+			{
+				for (int c = 0; c < channels; ++c)
+				{
+					next[r] += cov[r][c] * axis[c];
+				}
+				length = std::max(length, fabsf(next[r]));
+			}
+			if (length <= 0)
+			{
+				break;
+			}
+			for (int c = 0; c < channels; ++c)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = -std::numeric_limits<float>::max();
+		float axisLength2 = 0;
+		for (int c = 0; c < channels; ++c)
+		{
+			axisLength2 += axis[c] * axis[c];
+		}
+		for (int i = 0; i < 16; ++i)
+		{
+			float t = 0;
+			for (int c = 0; c < channels; ++c)
+			{
+				t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+			}
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+		for (int c = 0; c < channels; ++c)
+		{
+			const float scale = axisLength2 > 0 ? axis[c] / axisLength2 : 0;
+			minColor[c] = std::min(std::max(mean[c] + minT * scale, 0.0f), 255.0f);
+			maxColor[c] = std::min(std::max(mean[c] + maxT * scale, 0.0f), 255.0f);
+		}
+	}
+
+/**
+* RGB565̐F쐬
+*/
+	uint16_t PackRgb565(const float* color)
+	{
+		const auto quantize = [](float v, int maxValue) {
+			return static_cast<int>(std::min(std::max(v, 0.0f), 255.0f) * maxValue / 255.0f + 0.5f);
+		};
+		return static_cast<uint16_t>((quantize(color[0], 31) << 11) |
+			(quantize(color[1], 63) << 5) | quantize(color[2], 31));
+	}
+
+/**
+* RGB565̐F8rbgRGBɓWJ
+*/
+	void UnpackRgb565(uint16_t c, int* rgb)
+	{
+		const int r = (c >> 11) & 31;
+		const int g = (c >> 5) & 63;
+		const int b = c & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+/**
+* BC14F̃pbg쐬
+*
+* @param c0          [_0
+* @param c1          [_1
+* @param isFourColor trueȂ4F[h(BC3̐FubN)
+* @param palette     pbg̊i[(4F x RGBA)
+*/
+	void MakeBc1Palette(uint16_t c0, uint16_t c1, bool isFourColor, int (*palette)[4])
+	{
+		UnpackRgb565(c0, palette[0]);
+		UnpackRgb565(c1, palette[1]);
+		palette[0][3] = palette[1][3] = 255;
+		if (isFourColor || c0 > c1)
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			palette[2][3] = palette[3][3] = 255;
+		}
+		else
+		{
+			for (int c = 0; c < 3; ++c)
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+			palette[2][3] = 255;
+			palette[3][3] = 0;
+		}
+	}
+
+/**
+* efɍł߂pbg̔ԍI
+*
+* @return 덷̓a
+*/
+	int SelectBc1Indices(const uint8_t* rgba, const int (*palette)[4], uint8_t* indices)
+	{
+		int totalError = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			int bestError = std::numeric_limits<int>::max();
+			for (int k = 0; k < 4; ++k)
+			{
+				int error = 0;
+				for (int c = 0; c < 3; ++c)
+				{
+					const int d = rgba[i * 4 + c] - palette[k][c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = static_cast<uint8_t>(k);
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+/**
+* BC1`̐FubN쐬
+*
+* @param rgba  4x4f̐F(RGBA8)
+* @param block kʂ̊i[(8oCg)
+*
+* 厲̗[lɂāAŏ@Œ[_2܂ŉP.
+* 4F[hŊi[̂ŁABC3̐FubNƂĂg
+*/
+	void EncodeColorBlock(const uint8_t* rgba, uint8_t* block)
+	{
+		float minColor[4];
+		float maxColor[4];
+		FindEndpoints(rgba, 3, minColor, maxColor);
+		uint16_t c0 = PackRgb565(maxColor);
+		uint16_t c1 = PackRgb565(minColor);
+
+		int palette[4][4];
+		uint8_t indices[16];
+		MakeBc1Palette(c0, c1, true, palette);
+		int bestError = SelectBc1Indices(rgba, palette, indices);
+		for (int iteration = 0; iteration < 2 && bestError > 0; ++iteration)
+		{
+			//pbgԍƂ̒[_0̏d
+			static const double weights[4] = { 1.0, 0.0, 2.0 / 3.0, 1.0 / 3.0 };
+			LeastSquares ls;
+			for (int i = 0; i < 16; ++i)
+			{
+				const double w = weights[indices[i]];
+				ls.Add(w, 1.0 - w, rgba + i * 4, 3);
+			}
+			float a[4];
+			float b[4];
+			if (!ls.Solve(a, b, 3))
+			{
+				break;
+			}
+			const uint16_t n0 = PackRgb565(a);
+			const uint16_t n1 = PackRgb565(b);
+			int newPalette[4][4];
+			uint8_t newIndices[16];
+			MakeBc1Palette(n0, n1, true, newPalette);
+			const int error = SelectBc1Indices(rgba, newPalette, newIndices);
+			if (error >= bestError)
+			{
+				break;
+			}
+			bestError = error;
+			c0 = n0;
+			c1 = n1;
+			memcpy(indices, newIndices, sizeof(indices));
+		}
+
+		//4F[hɂ邽߁A[_0[_1傫
+		if (c0 < c1)
+		{
+			std::swap(c0, c1);
+			static const uint8_t swapped[4] = { 1, 0, 3, 2 };
+			for (uint8_t& e : indices)
+			{
+				e = swapped[e];
+			}
+		}
+		else if (c0 == c1)
+		{
+			memset(indices, 0, sizeof(indices));
+		}
+
+		block[0] = static_cast<uint8_t>(c0);
+		block[1] = static_cast<uint8_t>(c0 >> 8);
+		block[2] = static_cast<uint8_t>(c1);
+		block[3] = static_cast<uint8_t>(c1 >> 8);
+		for (int row = 0; row < 4; ++row)
+		{
+			block[4 + row] = static_cast<uint8_t>(indices[row * 4] | (indices[row * 4 + 1] << 2) |
+				(indices[row * 4 + 2] << 4) | (indices[row * 4 + 3] << 6));
+		}
+	}
+
+/**
+* BC4`̃At@ ubN쐬
+*
+* @param rgba  4x4f̐F(RGBA8)
+* @param block kʂ̊i[(8oCg)
+*/
+	void EncodeAlphaBlock(const uint8_t* rgba, uint8_t* block)
+	{
+		int a0 = 0;
+		int a1 = 255;
+		for (int i = 0; i < 16; ++i)
+		{
+			a0 = std::max<int>(a0, rgba[i * 4 + 3]);
+			a1 = std::min<int>(a1, rgba[i * 4 + 3]);
+		}
+		block[0] = static_cast<uint8_t>(a0);
+		block[1] = static_cast<uint8_t>(a1);
+
+		//a0 > a18iK[hŁAefɍł߂iKI
+		uint64_t bits = 0;
+		if (a0 > a1)
+		{
+			int palette[8] = { a0, a1 };
+			for (int k = 1; k < 7; ++k)
+			{
+				palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+			}
+			for (int i = 0; i < 16; ++i)
+			{
+				int best = 0;
+				int bestError = 256;
+				for (int k = 0; k < 8; ++k)
+				{
+					const int error = abs(rgba[i * 4 + 3] - palette[k]);
+					if (error < bestError)
+					{
+						bestError = error;
+						best = k;
+					}
+				}
+				bits |= static_cast<uint64_t>(best) << (i * 3);
+			}
+		}
+		for (int i = 0; i < 6; ++i)
+		{
+			block[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+	}
+
+/**
+* BC7[h6̒[_ʎq
+*
+* @param color [_̐F
+* @param q     7rbgɗʎqF̊i[
+*
+* @return Prbg
+*
+* Prbg4vfŋL̂ŁA덷̏قI
+*/
+	int QuantizeBc7Endpoint(const float* color, int* q)
+	{
+		int bestP = 0;
+		float bestError = std::numeric_limits<float>::max();
+		for (int p = 0; p < 2; ++p)
+		{
+			float error = 0;
+			int tmp[4];
+			for (int c = 0; c < 4; ++c)
+			{
+				tmp[c] = std::min(std::max(static_cast<int>((color[c] - p) / 2.0f + 0.5f), 0), 127);
+				const float d = static_cast<float>((tmp[c] << 1) | p) - color[c];
+				error += d * d;
+			}
+			if (error < bestError)
+			{
+				bestError = error;
+				bestP = p;
+				memcpy(q, tmp, sizeof(tmp));
+			}
+		}
+		return bestP;
+	}
+
+/**
+* BC7[h6̒[_ef̔ԍI
+*
+* @return 덷̓a
+*/
+	int SelectBc7Indices(const uint8_t* rgba, const int* e0, const int* e1, uint8_t* indices)
+	{
+		int palette[16][4];
+		for (int k = 0; k < 16; ++k)
+		{
+			for (int c = 0; c < 4; ++c)
+			{
+				palette[k][c] = ((64 - bc7Weights4[k]) * e0[c] + bc7Weights4[k] * e1[c] + 32) >> 6;
+			}
+		}
+		int totalError = 0;
+		for (int i = 0; i < 16; ++i)
+		{
+			int bestError = std::numeric_limits<int>::max();
+			for (int k = 0; k < 16; ++k)
+			{
+				int error = 0;
+				for (int c = 0; c < 4; ++c)
+				{
+					const int d = rgba[i * 4 + c] - palette[k][c];
+					error += d * d;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = static_cast<uint8_t>(k);
+				}
+			}
+			totalError += bestError;
+		}
+		return totalError;
+	}
+
+/**
+* 128rbg̃ubNɃrbg
+*/
+	struct BitWriter
+	{
+		uint8_t* data;
+		int position = 0;
+
+		void Write(uint32_t value, int bitCount)
+		{
+			for (int i = 0; i < bitCount; ++i, ++position)
+			{
+				if (value & (1u << i))
+				{
+					data[position / 8] |= static_cast<uint8_t>(1u << (position % 8));
+				}
+			}
+		}
+	};
+
+/**
+* 128rbg̃ubNrbgǂݏo
+*/
+	struct BitReader
+	{
+		const uint8_t* data;
+		int position = 0;
+
+		uint32_t Read(int bitCount)
+		{
+			uint32_t value = 0;
+			for (int i = 0; i < bitCount; ++i, ++position)
+			{
+				value |= static_cast<uint32_t>((data[position / 8] >> (position % 8)) & 1) << i;
+			}
+			return value;
+		}
+	};
+
+/**
+* BC7`([h6)̃ubN쐬
+*
+* @param rgba  4x4f̐F(RGBA8)
+* @param block kʂ̊i[(16oCg)
+*
+* [h61̒[_̑g16iK̕ԂRGBA܂Ƃ߂ĕ\.
+* g̃[h掿͗邪ATsvȂ̂ōɈkł
+*/
+	void EncodeBc7Block(const uint8_t* rgba, uint8_t* block)
+	{
+		float minColor[4];
+		float maxColor[4];
+		FindEndpoints(rgba, 4, minColor, maxColor);
+
+		int q0[4];
+		int q1[4];
+		int p0 = QuantizeBc7Endpoint(minColor, q0);
+		int p1 = QuantizeBc7Endpoint(maxColor, q1);
+		const auto expand = [](const int* q, int p, int* e) {
+			for (int c = 0; c < 4; ++c)
+			{
+				e[c] = (q[c] << 1) | p;
+			}
+		};
+		int e0[4];
+		int e1[4];
+		expand(q0, p0, e0);
+		expand(q1, p1, e1);
+		uint8_t indices[16];
+		int bestError = SelectBc7Indices(rgba, e0, e1, indices);
+
+		for (int iteration = 0; iteration < 2 && bestError > 0; ++iteration)
+		{
+			LeastSquares ls;
+			for (int i = 0; i < 16; ++i)
+			{
+				const double w = bc7Weights4[indices[i]] / 64.0;
+				ls.Add(1.0 - w, w, rgba + i * 4, 4);
+			}
+			float a[4];
+			float b[4];
+			if (!ls.Solve(a, b, 4))
+			{
+				break;
+			}
+			for (int c = 0; c < 4; ++c)
+			{
+				a[c] = std::min(std::max(a[c], 0.0f), 255.0f);
+				b[c] = std::min(std::max(b[c], 0.0f), 255.0f);
+			}
+			int n0[4];
+			int n1[4];
+			const int np0 = QuantizeBc7Endpoint(a, n0);
+			const int np1 = QuantizeBc7Endpoint(b, n1);
+			int ne0[4];
+			int ne1[4];
+			expand(n0, np0, ne0);
+			expand(n1, np1, ne1);
+			uint8_t newIndices[16];
+			const int error = SelectBc7Indices(rgba, ne0, ne1, newIndices);
+			if (error >= bestError)
+			{
+				break;
+			}
+			bestError = error;
+			memcpy(q0, n0, sizeof(q0));
+			memcpy(q1, n1, sizeof(q1));
+			p0 = np0;
+			p1 = np1;
+			memcpy(indices, newIndices, sizeof(indices));
+		}
+
+		//ŏ̉f̔ԍ͍ŏʃrbgȗ̂ŁA0`7ɂȂ悤ɒ[_ւ
+		if (indices[0] & 8)
+		{
+			std::swap(q0, q1);
+			std::swap(p0, p1);
+			for (uint8_t& e : indices)
+			{
+				e = static_cast<uint8_t>(15 - e);
+			}
+		}
+
+		memset(block, 0, 16);
+		BitWriter writer = { block };
+		writer.Write(1 << 6, 7);//[h6
+		for (int c = 0; c < 4; ++c)
+		{
+			writer.Write(q0[c], 7);
+			writer.Write(q1[c], 7);
+		}
+		writer.Write(p0, 1);
+		writer.Write(p1, 1);
+		writer.Write(indices[0], 3);
+		for (int i = 1; i < 16; ++i)
+		{
+			writer.Write(indices[i], 4);
+		}
+	}
+
+/**
+* BC1`̐FubNWJ
+*/
+	void DecodeColorBlock(const uint8_t* block, bool isFourColor, uint8_t* rgba)
+	{
+		const uint16_t c0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		const uint16_t c1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+		int palette[4][4];
+		MakeBc1Palette(c0, c1, isFourColor, palette);
+		for (int i = 0; i < 16; ++i)
+		{
+			const int index = (block[4 + i / 4] >> ((i % 4) * 2)) & 3;
+			for (int c = 0; c < 4; ++c)
+			{
+				rgba[i * 4 + c] = static_cast<uint8_t>(palette[index][c]);
+			}
+		}
+	}
+
+/**
+* BC4`̃At@ ubNWJ
+*/
+	void DecodeAlphaBlock(const uint8_t* block, uint8_t* rgba)
+	{
+		const int a0 = block[0];
+		const int a1 = block[1];
+		int palette[8] = { a0, a1 };
+		if (a0 > a1)
+		{
+			for (int k = 1; k < 7; ++k)
+			{
+				palette[k + 1] = ((7 - k) * a0 + k * a1) / 7;
+			}
+		}
+		else
+		{
+			for (int k = 1; k < 5; ++k)
+			{
+				palette[k + 1] = ((5 - k) * a0 + k * a1) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+		uint64_t bits = 0;
+		for (int i = 0; i < 6; ++i)
+		{
+			bits |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+		}
+		for (int i = 0; i < 16; ++i)
+		{
+			rgba[i * 4 + 3] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+		}
+	}
+
+/**
+* BC7`([h6)̃ubNWJ
+*
+* @retval true  WJ
+* @retval false [h6ȊÕubN
+*/
+	bool DecodeBc7Block(const uint8_t* block, uint8_t* rgba)
+	{
+		BitReader reader = { block };
+		if (reader.Read(7) != (1 << 6))
+		{
+			return false;
+		}
+		int q0[4];
+		int q1[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			q0[c] = reader.Read(7);
+			q1[c] = reader.Read(7);
+		}
+		const int p0 = reader.Read(1);
+		const int p1 = reader.Read(1);
+		for (int i = 0; i < 16; ++i)
+		{
+			const int index = reader.Read(i == 0 ? 3 : 4);
+			const int w = bc7Weights4[index];
+			for (int c = 0; c < 4; ++c)
+			{
+				const int e0 = (q0[c] << 1) | p0;
+				const int e1 = (q1[c] << 1) | p1;
+				rgba[i * 4 + c] = static_cast<uint8_t>(((64 - w) * e0 + w * e1 + 32) >> 6);
+			}
+		}
+		return true;
+	}
+
+/**
+* ubNk`ɑΉOpenGL̓`擾
+*
+* @param format ubNǩ`
+*
+* @return glCompressedTexImage2Dɓn`
+*/
+	GLenum GetInternalFormat(BlockFormat format)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case BlockFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		default: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+	}
+
+/**
+* 4x4f̃ubN1̃oCg擾
+*
+* @param format ubNǩ`
+*
+* @return ubÑoCg
+*/
+	size_t GetBlockSize(BlockFormat format)
+	{
+		return format == BlockFormat::BC1 ? 8 : 16;
+	}
+
+/**
+* 4x4f1ubNɈk
+*
+* @param format ubNǩ`
+* @param rgba   4x4f̐F(RGBA8 x 16fA摜Ɠs̏Ɋi[)
+* @param block  kʂ̊i[(GetBlockSizeoCg)
+*/
+	void EncodeBlock(BlockFormat format, const uint8_t* rgba, uint8_t* block)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1:
+			EncodeColorBlock(rgba, block);
+			break;
+		case BlockFormat::BC3:
+			EncodeAlphaBlock(rgba, block);
+			EncodeColorBlock(rgba, block + 8);
+			break;
+		case BlockFormat::BC7:
+			EncodeBc7Block(rgba, block);
+			break;
+		}
+	}
+
+/**
+* 1ubN4x4fɓWJ
+*
+* @param format ubNǩ`
+* @param block  WJubN
+* @param rgba   WJF̊i[(RGBA8 x 16f)
+*
+* @retval true  WJ
+* @retval false ΉĂȂubN(BC7̃[h6ȊO)
+*
+* kʂ̉掿mF邽߂̂̂ŁA`ɂ͎gȂ
+*/
+	bool DecodeBlock(BlockFormat format, const uint8_t* block, uint8_t* rgba)
+	{
+		switch (format)
+		{
+		case BlockFormat::BC1:
+			DecodeColorBlock(block, false, rgba);
+			return true;
+		case BlockFormat::BC3:
+			DecodeColorBlock(block + 8, true, rgba);
+			DecodeAlphaBlock(block, rgba);
+			return true;
+		case BlockFormat::BC7:
+			return DecodeBc7Block(block, rgba);
+		}
+		return false;
+	}
+
+/**
+* 摜ubNk
+*
+* @param image  k摜(RGBA8܂RED8)
+* @param format ubNǩ`
+* @param blocks kʂ̊i[
+*
+* @retval true  k
+* @retval false ΉĂȂf`
+*
+* 4̔{łȂ傫̉摜́A[̉fJԂăubN𖄂߂
+*/
+	bool Compress(const Texture::ImageData& image, BlockFormat format, std::vector<uint8_t>& blocks)
+	{
+		if (image.type != GL_UNSIGNED_BYTE || (image.format != GL_RGBA && image.format != GL_RED))
+		{
+			return false;
+		}
+		const int channels = image.format == GL_RGBA ? 4 : 1;
+		const GLsizei blockCountX = (image.width + 3) / 4;
+		const GLsizei blockCountY = (image.height + 3) / 4;
+		const size_t blockSize = GetBlockSize(format);
+		blocks.resize(blockCountX * blockCountY * blockSize);
+
+		uint8_t* out = blocks.data();
+		for (GLsizei by = 0; by < blockCountY; ++by)
+		{
+			for (GLsizei bx = 0; bx < blockCountX; ++bx, out += blockSize)
+			{
+				uint8_t rgba[16 * 4];
+				for (int i = 0; i < 16; ++i)
+				{
+					const GLsizei x = std::min(bx * 4 + i % 4, image.width - 1);
+					const GLsizei y = std::min(by * 4 + i / 4, image.height - 1);
+					const uint8_t* p = image.data.data() + (static_cast<size_t>(y) * image.width + x) * channels;
+					if (channels == 4)
+					{
+						memcpy(rgba + i * 4, p, 4);
+					}
+					else
+					{
+						rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = p[0];
+						rgba[i * 4 + 3] = 255;
+					}
+				}
+				EncodeBlock(format, rgba, out);
+			}
+		}
+		return true;
+	}
+
+/**
+* ubNkꂽ摜WJ
+*
+* @param blocks WJubN̔z
+* @param width  摜̕
+* @param height 摜̍
+* @param format ubNǩ`
+* @param image  WJ摜(RGBA8)̊i[
+*
+* @retval true  WJ
+* @retval false ΉĂȂubN
+*/
+	bool Decompress(const uint8_t* blocks, GLsizei width, GLsizei height,
+		BlockFormat format, Texture::ImageData& image)
+	{
+		image.width = width;
+		image.height = height;
+		image.format = GL_RGBA;
+		image.type = GL_UNSIGNED_BYTE;
+		image.data.resize(static_cast<size_t>(width) * height * 4);
+
+		const GLsizei blockCountX = (width + 3) / 4;
+		const GLsizei blockCountY = (height + 3) / 4;
+		const size_t blockSize = GetBlockSize(format);
+		for (GLsizei by = 0; by < blockCountY; ++by)
+		{
+			for (GLsizei bx = 0; bx < blockCountX; ++bx, blocks += blockSize)
+			{
+				uint8_t rgba[16 * 4];
+				if (!DecodeBlock(format, blocks, rgba))
+				{
+					return false;
+				}
+				for (int i = 0; i < 16; ++i)
+				{
+					const GLsizei x = bx * 4 + i % 4;
+					const GLsizei y = by * 4 + i / 4;
+					if (x < width && y < height)
+					{
+						memcpy(image.data.data() + (static_cast<size_t>(y) * width + x) * 4, rgba + i * 4, 4);
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+/**
+* 2̉摜PSNR(s[NMΎG)߂
+*
+* @param a        r摜(RGBA8)
+* @param b        r摜(RGBA8)
+* @param hasAlpha At@rȂtrue
+*
+* @return PSNR(fVx). 摜vꍇ͖
+*/
+	double ComputePsnr(const Texture::ImageData& a, const Texture::ImageData& b, bool hasAlpha)
+	{
+		const size_t pixelCount = std::min(a.data.size(), b.data.size()) / 4;
+		const int channels = hasAlpha ? 4 : 3;
+		double sum = 0;
+		for (size_t i = 0; i < pixelCount; ++i)
+		{
+			for (int c = 0; c < channels; ++c)
+			{
+				const double d = static_cast<double>(a.data[i * 4 + c]) - b.data[i * 4 + c];
+				sum += d * d;
+			}
+		}
+		if (sum <= 0 || pixelCount == 0)
+		{
+			return std::numeric_limits<double>::infinity();
+		}
+		const double mse = sum / (pixelCount * channels);
+		return 10.0 * log10(255.0 * 255.0 / mse);
+	}
+
+/**
+* 摜t@C~bv}bvt̃ubNkeNX` t@Cɕϊ
+*
+* @param srcPath ϊ摜t@C(TGA)
+* @param dstPath ot@C(KTX)
+* @param format  ubNǩ`
+*
+* @retval true  ϊ
+* @retval false ϊs
+*/
+	bool ConvertFile(const char* srcPath, const char* dstPath, BlockFormat format)
+	{
+		Texture::ImageData image;
+		if (!Texture::LoadImageData(srcPath, image))
+		{
+			return false;
+		}
+		std::vector<Texture::ImageData> mipLevels;
+		MipmapGenerator::Generate(image, mipLevels);
+
+		//SĂ̒ik
+		std::vector<std::vector<uint8_t>> blocks(mipLevels.size() + 1);
+		Texture::CompressedImage compressed;
+		compressed.internalFormat = GetInternalFormat(format);
+		compressed.width = image.width;
+		compressed.height = image.height;
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			const Texture::ImageData& level = i == 0 ? image : mipLevels[i - 1];
+			if (!Compress(level, format, blocks[i]))
+			{
+				std::cerr << "ERROR: " << srcPath << "͈kłȂ`ł\n";
+				return false;
+			}
+			compressed.levels.push_back({ level.width, level.height,
+				blocks[i].data(), static_cast<GLsizei>(blocks[i].size()) });
+		}
+		if (!Texture::SaveCompressedImage(dstPath, compressed))
+		{
+			return false;
+		}
+		std::cout << "INFO: " << srcPath << "" << dstPath << "ɕϊ [i=" <<
+			blocks.size() << " =" << image.width << " =" << image.height << "]\n";
+		return true;
+	}
+
+}//namespace BlockCompressor
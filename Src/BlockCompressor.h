@@ -0,0 +1,34 @@
+/**
+* @file BlockCompressor.h
+*/
+#ifndef BLOCKCOMPRESSOR_H_INCLUDED
+#define BLOCKCOMPRESSOR_H_INCLUDED
+#include "Texture.h"
+#include <stdint.h>
+#include <vector>
+
+//eNX`ubNk`ɕϊ֐i[閼O
+namespace BlockCompressor {
+
+/**
+* ubNǩ`
+*/
+	enum class BlockFormat
+	{
+		BC1,//RGB 4rbg/f(At@Ȃ)
+		BC3,//RGBA 8rbg/f(At@͓ƗĈk)
+		BC7,//RGBA 8rbg/f([h6̂ݎgp)
+	};
+
+	GLenum GetInternalFormat(BlockFormat format);
+	size_t GetBlockSize(BlockFormat format);
+	void EncodeBlock(BlockFormat format, const uint8_t* rgba, uint8_t* block);
+	bool DecodeBlock(BlockFormat format, const uint8_t* block, uint8_t* rgba);
+	bool Compress(const Texture::ImageData& image, BlockFormat format, std::vector<uint8_t>& blocks);
+	bool Decompress(const uint8_t* blocks, GLsizei width, GLsizei height,
+		BlockFormat format, Texture::ImageData& image);
+	double ComputePsnr(const Texture::ImageData& a, const Texture::ImageData& b, bool hasAlpha);
+	bool ConvertFile(const char* srcPath, const char* dstPath, BlockFormat format);
+
+}//namespace BlockCompressor
+#endif //BLOCKCOMPRESSOR_H_INCLUDED
@@ -0,0 +1,165 @@
+/**
+* @file BufferAllocator.cpp
+*/
+#include "BufferAllocator.h"
+#include <algorithm>
+#include <iterator>
+
+/**
+* RXgN^
+*
+* @param capacity Ǘ̈̑傫
+*/
+BufferAllocator::BufferAllocator(size_t capacity)
+{
+	Reset(capacity);
+}
+
+/**
+* ׂĂ̊蓖ĂjAǗ̈̑傫ݒ肷
+*
+* @param capacity Ǘ̈̑傫
+*/
+void BufferAllocator::Reset(size_t capacity)
+{
+	this->capacity = capacity;
+	usedSize = 0;
+	allocationCount = 0;
+	freeBlocks.clear();
+	if (capacity > 0)
+	{
+		freeBlocks.emplace(0, capacity);
+	}
+}
+
+/**
+* ̈蓖Ă
+*
+* @param size      蓖Ă傫
+* @param alignment JnʒűE(1ȏ)
+*
+* @return 蓖Ă̈̊Jnʒu. 蓖ĂȂꍇnpos
+*
+* ܂󂫗̈̂A]肪ł̂g(xXgtBbg)
+*/
+size_t BufferAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (size == 0)
+	{
+		return npos;
+	}
+	alignment = std::max<size_t>(alignment, 1);
+
+	auto best = freeBlocks.end();
+	size_t bestOffset = 0;
+	size_t bestRest = npos;
+	for (auto itr = freeBlocks.begin(); itr != freeBlocks.end(); ++itr)
+	{
+		const size_t offset = (itr->first + alignment - 1) / alignment * alignment;
+		const size_t end = itr->first + itr->second;
+		if (offset + size > end)
+		{
+			continue;
+		}
+		const size_t rest = end - (offset + size);
+		if (rest < bestRest)
+		{
+			best = itr;
+			bestOffset = offset;
+			bestRest = rest;
+			if (rest == 0)
+			{
+				break;
+			}
+		}
+	}
+	if (best == freeBlocks.end())
+	{
+		return npos;
+	}
+
+	//󂫗̈A蓖Ă̈̑Oɕ
+	const size_t blockOffset = best->first;
+	const size_t blockEnd = best->first + best->second;
+	freeBlocks.erase(best);
+	if (bestOffset > blockOffset)
+	{
+		freeBlocks.emplace(blockOffset, bestOffset - blockOffset);
+	}
+	if (bestOffset + size < blockEnd)
+	{
+		freeBlocks.emplace(bestOffset + size, blockEnd - (bestOffset + size));
+	}
+	usedSize += size;
+	++allocationCount;
+	return bestOffset;
+}
+
+/**
+* 蓖Ă̈
+*
+* @param offset AllocateԂJnʒu
+* @param size   Allocateɓn傫
+*/
+void BufferAllocator::Free(size_t offset, size_t size)
+{
+	if (size == 0 || offset == npos)
+	{
+		return;
+	}
+	usedSize -= size;
+	--allocationCount;
+
+	//Ő󂫗̈ƌ
+	auto next = freeBlocks.lower_bound(offset);
+	if (next != freeBlocks.end() && offset + size == next->first)
+	{
+		size += next->second;
+		next = freeBlocks.erase(next);
+	}
+	if (next != freeBlocks.begin())
+	{
+		const auto prev = std::prev(next);
+		if (prev->first + prev->second == offset)
+		{
+			prev->second += size;
+			return;
+		}
+	}
+	freeBlocks.emplace_hint(next, offset, size);
+}
+
+/**
+* Ǘ̈̑傫擾
+*
+* @return Ǘ̈̑傫
+*/
+size_t BufferAllocator::Capacity() const
+{
+	return capacity;
+}
+
+/**
+* fЉ̓v擾
+*
+* @return v
+*/
+BufferAllocator::Statistics BufferAllocator::GetStatistics() const
+{
+	Statistics stats = {};
+	stats.capacity = capacity;
+	stats.usedSize = usedSize;
+	stats.allocationCount = allocationCount;
+	stats.freeBlockCount = freeBlocks.size();
+	for (const auto& e : freeBlocks)
+	{
+		stats.freeSize += e.second;
+		stats.largestFreeBlock = std::max(stats.largestFreeBlock, e.second);
+	}
+	if (stats.freeSize > 0)
+	{
+		stats.fragmentation =
+			1.0f - static_cast<float>(stats.largestFreeBlock) / stats.freeSize;
+	}
+	return stats;
+}
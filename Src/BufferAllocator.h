@@ -0,0 +1,51 @@
+/**
+* @file BufferAllocator.h
+*/
+#ifndef BUFFERALLOCATOR_H_INCLUDED
+#define BUFFERALLOCATOR_H_INCLUDED
+#include <stddef.h>
+#include <map>
+
+/**
+* 傫ȃobt@̗̒̈蓖ĂNX
+*
+* obt@͎̂A󂫗̈̈ʒuƑ傫Ǘ.
+* 󂫗̈̓AhXɕێAɗאڂ󂫗̈ƌ.
+*/
+class BufferAllocator
+{
+public:
+	//蓖ĂɎsƂ̖߂l
+	static const size_t npos = static_cast<size_t>(-1);
+
+	/**
+	* fЉ̓v
+	*/
+	struct Statistics
+	{
+		size_t capacity;//Ǘ̈Ŝ̑傫
+		size_t usedSize;//蓖čς݂̑傫
+		size_t freeSize;//󂫗̈̍v
+		size_t largestFreeBlock;//ő̋󂫗̈̑傫
+		size_t freeBlockCount;//󂫗̈̐
+		size_t allocationCount;//蓖Ē̗̈̐
+		float fragmentation;//fЉ(0=󂫗̈悪1ɂ܂Ƃ܂Ă. 1ɋ߂قǍא؂)
+	};
+
+	BufferAllocator() = default;
+	explicit BufferAllocator(size_t capacity);
+
+	void Reset(size_t capacity);
+	size_t Allocate(size_t size, size_t alignment = 1);
+	void Free(size_t offset, size_t size);
+	size_t Capacity() const;
+	Statistics GetStatistics() const;
+
+private:
+	size_t capacity = 0;
+	size_t usedSize = 0;
+	size_t allocationCount = 0;
+	std::map<size_t, size_t> freeBlocks;//󂫗̈(L[=Jnʒu, l=傫)
+};
+
+#endif //BUFFERALLOCATOR_H_INCLUDED
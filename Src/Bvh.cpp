@@ -0,0 +1,903 @@
+/**
+* @file Bvh.cpp
+*/
+#include "Bvh.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <float.h>
+#include <stdio.h>
+#include <string.h>
+
+const int bvhBinCount = 16;//ʒǔTƂ̋Ԃ̐
+const uint32_t bvhMaxLeafSize = 8;//ȂĂ悢t̍ő̐̕
+const int bvhMaxDepth = 48;//؂̍ő̐[([ʒu͕̐Ɋ֌WȂtɂ)
+const float bvhTraversalCost = 1.0f;//m[h1ǂRXg(1̔1Ƃ)
+const size_t bvhMinParallelCount = 4096;//ʃXbhō쐬镔؂̍ŏ̐̕
+
+//BVHt@C̎ʎqƃo[W
+const char bvhFileMagic[4] = { 'B','V','H','F' };
+const uint32_t bvhFileVersion = 1;
+
+//BVHt@C̃wb_(̌Ƀm[hÂ̔ԍAE{bNXAOp`̒_)
+struct BvhFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t nodeCount;
+	uint32_t primitiveCount;
+	uint32_t triangleCount;//Op`BVHȂ畨̐ƓAȊO0
+};
+
+/**
+* E{bNX̕\ʐς߂
+*
+* @param min ŏW
+* @param max őW
+*
+* @return \ʐ. ̃{bNXȂ0
+*/
+float BvhSurfaceArea(const glm::vec3& min, const glm::vec3& max)
+{
+	const glm::vec3 size = max - min;
+	if (size.x < 0 || size.y < 0 || size.z < 0)
+	{
+		return 0;
+	}
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+/**
+* E{bNX_܂܂悤ɍL
+*
+* @param min ŏW. Lʂŏ㏑
+* @param max őW. Lʂŏ㏑
+* @param p   ܂߂_
+*/
+void BvhExtend(glm::vec3& min, glm::vec3& max, const glm::vec3& p)
+{
+	min = glm::vec3(std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z));
+	max = glm::vec3(std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z));
+}
+
+//؂쐬ƂɁASẴXbhŋLf[^
+struct BvhBuilder
+{
+	const std::vector<Aabb>& boxes;
+	std::vector<glm::vec3> centers;//E{bNX̒SW
+	std::vector<uint32_t>& indices;//̂̔ԍ. eXbh͏dȂȂ͈͂בւ
+};
+
+/**
+* ̂̒SWԂ߂
+*
+* @param center   ̂̒SW(鎲̐)
+* @param min      SW͈̔͂̍ŏl
+* @param binScale Ԃ̐ / SW͈̔͂̕
+*
+* @return Ԃ̔ԍ
+*/
+int BvhBinIndex(float center, float min, float binScale)
+{
+	const int bin = static_cast<int>((center - min) * binScale);
+	return std::min(std::max(bin, 0), bvhBinCount - 1);
+}
+
+/**
+* ͈̂̔͂畔؂쐬
+*
+* @param builder     Lf[^
+* @param first       ؂Ɋ܂߂ŏ̂̈̕ʒu(indices)
+* @param last        ؂Ɋ܂߂Ō̂̈̕ʒu+1
+* @param depth       ؂̍̐[
+* @param threadDepth ʃXbh쐬Ă悢c̐[
+* @param nodes       쐬m[h̒ǉ
+*
+* m[h͐[D揇ɒǉ. ǉ悪ؐp̔złAł悤ɁA
+* m[h̉E̎q̔ԍnodes̐擪̈ʒuɂ
+*/
+void BvhBuildNode(BvhBuilder& builder, uint32_t first, uint32_t last, int depth,
+	int threadDepth, std::vector<Bvh::Node>& nodes)
+{
+	const uint32_t nodeIndex = static_cast<uint32_t>(nodes.size());
+	nodes.push_back({});
+
+	//E{bNXƁASW͈̔͂߂
+	glm::vec3 min(FLT_MAX), max(-FLT_MAX);
+	glm::vec3 centerMin(FLT_MAX), centerMax(-FLT_MAX);
+	for (uint32_t i = first; i < last; ++i)
+	{
+		const Aabb& box = builder.boxes[builder.indices[i]];
+		BvhExtend(min, max, box.min);
+		BvhExtend(min, max, box.max);
+		BvhExtend(centerMin, centerMax, builder.centers[builder.indices[i]]);
+	}
+	nodes[nodeIndex].min = min;
+	nodes[nodeIndex].max = max;
+	const uint32_t count = last - first;
+
+	//Ԃ̋EƂɁAEɕƂ̃RXg߂
+	struct Bin
+	{
+		glm::vec3 min = glm::vec3(FLT_MAX);
+		glm::vec3 max = glm::vec3(-FLT_MAX);
+		uint32_t count = 0;
+	};
+	float bestCost = FLT_MAX;
+	int bestAxis = -1;
+	int bestSplit = 0;
+	for (int axis = 0; axis < 3 && count > 1 && depth < bvhMaxDepth; ++axis)
+	{
+		const float extent = centerMax[axis] - centerMin[axis];
+		if (!(extent > 0))
+		{
+			continue;
+		}
+		const float binScale = bvhBinCount / extent;
+		Bin bins[bvhBinCount];
+		for (uint32_t i = first; i < last; ++i)
+		{
+			const uint32_t index = builder.indices[i];
+			Bin& bin = bins[BvhBinIndex(builder.centers[index][axis], centerMin[axis], binScale)];
+			BvhExtend(bin.min, bin.max, builder.boxes[index].min);
+			BvhExtend(bin.min, bin.max, builder.boxes[index].max);
+			++bin.count;
+		}
+
+		//E̖ʐςƕ̐ݐςĂAݐςȂRXgׂ
+		float rightArea[bvhBinCount];
+		uint32_t rightCount[bvhBinCount];
+		Bin right;
+		for (int i = bvhBinCount - 1; i > 0; --i)
+		{
+			BvhExtend(right.min, right.max, bins[i].min);
+			BvhExtend(right.min, right.max, bins[i].max);
+			right.count += bins[i].count;
+			rightArea[i] = BvhSurfaceArea(right.min, right.max);
+			rightCount[i] = right.count;
+		}
+		Bin left;
+		for (int i = 0; i < bvhBinCount - 1; ++i)
+		{
+			BvhExtend(left.min, left.max, bins[i].min);
+			BvhExtend(left.min, left.max, bins[i].max);
+			left.count += bins[i].count;
+			if (left.count == 0 || rightCount[i + 1] == 0)
+			{
+				continue;
+			}
+			const float cost = BvhSurfaceArea(left.min, left.max) * left.count +
+				rightArea[i + 1] * rightCount[i + 1];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = i;
+			}
+		}
+	}
+
+	//ĂTȂȂȂAtɂ
+	const float area = BvhSurfaceArea(min, max);
+	const float leafCost = static_cast<float>(count);
+	const float splitCost = area > 0 ? bvhTraversalCost + bestCost / area : leafCost;
+	const bool canSplit = count > 1 && depth < bvhMaxDepth;
+	if (!canSplit || (count <= bvhMaxLeafSize && (bestAxis < 0 || splitCost >= leafCost)))
+	{
+		nodes[nodeIndex].offset = first;
+		nodes[nodeIndex].count = count;
+		return;
+	}
+
+	//ʒuŕ̂Eɕ.
+	//SĂ̒SWꍇAl덷ŕБɂȂꍇ́A̐Ŕɕ
+	uint32_t mid = first + count / 2;
+	if (bestAxis >= 0)
+	{
+		const float axisMin = centerMin[bestAxis];
+		const float binScale = bvhBinCount / (centerMax[bestAxis] - axisMin);
+		const auto itr = std::partition(builder.indices.begin() + first,
+			builder.indices.begin() + last, [&](uint32_t index) {
+				return BvhBinIndex(builder.centers[index][bestAxis], axisMin, binScale) <= bestSplit;
+			});
+		const uint32_t splitPos = static_cast<uint32_t>(itr - builder.indices.begin());
+		if (splitPos > first && splitPos < last)
+		{
+			mid = splitPos;
+		}
+	}
+
+	//傫؂́AE̎qʃXbhō쐬.
+	//E͈̔͂͏dȂȂ̂ŁAindices𓯎ɕבւĂȂ
+	if (threadDepth > 0 && last - mid >= bvhMinParallelCount && mid - first >= bvhMinParallelCount)
+	{
+		std::vector<Bvh::Node> rightNodes;
+		std::thread thread(BvhBuildNode, std::ref(builder), mid, last, depth + 1,
+			threadDepth - 1, std::ref(rightNodes));
+		BvhBuildNode(builder, first, mid, depth + 1, threadDepth - 1, nodes);
+		thread.join();
+
+		const uint32_t rightIndex = static_cast<uint32_t>(nodes.size());
+		for (Bvh::Node& e : rightNodes)
+		{
+			if (e.count == 0)
+			{
+				e.offset += rightIndex;
+			}
+		}
+		nodes.insert(nodes.end(), rightNodes.begin(), rightNodes.end());
+		nodes[nodeIndex].offset = rightIndex;
+	}
+	else
+	{
+		BvhBuildNode(builder, first, mid, depth + 1, threadDepth, nodes);
+		nodes[nodeIndex].offset = static_cast<uint32_t>(nodes.size());
+		BvhBuildNode(builder, mid, last, depth + 1, threadDepth, nodes);
+	}
+	nodes[nodeIndex].count = 0;
+}
+
+/**
+* E{bNXƎ̈ʒu֌W𒲂ׂ
+*
+* @param frustum 
+* @param min     E{bNX̍ŏW
+* @param max     E{bNX̍őW
+*
+* @retval -1 ̊Oɂ
+* @retval 0  ̋Eƌ
+* @retval 1  ɊSɊ܂܂
+*/
+int BvhClassifyBox(const Frustum& frustum, const glm::vec3& min, const glm::vec3& max)
+{
+	int result = 1;
+	for (const glm::vec4& plane : frustum.planes)
+	{
+		const float px = plane.x >= 0 ? max.x : min.x;
+		const float py = plane.y >= 0 ? max.y : min.y;
+		const float pz = plane.z >= 0 ? max.z : min.z;
+		if (plane.x * px + plane.y * py + plane.z * pz + plane.w < 0)
+		{
+			return -1;
+		}
+		const float nx = plane.x >= 0 ? min.x : max.x;
+		const float ny = plane.y >= 0 ? min.y : max.y;
+		const float nz = plane.z >= 0 ? min.z : max.z;
+		if (plane.x * nx + plane.y * ny + plane.z * nz + plane.w < 0)
+		{
+			result = 0;
+		}
+	}
+	return result;
+}
+
+/**
+* CE{bNXɓ鋗߂
+*
+* @param origin       C̎n_
+* @param invDirection Č̋t
+* @param min          E{bNX̍ŏW
+* @param max          E{bNX̍őW
+* @param maxDistance  艓͖
+*
+* @return C{bNXɓ鋗(n_{bNXȂ0). ȂFLT_MAX
+*
+* ̐0̎ł0*NaNɂȂ邪Astd::minstd::maẍ̏ԂNaN𖳎
+*/
+float BvhRayBox(const glm::vec3& origin, const glm::vec3& invDirection,
+	const glm::vec3& min, const glm::vec3& max, float maxDistance)
+{
+	float tEnter = 0;
+	float tExit = maxDistance;
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const float t0 = (min[axis] - origin[axis]) * invDirection[axis];
+		const float t1 = (max[axis] - origin[axis]) * invDirection[axis];
+		tEnter = std::max(tEnter, std::min(t0, t1));
+		tExit = std::min(tExit, std::max(t0, t1));
+	}
+	return tEnter <= tExit ? tEnter : FLT_MAX;
+}
+
+/**
+* CƎOp`̌𒲂ׂ(Moller-Trumbore@)
+*
+* @param origin    C̎n_
+* @param direction Č
+* @param v         Op`3_
+*
+* @return 鋗. ȂFLT_MAX
+*
+* ʂɂ
+*/
+float BvhRayTriangle(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3* v)
+{
+	const glm::vec3 e1 = v[1] - v[0];
+	const glm::vec3 e2 = v[2] - v[0];
+	const glm::vec3 p(direction.y * e2.z - direction.z * e2.y,
+		direction.z * e2.x - direction.x * e2.z, direction.x * e2.y - direction.y * e2.x);
+	const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+	if (det == 0)
+	{
+		return FLT_MAX;//CƎOp`s
+	}
+	const float invDet = 1.0f / det;
+	const glm::vec3 s = origin - v[0];
+	const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * invDet;
+	if (u < 0 || u > 1)
+	{
+		return FLT_MAX;
+	}
+	const glm::vec3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+	const float w = (direction.x * q.x + direction.y * q.y + direction.z * q.z) * invDet;
+	if (w < 0 || u + w > 1)
+	{
+		return FLT_MAX;
+	}
+	const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * invDet;
+	return t >= 0 ? t : FLT_MAX;
+}
+
+/**
+* ̂̋E{bNXBVH쐬
+*
+* @param boxes       ̂̋E{bNX̔z
+* @param threadCount 쐬ɎgXbh(0ȂCPŨXbh)
+*
+* @retval true  쐬
+* @retval false ̂A܂͋E{bNXs
+*
+* ʂ̓Xbhɂ炸ɂȂ
+*/
+bool Bvh::Build(const std::vector<Aabb>& boxes, int threadCount)
+{
+	Clear();
+	return BuildTree(boxes, threadCount);
+}
+
+/**
+* Op`BVH쐬
+*
+* @param positions     _W̔z
+* @param positionCount positions̗vf
+* @param indices       Op`Ƃ3̒_ԍׂz
+* @param triangleCount Op`̐
+* @param threadCount   쐬ɎgXbh(0ȂCPŨXbh)
+*
+* @retval true  쐬
+* @retval false _ԍ͈͊OA܂͎Op`
+*
+* ₢킹̌ʂ̔ԍ͎Op`̔ԍɂȂAC͎Op`Ƃ̌𒲂ׂ
+*/
+bool Bvh::BuildFromTriangles(const glm::vec3* positions, size_t positionCount,
+	const uint32_t* indices, size_t triangleCount, int threadCount)
+{
+	Clear();
+	std::vector<Aabb> boxes(triangleCount);
+	std::vector<glm::vec3> vertices(triangleCount * 3);
+	for (size_t i = 0; i < triangleCount; ++i)
+	{
+		Aabb& box = boxes[i];
+		box.min = glm::vec3(FLT_MAX);
+		box.max = glm::vec3(-FLT_MAX);
+		for (int k = 0; k < 3; ++k)
+		{
+			const uint32_t index = indices[i * 3 + k];
+			if (index >= positionCount)
+			{
+				std::cerr << "ERROR: BVH̎Op`" << i << "̒_ԍ" << index << "͈͊Oł\n";
+				return false;
+			}
+			vertices[i * 3 + k] = positions[index];
+			BvhExtend(box.min, box.max, positions[index]);
+		}
+	}
+	if (!BuildTree(boxes, threadCount))
+	{
+		return false;
+	}
+
+	//t̏ɕבւāATɋ߂ʒũǂނ悤ɂ
+	triangles.resize(vertices.size());
+	for (size_t i = 0; i < primitiveIndices.size(); ++i)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			triangles[i * 3 + k] = vertices[primitiveIndices[i] * 3 + k];
+		}
+	}
+	return true;
+}
+
+/**
+* E{bNX؂쐬
+*
+* @param boxes       ̂̋E{bNX̔z
+* @param threadCount 쐬ɎgXbh(0ȂCPŨXbh)
+*
+* @retval true  쐬
+* @retval false ̂A܂͋E{bNXs
+*/
+bool Bvh::BuildTree(const std::vector<Aabb>& boxes, int threadCount)
+{
+	if (boxes.empty())
+	{
+		return true;
+	}
+	if (boxes.size() >= 0x80000000U)
+	{
+		std::cerr << "ERROR: BVĤ̕܂(" << boxes.size() << ")\n";
+		return false;
+	}
+	BvhBuilder builder = { boxes, std::vector<glm::vec3>(boxes.size()), primitiveIndices };
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		const Aabb& box = boxes[i];
+		if (!(box.min.x <= box.max.x && box.min.y <= box.max.y && box.min.z <= box.max.z))
+		{
+			std::cerr << "ERROR: BVH̕" << i << "̋E{bNXsł\n";
+			primitiveIndices.clear();
+			return false;
+		}
+		builder.centers[i] = (box.min + box.max) * 0.5f;
+	}
+	primitiveIndices.resize(boxes.size());
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		primitiveIndices[i] = static_cast<uint32_t>(i);
+	}
+
+	//̂тɃXbh2{ɂȂ̂ŁAXbh𒴂Ȃ[܂ŕɍ쐬
+	if (threadCount <= 0)
+	{
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	int threadDepth = 0;
+	while ((1 << threadDepth) < threadCount && threadDepth < 8)
+	{
+		++threadDepth;
+	}
+	nodes.reserve(boxes.size() / 2 + 1);
+	BvhBuildNode(builder, 0, static_cast<uint32_t>(boxes.size()), 0, threadDepth, nodes);
+
+	primitiveBoxes.resize(boxes.size());
+	for (size_t i = 0; i < primitiveIndices.size(); ++i)
+	{
+		primitiveBoxes[i] = boxes[primitiveIndices[i]];
+	}
+	return true;
+}
+
+/**
+* BVHɂ
+*/
+void Bvh::Clear()
+{
+	nodes.clear();
+	primitiveIndices.clear();
+	primitiveBoxes.clear();
+	triangles.clear();
+}
+
+/**
+* BVH󂩂ǂׂ
+*
+* @retval true  ̂1
+* @retval false ̂
+*/
+bool Bvh::IsEmpty() const
+{
+	return nodes.empty();
+}
+
+/**
+* ̂̐擾
+*
+* @return ̂̐
+*/
+size_t Bvh::PrimitiveCount() const
+{
+	return primitiveIndices.size();
+}
+
+/**
+* Op`쐬BVHǂׂ
+*
+* @retval true  BuildFromTrianglesō쐬
+* @retval false Buildō쐬A܂͋
+*/
+bool Bvh::HasTriangles() const
+{
+	return !triangles.empty();
+}
+
+/**
+* ƏdȂ镨̂T
+*
+* @param frustum 
+* @param result  ƏdȂ镨̂̔ԍ̊i[(Ԃ͕s)
+*
+* @return ƏdȂ镨̂̐
+*
+* ɊSɊ܂܂m[h艺́A肹ɑSĂ̂̕ʂɉ
+*/
+size_t Bvh::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const
+{
+	result.clear();
+	if (nodes.empty())
+	{
+		return 0;
+	}
+	const uint32_t insideFlag = 0x80000000U;//X^bN̒lɕtAsv̈
+	uint32_t stack[bvhMaxDepth + 2];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const uint32_t value = stack[--top];
+		const uint32_t index = value & ~insideFlag;
+		const Node& node = nodes[index];
+		bool isInside = (value & insideFlag) != 0;
+		if (!isInside)
+		{
+			const int classification = BvhClassifyBox(frustum, node.min, node.max);
+			if (classification < 0)
+			{
+				continue;
+			}
+			isInside = classification > 0;
+		}
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if (isInside || frustum.TestBox(primitiveBoxes[i].min, primitiveBoxes[i].max))
+				{
+					result.push_back(primitiveIndices[i]);
+				}
+			}
+			continue;
+		}
+		const uint32_t flag = isInside ? insideFlag : 0;
+		stack[top++] = node.offset | flag;
+		stack[top++] = (index + 1) | flag;
+	}
+	return result.size();
+}
+
+/**
+* E{bNXƏdȂ镨̂T
+*
+* @param min    ׂ͈͂̍ŏW
+* @param max    ׂ͈͂̍őW
+* @param result ͈͂ƏdȂ镨̂̔ԍ̊i[(Ԃ͕s)
+*
+* @return ͈͂ƏdȂ镨̂̐
+*
+* Op`BVHł́AOp`̋E{bNXdȂ̂Ԃ
+*/
+size_t Bvh::QueryBox(const glm::vec3& min, const glm::vec3& max,
+	std::vector<uint32_t>& result) const
+{
+	const auto overlaps = [&min, &max](const glm::vec3& boxMin, const glm::vec3& boxMax) {
+		return boxMin.x <= max.x && boxMax.x >= min.x &&
+			boxMin.y <= max.y && boxMax.y >= min.y &&
+			boxMin.z <= max.z && boxMax.z >= min.z;
+	};
+	result.clear();
+	if (nodes.empty())
+	{
+		return 0;
+	}
+	uint32_t stack[bvhMaxDepth + 2];
+	int top = 0;
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const uint32_t index = stack[--top];
+		const Node& node = nodes[index];
+		if (!overlaps(node.min, node.max))
+		{
+			continue;
+		}
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				if (overlaps(primitiveBoxes[i].min, primitiveBoxes[i].max))
+				{
+					result.push_back(primitiveIndices[i]);
+				}
+			}
+			continue;
+		}
+		stack[top++] = node.offset;
+		stack[top++] = index + 1;
+	}
+	return result.size();
+}
+
+/**
+* Cŏɓ镨̂T
+*
+* @param origin      C̎n_
+* @param direction   Č(KȂĂ悢. ͂̃xNg̒PʂɂȂ)
+* @param maxDistance 艓͖̂
+* @param hit         ̂̊i[
+*
+* @retval true  ̂ɓ
+* @retval false ̂ɓȂ
+*
+* Op`BVHł͎Op`Ƃ̌AȊÔ͕̋E{bNXƂ̌𒲂ׂ.
+* ߂qm[h璲ׁA艓m[hׂ͒Ȃ
+*/
+bool Bvh::Raycast(const glm::vec3& origin, const glm::vec3& direction,
+	float maxDistance, RayHit& hit) const
+{
+	if (nodes.empty())
+	{
+		return false;
+	}
+	const glm::vec3 invDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+	const bool hasTriangles = !triangles.empty();
+	float closest = maxDistance;
+	uint32_t closestIndex = UINT32_MAX;
+
+	uint32_t stack[bvhMaxDepth + 2];
+	int top = 0;
+	if (BvhRayBox(origin, invDirection, nodes[0].min, nodes[0].max, closest) == FLT_MAX)
+	{
+		return false;
+	}
+	stack[top++] = 0;
+	while (top > 0)
+	{
+		const uint32_t index = stack[--top];
+		const Node& node = nodes[index];
+		if (node.count > 0)
+		{
+			for (uint32_t i = node.offset; i < node.offset + node.count; ++i)
+			{
+				const float t = hasTriangles ?
+					BvhRayTriangle(origin, direction, &triangles[i * 3]) :
+					BvhRayBox(origin, invDirection, primitiveBoxes[i].min, primitiveBoxes[i].max, closest);
+				if (t == FLT_MAX || t > closest || (t == closest && closestIndex != UINT32_MAX))
+				{
+					continue;
+				}
+				closest = t;
+				closestIndex = primitiveIndices[i];
+			}
+			continue;
+		}
+
+		//߂qm[hɐςŁAɒׂ
+		uint32_t nearChild = index + 1;
+		uint32_t farChild = node.offset;
+		float tNear = BvhRayBox(origin, invDirection, nodes[nearChild].min, nodes[nearChild].max, closest);
+		float tFar = BvhRayBox(origin, invDirection, nodes[farChild].min, nodes[farChild].max, closest);
+		if (tFar < tNear)
+		{
+			std::swap(nearChild, farChild);
+			std::swap(tNear, tFar);
+		}
+		if (tFar != FLT_MAX)
+		{
+			stack[top++] = farChild;
+		}
+		if (tNear != FLT_MAX)
+		{
+			stack[top++] = nearChild;
+		}
+	}
+	if (closestIndex == UINT32_MAX)
+	{
+		return false;
+	}
+	hit.index = closestIndex;
+	hit.distance = closest;
+	return true;
+}
+
+/**
+* BVHt@Cɕۑ
+*
+* @param path ۑt@C
+*
+* @retval true  ۑ
+* @retval false ۑs
+*
+* ǂݍݑƓoCgA\̂̔zůŎg
+*/
+bool Bvh::Save(const char* path) const
+{
+	std::ofstream ofs(path, std::ios_base::binary | std::ios_base::trunc);
+	if (!ofs.is_open())
+	{
+		std::cerr << "WARNING: " << path << "쐬ł܂\n";
+		return false;
+	}
+	BvhFileHeader header = {};
+	memcpy(header.magic, bvhFileMagic, sizeof(header.magic));
+	header.version = bvhFileVersion;
+	header.nodeCount = static_cast<uint32_t>(nodes.size());
+	header.primitiveCount = static_cast<uint32_t>(primitiveIndices.size());
+	header.triangleCount = static_cast<uint32_t>(triangles.size() / 3);
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	ofs.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(Node));
+	ofs.write(reinterpret_cast<const char*>(primitiveIndices.data()),
+		primitiveIndices.size() * sizeof(uint32_t));
+	ofs.write(reinterpret_cast<const char*>(primitiveBoxes.data()),
+		primitiveBoxes.size() * sizeof(Aabb));
+	ofs.write(reinterpret_cast<const char*>(triangles.data()),
+		triangles.size() * sizeof(glm::vec3));
+	if (!ofs)
+	{
+		std::cerr << "WARNING: " << path << "݂̏Ɏs\n";
+		ofs.close();
+		remove(path);
+		return false;
+	}
+	return true;
+}
+
+/**
+* BVHt@Cǂݍ
+*
+* @param path ǂݍރt@C
+*
+* @retval true  ǂݍݐ
+* @retval false t@CA܂͉Ă(BVH͋ɂȂ)
+*/
+bool Bvh::Load(const char* path)
+{
+	Clear();
+	std::ifstream ifs(path, std::ios_base::binary);
+	if (!ifs.is_open())
+	{
+		return false;
+	}
+	BvhFileHeader header = {};
+	ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+	if (!ifs || memcmp(header.magic, bvhFileMagic, sizeof(header.magic)) != 0 ||
+		header.version != bvhFileVersion || header.primitiveCount >= 0x80000000U ||
+		header.nodeCount > header.primitiveCount * 2U ||
+		(header.triangleCount != 0 && header.triangleCount != header.primitiveCount))
+	{
+		std::cerr << "WARNING: " << path << "BVHt@Cł͂ȂAo[WႢ܂\n";
+		return false;
+	}
+
+	//TCYĂĂȊmۂȂ悤ɁAt@C̎c̑傫Ɣׂ
+	const std::streamoff dataPos = ifs.tellg();
+	ifs.seekg(0, std::ios_base::end);
+	const std::streamoff fileSize = ifs.tellg();
+	ifs.seekg(dataPos);
+	const uint64_t dataSize = uint64_t(header.nodeCount) * sizeof(Node) +
+		uint64_t(header.primitiveCount) * (sizeof(uint32_t) + sizeof(Aabb)) +
+		uint64_t(header.triangleCount) * 3 * sizeof(glm::vec3);
+	if (fileSize < 0 || dataPos < 0 || uint64_t(fileSize - dataPos) != dataSize)
+	{
+		std::cerr << "WARNING: " << path << "̑傫sł\n";
+		return false;
+	}
+	nodes.resize(header.nodeCount);
+	primitiveIndices.resize(header.primitiveCount);
+	primitiveBoxes.resize(header.primitiveCount);
+	triangles.resize(header.triangleCount * 3);
+	ifs.read(reinterpret_cast<char*>(nodes.data()), nodes.size() * sizeof(Node));
+	ifs.read(reinterpret_cast<char*>(primitiveIndices.data()),
+		primitiveIndices.size() * sizeof(uint32_t));
+	ifs.read(reinterpret_cast<char*>(primitiveBoxes.data()), primitiveBoxes.size() * sizeof(Aabb));
+	ifs.read(reinterpret_cast<char*>(triangles.data()), triangles.size() * sizeof(glm::vec3));
+	if (!ifs || !IsValid())
+	{
+		std::cerr << "WARNING: " << path << "BVHĂ܂\n";
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+* ǂݍ񂾖؂̍\ׂ
+*
+* @retval true  TĂ͈͊OɃANZXȂ
+* @retval false Ă
+*
+* qm[h͕Keɂ̂ŁA擪珇ɐ[߂Ώzoł
+*/
+bool Bvh::IsValid() const
+{
+	if (nodes.empty())
+	{
+		return primitiveIndices.empty();
+	}
+	const size_t nodeCount = nodes.size();
+	const size_t primitiveCount = primitiveIndices.size();
+	std::vector<int> depth(nodeCount, -1);
+	depth[0] = 0;
+	size_t coveredCount = 0;
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		const Node& node = nodes[i];
+		if (depth[i] < 0 || depth[i] > bvhMaxDepth)
+		{
+			return false;//ǂQƂĂȂA܂͐[
+		}
+		if (node.count > 0)
+		{
+			if (node.offset > primitiveCount || node.count > primitiveCount - node.offset)
+			{
+				return false;
+			}
+			coveredCount += node.count;
+			continue;
+		}
+		const size_t left = i + 1;
+		const size_t right = node.offset;
+		if (right <= left || right >= nodeCount || depth[left] >= 0 || depth[right] >= 0)
+		{
+			return false;
+		}
+		depth[left] = depth[right] = depth[i] + 1;
+	}
+	if (coveredCount != primitiveCount)
+	{
+		return false;
+	}
+	for (const uint32_t index : primitiveIndices)
+	{
+		if (index >= primitiveCount)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* m[h̔z擾
+*
+* @return [D揇ɕ񂾃m[h̔z
+*/
+const std::vector<Bvh::Node>& Bvh::Nodes() const
+{
+	return nodes;
+}
+
+/**
+* ؂̌`̓v擾
+*
+* @return v
+*/
+Bvh::Statistics Bvh::GetStatistics() const
+{
+	Statistics stats = {};
+	stats.nodeCount = nodes.size();
+	if (nodes.empty())
+	{
+		return stats;
+	}
+	const float rootArea = BvhSurfaceArea(nodes[0].min, nodes[0].max);
+	std::vector<size_t> depth(nodes.size(), 0);
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		const Node& node = nodes[i];
+		const float probability = rootArea > 0 ?
+			BvhSurfaceArea(node.min, node.max) / rootArea : 1.0f;
+		if (node.count > 0)
+		{
+			++stats.leafCount;
+			stats.maxDepth = std::max(stats.maxDepth, depth[i]);
+			stats.maxLeafSize = std::max<size_t>(stats.maxLeafSize, node.count);
+			stats.sahCost += probability * node.count;
+			continue;
+		}
+		stats.sahCost += probability * bvhTraversalCost;
+		depth[i + 1] = depth[node.offset] = depth[i] + 1;
+	}
+	return stats;
+}
@@ -0,0 +1,84 @@
+/**
+* @file Bvh.h
+*/
+#ifndef BVH_H_INCLUDED
+#define BVH_H_INCLUDED
+#include "FrustumCuller.h"
+#include <glm/vec3.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//sE{bNX
+struct Aabb
+{
+	glm::vec3 min;//ŏW
+	glm::vec3 max;//őW
+};
+
+/**
+* Ȃ̂̋E{bNXKw(BVH)
+*
+* \ʐσq[XeBbN(SAH)ŕ؂A[D揇1̔zɊi[.
+* m[h̍̎q͏ɒɂ̂ŁAE̎q̔ԍ
+*/
+class Bvh
+{
+public:
+	//m[h(32oCg)
+	struct Node
+	{
+		glm::vec3 min;//E{bNX̍ŏW
+		uint32_t offset;//tȂŏ̂̈̕ʒuAm[hȂE̎q̔ԍ
+		glm::vec3 max;//E{bNX̍őW
+		uint32_t count;//tɊ܂܂镨̂̐. 0Ȃm[h
+	};
+
+	//C
+	struct RayHit
+	{
+		uint32_t index;//̂̔ԍ(Buildɓn)
+		float distance;//C̎n_̋
+	};
+
+	//؂̌`̓v
+	struct Statistics
+	{
+		size_t nodeCount;//m[h
+		size_t leafCount;//t̐
+		size_t maxDepth;//ł[t̐[
+		size_t maxLeafSize;//tɊ܂܂镨̂̍ő吔
+		float sahCost;//SAHŌς1̒T̃RXg(1̔1Ƃ)
+	};
+
+	bool Build(const std::vector<Aabb>& boxes, int threadCount = 0);
+	bool BuildFromTriangles(const glm::vec3* positions, size_t positionCount,
+		const uint32_t* indices, size_t triangleCount, int threadCount = 0);
+	void Clear();
+	bool IsEmpty() const;
+	size_t PrimitiveCount() const;
+	bool HasTriangles() const;
+
+	size_t QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& result) const;
+	size_t QueryBox(const glm::vec3& min, const glm::vec3& max,
+		std::vector<uint32_t>& result) const;
+	bool Raycast(const glm::vec3& origin, const glm::vec3& direction,
+		float maxDistance, RayHit& hit) const;
+
+	bool Save(const char* path) const;
+	bool Load(const char* path);
+
+	const std::vector<Node>& Nodes() const;
+	Statistics GetStatistics() const;
+
+private:
+	bool BuildTree(const std::vector<Aabb>& boxes, int threadCount);
+	bool IsValid() const;
+
+	std::vector<Node> nodes;
+	std::vector<uint32_t> primitiveIndices;//t̏ɕׂ̂̔ԍ
+	std::vector<Aabb> primitiveBoxes;//t̏ɕׂ̂̋E{bNX
+	std::vector<glm::vec3> triangles;//t̏ɕׂOp`̒_(3. Op`BVĤ)
+};
+
+#endif //BVH_H_INCLUDED
@@ -0,0 +1,338 @@
+/**
+* @file FrustumCuller.cpp
+*/
+#include "FrustumCuller.h"
+#include "Bvh.h"
+#include <math.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define FRUSTUMCULLER_USE_SSE
+#include <emmintrin.h>
+#endif
+
+/**
+* r[ vWFNVs񂩂王쐬
+*
+* @param matVP r[ vWFNVs
+*
+* @return [hWn̎
+*
+* NbvW -w <= x,y,z <= w As̍s̘aƍŕ\6̕ʂɕ
+*/
+Frustum Frustum::FromMatrix(const glm::mat4& matVP)
+{
+	//glm̍s͗DȂ̂ŁAso
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		rows[i] = glm::vec4(matVP[0][i], matVP[1][i], matVP[2][i], matVP[3][i]);
+	}
+	Frustum frustum;
+	frustum.planes[planeLeft] = rows[3] + rows[0];
+	frustum.planes[planeRight] = rows[3] - rows[0];
+	frustum.planes[planeBottom] = rows[3] + rows[1];
+	frustum.planes[planeTop] = rows[3] - rows[1];
+	frustum.planes[planeNear] = rows[3] + rows[2];
+	frustum.planes[planeFar] = rows[3] - rows[2];
+	for (glm::vec4& plane : frustum.planes)
+	{
+		const float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0)
+		{
+			plane /= length;
+		}
+	}
+	return frustum;
+}
+
+/**
+* ƏdȂ邩ׂ
+*
+* @param center ̒SW
+* @param radius ̔a
+*
+* @retval true  dȂ(\)
+* @retval false ̊Oɂ
+*/
+bool Frustum::TestSphere(const glm::vec3& center, float radius) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		const float distance =
+			plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		if (!(distance + radius >= 0))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* sE{bNXƏdȂ邩ׂ
+*
+* @param min {bNX̍ŏW
+* @param max {bNX̍őW
+*
+* @retval true  dȂ(\)
+* @retval false ̊Oɂ
+*
+* ʂƂɁA@̌ɍłi񂾒_ʂ̊Oɂ΁A{bNXŜOɂ
+*/
+bool Frustum::TestBox(const glm::vec3& min, const glm::vec3& max) const
+{
+	for (const glm::vec4& plane : planes)
+	{
+		const float x = plane.x >= 0 ? max.x : min.x;
+		const float y = plane.y >= 0 ? max.y : min.y;
+		const float z = plane.z >= 0 ? max.z : min.z;
+		if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* SĂ̋폜
+*/
+void SphereArrays::Clear()
+{
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	radius.clear();
+}
+
+/**
+* ǉ
+*
+* @param center ̒SW
+* @param r      ̔a
+*/
+void SphereArrays::Push(const glm::vec3& center, float r)
+{
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	radius.push_back(r);
+}
+
+/**
+* Eǉ
+*
+* @param sphere ǉ鋫E
+*/
+void SphereArrays::Push(const BoundingSphere& sphere)
+{
+	Push(glm::vec3(sphere.center.x, sphere.center.y, sphere.center.z), sphere.radius);
+}
+
+/**
+* ̐擾
+*
+* @return ̐
+*/
+size_t SphereArrays::Size() const
+{
+	return centerX.size();
+}
+
+/**
+* SIMD߂Ŕ肷邩ǂ擾
+*
+* @retval true  4SSE߂Ŕ肷
+* @retval false SIMD߂gȂ
+*/
+bool FrustumCuller::IsSimdEnabled()
+{
+#if defined(FRUSTUMCULLER_USE_SSE)
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+* Ɏgݒ肷
+*
+* @param matVP r[ vWFNVs
+*/
+void FrustumCuller::SetViewProjectionMatrix(const glm::mat4& matVP)
+{
+	frustum = Frustum::FromMatrix(matVP);
+}
+
+/**
+* Ɏg擾
+*
+* @return [hWn̎
+*/
+const Frustum& FrustumCuller::GetFrustum() const
+{
+	return frustum;
+}
+
+/**
+* ƏdȂ鋅I
+*
+* @param spheres        [hWn̋E̔z
+* @param visibleIndices ƏdȂ鋅̔ԍ̊i[()
+*
+* @return ƏdȂ鋅̐
+*
+* 4̋6̕ʂƂ܂Ƃ߂ĔrA鋅̔ԍ𕪊򂹂ɋl߂ď.
+* ʂCullScalarƊSɈv
+*/
+size_t FrustumCuller::Cull(const SphereArrays& spheres, std::vector<uint32_t>& visibleIndices)
+{
+#if defined(FRUSTUMCULLER_USE_SSE)
+	const size_t count = spheres.Size();
+	visibleIndices.resize(count);
+	uint32_t* const out = visibleIndices.data();
+	size_t visibleCount = 0;
+
+	__m128 planeX[Frustum::planeCount], planeY[Frustum::planeCount];
+	__m128 planeZ[Frustum::planeCount], planeW[Frustum::planeCount];
+	for (int i = 0; i < Frustum::planeCount; ++i)
+	{
+		planeX[i] = _mm_set1_ps(frustum.planes[i].x);
+		planeY[i] = _mm_set1_ps(frustum.planes[i].y);
+		planeZ[i] = _mm_set1_ps(frustum.planes[i].z);
+		planeW[i] = _mm_set1_ps(frustum.planes[i].w);
+	}
+	const __m128 zero = _mm_setzero_ps();
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(&spheres.centerX[i]);
+		const __m128 y = _mm_loadu_ps(&spheres.centerY[i]);
+		const __m128 z = _mm_loadu_ps(&spheres.centerZ[i]);
+		const __m128 r = _mm_loadu_ps(&spheres.radius[i]);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int p = 0; p < Frustum::planeCount; ++p)
+		{
+			//TestSphereƓԂŌvZAۂߌ덷܂ňv
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeZ[p], z));
+			distance = _mm_add_ps(distance, planeW[p]);
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, r), zero));
+		}
+		const int mask = _mm_movemask_ps(inside);
+		const uint32_t index = static_cast<uint32_t>(i);
+		out[visibleCount] = index;
+		visibleCount += mask & 1;
+		out[visibleCount] = index + 1;
+		visibleCount += (mask >> 1) & 1;
+		out[visibleCount] = index + 2;
+		visibleCount += (mask >> 2) & 1;
+		out[visibleCount] = index + 3;
+		visibleCount += (mask >> 3) & 1;
+	}
+
+	//4ɖȂc1肷
+	for (; i < count; ++i)
+	{
+		if (frustum.TestSphere(glm::vec3(spheres.centerX[i], spheres.centerY[i],
+			spheres.centerZ[i]), spheres.radius[i]))
+		{
+			out[visibleCount++] = static_cast<uint32_t>(i);
+		}
+	}
+	visibleIndices.resize(visibleCount);
+	CountResult(count, visibleCount);
+	return visibleCount;
+#else
+	return CullScalar(spheres, visibleIndices);
+#endif
+}
+
+/**
+* ƏdȂ鋅SIMDg킸ɑI
+*
+* @param spheres        [hWn̋E̔z
+* @param visibleIndices ƏdȂ鋅̔ԍ̊i[()
+*
+* @return ƏdȂ鋅̐
+*/
+size_t FrustumCuller::CullScalar(const SphereArrays& spheres, std::vector<uint32_t>& visibleIndices)
+{
+	const size_t count = spheres.Size();
+	visibleIndices.clear();
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (frustum.TestSphere(glm::vec3(spheres.centerX[i], spheres.centerY[i],
+			spheres.centerZ[i]), spheres.radius[i]))
+		{
+			visibleIndices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	CountResult(count, visibleIndices.size());
+	return visibleIndices.size();
+}
+
+/**
+* BVHɓo^̂̂AƏdȂ̂I
+*
+* @param bvh            [hWn̂̕o^BVH
+* @param visibleIndices ƏdȂ镨̂̔ԍ̊i[(Ԃ͕s)
+*
+* @return ƏdȂ镨̂̐
+*
+* ̊Oɂm[h艺ׂ̂͒̕ȂAWvł͑SĂ̂̕𔻒肵̂ƂĐ
+*/
+size_t FrustumCuller::Cull(const Bvh& bvh, std::vector<uint32_t>& visibleIndices)
+{
+	const size_t visibleCount = bvh.QueryFrustum(frustum, visibleIndices);
+	CountResult(bvh.PrimitiveCount(), visibleCount);
+	return visibleCount;
+}
+
+/**
+* Vt[̏WvJn
+*
+* Wvt[̌ʂ́AGetFrameStatisticsŎ擾ł悤ɂȂ
+*/
+void FrustumCuller::BeginFrame()
+{
+	lastFrame = frame;
+	lastFrame.frameCount = 1;
+	++total.frameCount;
+	frame = {};
+}
+
+/**
+* Õt[̔萔擾
+*
+* @return Õt[Ŕ肵̂̐
+*/
+FrustumCuller::Statistics FrustumCuller::GetFrameStatistics() const
+{
+	return lastFrame;
+}
+
+/**
+* ܂ł̔萔̍v擾
+*
+* @return 肵̂̐̍v
+*/
+FrustumCuller::Statistics FrustumCuller::GetTotalStatistics() const
+{
+	return total;
+}
+
+/**
+* 茋ʂWv
+*
+* @param testedCount  肵̂̐
+* @param visibleCount ƏdȂ̂̐
+*/
+void FrustumCuller::CountResult(size_t testedCount, size_t visibleCount)
+{
+	frame.testedCount += testedCount;
+	frame.culledCount += testedCount - visibleCount;
+	total.testedCount += testedCount;
+	total.culledCount += testedCount - visibleCount;
+}
@@ -0,0 +1,94 @@
+/**
+* @file FrustumCuller.h
+*/
+#ifndef FRUSTUMCULLER_H_INCLUDED
+#define FRUSTUMCULLER_H_INCLUDED
+#include "Geometry.h"
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class Bvh;
+
+/**
+* 
+*
+* 6̕ʂ̖@͎̓A1ɐKĂ.
+* _pƕʂ̋ dot(xyz, p) + w ŁAȂ王̊O
+*/
+struct Frustum
+{
+	//ʂ̔ԍ
+	enum Plane
+	{
+		planeLeft,
+		planeRight,
+		planeBottom,
+		planeTop,
+		planeNear,
+		planeFar,
+		planeCount,
+	};
+
+	glm::vec4 planes[planeCount];
+
+	static Frustum FromMatrix(const glm::mat4& matVP);
+	bool TestSphere(const glm::vec3& center, float radius) const;
+	bool TestBox(const glm::vec3& min, const glm::vec3& max) const;
+};
+
+/**
+* E̒SWƔa𐬕Ƃ̔zɂ܂Ƃ߂
+*
+* SIMD߂ŕ̋𓯎ɔł悤ɁAx, y, z, aʁX̔zɊi[
+*/
+struct SphereArrays
+{
+	std::vector<float> centerX, centerY, centerZ;
+	std::vector<float> radius;
+
+	void Clear();
+	void Push(const glm::vec3& center, float radius);
+	void Push(const BoundingSphere& sphere);
+	size_t Size() const;
+};
+
+/**
+* ̊Oɂ镨̂`Ώۂ珜NX
+*/
+class FrustumCuller
+{
+public:
+	//肵̂̐
+	struct Statistics
+	{
+		size_t testedCount;//肵
+		size_t culledCount;//̊Oɂ̂ŏ
+		size_t frameCount;//Wvt[
+	};
+
+	static bool IsSimdEnabled();
+
+	void SetViewProjectionMatrix(const glm::mat4& matVP);
+	const Frustum& GetFrustum() const;
+	size_t Cull(const SphereArrays& spheres, std::vector<uint32_t>& visibleIndices);
+	size_t CullScalar(const SphereArrays& spheres, std::vector<uint32_t>& visibleIndices);
+	size_t Cull(const Bvh& bvh, std::vector<uint32_t>& visibleIndices);
+
+	void BeginFrame();
+	Statistics GetFrameStatistics() const;
+	Statistics GetTotalStatistics() const;
+
+private:
+	void CountResult(size_t testedCount, size_t visibleCount);
+
+	Frustum frustum = {};
+	Statistics frame = {};//Wṽt[
+	Statistics lastFrame = {};//Õt[
+	Statistics total = {};//܂ł̍v
+};
+
+#endif //FRUSTUMCULLER_H_INCLUDED
@@ -0,0 +1,504 @@
+/**
+* @file GLStateCache.cpp
+*/
+#include "GLStateCache.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <string.h>
+
+/**
+* vOgp
+*/
+void GLBackend::UseProgram(GLuint program)
+{
+	glUseProgram(program);
+}
+
+/**
+* Ώۂ̃eNX` jbgI
+*/
+void GLBackend::ActiveTexture(GLenum unit)
+{
+	glActiveTexture(unit);
+}
+
+/**
+* eNX`
+*/
+void GLBackend::BindTexture(GLenum target, GLuint texture)
+{
+	glBindTexture(target, texture);
+}
+
+/**
+* VAO
+*/
+void GLBackend::BindVertexArray(GLuint vao)
+{
+	glBindVertexArray(vao);
+}
+
+/**
+* int^uniformϐݒ肷
+*/
+void GLBackend::ProgramUniform1i(GLuint program, GLint location, GLint value)
+{
+	glProgramUniform1i(program, location, value);
+}
+
+/**
+* vec3^uniformϐݒ肷
+*/
+void GLBackend::ProgramUniform3fv(GLuint program, GLint location, const GLfloat* value)
+{
+	glProgramUniform3fv(program, location, 1, value);
+}
+
+/**
+* mat4^uniformϐݒ肷
+*/
+void GLBackend::ProgramUniformMatrix4fv(GLuint program, GLint location, const GLfloat* value)
+{
+	glProgramUniformMatrix4fv(program, location, 1, GL_FALSE, value);
+}
+
+/**
+* eNX`폜
+*/
+void GLBackend::DeleteTexture(GLuint texture)
+{
+	glDeleteTextures(1, &texture);
+}
+
+/**
+* vO폜
+*/
+void GLBackend::DeleteProgram(GLuint program)
+{
+	glDeleteProgram(program);
+}
+
+/**
+* VAO폜
+*/
+void GLBackend::DeleteVertexArray(GLuint vao)
+{
+	glDeleteVertexArrays(1, &vao);
+}
+
+void RecordingGLBackend::UseProgram(GLuint program)
+{
+	calls.push_back({ "glUseProgram", program, 0 });
+}
+
+void RecordingGLBackend::ActiveTexture(GLenum unit)
+{
+	calls.push_back({ "glActiveTexture", unit - GL_TEXTURE0, 0 });
+}
+
+void RecordingGLBackend::BindTexture(GLenum target, GLuint texture)
+{
+	calls.push_back({ "glBindTexture", texture, static_cast<GLint>(target) });
+}
+
+void RecordingGLBackend::BindVertexArray(GLuint vao)
+{
+	calls.push_back({ "glBindVertexArray", vao, 0 });
+}
+
+void RecordingGLBackend::ProgramUniform1i(GLuint program, GLint location, GLint)
+{
+	calls.push_back({ "glProgramUniform1i", program, location });
+}
+
+void RecordingGLBackend::ProgramUniform3fv(GLuint program, GLint location, const GLfloat*)
+{
+	calls.push_back({ "glProgramUniform3fv", program, location });
+}
+
+void RecordingGLBackend::ProgramUniformMatrix4fv(GLuint program, GLint location, const GLfloat*)
+{
+	calls.push_back({ "glProgramUniformMatrix4fv", program, location });
+}
+
+void RecordingGLBackend::DeleteTexture(GLuint texture)
+{
+	calls.push_back({ "glDeleteTextures", texture, 0 });
+}
+
+void RecordingGLBackend::DeleteProgram(GLuint program)
+{
+	calls.push_back({ "glDeleteProgram", program, 0 });
+}
+
+void RecordingGLBackend::DeleteVertexArray(GLuint vao)
+{
+	calls.push_back({ "glDeleteVertexArrays", vao, 0 });
+}
+
+/**
+* L^
+*/
+void RecordingGLBackend::Clear()
+{
+	calls.clear();
+}
+
+/**
+* L^Ăяo擾
+*
+* @return Ăяoɕ񂾋L^
+*/
+const std::vector<RecordingGLBackend::Call>& RecordingGLBackend::Calls() const
+{
+	return calls;
+}
+
+/**
+* ֐̌Ăяo񐔂𐔂
+*
+* @param name ֐
+*
+* @return nameĂяo
+*/
+size_t RecordingGLBackend::Count(const char* name) const
+{
+	size_t count = 0;
+	for (const Call& e : calls)
+	{
+		if (strcmp(e.name, name) == 0)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+/**
+* ԃLbV擾
+*
+* @return ԃLbṼCX^X
+*/
+GLStateCache& GLStateCache::Instance()
+{
+	static GLStateCache instance;
+	return instance;
+}
+
+/**
+* RXgN^
+*/
+GLStateCache::GLStateCache()
+{
+	Invalidate();
+}
+
+/**
+* OpenGL֐̌Ăяoݒ肷
+*
+* @param backend Ăяo. nullptrȂۂOpenGL֐Ăяo
+*
+* Ăяo悪ςƏԂȂȂ̂ŁAL^Ԃ͑SĔj
+*/
+void GLStateCache::SetBackend(GLBackend* backend)
+{
+	this->backend = backend ? backend : &defaultBackend;
+	Invalidate();
+}
+
+/**
+* L^Ԃj
+*
+* ̃NXʂɏԂύXꍇɌĂяo.
+* ̌ĂяóAlɊւ炸OpenGLɓn
+*/
+void GLStateCache::Invalidate()
+{
+	program = unknown;
+	vao = unknown;
+	activeUnit = unknown;
+	for (auto& unit : textures)
+	{
+		for (GLuint& e : unit)
+		{
+			e = unknown;
+		}
+	}
+	uniforms.clear();
+}
+
+/**
+* Vt[̏WvJn
+*
+* Wvt[̌ʂ́AGetFrameStatisticsŎ擾ł悤ɂȂ
+*/
+void GLStateCache::BeginFrame()
+{
+	lastFrame = frame;
+	lastFrame.frameCount = 1;
+	++total.frameCount;
+	frame = {};
+}
+
+/**
+* Õt[̌Ăяo񐔂擾
+*
+* @return Õt[ŏԂύX悤Ƃ
+*/
+GLStateCache::Statistics GLStateCache::GetFrameStatistics() const
+{
+	return lastFrame;
+}
+
+/**
+* ܂ł̌Ăяo񐔂̍v擾
+*
+* @return ԂύX悤Ƃ񐔂̍v
+*/
+GLStateCache::Statistics GLStateCache::GetTotalStatistics() const
+{
+	return total;
+}
+
+/**
+* vOgp
+*
+* @param program gpvOID
+*/
+void GLStateCache::UseProgram(GLuint program)
+{
+	if (this->program == program)
+	{
+		CountCall(false);
+		return;
+	}
+	this->program = program;
+	backend->UseProgram(program);
+	CountCall(true);
+}
+
+/**
+* eNX` jbgɃeNX`蓖Ă
+*
+* @param unit    蓖Đ̃eNX` jbgԍ(0`)
+* @param target  eNX`̎(GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY)
+* @param texture 蓖ĂeNX`ID
+*
+* L^ĂȂނ̃eNX`⃆jbǵAOpenGLɓn
+*/
+void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+{
+	int index = targetCount;
+	if (target == GL_TEXTURE_2D)
+	{
+		index = target2D;
+	}
+	else if (target == GL_TEXTURE_2D_ARRAY)
+	{
+		index = target2DArray;
+	}
+	GLuint* binding = nullptr;
+	if (unit < maxTextureUnits && index < targetCount)
+	{
+		binding = &textures[unit][index];
+		if (*binding == texture)
+		{
+			CountCall(false);
+			return;
+		}
+	}
+	if (activeUnit != unit)
+	{
+		activeUnit = unit;
+		backend->ActiveTexture(GL_TEXTURE0 + unit);
+		CountCall(true);
+	}
+	backend->BindTexture(target, texture);
+	CountCall(true);
+	if (binding)
+	{
+		*binding = texture;
+	}
+}
+
+/**
+* VAO
+*
+* @param vao VAOID
+*/
+void GLStateCache::BindVertexArray(GLuint vao)
+{
+	if (this->vao == vao)
+	{
+		CountCall(false);
+		return;
+	}
+	this->vao = vao;
+	backend->BindVertexArray(vao);
+	CountCall(true);
+}
+
+/**
+* int^uniformϐݒ肷
+*
+* @param program  ݒ̃vOID
+* @param location uniformϐ̈ʒu. Ȃ牽Ȃ
+* @param value    ݒ肷l
+*
+* gp̃vO؂ւɐݒ肷
+*/
+void GLStateCache::SetUniform(GLuint program, GLint location, GLint value)
+{
+	if (location >= 0 && UpdateUniform(program, location, &value, sizeof(value)))
+	{
+		backend->ProgramUniform1i(program, location, value);
+	}
+}
+
+/**
+* vec3^uniformϐݒ肷
+*
+* @param program  ݒ̃vOID
+* @param location uniformϐ̈ʒu. Ȃ牽Ȃ
+* @param value    ݒ肷l
+*/
+void GLStateCache::SetUniform(GLuint program, GLint location, const glm::vec3& value)
+{
+	if (location >= 0 && UpdateUniform(program, location, &value, sizeof(value)))
+	{
+		backend->ProgramUniform3fv(program, location, glm::value_ptr(value));
+	}
+}
+
+/**
+* mat4^uniformϐݒ肷
+*
+* @param program  ݒ̃vOID
+* @param location uniformϐ̈ʒu. Ȃ牽Ȃ
+* @param value    ݒ肷l
+*/
+void GLStateCache::SetUniform(GLuint program, GLint location, const glm::mat4& value)
+{
+	if (location >= 0 && UpdateUniform(program, location, &value, sizeof(value)))
+	{
+		backend->ProgramUniformMatrix4fv(program, location, glm::value_ptr(value));
+	}
+}
+
+/**
+* eNX`폜
+*
+* @param texture 폜eNX`ID
+*
+* 폜eNX`蓖ĂĂjbǵAOpenGLƓ0ɖ߂̂Ƃ
+*/
+void GLStateCache::DeleteTexture(GLuint texture)
+{
+	if (!texture)
+	{
+		return;
+	}
+	backend->DeleteTexture(texture);
+	for (auto& unit : textures)
+	{
+		for (GLuint& e : unit)
+		{
+			if (e == texture)
+			{
+				e = 0;
+			}
+		}
+	}
+}
+
+/**
+* vO폜
+*
+* @param program 폜vOID
+*
+* IDėpĂÂlƔׂȂ悤ɁAuniformϐ̋L^j.
+* gp̃vÓA폜Ăʂ̃vOɐ؂ւ܂Ŏgp̂܂܂ɂȂ
+*/
+void GLStateCache::DeleteProgram(GLuint program)
+{
+	if (!program)
+	{
+		return;
+	}
+	backend->DeleteProgram(program);
+	for (auto itr = uniforms.begin(); itr != uniforms.end();)
+	{
+		if ((itr->first >> 32) == program)
+		{
+			itr = uniforms.erase(itr);
+		}
+		else
+		{
+			++itr;
+		}
+	}
+}
+
+/**
+* VAO폜
+*
+* @param vao 폜VAOID
+*
+* VAO폜ꍇAOpenGLƓ0ꂽ̂Ƃ
+*/
+void GLStateCache::DeleteVertexArray(GLuint vao)
+{
+	if (!vao)
+	{
+		return;
+	}
+	backend->DeleteVertexArray(vao);
+	if (this->vao == vao)
+	{
+		this->vao = 0;
+	}
+}
+
+/**
+* uniformϐ̋L^XV
+*
+* @param program  ݒ̃vOID
+* @param location uniformϐ̈ʒu
+* @param data     ݒ肷l
+* @param size     datãoCg
+*
+* @retval true  lς̂OpenGLɓnKv
+* @retval false L^ƓlȂ̂ŏȗł
+*/
+bool GLStateCache::UpdateUniform(GLuint program, GLint location, const void* data, size_t size)
+{
+	const uint64_t key = (static_cast<uint64_t>(program) << 32) | static_cast<uint32_t>(location);
+	auto result = uniforms.emplace(key, UniformValue());
+	UniformValue& value = result.first->second;
+	if (!result.second && memcmp(value.data, data, size) == 0)
+	{
+		CountCall(false);
+		return false;
+	}
+	memcpy(value.data, data, size);
+	CountCall(true);
+	return true;
+}
+
+/**
+* Ăяo񐔂𐔂
+*
+* @param isIssued true=OpenGLɓn, false=ȗ
+*/
+void GLStateCache::CountCall(bool isIssued)
+{
+	if (isIssued)
+	{
+		++frame.issuedCalls;
+		++total.issuedCalls;
+	}
+	else
+	{
+		++frame.redundantCalls;
+		++total.redundantCalls;
+	}
+}
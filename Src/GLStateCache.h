@@ -0,0 +1,144 @@
+/**
+* @file GLStateCache.h
+*/
+#ifndef GLSTATECACHE_H_INCLUDED
+#define GLSTATECACHE_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+* OpenGL̏ԂύX֐̌Ăяo
+*
+* ł͎ۂOpenGL֐Ăяo.
+* `Ȃœm߂Ƃ́ARecordingGLBackendɍւ.
+*/
+class GLBackend
+{
+public:
+	virtual ~GLBackend() = default;
+	virtual void UseProgram(GLuint program);
+	virtual void ActiveTexture(GLenum unit);
+	virtual void BindTexture(GLenum target, GLuint texture);
+	virtual void BindVertexArray(GLuint vao);
+	virtual void ProgramUniform1i(GLuint program, GLint location, GLint value);
+	virtual void ProgramUniform3fv(GLuint program, GLint location, const GLfloat* value);
+	virtual void ProgramUniformMatrix4fv(GLuint program, GLint location, const GLfloat* value);
+	virtual void DeleteTexture(GLuint texture);
+	virtual void DeleteProgram(GLuint program);
+	virtual void DeleteVertexArray(GLuint vao);
+};
+
+/**
+* OpenGL֐ĂяoɁAĂяoL^邾̌Ăяo
+*/
+class RecordingGLBackend : public GLBackend
+{
+public:
+	//L^Ăяo
+	struct Call
+	{
+		const char* name;//֐
+		GLuint object;//Ώۂ̃IuWFNg(eNX` jbg̏ꍇ̓jbgԍ)
+		GLint location;//uniformϐ̈ʒu܂̓eNX`̎
+	};
+
+	virtual ~RecordingGLBackend() = default;
+	virtual void UseProgram(GLuint program) override;
+	virtual void ActiveTexture(GLenum unit) override;
+	virtual void BindTexture(GLenum target, GLuint texture) override;
+	virtual void BindVertexArray(GLuint vao) override;
+	virtual void ProgramUniform1i(GLuint program, GLint location, GLint value) override;
+	virtual void ProgramUniform3fv(GLuint program, GLint location, const GLfloat* value) override;
+	virtual void ProgramUniformMatrix4fv(GLuint program, GLint location, const GLfloat* value) override;
+	virtual void DeleteTexture(GLuint texture) override;
+	virtual void DeleteProgram(GLuint program) override;
+	virtual void DeleteVertexArray(GLuint vao) override;
+
+	void Clear();
+	const std::vector<Call>& Calls() const;
+	size_t Count(const char* name) const;
+
+private:
+	std::vector<Call> calls;
+};
+
+/**
+* OpenGL̏ԂL^AԂςȂĂяoȗNX
+*
+* gp̃vOAeNX` jbgƂ̃eNX`AVAOA
+* vOƂuniformϐ̒loĂAl̐ݒOpenGLɓnȂ.
+* L^ԂƂȂ悤ɁȀԂ͕K̃NXʂĕύX邱.
+*/
+class GLStateCache
+{
+public:
+	//ԂύX֐̌Ăяo
+	struct Statistics
+	{
+		size_t issuedCalls;//OpenGLɓn
+		size_t redundantCalls;//ԂςȂ̂ŏȗ
+		size_t frameCount;//Wvt[
+	};
+
+	static GLStateCache& Instance();
+
+	void SetBackend(GLBackend* backend);
+	void Invalidate();
+	void BeginFrame();
+	Statistics GetFrameStatistics() const;
+	Statistics GetTotalStatistics() const;
+
+	void UseProgram(GLuint program);
+	void BindTexture(GLuint unit, GLenum target, GLuint texture);
+	void BindVertexArray(GLuint vao);
+	void SetUniform(GLuint program, GLint location, GLint value);
+	void SetUniform(GLuint program, GLint location, const glm::vec3& value);
+	void SetUniform(GLuint program, GLint location, const glm::mat4& value);
+	void DeleteTexture(GLuint texture);
+	void DeleteProgram(GLuint program);
+	void DeleteVertexArray(GLuint vao);
+
+private:
+	GLStateCache();
+	~GLStateCache() = default;
+	GLStateCache(const GLStateCache&) = delete;
+	GLStateCache& operator=(const GLStateCache&) = delete;
+
+	bool UpdateUniform(GLuint program, GLint location, const void* data, size_t size);
+	void CountCall(bool isIssued);
+
+	//L^ĂeNX`̎
+	enum TextureTarget
+	{
+		target2D,
+		target2DArray,
+		targetCount,
+	};
+	static const GLuint maxTextureUnits = 16;
+	static const GLuint unknown = static_cast<GLuint>(-1);//ԂȂƂl
+
+	//uniformϐ̒l(őmat4̑傫)
+	struct UniformValue
+	{
+		GLfloat data[16];
+	};
+
+	GLBackend defaultBackend;
+	GLBackend* backend = &defaultBackend;
+	GLuint program = unknown;
+	GLuint vao = unknown;
+	GLuint activeUnit = unknown;
+	GLuint textures[maxTextureUnits][targetCount];
+	std::unordered_map<uint64_t, UniformValue> uniforms;//L[=(vO<<32)|ʒu
+
+	Statistics frame = {};//Wṽt[
+	Statistics lastFrame = {};//Õt[
+	Statistics total = {};//܂ł̍v
+};
+
+#endif //GLSTATECACHE_H_INCLUDED
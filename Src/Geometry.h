@@ -32,6 +32,48 @@ struct Vertex
 	Vector3 normal;//@
 };
 
+//_f[^̌`
+enum class VertexFormat
+{
+	Float,//Vertex^(48oCg)
+	Packed,//PackedVertex^(20oCg)
+};
+
+//k_f[^^
+struct PackedVertex
+{
+	GLushort position[3];//bV͈̔͂ŐKW(0`65535)
+	GLushort padding;
+	GLushort texCoord[2];//x_̃eNX`W
+	GLshort normal[2];//ʑ̎ʑ2ɂ@(-32767`32767)
+	GLubyte color[4];//_F(0`255)
+};
+
+//sE{bNX
+struct BoundingBox
+{
+	Vector3 min;//ŏW
+	Vector3 max;//őW
+};
+
+//E
+struct BoundingSphere
+{
+	Vector3 center;//SW
+	float radius;//a
+};
+
+//bV̏ڍדx(LOD)̍ő吔
+const int maxMeshLodCount = 4;
+
+//ڍדxƂ̕`͈
+struct MeshLod
+{
+	GLsizei count;//`悷CfbNX
+	const GLvoid* indices;//`JnCfbNXoCgItZbg
+	float error;//̌`Ƃ̌덷(fWnł̋)
+};
+
 //`f[^^
 struct Mesh
 {
@@ -39,5 +81,12 @@ struct Mesh
 	GLsizei count;//`悷CfbNX
 	const GLvoid* indices;//`JnCfbNXoCgItZbg
 	GLint baseVertex;//CfbNX0ԂƂ݂Ȃ钸_z̈ʒu
+	GLenum indexType;//CfbNX̌^(GL_UNSIGNED_SHORT or GL_UNSIGNED_INT)
+	Vector3 positionOffset;//_W𕜌邽߂̕sړ(Float`ł0)
+	Vector3 positionScale;//_W𕜌邽߂̊g嗦(Float`ł1)
+	int lodCount;//ڍדx̐(1ȏ)
+	MeshLod lods[maxMeshLodCount];//ڍדxƂ̕`͈(0Ԃ͌̌`)
+	BoundingBox bounds;//fWnł̋E{bNX
+	BoundingSphere sphere;//fWnł̋E
 };
 #endif //GEOMETRY_H_INCLUDED
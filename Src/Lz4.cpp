@@ -0,0 +1,302 @@
+/**
+* @file Lz4.cpp
+*/
+#include "Lz4.h"
+#include <string.h>
+#include <vector>
+
+//LZ4ubN`̈kƓWJs֐i[閼O
+namespace Lz4 {
+
+	const size_t minMatch = 4;//vƂ݂Ȃŏ̃oCg
+	const size_t lastLiterals = 5;//ubŃAKeƂĊi[oCg
+	const size_t matchFindLimit = 12;//v̊JnʒuƃubNƂ̍ŏ
+	const size_t maxOffset = 65535;//vTő̋
+	const int hashBits = 16;//vTnbV\̑傫(rbg)
+
+/**
+* 4oCgǂݍ
+*
+* @param p ǂݍވʒu
+*
+* @return ǂݍ񂾒l
+*/
+	uint32_t Read32(const uint8_t* p)
+	{
+		uint32_t value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+/**
+* 4oCg̕тnbV\̔ԍ߂
+*
+* @param sequence 4oCg̕
+*
+* @return nbV\̔ԍ
+*/
+	uint32_t HashSequence(uint32_t sequence)
+	{
+		return (sequence * 2654435761U) >> (32 - hashBits);
+	}
+
+/**
+* 15ȏ̂Ƃ̒ǉoCg
+*
+* @param op     ݈ʒu. 񂾕i
+* @param length g[Nɓ肫Ȃ(15l)
+*/
+	void WriteLength(uint8_t*& op, size_t length)
+	{
+		for (; length >= 255; length -= 255)
+		{
+			*op++ = 255;
+		}
+		*op++ = static_cast<uint8_t>(length);
+	}
+
+/**
+* 15̂Ƃ̒ǉoCgǂݍ
+*
+* @param ip     ǂݍ݈ʒu. ǂݍ񂾕i
+* @param end    ͂̏I[
+* @param length ̊i[. ǂݍ񂾒lZ
+*
+* @retval true  ǂݍݐ
+* @retval false ͂rŏIĂ
+*/
+	bool ReadLength(const uint8_t*& ip, const uint8_t* end, size_t& length)
+	{
+		uint8_t b;
+		do
+		{
+			if (ip >= end)
+			{
+				return false;
+			}
+			b = *ip++;
+			length += b;
+		} while (b == 255);
+		return true;
+	}
+
+/**
+* 1̃V[PX(eƈv)
+*
+* @param op          ݈ʒu. 񂾕i
+* @param literals    e̐擪
+* @param literalSize ẽoCg
+* @param offset      v̋(0ȂvȂ̍Ō̃V[PX)
+* @param matchSize   ṽoCg
+*/
+	void WriteSequence(uint8_t*& op, const uint8_t* literals, size_t literalSize,
+		size_t offset, size_t matchSize)
+	{
+		uint8_t* token = op++;
+		if (literalSize >= 15)
+		{
+			*token = 15 << 4;
+			WriteLength(op, literalSize - 15);
+		}
+		else
+		{
+			*token = static_cast<uint8_t>(literalSize << 4);
+		}
+		memcpy(op, literals, literalSize);
+		op += literalSize;
+		if (offset == 0)
+		{
+			return;
+		}
+		*op++ = static_cast<uint8_t>(offset);
+		*op++ = static_cast<uint8_t>(offset >> 8);
+		const size_t length = matchSize - minMatch;
+		if (length >= 15)
+		{
+			*token |= 15;
+			WriteLength(op, length - 15);
+		}
+		else
+		{
+			*token |= static_cast<uint8_t>(length);
+		}
+	}
+
+/**
+* k̍őoCg߂
+*
+* @param srcSize kf[^̃oCg
+*
+* @return kʂi[̂ɕKvȃoCg
+*/
+	size_t CompressBound(size_t srcSize)
+	{
+		return srcSize + srcSize / 255 + 16;
+	}
+
+/**
+* f[^LZ4ubN`ňk
+*
+* @param src         kf[^
+* @param srcSize     src̃oCg
+* @param dst         kʂ̊i[
+* @param dstCapacity dst̃oCg. CompressBound(srcSize)ȏł邱
+*
+* @return k̃oCg. s0
+*
+* 4oCg̃nbVŒȌoʒuTAvOɐL΂×~@ňk.
+* kWJ̑D悵`Ȃ̂ŁAWJ̓t@C̓ǂݍ݂\
+*/
+	size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+	{
+		if (dstCapacity < CompressBound(srcSize))
+		{
+			return 0;
+		}
+		uint8_t* op = dst;
+		size_t anchor = 0;//܂łȂe̐擪
+		if (srcSize > matchFindLimit)
+		{
+			std::vector<uint32_t> table(size_t(1) << hashBits, 0);
+			const size_t matchLimit = srcSize - lastLiterals;
+			size_t ip = 0;
+			while (ip + matchFindLimit <= srcSize)
+			{
+				const uint32_t sequence = Read32(src + ip);
+				uint32_t& slot = table[HashSequence(sequence)];
+				size_t ref = slot;
+				slot = static_cast<uint32_t>(ip);
+				if (ref >= ip || ip - ref > maxOffset || Read32(src + ref) != sequence)
+				{
+					++ip;
+					continue;
+				}
+
+				//vƑOɐL΂
+				size_t length = minMatch;
+				while (ip + length < matchLimit && src[ip + length] == src[ref + length])
+				{
+					++length;
+				}
+				while (ip > anchor && ref > 0 && src[ip - 1] == src[ref - 1])
+				{
+					--ip;
+					--ref;
+					++length;
+				}
+				WriteSequence(op, src + anchor, ip - anchor, ip - ref, length);
+				ip += length;
+				anchor = ip;
+			}
+		}
+		WriteSequence(op, src + anchor, srcSize - anchor, 0, 0);
+		return op - dst;
+	}
+
+/**
+* LZ4ubN`̃f[^WJ
+*
+* @param src     WJf[^
+* @param srcSize src̃oCg
+* @param dst     WJʂ̊i[
+* @param dstSize WJ̃oCg
+*
+* @retval true  WJ
+* @retval false f[^ĂA܂͓WJ̃oCgvȂ
+*
+* ꂽf[^łdst͈̔͊Oɂ͏܂Ȃ
+*/
+	bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+	{
+		const uint8_t* ip = src;
+		const uint8_t* const srcEnd = src + srcSize;
+		uint8_t* op = dst;
+		uint8_t* const dstEnd = dst + dstSize;
+		while (ip < srcEnd)
+		{
+			//eRs[
+			const uint8_t token = *ip++;
+			size_t literalSize = token >> 4;
+			if (literalSize == 15 && !ReadLength(ip, srcEnd, literalSize))
+			{
+				return false;
+			}
+			if (literalSize > static_cast<size_t>(srcEnd - ip) ||
+				literalSize > static_cast<size_t>(dstEnd - op))
+			{
+				return false;
+			}
+			if (literalSize <= 16 && srcEnd - ip >= 16 && dstEnd - op >= 16)
+			{
+				//ZéA]ɏĂȂ͈͂ȂŒ蒷ŃRs[
+				memcpy(op, ip, 16);
+			}
+			else
+			{
+				memcpy(op, ip, literalSize);
+			}
+			ip += literalSize;
+			op += literalSize;
+			if (ip == srcEnd)
+			{
+				break;//Ō̃V[PXɂ͈v
+			}
+
+			//vRs[
+			if (srcEnd - ip < 2)
+			{
+				return false;
+			}
+			const size_t offset = ip[0] | (ip[1] << 8);
+			ip += 2;
+			if (offset == 0 || offset > static_cast<size_t>(op - dst))
+			{
+				return false;
+			}
+			size_t matchSize = token & 15;
+			if (matchSize == 15 && !ReadLength(ip, srcEnd, matchSize))
+			{
+				return false;
+			}
+			matchSize += minMatch;
+			if (matchSize > static_cast<size_t>(dstEnd - op))
+			{
+				return false;
+			}
+			const uint8_t* match = op - offset;
+			if (matchSize <= 16 && offset >= 16 && dstEnd - op >= 16)
+			{
+				memcpy(op, match, 16);
+				op += matchSize;
+			}
+			else if (offset >= matchSize)
+			{
+				memcpy(op, match, matchSize);
+				op += matchSize;
+			}
+			else if (offset >= 8)
+			{
+				//͈͂dȂĂA8oCgPʂȂ珑ݍς݂̕ǂ
+				uint8_t* const matchEnd = op + matchSize;
+				for (; op + 8 <= matchEnd; op += 8, match += 8)
+				{
+					memcpy(op, match, 8);
+				}
+				while (op < matchEnd)
+				{
+					*op++ = *match++;
+				}
+			}
+			else
+			{
+				//ZƔ͈͂dȂ̂ŁA1oCgRs[ČJԂWJ
+				for (size_t i = 0; i < matchSize; ++i)
+				{
+					*op++ = match[i];
+				}
+			}
+		}
+		return op == dstEnd;
+	}
+
+}//namespace Lz4
@@ -0,0 +1,17 @@
+/**
+* @file Lz4.h
+*/
+#ifndef LZ4_H_INCLUDED
+#define LZ4_H_INCLUDED
+#include <stddef.h>
+#include <stdint.h>
+
+//LZ4ubN`̈kƓWJs֐i[閼O
+namespace Lz4 {
+
+	size_t CompressBound(size_t srcSize);
+	size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+	bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+}//namespace Lz4
+#endif //LZ4_H_INCLUDED
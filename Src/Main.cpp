@@ -4,14 +4,63 @@
 #include "GLFWEW.h"
 #include "TitleScene.h"
 #include "MainGameScene.h"
+#include "AssetManager.h"
+#include "AssetPack.h"
+#include "Benchmark.h"
+#include "BlockCompressor.h"
+#include "GLStateCache.h"
+#include <iostream>
+#include <string.h>
 
-MeshList meshList;
+//1t[ŃAZbgGPU]Ɏg(b)
+const double assetUploadBudget = 0.004;
+
+//Q[̃AZbg܂Ƃ߂pbN. Resȉ̃t@CD悵ēǂݍ
+const char* const assetPackPath = "Res/Assets.pak";
 
 /**
 * Gg[|Cg
 */
-int main(void)
+int main(int argc, char** argv)
 {
+	//v̎w肪΁AQ[NɌvs
+	if (Benchmark::Run(argc, argv))
+	{
+		return 0;
+	}
+
+	//eNX`k̎w肪΁AQ[Nɕϊs
+	//: --compress-texture Res/wallWidth.tga Res/wallWidth.ktx bc1
+	if (argc >= 4 && strcmp(argv[1], "--compress-texture") == 0)
+	{
+		BlockCompressor::BlockFormat format = BlockCompressor::BlockFormat::BC1;
+		if (argc >= 5 && strcmp(argv[4], "bc3") == 0)
+		{
+			format = BlockCompressor::BlockFormat::BC3;
+		}
+		else if (argc >= 5 && strcmp(argv[4], "bc7") == 0)
+		{
+			format = BlockCompressor::BlockFormat::BC7;
+		}
+		return BlockCompressor::ConvertFile(argv[2], argv[3], format) ? 0 : 1;
+	}
+
+	//pbN쐬̎w肪΁AQ[Nɍ쐬s
+	//: --build-pack Res/Assets.pak --lz4 Res/Simple.vert Res/Simple.frag Res/Ground.tga
+	if (argc >= 3 && strcmp(argv[1], "--build-pack") == 0)
+	{
+		const bool useLz4 = argc >= 4 && strcmp(argv[3], "--lz4") == 0;
+		const int first = useLz4 ? 4 : 3;
+		return AssetPack::Build(argv[2], argv + first, argc - first, useLz4) ? 0 : 1;
+	}
+
+	//[J[Xbhǂݍ݂n߂OɃpbNJĂ
+	if (AssetPack::Instance().Open(assetPackPath))
+	{
+		std::cout << "INFO: " << assetPackPath << "gp [t@C=" <<
+			AssetPack::Instance().EntryCount() << "]\n";
+	}
+
 	GLFWEW::Window& window = GLFWEW::Window::Instance();
 	if (!window.Init(1000,600,"OpenGL3D_FPS"))
 	{
@@ -25,6 +74,8 @@ int main(void)
 		delete pTitleScene;
 		return 1;
 	}
+	//^Cgʂ\ĂԂɃCQ[ʂ̃AZbgǂݍ
+	MainGameScene::LoadAssetsAsync();
 
 
 	//C[v
@@ -32,6 +83,8 @@ int main(void)
 	while(!window.ShouldClose())
 	{
 		window.UpdateTimer();
+		GLStateCache::Instance().BeginFrame();
+		AssetManager::Instance().Update(assetUploadBudget);
 		if (pTitleScene)
 		{
 			pTitleScene->ProcessInput();
@@ -47,6 +100,8 @@ int main(void)
 				{
 					break;
 				}
+				//^CgʂgĂAZbg
+				AssetManager::Instance().CollectGarbage();
 			}
 		}
 		else if (pMainGameScene)
@@ -67,6 +122,16 @@ int main(void)
 		pMainGameScene->Finalize();
 		delete pMainGameScene;
 	}
+	AssetManager::Instance().Clear();
+
+	//ԕύX̌Ăяoǂꂾȗł\
+	const GLStateCache::Statistics glStats = GLStateCache::Instance().GetTotalStatistics();
+	if (glStats.frameCount > 0)
+	{
+		std::cout << "INFO: OpenGLԕύX[1t[ s=" <<
+			glStats.issuedCalls / glStats.frameCount << " ȗ=" <<
+			glStats.redundantCalls / glStats.frameCount << "]\n";
+	}
 
 	return 0;
 }
\ No newline at end of file
@@ -3,7 +3,64 @@
 */
 #include "MainGameScene.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <iostream>
+#include <cmath>
+
+//CQ[ʂŎgVF[_[ƃeNX`
+const char* const vsSimplePath = "Res/Simple.vert";
+const char* const fsSimplePath = "Res/Simple.frag";
+const char* const vsLightingPath = "Res/FragmentLightingInstanced.vert";//`L[ŕ`悷
+const char* const fsLightingPath = "Res/FragmentLighting.frag";
+
+//CQ[ʂ̃eNX`1̃eNX`zɂ܂Ƃ߁AwԍŐ؂ւ
+const char* const texArrayPaths[] = {
+	"Res/Ground.tga",
+	"Res/Human.tga",
+	"Res/wallWidth.tga",
+	"Res/wallHeight.tga",
+};
+const size_t texArrayCount = sizeof(texArrayPaths) / sizeof(texArrayPaths[0]);
+
+//CQ[ʂ̃eNX`gĂ悢VRAM̗
+const size_t textureBudget = 8 * 1024 * 1024;
+
+//uniformobt@̑傫(t[̂̃̕f[^)
+const size_t uniformBufferSize = 1024 * 1024;
+
+//eNX`z̑wԍ(texArrayPathsƓ)
+enum TextureLayer
+{
+	layerGround,
+	layerHuman,
+	layerWallWidth,
+	layerWallHeight,
+};
+
+//xɌŒŔzu镨(BVHɓo^āAƏdȂ̂`悷)
+struct LevelPiece
+{
+	int meshIndex;
+	TextureLayer layer;
+	glm::vec3 position;
+	bool isOccluder;//ՕƂđ̂̕Bǂ
+};
+const LevelPiece levelPieces[] = {
+	//n
+	{ 0, layerGround, glm::vec3(0, -3, 0), false },
+
+	//(). ǂ̃bV͒g̋l܂Ȃ̂ŁAE{bNX̂܂܎ՕɎg
+	{ 3, layerWallWidth, glm::vec3(-10, -5.5, -20), true },
+	{ 3, layerWallWidth, glm::vec3(10, -5.5, -20), true },
+	{ 3, layerWallWidth, glm::vec3(-10, -5.5, 20), true },
+	{ 3, layerWallWidth, glm::vec3(10, -5.5, 20), true },
+
+	//(c)
+	{ 4, layerWallHeight, glm::vec3(19, -3.9, -10), true },
+	{ 4, layerWallHeight, glm::vec3(19, -3.9, 10), true },
+	{ 4, layerWallHeight, glm::vec3(-19, -3.9, -10), true },
+	{ 4, layerWallHeight, glm::vec3(-19, -3.9, 10), true },
+};
 
 /**
 * vC[̏ԂXV
@@ -23,35 +80,71 @@ void PlayerActor::Update(float deltaTime)
 	Actor::Update(deltaTime);
 }
 
+/**
+* CQ[ʂŎgAZbg̔񓯊ǂݍ݂v
+*
+* Ỏʂ\ĂԂɌĂяoĂƁAInitializeœǂݍ݂҂ɍς
+*/
+void MainGameScene::LoadAssetsAsync()
+{
+	AssetManager& assets = AssetManager::Instance();
+	assets.LoadMeshListAsync(VertexFormat::Packed);
+	assets.LoadProgramAsync(vsSimplePath, fsSimplePath);
+	assets.LoadProgramAsync(vsLightingPath, fsLightingPath);
+}
+
 /**
 * 
 */
 bool MainGameScene::Initialize()
 {
-	if (!meshList.Allcate())
+	AssetManager& assets = AssetManager::Instance();
+	meshList = assets.GetMeshList(VertexFormat::Packed);
+	if (!meshList)
+	{
+		return false;
+	}
+	progSimple = assets.GetProgram(vsSimplePath, fsSimplePath);
+	progLighting = assets.GetProgram(vsLightingPath, fsLightingPath);
+	if (!uniformBuffer.Init(uniformBufferSize))
 	{
 		return false;
 	}
-	progSimple.Reset(Shader::BuildFromFile("Res/Simple.vert", "Res/Simple.frag"));
-	progLighting.Reset(Shader::BuildFromFile(
-		"Res/FragmentLighting.vert", "Res/FragmentLighting.frag"));
 
 	//eNX`̓ǂݍ
-	texGround.Reset(Texture::LoadImage2D("Res/Ground.tga"));
-	texHuman.Reset(Texture::LoadImage2D("Res/Human.tga"));
-	texWallWidth.Reset(Texture::LoadImage2D("Res/wallWidth.tga"));
-	texWallHeight.Reset(Texture::LoadImage2D("Res/wallHeight.tga"));
+	//eNX`z͏i珇ɁA`ɕKvȕVRAMɒu
+	textureStreamer.SetBudget(textureBudget);
+	texArrayId = textureStreamer.AddArray(texArrayPaths, texArrayCount);
 
 	//̐ݒ
 	lights.ambient.color = glm::vec3(0.05f, 0.1f, 0.1f) * 14.0f;
 	lights.directional.direction = glm::normalize(glm::vec3(-5,-50,-15));
 	lights.directional.color = glm::vec3(1, 1, 1);
 
-	player.Initialize(1, texHuman.Get(), 10,
+	player.Initialize(1, layerHuman, 10,
 		glm::vec3(2,-3,0), glm::vec3(0,0,0), glm::vec3(1));
 
-	player.colLocal =
-	{ glm::vec3(-0.5f,0.0f,-0.5f), glm::vec3(1.0f,1.7f,1.0f) };
+	player.SetCollisionFromMesh(meshList->Get(player.mesh));
+
+	//Œ̂̃̕[hWn̋E{bNXABVH쐬
+	levelBoxes.clear();
+	levelBoxes.reserve(sizeof(levelPieces) / sizeof(levelPieces[0]));
+	for (const LevelPiece& e : levelPieces)
+	{
+		const Rect rect = TransformRect(ToRect(meshList->Get(e.meshIndex).bounds),
+			e.position, glm::vec3(0), glm::vec3(1));
+		levelBoxes.push_back({ rect.origin, rect.origin + rect.size });
+	}
+	if (!levelBvh.Build(levelBoxes))
+	{
+		return false;
+	}
+
+	//Օ̐[xobt@́Aʂ\CPUׂ̕}
+	if (!occlusionCuller.Init(320, 192))
+	{
+		return false;
+	}
 
 	return true;
 }
@@ -139,62 +232,121 @@ void MainGameScene::Render()
 
 	glfwPollEvents();
 
-	progLighting.Use();
-
-	meshList.BindVertexArray();
+	//Õt[ŕ񍐂ꂽ傫ɍ킹āAeNX`̏풓iXV
+	textureStreamer.Update();
 
-	//Wϊs쐬
+	//Wϊs쐬.
+	//AXyNg͎ۂ̃r[|[g狁߂(ŏ͍0ɂȂ̂1sNZƂ݂Ȃ)
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	const float viewportWidth = static_cast<float>(std::max(viewport[2], 1));
+	const float viewportHeight = static_cast<float>(std::max(viewport[3], 1));
+	const float fovY = glm::radians(45.0f);
 	const glm::mat4x4 matProj =
-		glm::perspective(glm::radians(45.0f), 1000.0f / 600.0f, 0.1f, 500.0f);
+		glm::perspective(fovY, viewportWidth / viewportHeight, 0.1f, 500.0f);
 	const glm::mat4x4 matRotY =
 		glm::rotate(glm::mat4(1), player.rotation.y, glm::vec3(0, 1, 0));
 	const glm::vec3 viewVector = matRotY * glm::vec4(0, 2, -2, 1);
 	const glm::mat4x4 matView =
 		glm::lookAt(viewPos,player.position + viewVector,glm::vec3(0,1,0));
 
-	progLighting.SetViewProjectionMatrix(matProj * matView);
+	progLighting->SetViewProjectionMatrix(matView, matProj);
+
+	//matProjœeƂA1Œ1̂̕ʏŉsNZɂȂ邩
+	const float projectionScale = viewportHeight / (2.0f * std::tan(fovY * 0.5f));
+	const auto selectLod = [&](int meshIndex, const glm::vec3& position) {
+		return SelectMeshLod(meshList->Get(meshIndex),
+			glm::length(position - viewPos), 1.0f, projectionScale);
+	};
+
+	//bV̉ʏ̑傫AeNX`ɕKvȉ𑜓xƂĕ񍐂
+	const auto reportTextureUsage = [&](int meshIndex, const glm::vec3& position) {
+		const float distance = std::max(glm::length(position - viewPos), 0.1f);
+		const float diameter = meshList->Get(meshIndex).sphere.radius * 2.0f;
+		textureStreamer.ReportUsage(texArrayId, diameter * projectionScale / distance);
+	};
 
 	//ݒ肷
-	progLighting.SetLightList(lights);
+	progLighting->SetLightList(lights);
+
+	//`悷镨̂W߂ĂAfsTransformBatchł܂Ƃ߂ČvZ
+	drawItems.clear();
+	drawTransforms.Clear();
+	const auto submit = [&](int meshIndex, GLint layer, const glm::vec3& position,
+		const glm::vec3& rotation, const glm::vec3& scale) {
+		drawItems.push_back({ meshIndex, layer });
+		drawTransforms.Push(position, rotation, scale);
+	};
 
-	progLighting.BindTexture(0, player.texture);
-	progLighting.Draw(meshList.Get(player.mesh),
-		player.position, player.rotation, player.scale);
+	//̊Oɂ镨̂́AeNX`̎gp񍐂܂߂ĉȂ.
+	//Œ̂̕BVHŁÂ͋EŔ肷
+	const glm::mat4 matVP = matProj * matView;
+	frustumCuller.BeginFrame();
+	frustumCuller.SetViewProjectionMatrix(matVP);
+	frustumCuller.Cull(levelBvh, visibleIndices);
 
-	progLighting.BindTexture(0, texGround.Get());
-	//nʂ\
+	//ƏdȂՕ[xobt@ɕ`ẢɉB镨̂.
+	//Օ͎g̐[xŉBꂽƔ肳Ȃ悤ɁA肹ɕ`悷
+	occlusionCuller.BeginFrame(matVP);
+	occluderIndices.clear();
+	size_t occludeeCount = 0;
+	for (const uint32_t i : visibleIndices)
+	{
+		if (levelPieces[i].isOccluder)
+		{
+			occlusionCuller.AddOccluderBox(levelBoxes[i].min, levelBoxes[i].max);
+			occluderIndices.push_back(i);
+		}
+		else
+		{
+			visibleIndices[occludeeCount++] = i;
+		}
+	}
+	visibleIndices.resize(occludeeCount);
+	occlusionCuller.Rasterize();
+	occlusionCuller.Cull(levelBoxes, visibleIndices);
+	visibleIndices.insert(visibleIndices.end(), occluderIndices.begin(), occluderIndices.end());
+	for (const uint32_t i : visibleIndices)
 	{
-		progLighting.Draw(meshList.Get(0),
-			glm::vec3(0,-3,0), glm::vec3(0), glm::vec3(1));
+		const LevelPiece& e = levelPieces[i];
+		submit(e.meshIndex, e.layer, e.position, glm::vec3(0), glm::vec3(1));
 	}
-
-
-	//ǂ\()
-	progLighting.BindTexture(0, texWallWidth.Get());
+	cullSpheres.Clear();
+	cullSpheres.Push(TransformSphere(meshList->Get(player.mesh).sphere,
+		player.position, player.rotation, player.scale));
+	if (frustumCuller.Cull(cullSpheres, visibleIndices) > 0)
 	{
-		progLighting.Draw(meshList.Get(3),
-			glm::vec3(-10,-5.5,-20), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(3),
-			glm::vec3(10,-5.5,-20), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(3),
-			glm::vec3(-10, -5.5, 20), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(3),
-			glm::vec3(10, -5.5, 20), glm::vec3(0), glm::vec3(1));
+		const Rect rect = TransformRect(ToRect(meshList->Get(player.mesh).bounds),
+			player.position, player.rotation, player.scale);
+		if (occlusionCuller.TestBox(rect.origin, rect.origin + rect.size))
+		{
+			submit(player.mesh, player.texture, player.position, player.rotation, player.scale);
+		}
 	}
 
+	//CX^X`̃VF[_[MVPsFrameData狁߂̂ŁAfs񂾂vZ
+	drawMatrices.resize(drawItems.size());
+	TransformBatch::Output transformOutput;
+	transformOutput.matModel = drawMatrices.data();
+	TransformBatch::Compute(drawTransforms, matVP, lights.directional.direction, transformOutput);
 
-	//ǂ\(c)
-	progLighting.BindTexture(0, texWallHeight.Get());
+	//`͕`L[ɗ߂ĂAvOAeNX`AbV̏ɕבւĂ`悷.
+	//eNX`͑SēeNX`zȂ̂ŁAwԍ̓CX^XƂɎw肷
+	const std::shared_ptr<Texture::Image2D> texArray = textureStreamer.Get(texArrayId);
+	for (size_t i = 0; i < drawItems.size(); ++i)
 	{
-		progLighting.Draw(meshList.Get(4),
-			glm::vec3(19,-3.9,-10), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(4),
-			glm::vec3(19,-3.9,10), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(4),
-			glm::vec3(-19,-3.9, -10), glm::vec3(0), glm::vec3(1));
-		progLighting.Draw(meshList.Get(4),
-			glm::vec3(-19,-3.9,10), glm::vec3(0), glm::vec3(1));
+		const DrawItem& e = drawItems[i];
+		const glm::vec3 position(drawTransforms.positionX[i],
+			drawTransforms.positionY[i], drawTransforms.positionZ[i]);
+		reportTextureUsage(e.meshIndex, position);
+		renderQueue.Submit(RenderPass::Opaque, *progLighting,
+			texArray->Get(), texArray->Target(), meshList->Get(e.meshIndex), e.meshIndex,
+			selectLod(e.meshIndex, position), drawMatrices[i],
+			e.layer, glm::length(position - viewPos));
 	}
+
+	//߂`בւẪf[^܂Ƃ߂ďł`悷
+	renderQueue.Flush(*meshList, uniformBuffer);
 }
 
 /**
@@ -202,5 +354,27 @@ void MainGameScene::Render()
 */
 void MainGameScene::Finalize()
 {
+	//JOłǂꂾ`点\
+	const FrustumCuller::Statistics cullStats = frustumCuller.GetTotalStatistics();
+	if (cullStats.frameCount > 0)
+	{
+		std::cout << "INFO: JO[1t[ =" <<
+			cullStats.testedCount / cullStats.frameCount << " O=" <<
+			cullStats.culledCount / cullStats.frameCount << "]\n";
+	}
+	const OcclusionCuller::Statistics occlusionStats = occlusionCuller.GetTotalStatistics();
+	if (occlusionStats.frameCount > 0)
+	{
+		std::cout << "INFO: IN[WJO[1t[ Օ̎Op`=" <<
+			occlusionStats.occluderTriangleCount / occlusionStats.frameCount << " =" <<
+			occlusionStats.testedCount / occlusionStats.frameCount << " O=" <<
+			occlusionStats.culledCount / occlusionStats.frameCount << "]\n";
+	}
 
+	renderQueue.Clear();
+	occlusionCuller.Destroy();
+	levelBvh.Clear();
+	levelBoxes.clear();
+	textureStreamer.Clear();
+	uniformBuffer.Destroy();
 }
\ No newline at end of file
@@ -8,6 +8,13 @@
 #include "Shader.h"
 #include "MeshList.h"
 #include "Actor.h"
+#include "AssetManager.h"
+#include "TextureStreamer.h"
+#include "RenderQueue.h"
+#include "FrustumCuller.h"
+#include "Bvh.h"
+#include "OcclusionCuller.h"
+#include <memory>
 
 /**
 * vC[삷AN^[
@@ -28,6 +35,7 @@ public:
 	MainGameScene() = default;
 	~MainGameScene() = default;
 
+	static void LoadAssetsAsync();
 	bool Initialize();
 	void ProcessInput();
 	void Update();
@@ -35,16 +43,33 @@ public:
 	void Finalize();
 
 private:
-	MeshList meshList;
+	std::shared_ptr<MeshList> meshList;
 
-	Texture::Image2D texGround;
-	Texture::Image2D texHuman;
-	Texture::Image2D texWallWidth;
-	Texture::Image2D texWallHeight;
+	TextureStreamer textureStreamer;
+	size_t texArrayId = 0;//nʁAlAǂ̉摜܂Ƃ߂eNX`z̔ԍ
 
-	Shader::Program progSimple;
-	Shader::Program progLighting;
+	std::shared_ptr<Shader::Program> progSimple;
+	std::shared_ptr<Shader::Program> progLighting;
 	Shader::LightList lights;
+	UniformRingBuffer uniformBuffer;//t[ƕ̂uniformf[^̏ݐ
+	RenderQueue renderQueue;//בւĂ܂Ƃ߂ĕ`悷`L[
+	FrustumCuller frustumCuller;//̊Oɂ镨̂
+	Bvh levelBvh;//xɌŒŔzu镨̂BVH
+	std::vector<Aabb> levelBoxes;//xɌŒŔzu镨̂̃[hWn̋E{bNX
+	OcclusionCuller occlusionCuller;//ՕɉB镨̂
+	SphereArrays cullSpheres;//JOɎg[hWn̋E
+	std::vector<uint32_t> visibleIndices;//`悷镨̂̔ԍ
+	std::vector<uint32_t> occluderIndices;//ՕƂĐ[xobt@ɕ`̂̔ԍ
+
+	//`L[ɒǉ镨(fsTransformBatchł܂Ƃ߂ČvZ)
+	struct DrawItem
+	{
+		int meshIndex;
+		GLint layer;
+	};
+	std::vector<DrawItem> drawItems;
+	TransformBatch::Arrays drawTransforms;//drawItemsƓ
+	std::vector<glm::mat4> drawMatrices;//drawItemsƓ
 
 	float angleY = 0;
 	glm::vec3 viewPos;
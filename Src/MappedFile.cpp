@@ -0,0 +1,153 @@
+/**
+* @file MappedFile.cpp
+*/
+#include "MappedFile.h"
+#include <iostream>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+* RXgN^
+*
+* @param path }bvt@C
+*/
+MappedFile::MappedFile(const char* path)
+{
+	Open(path);
+}
+
+/**
+* fXgN^
+*/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/**
+* t@CɃ}bv
+*
+* @param path }bvt@C
+*
+* @retval true }bv
+* @retval false }bvs(t@CA܂͋)
+*/
+bool MappedFile::Open(const char* path)
+{
+	Close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		std::cerr << "ERROR: " << path << "}bvł܂\n";
+		return false;
+	}
+	hFile = file;
+	hMapping = mapping;
+	data = static_cast<const uint8_t*>(view);
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+	{
+		std::cerr << "ERROR: " << path << "}bvł܂\n";
+		return false;
+	}
+	data = static_cast<const uint8_t*>(view);
+	size = static_cast<size_t>(st.st_size);
+#endif
+	return true;
+}
+
+/**
+* }bvăt@C
+*/
+void MappedFile::Close()
+{
+	if (!data)
+	{
+		return;
+	}
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(hMapping);
+	CloseHandle(hFile);
+	hMapping = nullptr;
+	hFile = nullptr;
+#else
+	munmap(const_cast<uint8_t*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+/**
+* t@C}bvĂ邩ׂ
+*
+* @retval true }bvĂȂ
+* @retval false }bvĂ
+*/
+bool MappedFile::IsNull() const
+{
+	return data == nullptr;
+}
+
+/**
+* }bvꂽf[^̐擪擾
+*
+* @return f[^̐擪AhX
+*/
+const uint8_t* MappedFile::Data() const
+{
+	return data;
+}
+
+/**
+* }bvꂽf[^̃oCg擾
+*
+* @return f[^̃oCg
+*/
+size_t MappedFile::Size() const
+{
+	return size;
+}
@@ -0,0 +1,35 @@
+/**
+* @file MappedFile.h
+*/
+#ifndef MAPPEDFILE_H_INCLUDED
+#define MAPPEDFILE_H_INCLUDED
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+* ǂݎp̃}bvgt@C
+*/
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const char* path);
+	~MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const char* path);
+	void Close();
+	bool IsNull() const;
+	const uint8_t* Data() const;
+	size_t Size() const;
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void* hFile = nullptr;
+	void* hMapping = nullptr;
+#endif
+};
+#endif //MAPPEDFILE_H_INCLUDED
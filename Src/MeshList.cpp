@@ -2,12 +2,28 @@
 * @file MeshList.cpp
 */
 #include "Meshlist.h"
+#include "AssetPack.h"
+#include "GLStateCache.h"
+#include "UniformBuffer.h"
+#include "MeshOptimizer.h"
+#include "VertexPacker.h"
+#include <glm/gtc/matrix_transform.hpp>
 #include <fstream>
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <float.h>
 #include <stdio.h>
 #include <math.h>
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 const Vertex vGrand[] =
 {
@@ -60,20 +76,508 @@ const GLushort iGrand[] =
 	18,19,24,24,23,18,
 };
 
+/**
+* bVLbṼt@C擾
+*
+* @param format _f[^̌`
+*
+* @return _f[^̌`ɑΉLbVt@C
+*/
+const char* GetMeshCachePath(VertexFormat format)
+{
+	return format == VertexFormat::Packed ?
+		"Res/MeshListPacked.cache" : "Res/MeshList.cache";
+}
+
+//bVLbV̌`. \ςo[Wグ邱
+const char meshCacheMagic[4] = { 'M','L','C','B' };
+const uint32_t meshCacheVersion = 6;
+
+//bVLbṼwb_
+struct MeshCacheHeader
+{
+	char magic[4];//ʎq
+	uint32_t version;//`̃o[W
+	uint32_t vertexSize;//_f[^1̃oCg
+	uint32_t sourceCount;//ɂȂOBJt@C̐
+	uint32_t meshCount;//bV̐
+	uint32_t vertexFormat;//_f[^̌`
+	uint64_t vertexOffset;//_f[^̃t@C擪̈ʒu
+	uint64_t vertexBytes;//_f[^̃oCg
+	uint64_t indexOffset;//CfbNXf[^̃t@C擪̈ʒu
+	uint64_t indexBytes;//CfbNXf[^̃oCg
+};
+
+//LbV̌ɂȂOBJt@C̏
+struct MeshCacheSource
+{
+	uint64_t pathHash;//t@C̃nbVl
+	uint64_t fileSize;//t@CTCY
+	int64_t writeTime;//ŏIXV
+};
+
+//LbVɊi[ڍדxƂ̕`͈
+struct MeshCacheLod
+{
+	int32_t count;
+	float error;
+	uint64_t indexOffset;
+};
+
+//LbVɊi[郁bV
+struct MeshCacheMesh
+{
+	uint32_t mode;
+	int32_t count;
+	uint64_t indexOffset;
+	int32_t baseVertex;
+	uint32_t indexType;
+	Vector3 positionOffset;
+	Vector3 positionScale;
+	int32_t lodCount;
+	uint32_t reserved;
+	MeshCacheLod lods[maxMeshLodCount];
+	BoundingBox bounds;
+	BoundingSphere sphere;
+};
+
+/**
+* t@C̎ʏ擾
+*
+* @param path ׂt@C
+*
+* @return t@C̎ʏ. t@CꍇATCYƎ0ɂȂ
+*/
+MeshCacheSource GetCacheSource(const char* path)
+{
+	//t@C̃nbVlvZ(FNV-1a)
+	MeshCacheSource source = {};
+	source.pathHash = 14695981039346656037ULL;
+	for (const char* p = path; *p; ++p)
+	{
+		source.pathHash = (source.pathHash ^ (uint8_t)*p) * 1099511628211ULL;
+	}
+
+#ifdef _WIN32
+	struct _stat64 st;
+	if (_stat64(path, &st) == 0)
+#else
+	struct stat st;
+	if (stat(path, &st) == 0)
+#endif
+	{
+		source.fileSize = (uint64_t)st.st_size;
+		source.writeTime = (int64_t)st.st_mtime;
+	}
+	return source;
+}
+
+/**
+* LbV畜`͈͂ACfbNXf[^ƒ_f[^̒Ɏ܂Ă邩ׂ
+*
+* @param mode        v~eBu̎
+* @param indexType   CfbNX̌^
+* @param count       `悷CfbNX
+* @param indexOffset ŏ̃CfbNẌʒu(CfbNXf[^̐擪̃oCg)
+* @param baseVertex  CfbNX0ԂƂ݂Ȃ_̈ʒu
+* @param indexData   CfbNXf[^
+* @param indexBytes  CfbNXf[^̃oCg
+* @param vertexCount _f[^̐
+*
+* @retval true  ܂Ă
+* @retval false ͈͊OwĂ
+*
+* ͈͓̃CfbNXSēǂŁAbaseVertex𑫂_ԍׂ.
+* MeshList郁bV͎Op`Ȃ̂ŁAȊO̎ނsƂ݂Ȃ
+*/
+bool IsValidCacheRange(uint32_t mode, uint32_t indexType, int32_t count,
+	uint64_t indexOffset, int32_t baseVertex,
+	const uint8_t* indexData, uint64_t indexBytes, uint64_t vertexCount)
+{
+	size_t indexSize;
+	switch (indexType)
+	{
+	case GL_UNSIGNED_BYTE: indexSize = 1; break;
+	case GL_UNSIGNED_SHORT: indexSize = 2; break;
+	case GL_UNSIGNED_INT: indexSize = 4; break;
+	default: return false;
+	}
+	if (mode != GL_TRIANGLES || count < 0 || baseVertex < 0 || indexOffset % indexSize != 0 ||
+		indexOffset > indexBytes || (uint64_t)count * indexSize > indexBytes - indexOffset)
+	{
+		return false;
+	}
+	const uint8_t* p = indexData + indexOffset;
+	for (int32_t i = 0; i < count; ++i, p += indexSize)
+	{
+		uint32_t index = 0;
+		memcpy(&index, p, indexSize);//gGfBAȂ̂ŉʂl߂΂悢
+		if ((uint64_t)baseVertex + index >= vertexCount)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+* LbV̈ʒu16̔{ɐ؂グ
+*
+* @param offset ؂グʒu
+*
+* @return 16oCgEɑʒu
+*/
+uint64_t AlignCacheOffset(uint64_t offset)
+{
+	return (offset + 15) & ~uint64_t(15);
+}
+
+//OBJt@C̖ʂ\钸_̔ԍ
+struct ObjFace
+{
+	int v;
+	int vt;
+	int vn;
+};
+
+//OBJt@Cǂݎf[^
+struct ObjData
+{
+	std::vector<Vector3> positionList;
+	std::vector<Vector2> texCoordList;
+	std::vector<Vector3> normalList;
+	std::vector<ObjFace> faceList;
+};
+
+/**
+* s̋󔒂ǂݔ΂
+*
+* @param p   ǂݎʒu
+* @param end s̏I[
+*/
+void SkipObjSpace(const char*& p, const char* end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\v' || *p == '\f'))
+	{
+		++p;
+	}
+}
+
+/**
+* s1ǂݎ(sscanf" %f"ƓK)
+*
+* @param p   ǂݎʒu. Ɛl̒ɐi
+* @param end s̏I[
+* @param out ǂݎl̊i[
+*
+* @retval true ǂݎ萬
+* @retval false ǂݎ莸s
+*/
+bool ParseObjFloat(const char*& p, const char* end, float& out)
+{
+	SkipObjSpace(p, end);
+	if (p >= end)
+	{
+		return false;
+	}
+	char* next;
+	out = strtof(p, &next);
+	if (next == p)
+	{
+		return false;
+	}
+	p = next;
+	return true;
+}
+
+/**
+* s琮1ǂݎ(sscanf" %d"ƓK)
+*
+* @param p   ǂݎʒu. Ɛl̒ɐi
+* @param end s̏I[
+* @param out ǂݎl̊i[
+*
+* @retval true ǂݎ萬
+* @retval false ǂݎ莸s
+*/
+bool ParseObjInt(const char*& p, const char* end, int& out)
+{
+	SkipObjSpace(p, end);
+	if (p >= end)
+	{
+		return false;
+	}
+	char* next;
+	out = (int)strtol(p, &next, 10);
+	if (next == p)
+	{
+		return false;
+	}
+	p = next;
+	return true;
+}
+
+/**
+* s̐擪w肵ƈv邩ׂ
+*
+* @param p      ǂݎʒu. vƕ̒ɐi
+* @param end    s̏I[
+* @param prefix r镶
+*
+* @retval true v
+* @retval false vȂ
+*/
+bool ParseObjPrefix(const char*& p, const char* end, const char* prefix)
+{
+	const char* q = p;
+	for (; *prefix; ++prefix, ++q)
+	{
+		if (q >= end || *q != *prefix)
+		{
+			return false;
+		}
+	}
+	p = q;
+	return true;
+}
+
+/**
+* OBJt@C1s͂
+*
+* @param line s̐擪
+* @param end  s̏I[(s̈ʒu)
+* @param data ǂݎf[^̊i[
+*
+* ȑOsscanf_sɂ锻ƓԁAKŉ߂
+*/
+void ParseObjLine(const char* line, const char* end, ObjData& data)
+{
+	const char* p = line;
+	Vector3 v;
+	if (ParseObjPrefix(p, end, "v") && ParseObjFloat(p, end, v.x) &&
+		ParseObjFloat(p, end, v.y) && ParseObjFloat(p, end, v.z))
+	{
+		data.positionList.push_back(v);
+		return;
+	}
+
+	p = line;
+	Vector2 vt;
+	if (ParseObjPrefix(p, end, "vt") &&
+		ParseObjFloat(p, end, vt.x) && ParseObjFloat(p, end, vt.y))
+	{
+		data.texCoordList.push_back(vt);
+		return;
+	}
+
+	p = line;
+	Vector3 vn;
+	if (ParseObjPrefix(p, end, "vn") && ParseObjFloat(p, end, vn.x) &&
+		ParseObjFloat(p, end, vn.y) && ParseObjFloat(p, end, vn.z))
+	{
+		const float length = sqrt(vn.x * vn.x + vn.y * vn.y + vn.z * vn.z);
+		vn.x /= length;
+		vn.y /= length;
+		vn.z /= length;
+		data.normalList.push_back(vn);
+		return;
+	}
+
+	p = line;
+	if (!ParseObjPrefix(p, end, "f"))
+	{
+		return;
+	}
+	ObjFace f[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		if (!ParseObjInt(p, end, f[i].v) || !ParseObjPrefix(p, end, "/") ||
+			!ParseObjInt(p, end, f[i].vt) || !ParseObjPrefix(p, end, "/") ||
+			!ParseObjInt(p, end, f[i].vn))
+		{
+			return;
+		}
+	}
+	data.faceList.insert(data.faceList.end(), f, f + 3);
+}
+
+/**
+* OBJt@C̈ꕔ͂
+*
+* @param begin ͔͈͂̐擪(s)
+* @param end   ͔͈͂̏I[(s܂͕̏I[)
+* @param data  ǂݎf[^̊i[
+*/
+void ParseObjChunk(const char* begin, const char* end, ObjData& data)
+{
+	while (begin < end)
+	{
+		const char* lineEnd =
+			static_cast<const char*>(memchr(begin, '\n', end - begin));
+		if (!lineEnd)
+		{
+			lineEnd = end;
+		}
+		ParseObjLine(begin, lineEnd, data);
+		begin = lineEnd + 1;
+	}
+}
+
+/**
+* OBJt@Cǂݍŉ͂
+*
+* @param path ǂݍOBJt@C
+* @param data ǂݎf[^̊i[
+*
+* @retval true ǂݍݐ
+* @retval false ǂݍݎs
+*
+* t@CŜ1xɓǂݍ݁AsPʂɋ؂͈͂𕡐̃Xbhŉ͂
+*/
+bool ParseObjFile(const char* path, ObjData& data)
+{
+	//t@CŜǂݍ. ɂ͐l̓ǂݎ~߂邽߂̏I[u
+	AssetFile file(path);
+	if (file.IsNull())
+	{
+		return false;
+	}
+	const size_t length = file.Size();
+	std::vector<char> buf(length + 1);
+	memcpy(buf.data(), file.Data(), length);
+	file.Close();
+	buf[length] = '\0';
+	const char* const begin = buf.data();
+	const char* const end = begin + length;
+
+	//t@C̓XbhԂ̂ق傫̂ŕȂ
+	const size_t minChunkSize = 256 * 1024;
+	size_t chunkCount = std::thread::hardware_concurrency();
+	if (chunkCount < 1)
+	{
+		chunkCount = 1;
+	}
+	if (chunkCount > length / minChunkSize)
+	{
+		chunkCount = length / minChunkSize;
+	}
+	if (chunkCount <= 1)
+	{
+		ParseObjChunk(begin, end, data);
+		return true;
+	}
+
+	//s̓rŕȂ悤ɁA؂ʒu̍s܂Ői߂
+	std::vector<const char*> bounds(chunkCount + 1);
+	bounds[0] = begin;
+	bounds[chunkCount] = end;
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		const char* p = begin + length * i / chunkCount;
+		if (p < bounds[i - 1])
+		{
+			p = bounds[i - 1];
+		}
+		const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		bounds[i] = lineEnd ? lineEnd + 1 : end;
+	}
+
+	//擪͈̔͂͌ĂяõXbhŉ͂
+	std::vector<ObjData> chunks(chunkCount);
+	std::vector<std::thread> threads;
+	threads.reserve(chunkCount - 1);
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		threads.emplace_back(ParseObjChunk, bounds[i], bounds[i + 1], std::ref(chunks[i]));
+	}
+	ParseObjChunk(bounds[0], bounds[1], chunks[0]);
+	for (auto& e : threads)
+	{
+		e.join();
+	}
+
+	//t@C̏ԂǂɘA
+	size_t positionCount = 0, texCoordCount = 0, normalCount = 0, faceCount = 0;
+	for (const ObjData& e : chunks)
+	{
+		positionCount += e.positionList.size();
+		texCoordCount += e.texCoordList.size();
+		normalCount += e.normalList.size();
+		faceCount += e.faceList.size();
+	}
+	data.positionList.reserve(positionCount);
+	data.texCoordList.reserve(texCoordCount);
+	data.normalList.reserve(normalCount);
+	data.faceList.reserve(faceCount);
+	for (const ObjData& e : chunks)
+	{
+		data.positionList.insert(data.positionList.end(), e.positionList.begin(), e.positionList.end());
+		data.texCoordList.insert(data.texCoordList.end(), e.texCoordList.begin(), e.texCoordList.end());
+		data.normalList.insert(data.normalList.end(), e.normalList.begin(), e.normalList.end());
+		data.faceList.insert(data.faceList.end(), e.faceList.begin(), e.faceList.end());
+	}
+	return true;
+}
+
+/**
+* _f[^͂ދE{bNXƋEvZ
+*
+* @param begin  _f[^z̐擪
+* @param end    _f[^z̏I[
+* @param box    E{bNX̊i[
+* @param sphere E̊i[
+*
+* E̒S͋E{bNX̒SƂAł_܂ł̋𔼌aƂ
+*/
+void ComputeMeshBounds(const Vertex* begin, const Vertex* end,
+	BoundingBox& box, BoundingSphere& sphere)
+{
+	if (begin == end)
+	{
+		box = { { 0, 0, 0 }, { 0, 0, 0 } };
+		sphere = { { 0, 0, 0 }, 0 };
+		return;
+	}
+
+	box.min = box.max = begin->position;
+	for (const Vertex* v = begin; v != end; ++v)
+	{
+		box.min.x = std::min(box.min.x, v->position.x);
+		box.min.y = std::min(box.min.y, v->position.y);
+		box.min.z = std::min(box.min.z, v->position.z);
+		box.max.x = std::max(box.max.x, v->position.x);
+		box.max.y = std::max(box.max.y, v->position.y);
+		box.max.z = std::max(box.max.z, v->position.z);
+	}
+
+	sphere.center = { (box.min.x + box.max.x) * 0.5f,
+		(box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f };
+	float radiusSq = 0;
+	for (const Vertex* v = begin; v != end; ++v)
+	{
+		const float x = v->position.x - sphere.center.x;
+		const float y = v->position.y - sphere.center.y;
+		const float z = v->position.z - sphere.center.z;
+		radiusSq = std::max(radiusSq, x * x + y * y + z * z);
+	}
+	sphere.radius = sqrtf(radiusSq);
+}
+
 /**
 * Vertex Buffer Object쐬
 *
 * @param size _f[^̃TCY
 * @param data _f[^ւ̃|C^
+* @param usage obt@̎g
 *
 * @return 쐬VBO
 */
-GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
+GLuint CreateVBO(GLsizeiptr size, const GLvoid* data, GLenum usage = GL_STATIC_DRAW)
 {
 	GLuint vbo = 0;
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, size, data, usage);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 	return vbo;
@@ -84,15 +588,16 @@ GLuint CreateVBO(GLsizeiptr size, const GLvoid* data)
 *
 * @param size CfbNXf[^̃TCY
 * @param data CfbNXf[^ւ̃|C^
+* @param usage obt@̎g
 *
 * return 쐬IBO
 */
-GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
+GLuint CreateIBO(GLsizeiptr size, const GLvoid* data, GLenum usage = GL_STATIC_DRAW)
 {
 	GLuint ibo = 0;
 	glGenBuffers(1, &ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, usage);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
 	return ibo;
@@ -102,37 +607,73 @@ GLuint CreateIBO(GLsizeiptr size, const GLvoid* data)
 * Vertex Array Object쐬
 *
 * @param vbo VAOɊ֘AtVBO
+* @param ibo VAOɊ֘AtIBO
+* @param objectIndexBuffer ̔ԍ(0`maxObjectsPerBlock-1)i[obt@.
+*                          0ȂCX^X`pƂĕ̔ԍ̑ݒ肵Ȃ
+* @param format VBOɊi[Ă钸_f[^̌`
 *
 * @return 쐬VAO
+*
+* VBOIBO͌ォ畔Iɏ悤ɍ폜Ɏc
 */
-GLuint CreateVAO(GLuint vbo, GLuint ibo)
+GLuint CreateVAO(GLuint vbo, GLuint ibo, GLuint objectIndexBuffer, VertexFormat format)
 {
 	GLuint vao = 0;
 	glGenVertexArrays(1, &vao);//VAO쐬
-	glBindVertexArray(vao);//w肳ꂽVAOOpenGĹȕ݂Ώہvɐݒ
+	GLStateCache::Instance().BindVertexArray(vao);//w肳ꂽVAOOpenGĹȕ݂Ώہvɐݒ
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);//OɑΉVBOOpenGLɊ蓖
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);//OɑΉIBOOpenGLɊ蓖
 
-	glEnableVertexAttribArray(0);//oCfBO |CgL
-	glVertexAttribPointer(0, sizeof(Vertex::position) / sizeof(float),
-		GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, position)));
+	if (format == VertexFormat::Packed)
+	{
+		//W0`1ɐKēǂݎAfsŌ͈̔͂ɖ߂
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex),
+			(const GLvoid*)(offsetof(PackedVertex, position)));
 
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, sizeof(Vertex::color) / sizeof(float),
-		GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, color)));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex),
+			(const GLvoid*)(offsetof(PackedVertex, color)));
 
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, sizeof(Vertex::texCoord) / sizeof(float),
-		GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, texCoord)));
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(PackedVertex),
+			(const GLvoid*)(offsetof(PackedVertex, texCoord)));
 
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, sizeof(Vertex::normal) / sizeof(float),
-		GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, normal)));
+		//ʑ̎ʑ̖@4ԂɊ蓖āA_VF[_[ŕ
+		glEnableVertexAttribArray(4);
+		glVertexAttribPointer(4, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex),
+			(const GLvoid*)(offsetof(PackedVertex, normal)));
+	}
+	else
+	{
+		glEnableVertexAttribArray(0);//oCfBO |CgL
+		glVertexAttribPointer(0, sizeof(Vertex::position) / sizeof(float),
+			GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, position)));
 
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, sizeof(Vertex::color) / sizeof(float),
+			GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, color)));
 
-	glBindVertexArray(0);
-	glDeleteBuffers(1, &vbo);
-	glDeleteBuffers(1, &ibo);
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, sizeof(Vertex::texCoord) / sizeof(float),
+			GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, texCoord)));
+
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, sizeof(Vertex::normal) / sizeof(float),
+			GL_FLOAT, GL_FALSE, sizeof(Vertex), (const GLvoid*)(offsetof(Vertex, normal)));
+	}
+
+	//̔ԍ̓CX^XƂɐi߁A`̃x[XCX^XŊJnʒuw肷.
+	//x[XCX^XgȂł͔zLɂA`悲Ƃɒ萔̒_Ŏw肷
+	if (objectIndexBuffer && GLEW_ARB_base_instance)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, objectIndexBuffer);
+		glEnableVertexAttribArray(objectIndexAttribute);
+		glVertexAttribIPointer(objectIndexAttribute, 1, GL_UNSIGNED_INT, sizeof(GLuint), nullptr);
+		glVertexAttribDivisor(objectIndexAttribute, 1);
+	}
+
+	GLStateCache::Instance().BindVertexArray(0);
 
 	return vao;
 }
@@ -143,64 +684,418 @@ GLuint CreateVAO(GLuint vbo, GLuint ibo)
 MeshList::MeshList()
 {
 
-}
+}
+
+/**
+* fXgN^
+*/
+MeshList::~MeshList()
+{
+	Free();
+}
+
+/**
+* ff[^Mesh̃Xg쐬
+*
+* @param format _f[^̌`
+*
+* retval true 쐬
+* retval false 쐬s
+*/
+bool MeshList::Allcate(VertexFormat format)
+{
+	Free();
+	return Prepare(format) && Upload();
+}
+
+/**
+* GPUɓ]郂ff[^pӂ
+*
+* @param format _f[^̌`
+*
+* retval true pӂł
+* retval false pӂłȂ
+*
+* OpenGL̊֐gȂ̂ŁA[J[XbhĂяoƂł.
+* pӂf[^Upload֐GPUɓ].
+* VAO쐬ς݂̏ꍇ́AFree֐ŉĂ
+*/
+bool MeshList::Prepare(VertexFormat format)
+{
+	std::vector<Mesh>().swap(meshes);
+	this->format = format;
+
+	//ǂݍOBJt@C
+	static const char* const objFiles[] =
+	{
+		"Res/Ground.obj",
+		"Res/Human.obj",
+		"Res/Plane.obj",
+		"Res/wallWidth.obj",
+		"Res/wallHeight.obj",
+		//"Res/obj/Handgun_obj.obj",
+	};
+	const size_t objCount = sizeof(objFiles) / sizeof(objFiles[0]);
+
+	const auto loadStart = std::chrono::steady_clock::now();
+
+	//LbVLȂOBJt@C͂ɍς܂
+	const bool isCached = LoadCache(cache, objFiles, objCount);
+	if (isCached)
+	{
+		const MeshCacheHeader& header =
+			*reinterpret_cast<const MeshCacheHeader*>(cache.Data());
+		vertexData = cache.Data() + header.vertexOffset;
+		vertexBytes = (GLsizeiptr)header.vertexBytes;
+		indexData = cache.Data() + header.indexOffset;
+		indexBytes = (GLsizeiptr)header.indexBytes;
+	}
+	else
+	{
+		//eʂ\
+		meshes.reserve(100);
+		tmpVertices.reserve(10'000);
+		tmpIndices.reserve(10'000);
+
+		//bVǉ
+		for (size_t i = 0; i < objCount; ++i)
+		{
+			AddFromObjFile(objFiles[i]);
+		}
+
+		if (format == VertexFormat::Packed)
+		{
+			PackVertices();
+			vertexData = tmpPackedVertices.data();
+			vertexBytes = tmpPackedVertices.size() * sizeof(PackedVertex);
+		}
+		else
+		{
+			vertexData = tmpVertices.data();
+			vertexBytes = tmpVertices.size() * sizeof(Vertex);
+		}
+		SaveCache(objFiles, objCount, vertexData, vertexBytes);
+
+		indexData = tmpIndices.data();
+		indexBytes = tmpIndices.size();
+	}
+
+	//NԂrł悤ɓǂݍݎԂ\
+	const std::chrono::duration<double, std::milli> loadTime =
+		std::chrono::steady_clock::now() - loadStart;
+	std::cout << "INFO: bVǂݍݎ=" << loadTime.count() << "ms (" <<
+		(isCached ? "LbV" : "OBJ") << ")\n";
+
+	return vertexBytes > 0 && indexBytes > 0;
+}
+
+/**
+* Prepare֐ŗpӂff[^GPUɓ]
+*
+* retval true ]
+* retval false ]s
+*
+* OpenGLReLXgXbhĂяo
+*/
+bool MeshList::Upload()
+{
+	//sɃbVǉł悤ɁA\񕪂傫ȃobt@
+	const size_t stride = format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+	const size_t staticVertexCount = (size_t)vertexBytes / stride;
+	const size_t vertexCapacity = staticVertexCount + reservedVertexCount;
+	const size_t indexCapacity = ((size_t)indexBytes + reservedIndexBytes + 3) & ~size_t(3);
+	const bool isDynamic = reservedVertexCount > 0 || reservedIndexBytes > 0;
+	const GLenum usage = isDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW;
+
+	//VAO쐬
+	vbo = CreateVBO(vertexCapacity * stride, isDynamic ? nullptr : vertexData, usage);
+	ibo = CreateIBO(indexCapacity, isDynamic ? nullptr : indexData, usage);
+	if (isDynamic)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, 0, vertexBytes, vertexData);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ibo);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, 0, indexBytes, indexData);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	}
+	std::vector<GLuint> objectIndices(maxObjectsPerBlock);
+	for (GLuint i = 0; i < maxObjectsPerBlock; ++i)
+	{
+		objectIndices[i] = i;
+	}
+	objectIndexBuffer = CreateVBO(objectIndices.size() * sizeof(GLuint), objectIndices.data());
+	vao = CreateVAO(vbo, ibo, objectIndexBuffer, format);
+	instancedVao = CreateVAO(vbo, ibo, 0, format);
+
+	//Allcateō쐬bV̗̈͊蓖čς݂ɂĂ
+	vertexAllocator.Reset(vertexCapacity);
+	vertexAllocator.Allocate(staticVertexCount);
+	indexAllocator.Reset(indexCapacity);
+	indexAllocator.Allocate(indexBytes);
+	dynamicRanges.assign(meshes.size(), DynamicRange{ 0, 0, 0, 0 });
+	freeMeshSlots.clear();
+
+	//vector̃
+	std::vector<Vertex>().swap(tmpVertices);
+	std::vector<PackedVertex>().swap(tmpPackedVertices);
+	std::vector<GLubyte>().swap(tmpIndices);
+	cache.Close();
+	vertexData = indexData = nullptr;
+	vertexBytes = indexBytes = 0;
+
+	if (!vbo || !ibo || !vao || !instancedVao)
+	{
+		std::cerr << "ERROR:VAO̍쐬Ɏs\n";
+		return false;
+	}
+	return true;
+}
+
+/**
+* bVLbVǂݍ
+*
+* @param cache LbVt@C}bvIuWFNg
+* @param paths LbV̌ɂȂOBJt@C̔z
+* @param count paths̗vf
+*
+* @retval true LbVL. meshesɃbVݒ肵
+* @retval false LbVA܂͌Â
+*/
+bool MeshList::LoadCache(AssetFile& cache, const char* const* paths, size_t count)
+{
+	if (!cache.Open(GetMeshCachePath(format)))
+	{
+		return false;
+	}
+
+	//`v邩ׂ
+	const uint8_t* p = cache.Data();
+	const size_t size = cache.Size();
+	if (size < sizeof(MeshCacheHeader))
+	{
+		cache.Close();
+		return false;
+	}
+	MeshCacheHeader header;
+	memcpy(&header, p, sizeof(header));
+	if (memcmp(header.magic, meshCacheMagic, sizeof(header.magic)) != 0 ||
+		header.version != meshCacheVersion ||
+		header.vertexFormat != (uint32_t)format ||
+		header.vertexSize != (format == VertexFormat::Packed ?
+			sizeof(PackedVertex) : sizeof(Vertex)) ||
+		header.sourceCount != count ||
+		header.vertexOffset > size || header.vertexBytes > size - header.vertexOffset ||
+		header.indexOffset > size || header.indexBytes > size - header.indexOffset)
+	{
+		cache.Close();
+		return false;
+	}
+
+	//OBJt@CXVĂȂׂ.
+	//AZbg pbÑLbV̓pbN쐬Ɋm肵Ă̂ŒׂȂ
+	const size_t tableSize = sizeof(MeshCacheHeader) +
+		sizeof(MeshCacheSource) * header.sourceCount +
+		sizeof(MeshCacheMesh) * header.meshCount;
+	if (tableSize > size)
+	{
+		cache.Close();
+		return false;
+	}
+	const uint8_t* sources = p + sizeof(MeshCacheHeader);
+	for (size_t i = 0; i < count && !cache.IsPacked(); ++i)
+	{
+		MeshCacheSource cached;
+		memcpy(&cached, sources + sizeof(MeshCacheSource) * i, sizeof(cached));
+		const MeshCacheSource current = GetCacheSource(paths[i]);
+		if (memcmp(&cached, &current, sizeof(current)) != 0)
+		{
+			cache.Close();
+			return false;
+		}
+	}
 
-/**
-* fXgN^
-*/
-MeshList::~MeshList()
-{
-	Free();
+	//bV𕜌.
+	//ꂽLbVŔ͈͊O`悵Ȃ悤ɁAebV̕`͈͂𒲂ׂ
+	const uint8_t* meshTable = sources + sizeof(MeshCacheSource) * header.sourceCount;
+	const uint8_t* indexData = p + header.indexOffset;
+	const uint64_t vertexCount = header.vertexBytes / header.vertexSize;
+	meshes.reserve(header.meshCount);
+	for (size_t i = 0; i < header.meshCount; ++i)
+	{
+		MeshCacheMesh cached;
+		memcpy(&cached, meshTable + sizeof(MeshCacheMesh) * i, sizeof(cached));
+		bool isValid = cached.lodCount >= 1 && cached.lodCount <= maxMeshLodCount &&
+			IsValidCacheRange(cached.mode, cached.indexType, cached.count, cached.indexOffset,
+				cached.baseVertex, indexData, header.indexBytes, vertexCount);
+		for (int lod = 0; isValid && lod < cached.lodCount; ++lod)
+		{
+			isValid = IsValidCacheRange(cached.mode, cached.indexType, cached.lods[lod].count,
+				cached.lods[lod].indexOffset, cached.baseVertex,
+				indexData, header.indexBytes, vertexCount);
+		}
+		if (!isValid)
+		{
+			std::cerr << "WARNING: " << GetMeshCachePath(format) <<
+				"̃bV" << i << "͈͊OwĂ̂ŁALbV蒼܂\n";
+			meshes.clear();
+			cache.Close();
+			return false;
+		}
+		Mesh m;
+		m.mode = cached.mode;
+		m.count = cached.count;
+		m.indices = (const GLvoid*)(size_t)cached.indexOffset;
+		m.baseVertex = cached.baseVertex;
+		m.indexType = cached.indexType;
+		m.positionOffset = cached.positionOffset;
+		m.positionScale = cached.positionScale;
+		m.lodCount = cached.lodCount;
+		for (int lod = 0; lod < maxMeshLodCount; ++lod)
+		{
+			m.lods[lod].count = cached.lods[lod].count;
+			m.lods[lod].indices = (const GLvoid*)(size_t)cached.lods[lod].indexOffset;
+			m.lods[lod].error = cached.lods[lod].error;
+		}
+		m.bounds = cached.bounds;
+		m.sphere = cached.sphere;
+		meshes.push_back(m);
+	}
+	return true;
 }
 
 /**
-* ff[^Mesh̃Xg쐬
+* bVLbVo
 *
-* retval true 쐬
-* retval false 쐬s
+* @param paths LbV̌ɂȂOBJt@C̔z
+* @param count paths̗vf
+* @param vertexData  VBOɊi[钸_f[^
+* @param vertexBytes _f[^̃oCg
+*
+* @retval true o
+* @retval false os
 */
-bool MeshList::Allcate()
+bool MeshList::SaveCache(const char* const* paths, size_t count,
+	const GLvoid* vertexData, GLsizeiptr vertexBytes) const
 {
-	Free();
-
-	//eʂ\
-	meshes.reserve(100);
-	tmpVertices.reserve(10'000);
-	tmpIndices.reserve(10'000);
+	const char* cachePath = GetMeshCachePath(format);
+	std::ofstream ofs(cachePath, std::ios_base::binary | std::ios_base::trunc);
+	if (!ofs.is_open())
+	{
+		std::cerr << "WARNING: " << cachePath << "쐬ł܂\n";
+		return false;
+	}
 
-	//bVǉ
-	AddFromObjFile("Res/Ground.obj");
-	AddFromObjFile("Res/Human.obj");
-	AddFromObjFile("Res/Plane.obj");
-	AddFromObjFile("Res/wallWidth.obj");
-	AddFromObjFile("Res/wallHeight.obj");
-	//AddFromObjFile("Res/obj/Handgun_obj.obj");
+	MeshCacheHeader header = {};
+	memcpy(header.magic, meshCacheMagic, sizeof(header.magic));
+	header.version = meshCacheVersion;
+	header.vertexFormat = (uint32_t)format;
+	header.vertexSize = format == VertexFormat::Packed ?
+		sizeof(PackedVertex) : sizeof(Vertex);
+	header.sourceCount = (uint32_t)count;
+	header.meshCount = (uint32_t)meshes.size();
+	const uint64_t tableSize = sizeof(MeshCacheHeader) +
+		sizeof(MeshCacheSource) * header.sourceCount +
+		sizeof(MeshCacheMesh) * header.meshCount;
+	header.vertexOffset = AlignCacheOffset(tableSize);
+	header.vertexBytes = vertexBytes;
+	header.indexOffset = AlignCacheOffset(header.vertexOffset + header.vertexBytes);
+	header.indexBytes = tmpIndices.size();
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-	//VAO쐬
-	GLuint vbo = CreateVBO(tmpVertices.size() * sizeof(Vertex), tmpVertices.data());
-	GLuint ibo = CreateIBO(tmpIndices.size() * sizeof(GLushort), tmpIndices.data());
-	vao = CreateVAO(vbo, ibo);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const MeshCacheSource source = GetCacheSource(paths[i]);
+		ofs.write(reinterpret_cast<const char*>(&source), sizeof(source));
+	}
+	for (const Mesh& m : meshes)
+	{
+		MeshCacheMesh cached = {};
+		cached.mode = m.mode;
+		cached.count = m.count;
+		cached.indexOffset = (uint64_t)(size_t)m.indices;
+		cached.baseVertex = m.baseVertex;
+		cached.indexType = m.indexType;
+		cached.positionOffset = m.positionOffset;
+		cached.positionScale = m.positionScale;
+		cached.lodCount = m.lodCount;
+		for (int lod = 0; lod < m.lodCount; ++lod)
+		{
+			cached.lods[lod].count = m.lods[lod].count;
+			cached.lods[lod].indexOffset = (uint64_t)(size_t)m.lods[lod].indices;
+			cached.lods[lod].error = m.lods[lod].error;
+		}
+		cached.bounds = m.bounds;
+		cached.sphere = m.sphere;
+		ofs.write(reinterpret_cast<const char*>(&cached), sizeof(cached));
+	}
 
-	//vector̃
-	std::vector<Vertex>().swap(tmpVertices);
-	std::vector<GLushort>().swap(tmpIndices);
+	//f[^̊Jnʒu16oCgEɑďo
+	const char padding[16] = {};
+	ofs.write(padding, header.vertexOffset - tableSize);
+	ofs.write(static_cast<const char*>(vertexData), header.vertexBytes);
+	ofs.write(padding,
+		header.indexOffset - (header.vertexOffset + header.vertexBytes));
+	ofs.write(reinterpret_cast<const char*>(tmpIndices.data()), header.indexBytes);
 
-	if (!vbo || !ibo || !vao)
+	if (!ofs)
 	{
-		std::cerr << "ERROR:VAO̍쐬Ɏs\n";
+		std::cerr << "WARNING: " << cachePath << "݂̏Ɏs\n";
+		ofs.close();
+		remove(cachePath);
 		return false;
 	}
 	return true;
 }
 
+/**
+* _f[^PackedVertex`Ɉk
+*
+* bVƂ̍W͈̔͂ŗʎqAp̒lMeshɐݒ肷.
+* ebV̗eʂƁAkEɂ덷\
+*/
+void MeshList::PackVertices()
+{
+	tmpPackedVertices.resize(tmpVertices.size());
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		Mesh& m = meshes[i];
+		const size_t end = i + 1 < meshes.size() ?
+			(size_t)meshes[i + 1].baseVertex : tmpVertices.size();
+		const Vertex* vBegin = tmpVertices.data() + m.baseVertex;
+		const Vertex* vEnd = tmpVertices.data() + end;
+		PackedVertex* packed = tmpPackedVertices.data() + m.baseVertex;
+		VertexPacker::Pack(vBegin, vEnd, packed, m.positionOffset, m.positionScale);
+
+		const VertexPacker::PackingError error = VertexPacker::MeasureError(
+			vBegin, vEnd, packed, m.positionOffset, m.positionScale);
+		const size_t count = vEnd - vBegin;
+		std::cout << "INFO: bV" << i << " [_=" << count <<
+			" e=" << count * sizeof(Vertex) << "->" << count * sizeof(PackedVertex) <<
+			"oCg 덷(W=" << error.position << " UV=" << error.texCoord <<
+			" @=" << error.normal << "x F=" << error.color << ")]\n";
+	}
+}
+
 /**
 * bVXgj
 */
 void MeshList::Free()
 {
-	glDeleteVertexArrays(1, &vao);
+	GLStateCache::Instance().DeleteVertexArray(vao);
+	GLStateCache::Instance().DeleteVertexArray(instancedVao);
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ibo);
+	glDeleteBuffers(1, &objectIndexBuffer);
 	vao = 0;
+	instancedVao = 0;
+	vbo = 0;
+	ibo = 0;
+	objectIndexBuffer = 0;
 	std::vector<Mesh>().swap(meshes);
+	std::vector<DynamicRange>().swap(dynamicRanges);
+	std::vector<size_t>().swap(freeMeshSlots);
+	vertexAllocator.Reset(0);
+	indexAllocator.Reset(0);
 }
 
 
@@ -209,7 +1104,17 @@ void MeshList::Free()
 */
 void MeshList::BindVertexArray()
 {
-	glBindVertexArray(vao);
+	GLStateCache::Instance().BindVertexArray(vao);
+}
+
+/**
+* CX^X`ɎgpVAOݒ肷
+*
+* VAOɂ͕̔ԍ̑. CX^XƂ̑RenderQueueݒ肷
+*/
+void MeshList::BindInstancedVertexArray()
+{
+	GLStateCache::Instance().BindVertexArray(instancedVao);
 }
 
 /**
@@ -239,13 +1144,97 @@ void MeshList::Add(const Vertex* vBegin, const Vertex* vEnd,
 	Mesh m;
 	m.mode = GL_TRIANGLES;
 	m.count = iEnd - iBegin;
-	m.indices = (const GLvoid*)(tmpIndices.size() * sizeof(GLushort));
+	m.indices = (const GLvoid*)tmpIndices.size();
+	m.baseVertex = (GLint)tmpVertices.size();
+	m.indexType = GL_UNSIGNED_SHORT;
+	m.positionOffset = { 0, 0, 0 };
+	m.positionScale = { 1, 1, 1 };
+	m.lodCount = 1;
+	m.lods[0] = { m.count, m.indices, 0 };
+	ComputeMeshBounds(vBegin, vEnd, m.bounds, m.sphere);
+	meshes.push_back(m);
+
+	//f̃f[^vectorɃRs[
+	tmpVertices.insert(tmpVertices.end(), vBegin, vEnd);
+	tmpIndices.insert(tmpIndices.end(),
+		(const GLubyte*)iBegin, (const GLubyte*)iEnd);
+}
+
+/**
+* Meshǉ(32bitCfbNX)
+*
+* @param vBegin ǉ钸_f[^z̐擪
+* @param vEnd ǉ钸_f[^z̏I[
+* @param iBegin ǉCfbNXf[^z̐擪
+* @param iEnd ǉCfbNXf[^z̏I[
+*/
+void MeshList::Add(const Vertex* vBegin, const Vertex* vEnd,
+	const GLuint* iBegin, const GLuint* iEnd)
+{
+	//32bitCfbNX̊Jnʒu4oCgEɑ
+	tmpIndices.resize((tmpIndices.size() + 3) & ~size_t(3));
+
+	//bVǉ
+	Mesh m;
+	m.mode = GL_TRIANGLES;
+	m.count = iEnd - iBegin;
+	m.indices = (const GLvoid*)tmpIndices.size();
 	m.baseVertex = (GLint)tmpVertices.size();
+	m.indexType = GL_UNSIGNED_INT;
+	m.positionOffset = { 0, 0, 0 };
+	m.positionScale = { 1, 1, 1 };
+	m.lodCount = 1;
+	m.lods[0] = { m.count, m.indices, 0 };
+	ComputeMeshBounds(vBegin, vEnd, m.bounds, m.sphere);
 	meshes.push_back(m);
 
 	//f̃f[^vectorɃRs[
 	tmpVertices.insert(tmpVertices.end(), vBegin, vEnd);
-	tmpIndices.insert(tmpIndices.end(), iBegin, iEnd);
+	tmpIndices.insert(tmpIndices.end(),
+		(const GLubyte*)iBegin, (const GLubyte*)iEnd);
+}
+
+/**
+* ŌɒǉMeshɏڍדx`͈͂ǉ
+*
+* @param iBegin ǉCfbNXf[^z̐擪
+* @param iEnd ǉCfbNXf[^z̏I[
+* @param error ̌`Ƃ̌덷
+*
+* CfbNXMeshƓ_f[^wAMeshƓ^łȂ΂ȂȂ
+*/
+void MeshList::AddLod(const GLushort* iBegin, const GLushort* iEnd, float error)
+{
+	Mesh& m = meshes.back();
+	if (m.lodCount >= maxMeshLodCount || m.indexType != GL_UNSIGNED_SHORT)
+	{
+		return;
+	}
+	m.lods[m.lodCount++] = { (GLsizei)(iEnd - iBegin), (const GLvoid*)tmpIndices.size(), error };
+	tmpIndices.insert(tmpIndices.end(),
+		(const GLubyte*)iBegin, (const GLubyte*)iEnd);
+}
+
+/**
+* ŌɒǉMeshɏڍדx`͈͂ǉ(32bitCfbNX)
+*
+* @param iBegin ǉCfbNXf[^z̐擪
+* @param iEnd ǉCfbNXf[^z̏I[
+* @param error ̌`Ƃ̌덷
+*
+* CfbNXMeshƓ_f[^wAMeshƓ^łȂ΂ȂȂ
+*/
+void MeshList::AddLod(const GLuint* iBegin, const GLuint* iEnd, float error)
+{
+	Mesh& m = meshes.back();
+	if (m.lodCount >= maxMeshLodCount || m.indexType != GL_UNSIGNED_INT)
+	{
+		return;
+	}
+	tmpIndices.resize((tmpIndices.size() + 3) & ~size_t(3));
+	m.lods[m.lodCount++] = { (GLsizei)(iEnd - iBegin), (const GLvoid*)tmpIndices.size(), error };
+	tmpIndices.insert(tmpIndices.end(),
+		(const GLubyte*)iBegin, (const GLubyte*)iEnd);
 }
 
 /**
@@ -258,72 +1247,17 @@ void MeshList::Add(const Vertex* vBegin, const Vertex* vEnd,
 */
 bool MeshList::AddFromObjFile(const char* path)
 {
-	//t@CJ
-	std::ifstream ifs;
-	ifs.open(path);
-	if (!ifs.is_open())
+	//t@C烂f̃f[^ǂݍ
+	ObjData data;
+	if (!ParseObjFile(path, data))
 	{
 		std::cerr << "ERROR: " << path << "J܂\n";
 		return false;
 	}
-
-	//f[^ǂݎp̕ϐ
-	struct Face
-	{
-		int v;
-		int vt;
-		int vn;
-	};
-	std::vector<Face> faceList;
-	std::vector<Vector3> positionList;
-	std::vector<Vector2> texCoordList;
-	std::vector<Vector3> normalList;
-
-	faceList.reserve(1000);
-	positionList.reserve(1000);
-	texCoordList.reserve(1000);
-	normalList.reserve(1000);
-
-	//t@C烂f̃f[^ǂݍ
-	while (!ifs.eof())
-	{
-		std::string line;
-		getline(ifs, line);
-		
-		//ǂݎ菈p̕ϐ`
-		Vector3 v;
-		Vector2 vt;
-		Vector3 vn;
-		Face f[3];
-
-		//f[^𕶖@ɑΉϐɊi[
-		if (sscanf_s(line.data(), "v %f %f %f", &v.x, &v.y, &v.z) == 3)
-		{
-			positionList.push_back(v);
-		}
-		else if (sscanf_s(line.data(), "vt %f %f", &vt.x, &vt.y) == 2)
-		{
-			texCoordList.push_back(vt);
-		}
-		else if (sscanf_s(line.data(), "vn %f %f %f",
-			&vn.x, &vn.y, &vn.z) == 3)
-		{
-			const float length = sqrt(vn.x * vn.x + vn.y * vn.y + vn.z * vn.z);
-			vn.x /= length;
-			vn.y /= length;
-			vn.z /= length;
-			normalList.push_back(vn);
-		}
-		else if (sscanf_s(line.data(), "f %d/%d/%d %d/%d/%d %d/%d/%d",
-			&f[0].v, &f[0].vt, &f[0].vn,
-			&f[1].v, &f[1].vt, &f[1].vn,
-			&f[2].v, &f[2].vt, &f[2].vn) == 9)
-		{
-			faceList.push_back(f[0]);
-			faceList.push_back(f[1]);
-			faceList.push_back(f[2]);
-		}
-	}
+	std::vector<ObjFace>& faceList = data.faceList;
+	std::vector<Vector3>& positionList = data.positionList;
+	std::vector<Vector2>& texCoordList = data.texCoordList;
+	std::vector<Vector3>& normalList = data.normalList;
 
 	//f[^s̏ꍇ͍쐬~
 	if (positionList.empty())
@@ -344,40 +1278,45 @@ bool MeshList::AddFromObjFile(const char* path)
 
 	//_f[^ƃCfbNXf[^p̕ϐ
 	std::vector<Vertex> vertices;
-	std::vector<GLushort> indices;
-	std::vector<Face> faceToVertexList;
+	std::vector<GLuint> indices;
 	vertices.reserve(faceList.size());
 	indices.reserve(faceList.size());
-	faceToVertexList.reserve(faceList.size());
 
-	// f̃f[^𒸓_f[^ƃCfbNXf[^ɕϊ.
-	for (size_t i = 0; i < faceList.size(); i++)
+	//ʃf[^璸_ԍ߂̃nbV\
+	struct FaceHash
 	{
-		//d钸_f[^邩ׂ
-		size_t n = 0;
-		for (; n < faceToVertexList.size(); n++)
+		size_t operator()(const ObjFace& f) const
 		{
-			if (faceToVertexList[n].v == faceList[i].v &&
-				faceToVertexList[n].vt == faceList[i].vt &&
-				faceToVertexList[n].vn == faceList[i].vn)
-			{
-				//d钸_f[^
-				break;
-			}
+			size_t h = std::hash<int>()(f.v);
+			h ^= std::hash<int>()(f.vt) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			h ^= std::hash<int>()(f.vn) + 0x9e3779b9 + (h << 6) + (h >> 2);
+			return h;
+		}
+	};
+	struct FaceEqual
+	{
+		bool operator()(const ObjFace& a, const ObjFace& b) const
+		{
+			return a.v == b.v && a.vt == b.vt && a.vn == b.vn;
 		}
+	};
+	std::unordered_map<ObjFace, GLuint, FaceHash, FaceEqual> faceToVertexMap;
+	faceToVertexMap.reserve(faceList.size());
 
-		if (n < faceToVertexList.size())
+	// f̃f[^𒸓_f[^ƃCfbNXf[^ɕϊ.
+	for (size_t i = 0; i < faceList.size(); i++)
+	{
+		//d钸_f[^邩ׂ
+		const auto result = faceToVertexMap.emplace(faceList[i], (GLuint)vertices.size());
+		if (!result.second)
 		{
 			//d钸_f[^A_f[^̃CfbNXǉ
-			indices.push_back((GLushort)n);
+			indices.push_back(result.first->second);
 		}
 		else
 		{
 			//d钸_f[^Ȃ΁AV_f[^쐬ÃCfbNXǉ
-			indices.push_back((GLushort)vertices.size());
-
-			//ʃf[^ǉ
-			faceToVertexList.push_back(faceList[i]);
+			indices.push_back((GLuint)vertices.size());
 
 			//_f[^ǉ
 			Vertex vertex;
@@ -412,8 +1351,293 @@ bool MeshList::AddFromObjFile(const char* path)
 	std::cout << "INFO: " << path <<
 		" [_=" << vertices.size() << " CfbNX=" << indices.size() << "]\n";
 
-	Add(vertices.data(), vertices.data() + vertices.size(),
-		indices.data(), indices.data() + indices.size());
+	//`ǂȂ悤ɎOp`ƒ_בւ
+	const MeshOptimizer::CacheStatistics before =
+		MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+	const size_t degenerateCount =
+		MeshOptimizer::RemoveDegenerateTriangles(indices, vertices);
+	const size_t duplicateCount = MeshOptimizer::RemoveDuplicateTriangles(indices);
+	MeshOptimizer::OptimizeVertexCache(indices, vertices.size());
+	MeshOptimizer::OptimizeOverdraw(indices, vertices);
+	MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+	const MeshOptimizer::CacheStatistics after =
+		MeshOptimizer::AnalyzeVertexCache(indices, vertices.size());
+	std::cout << "INFO: " << path <<
+		" [ACMR=" << before.acmr << "->" << after.acmr <<
+		" ATVR=" << before.atvr << "->" << after.atvr <<
+		" kގOp`=" << degenerateCount << " dOp`=" << duplicateCount << "]\n";
+
+	//_16bitɎ܂ꍇ16bitCfbNXɋlߒ
+	const bool isShortIndex = vertices.size() <= 0x10000;
+	if (isShortIndex)
+	{
+		const std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+		Add(vertices.data(), vertices.data() + vertices.size(),
+			shortIndices.data(), shortIndices.data() + shortIndices.size());
+	}
+	else
+	{
+		Add(vertices.data(), vertices.data() + vertices.size(),
+			indices.data(), indices.data() + indices.size());
+	}
+
+	//Op`𔼕炵ڍדx. _f[^͌̃bVƋL
+	std::vector<GLuint> lodIndices;
+	size_t previousCount = indices.size();
+	float lodError = 0;
+	for (int lod = 1; lod < maxMeshLodCount; ++lod)
+	{
+		const size_t target = indices.size() / 3 / ((size_t)1 << lod) * 3;
+		const float error = MeshOptimizer::Simplify(vertices, indices, target, lodIndices);
+
+		//قƂǌ点ȂȂł؂
+		if (lodIndices.empty() || lodIndices.size() > previousCount * 9 / 10)
+		{
+			break;
+		}
+		MeshOptimizer::OptimizeVertexCache(lodIndices, vertices.size());
+		previousCount = lodIndices.size();
+		lodError = std::max(lodError, error);
+
+		if (isShortIndex)
+		{
+			const std::vector<GLushort> shortIndices(lodIndices.begin(), lodIndices.end());
+			AddLod(shortIndices.data(), shortIndices.data() + shortIndices.size(), lodError);
+		}
+		else
+		{
+			AddLod(lodIndices.data(), lodIndices.data() + lodIndices.size(), lodError);
+		}
+		std::cout << "INFO: " << path << " LOD" << lod <<
+			" [Op`=" << indices.size() / 3 << "->" << lodIndices.size() / 3 <<
+			" 덷=" << lodError << "]\n";
+	}
+
+	return true;
+}
+
+/**
+* sɒǉ郁bV̂߂ɗ\񂷂eʂݒ肷
+*
+* @param vertexCount \񂷂钸_
+* @param indexBytes  \񂷂CfbNX̃oCg
+*
+* Allcate(܂Upload)̑OɌĂяo
+*/
+void MeshList::Reserve(size_t vertexCount, size_t indexBytes)
+{
+	reservedVertexCount = vertexCount;
+	reservedIndexBytes = indexBytes;
+}
+
+/**
+* 쐬ς݂VAOɃbVǉ
+*
+* @param vBegin ǉ钸_f[^z̐擪
+* @param vEnd   ǉ钸_f[^z̏I[
+* @param iBegin ǉCfbNXf[^z̐擪
+* @param iEnd   ǉCfbNXf[^z̏I[
+*
+* @return ǉbV̔ԍ. ǉłȂꍇ-1
+*
+* Reserveŗ\񂵂̈悩犄蓖Ă̂ŁAVAO⑼̃bV̈ʒu͕ςȂ.
+* _16bitɎ܂ꍇ16bitCfbNXɋlߒ
+*/
+int MeshList::AddDynamic(const Vertex* vBegin, const Vertex* vEnd,
+	const GLuint* iBegin, const GLuint* iEnd)
+{
+	if (!vao || vBegin == vEnd || iBegin == iEnd)
+	{
+		return -1;
+	}
+
+	//_ƃCfbNẌ̗蓖Ă
+	const size_t vertexCount = vEnd - vBegin;
+	const bool isShortIndex = vertexCount <= 0x10000;
+	const size_t indexSize = isShortIndex ? sizeof(GLushort) : sizeof(GLuint);
+	const size_t indexBytes = (iEnd - iBegin) * indexSize;
+	const size_t vertexOffset = vertexAllocator.Allocate(vertexCount);
+	if (vertexOffset == BufferAllocator::npos)
+	{
+		std::cerr << "ERROR: _obt@̋󂫂܂(_=" << vertexCount << ")\n";
+		return -1;
+	}
+	const size_t indexOffset = indexAllocator.Allocate(indexBytes, indexSize);
+	if (indexOffset == BufferAllocator::npos)
+	{
+		vertexAllocator.Free(vertexOffset, vertexCount);
+		std::cerr << "ERROR: CfbNXobt@̋󂫂܂(" << indexBytes << "oCg)\n";
+		return -1;
+	}
+
+	Mesh m;
+	m.mode = GL_TRIANGLES;
+	m.count = iEnd - iBegin;
+	m.indices = (const GLvoid*)indexOffset;
+	m.baseVertex = (GLint)vertexOffset;
+	m.indexType = isShortIndex ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	m.positionOffset = { 0, 0, 0 };
+	m.positionScale = { 1, 1, 1 };
+	m.lodCount = 1;
+	m.lods[0] = { m.count, m.indices, 0 };
+	ComputeMeshBounds(vBegin, vEnd, m.bounds, m.sphere);
+
+	//蓖Ă̈悾.
+	//VAOIBOςȂ悤ɁAGL_COPY_WRITE_BUFFERɃoChē]
+	glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+	if (format == VertexFormat::Packed)
+	{
+		std::vector<PackedVertex> packed(vertexCount);
+		VertexPacker::Pack(vBegin, vEnd, packed.data(), m.positionOffset, m.positionScale);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * sizeof(PackedVertex),
+			vertexCount * sizeof(PackedVertex), packed.data());
+	}
+	else
+	{
+		glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * sizeof(Vertex),
+			vertexCount * sizeof(Vertex), vBegin);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ibo);
+	if (isShortIndex)
+	{
+		const std::vector<GLushort> shortIndices(iBegin, iEnd);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexBytes, shortIndices.data());
+	}
+	else
+	{
+		glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexBytes, iBegin);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	//폜ς݂̃bV̔ԍ΍ėp
+	const DynamicRange range = { vertexOffset, vertexCount, indexOffset, indexBytes };
+	size_t index = meshes.size();
+	if (!freeMeshSlots.empty())
+	{
+		index = freeMeshSlots.back();
+		freeMeshSlots.pop_back();
+		meshes[index] = m;
+		dynamicRanges[index] = range;
+	}
+	else
+	{
+		meshes.push_back(m);
+		dynamicRanges.push_back(range);
+	}
+	return (int)index;
+}
+
+/**
+* AddDynamicŒǉbV폜
+*
+* @param index 폜郁bV̔ԍ
+*
+* @retval true  폜
+* @retval false 폜łȂ(Allcateō쐬bVA܂͍폜ς)
+*
+* 폜bV͕`悵Ă\Ȃ. ԍ͎AddDynamicōėp
+*/
+bool MeshList::Remove(size_t index)
+{
+	if (index >= dynamicRanges.size() || dynamicRanges[index].vertexCount == 0)
+	{
+		return false;
+	}
+	DynamicRange& range = dynamicRanges[index];
+	vertexAllocator.Free(range.vertexOffset, range.vertexCount);
+	indexAllocator.Free(range.indexOffset, range.indexBytes);
+	range = DynamicRange{ 0, 0, 0, 0 };
 
+	Mesh& m = meshes[index];
+	m.count = 0;
+	m.lodCount = 1;
+	m.lods[0] = { 0, m.indices, 0 };
+	freeMeshSlots.push_back(index);
 	return true;
-}
\ No newline at end of file
+}
+
+/**
+* _obt@̒fЉ̓v擾
+*
+* @return v(Pʂ͒_)
+*/
+BufferAllocator::Statistics MeshList::GetVertexBufferStatistics() const
+{
+	return vertexAllocator.GetStatistics();
+}
+
+/**
+* CfbNXobt@̒fЉ̓v擾
+*
+* @return v(Pʂ̓oCg)
+*/
+BufferAllocator::Statistics MeshList::GetIndexBufferStatistics() const
+{
+	return indexAllocator.GetStatistics();
+}
+
+/**
+* ʏł̌덷e͈͂Ɏ܂AłeڍדxI
+*
+* @param mesh            `悷郁bV
+* @param distance        _烁bV܂ł̋
+* @param scale           bV̊g嗦
+* @param projectionScale 1̈ʒuɂ钷1̂̕ʏŉsNZɂȂ邩
+*                        (ʂ̍ / (2 * tan(p / 2)))
+* @param maxPixelError   eʏ̌덷(sNZ)
+*
+* @return `Ɏgڍדx̔ԍ
+*/
+int SelectMeshLod(const Mesh& mesh, float distance, float scale,
+	float projectionScale, float maxPixelError)
+{
+	const float pixelsPerUnit = scale * projectionScale / std::max(distance, 0.0001f);
+	for (int lod = mesh.lodCount - 1; lod > 0; --lod)
+	{
+		if (mesh.lods[lod].error * pixelsPerUnit <= maxPixelError)
+		{
+			return lod;
+		}
+	}
+	return 0;
+}
+
+/**
+* kꂽ_W(0`1)bV{͈̔͂ɖ߂s߂
+*
+* @param mesh Ώۂ̃bV
+*
+* @return kꂽ_W߂s
+*/
+glm::mat4 MakeDequantizeMatrix(const Mesh& mesh)
+{
+	return glm::scale(
+		glm::translate(glm::mat4(1), glm::vec3(mesh.positionOffset.x,
+			mesh.positionOffset.y, mesh.positionOffset.z)),
+		glm::vec3(mesh.positionScale.x, mesh.positionScale.y, mesh.positionScale.z));
+}
+
+/**
+* bV̕`ɎgfsƖ@s߂
+*
+* @param mesh      `悷郁bV
+* @param matModel  fs(]EgkEsړ܂ނ)
+* @param matMesh   kꂽ_W߂ϊ܂߂fs̊i[
+* @param matNormal @s̊e̊i[(3vf)
+*
+* fs̊éu]s̗~g嗦vȂ̂ŁA2Ŋ
+* @s̗(]s̗񁀊g嗦)ɂȂ.
+* g嗦0̎͌܂Ȃ̂ŁAInfNaNɂȂȂ悤0̗ɂ
+*/
+void MakeMeshMatrices(const Mesh& mesh, const glm::mat4& matModel,
+	glm::mat4& matMesh, glm::vec3* matNormal)
+{
+	matMesh = matModel * MakeDequantizeMatrix(mesh);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		const glm::vec3 axis(matModel[i]);
+		const float lengthSquared = glm::dot(axis, axis);
+		matNormal[i] = lengthSquared < FLT_MIN ? glm::vec3(0) : axis / lengthSquared;
+	}
+}
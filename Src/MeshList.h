@@ -5,6 +5,10 @@
 #define MESHLIST_H_INCLUDED
 #include <GL/glew.h>
 #include "Geometry.h"
+#include "AssetPack.h"
+#include "BufferAllocator.h"
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
 #include <vector>
 
 /**
@@ -16,19 +20,72 @@ public:
 	MeshList();
 	~MeshList();
 
-	bool Allcate();
+	bool Allcate(VertexFormat format = VertexFormat::Float);
+	bool Prepare(VertexFormat format = VertexFormat::Float);
+	bool Upload();
 	void Free();
 	void Add(const Vertex*, const Vertex*, const GLushort*, const GLushort*);
+	void Add(const Vertex*, const Vertex*, const GLuint*, const GLuint*);
+	void AddLod(const GLushort*, const GLushort*, float);
+	void AddLod(const GLuint*, const GLuint*, float);
 	bool AddFromObjFile(const char* path);
 
+	void Reserve(size_t vertexCount, size_t indexBytes);
+	int AddDynamic(const Vertex*, const Vertex*, const GLuint*, const GLuint*);
+	bool Remove(size_t index);
+	BufferAllocator::Statistics GetVertexBufferStatistics() const;
+	BufferAllocator::Statistics GetIndexBufferStatistics() const;
+
 	void BindVertexArray();
+	void BindInstancedVertexArray();
 	const Mesh& Get(size_t index) const;
 
 private:
+	bool LoadCache(AssetFile&, const char* const*, size_t);
+	bool SaveCache(const char* const*, size_t, const GLvoid*, GLsizeiptr) const;
+	void PackVertices();
+
 	GLuint vao = 0;
+	GLuint instancedVao = 0;//CX^X`pVAO(̔ԍ̑Ȃ)
+	GLuint vbo = 0;
+	GLuint ibo = 0;
+	GLuint objectIndexBuffer = 0;//uniformubN̔̕ԍobt@
+	VertexFormat format = VertexFormat::Float;
 	std::vector<Mesh> meshes;
 
 	std::vector<Vertex> tmpVertices;
-	std::vector<GLushort> tmpIndices;
+	std::vector<PackedVertex> tmpPackedVertices;
+	std::vector<GLubyte> tmpIndices;//16bit32bit̃CfbNX݂邽߃oCgPʂŕێ
+
+	//PrepareŗpӂAUploadœ]f[^
+	AssetFile cache;
+	const GLvoid* vertexData = nullptr;
+	const GLvoid* indexData = nullptr;
+	GLsizeiptr vertexBytes = 0;
+	GLsizeiptr indexBytes = 0;
+
+	//sɒǉE폜郁bVp̗̈
+	size_t reservedVertexCount = 65536;//\񂷂钸_
+	size_t reservedIndexBytes = 256 * 1024;//\񂷂CfbNX̃oCg
+	BufferAllocator vertexAllocator;//VBO̊蓖(Pʂ͒_)
+	BufferAllocator indexAllocator;//IBO̊蓖(Pʂ̓oCg)
+
+	//AddDynamicŒǉbVgĂ̈
+	struct DynamicRange
+	{
+		size_t vertexOffset;
+		size_t vertexCount;//0ȂAllcateō쐬bV
+		size_t indexOffset;
+		size_t indexBytes;
+	};
+	std::vector<DynamicRange> dynamicRanges;//meshesƓ
+	std::vector<size_t> freeMeshSlots;//Removeŋ󂢂meshes̔ԍ
 };
+
+int SelectMeshLod(const Mesh& mesh, float distance, float scale,
+	float projectionScale, float maxPixelError = 1.0f);
+glm::mat4 MakeDequantizeMatrix(const Mesh& mesh);
+void MakeMeshMatrices(const Mesh& mesh, const glm::mat4& matModel,
+	glm::mat4& matMesh, glm::vec3* matNormal);
+
 #endif //MESHLIST_H_INCLUDED
\ No newline at end of file
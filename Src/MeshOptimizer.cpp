@@ -0,0 +1,861 @@
+/**
+* @file MeshOptimizer.cpp
+*/
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <unordered_set>
+#include <unordered_map>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+
+//bV̕`グ邽߂̊֐i[閼O
+namespace MeshOptimizer {
+
+/**
+* FIFO̒_LbV͕킵āALbV~X̉񐔂𐔂
+*/
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t vertexCount, size_t cacheSize) :
+			timestamps(vertexCount, 0), cacheSize(cacheSize), time(cacheSize + 1)
+		{
+		}
+
+		//_QƂALbV~XȂtrueԂ
+		bool Access(GLuint v)
+		{
+			if (time - timestamps[v] > cacheSize)
+			{
+				timestamps[v] = time++;
+				return true;
+			}
+			return false;
+		}
+
+		//LbVɂ
+		void Flush()
+		{
+			time += cacheSize + 1;
+		}
+
+	private:
+		std::vector<size_t> timestamps;
+		size_t cacheSize;
+		size_t time;
+	};
+
+/**
+* _LbV̌vZ
+*
+* @param indices     ׂCfbNXz(Op`Xg)
+* @param vertexCount _
+* @param cacheSize   z肷FIFOLbV̑傫
+*
+* @return ACMRATVR
+*/
+	CacheStatistics AnalyzeVertexCache(const std::vector<GLuint>& indices,
+		size_t vertexCount, size_t cacheSize)
+	{
+		CacheStatistics result = { 0, 0 };
+		if (indices.empty() || vertexCount == 0)
+		{
+			return result;
+		}
+
+		FifoCache cache(vertexCount, cacheSize);
+		std::vector<bool> used(vertexCount, false);
+		size_t misses = 0;
+		size_t usedCount = 0;
+		for (GLuint v : indices)
+		{
+			misses += cache.Access(v);
+			if (!used[v])
+			{
+				used[v] = true;
+				++usedCount;
+			}
+		}
+		result.acmr = (float)misses / (float)(indices.size() / 3);
+		result.atvr = (float)misses / (float)usedCount;
+		return result;
+	}
+
+/**
+* ʐς0̎Op`菜
+*
+* @param indices  CfbNXz
+* @param vertices CfbNXw_z
+*
+* @return 菜Op`̐
+*
+* _2ȏgOp`ƁA2_ȏ̍WvOp`ΏۂƂ
+*/
+	size_t RemoveDegenerateTriangles(std::vector<GLuint>& indices,
+		const std::vector<Vertex>& vertices)
+	{
+		const auto isSamePosition = [&vertices](GLuint a, GLuint b) {
+			const Vector3& pa = vertices[a].position;
+			const Vector3& pb = vertices[b].position;
+			return pa.x == pb.x && pa.y == pb.y && pa.z == pb.z;
+		};
+
+		size_t n = 0;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const GLuint a = indices[i];
+			const GLuint b = indices[i + 1];
+			const GLuint c = indices[i + 2];
+			if (isSamePosition(a, b) || isSamePosition(b, c) || isSamePosition(c, a))
+			{
+				continue;
+			}
+			indices[n++] = a;
+			indices[n++] = b;
+			indices[n++] = c;
+		}
+		const size_t removed = (indices.size() - n) / 3;
+		indices.resize(n);
+		return removed;
+	}
+
+/**
+* _𓯂ŌԎOp`1ɂ܂Ƃ߂
+*
+* @param indices CfbNXz
+*
+* @return 菜Op`̐
+*/
+	size_t RemoveDuplicateTriangles(std::vector<GLuint>& indices)
+	{
+		//_ԍŏ̒_n܂悤ɉ]̂Op`̎ʎqƂ
+		struct Triangle
+		{
+			GLuint v[3];
+			bool operator==(const Triangle& o) const
+			{
+				return v[0] == o.v[0] && v[1] == o.v[1] && v[2] == o.v[2];
+			}
+		};
+		struct TriangleHash
+		{
+			size_t operator()(const Triangle& t) const
+			{
+				uint64_t h = t.v[0];
+				h = h * 0x9E3779B97F4A7C15ULL + t.v[1];
+				h = h * 0x9E3779B97F4A7C15ULL + t.v[2];
+				return (size_t)(h ^ (h >> 32));
+			}
+		};
+		std::unordered_set<Triangle, TriangleHash> triangles;
+		triangles.reserve(indices.size() / 3);
+
+		size_t n = 0;
+		for (size_t i = 0; i + 2 < indices.size(); i += 3)
+		{
+			const GLuint a = indices[i];
+			const GLuint b = indices[i + 1];
+			const GLuint c = indices[i + 2];
+			Triangle t;
+			if (a <= b && a <= c)
+			{
+				t = { { a, b, c } };
+			}
+			else if (b <= c)
+			{
+				t = { { b, c, a } };
+			}
+			else
+			{
+				t = { { c, a, b } };
+			}
+			if (!triangles.insert(t).second)
+			{
+				continue;
+			}
+			indices[n++] = a;
+			indices[n++] = b;
+			indices[n++] = c;
+		}
+		const size_t removed = (indices.size() - n) / 3;
+		indices.resize(n);
+		return removed;
+	}
+
+	//OptimizeVertexCachez肷LRULbV̑傫
+	const int lruCacheSize = 32;
+
+/**
+* _̗DxvZ(Forsyth̕@)
+*
+* @param cachePosition LRULbV̈ʒu(-1=LbVO)
+* @param remaining     ̒_go͂̎Op`̐
+*
+* @return _̗Dx
+*/
+	float VertexScore(int cachePosition, GLuint remaining)
+	{
+		if (remaining == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0;
+		if (cachePosition >= 0)
+		{
+			//O̎Op`̒_́A̎Op`őĎgɂ̂ŗDxŒ肷
+			if (cachePosition < 3)
+			{
+				score = 0.75f;
+			}
+			else
+			{
+				const float scale = 1.0f / (lruCacheSize - 3);
+				score = powf(1.0f - (cachePosition - 3) * scale, 1.5f);
+			}
+		}
+
+		//c̎Op`Ȃ_ɕЕt
+		score += 2.0f / sqrtf((float)remaining);
+		return score;
+	}
+
+/**
+* _LbV̌ǂȂ悤ɎOp`בւ
+*
+* @param indices     בւCfbNXz
+* @param vertexCount _
+*
+* Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"̕@g
+*/
+	void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		//_Op`߂̕\
+		std::vector<GLuint> remaining(vertexCount, 0);
+		for (size_t i = 0; i < triangleCount * 3; ++i)
+		{
+			++remaining[indices[i]];
+		}
+		std::vector<GLuint> offsets(vertexCount + 1, 0);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			offsets[v + 1] = offsets[v] + remaining[v];
+		}
+		std::vector<GLuint> adjacency(triangleCount * 3);
+		{
+			std::vector<GLuint> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < triangleCount * 3; ++i)
+			{
+				adjacency[fill[indices[i]]++] = (GLuint)(i / 3);
+			}
+		}
+
+		//_ƎOp`̗Dx
+		std::vector<int> cachePosition(vertexCount, -1);
+		std::vector<float> vertexScore(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			vertexScore[v] = VertexScore(-1, remaining[v]);
+		}
+		std::vector<float> triangleScore(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			triangleScore[t] = vertexScore[indices[t * 3]] +
+				vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+		}
+
+		std::vector<GLuint> result;
+		result.reserve(triangleCount * 3);
+		std::vector<GLuint> cache;
+		std::vector<GLuint> newCache;
+		cache.reserve(lruCacheSize + 3);
+		newCache.reserve(lruCacheSize + 3);
+
+		size_t best = std::max_element(triangleScore.begin(), triangleScore.end()) -
+			triangleScore.begin();
+		size_t scanPosition = 0;
+		while (result.size() < triangleCount * 3)
+		{
+			//LbVɌ₪΁Ao͂̎Op`擪T
+			if (best == triangleCount)
+			{
+				while (emitted[scanPosition])
+				{
+					++scanPosition;
+				}
+				best = scanPosition;
+			}
+
+			//łDx̍Op`o͂
+			const GLuint* tri = &indices[best * 3];
+			result.insert(result.end(), tri, tri + 3);
+			emitted[best] = true;
+			for (int i = 0; i < 3; ++i)
+			{
+				--remaining[tri[i]];
+			}
+
+			//o͂Op`̒_LbV̐擪Ɉړ
+			newCache.assign(tri, tri + 3);
+			for (GLuint v : cache)
+			{
+				if (v != tri[0] && v != tri[1] && v != tri[2])
+				{
+					newCache.push_back(v);
+				}
+			}
+
+			//LbV̒_ƁAӂꂽ_̗DxXV
+			for (size_t i = 0; i < newCache.size(); ++i)
+			{
+				const GLuint v = newCache[i];
+				cachePosition[v] = i < (size_t)lruCacheSize ? (int)i : -1;
+				vertexScore[v] = VertexScore(cachePosition[v], remaining[v]);
+			}
+
+			//DxςOp`XVAɏo͂Op`I
+			best = triangleCount;
+			float bestScore = -1.0f;
+			for (GLuint v : newCache)
+			{
+				for (GLuint i = offsets[v]; i < offsets[v + 1]; ++i)
+				{
+					const GLuint t = adjacency[i];
+					if (emitted[t])
+					{
+						continue;
+					}
+					const float score = vertexScore[indices[t * 3]] +
+						vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+					triangleScore[t] = score;
+					if (score > bestScore)
+					{
+						bestScore = score;
+						best = t;
+					}
+				}
+			}
+
+			if (newCache.size() > (size_t)lruCacheSize)
+			{
+				newCache.resize(lruCacheSize);
+			}
+			cache.swap(newCache);
+		}
+		indices.swap(result);
+	}
+
+/**
+* Ȍɕ`ɂȂ悤ɎOp`̉בւ
+*
+* @param indices   בւCfbNXz(OptimizeVertexCachěɎg)
+* @param vertices  CfbNXw_z
+* @param threshold e钸_LbV̈(1.05=5%܂ŋ)
+*
+* Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and
+* Reduced Overdraw"̕@g. _LbV̌ۂĂ͈͂ŎOp`
+* ɋ؂AOĂقǐɕ`悷
+*/
+	void OptimizeOverdraw(std::vector<GLuint>& indices,
+		const std::vector<Vertex>& vertices, float threshold)
+	{
+		const size_t triangleCount = indices.size() / 3;
+		if (triangleCount < 2)
+		{
+			return;
+		}
+		const size_t cacheSize = 16;
+
+		//3_ƂLbV~Xʒuŋ؂(LbVɂȂʒu)
+		std::vector<size_t> clusters;
+		{
+			FifoCache cache(vertices.size(), cacheSize);
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				const int misses = cache.Access(indices[t * 3]) +
+					cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+				if (t == 0 || misses == 3)
+				{
+					clusters.push_back(t);
+				}
+			}
+			clusters.push_back(triangleCount);
+		}
+
+		//̈e͈͂Ɏ܂ʒuŁAɍׂ؂
+		std::vector<size_t> softClusters;
+		{
+			FifoCache cache(vertices.size(), cacheSize);
+			for (size_t c = 0; c + 1 < clusters.size(); ++c)
+			{
+				const size_t begin = clusters[c];
+				const size_t end = clusters[c + 1];
+
+				cache.Flush();
+				size_t clusterMisses = 0;
+				for (size_t i = begin * 3; i < end * 3; ++i)
+				{
+					clusterMisses += cache.Access(indices[i]);
+				}
+				const float limit = threshold * clusterMisses / (float)(end - begin);
+
+				cache.Flush();
+				softClusters.push_back(begin);
+				size_t start = begin;
+				size_t misses = 0;
+				for (size_t t = begin; t < end; ++t)
+				{
+					misses += cache.Access(indices[t * 3]) +
+						cache.Access(indices[t * 3 + 1]) + cache.Access(indices[t * 3 + 2]);
+					if (t + 1 < end && (float)misses / (float)(t + 1 - start) <= limit)
+					{
+						softClusters.push_back(t + 1);
+						start = t + 1;
+						misses = 0;
+						cache.Flush();
+					}
+				}
+			}
+			softClusters.push_back(triangleCount);
+		}
+
+		//bVŜ̒S߂
+		double center[3] = { 0, 0, 0 };
+		double totalArea = 0;
+		std::vector<float> areas(triangleCount);
+		std::vector<Vector3> normals(triangleCount);
+		std::vector<Vector3> centroids(triangleCount);
+		for (size_t t = 0; t < triangleCount; ++t)
+		{
+			const Vector3& a = vertices[indices[t * 3]].position;
+			const Vector3& b = vertices[indices[t * 3 + 1]].position;
+			const Vector3& c = vertices[indices[t * 3 + 2]].position;
+			const Vector3 ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+			const Vector3 ac = { c.x - a.x, c.y - a.y, c.z - a.z };
+			const Vector3 n = {
+				ab.y * ac.z - ab.z * ac.y,
+				ab.z * ac.x - ab.x * ac.z,
+				ab.x * ac.y - ab.y * ac.x };
+			const float area = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+			areas[t] = area;
+			normals[t] = n;
+			centroids[t] = { (a.x + b.x + c.x) / 3, (a.y + b.y + c.y) / 3, (a.z + b.z + c.z) / 3 };
+			center[0] += centroids[t].x * area;
+			center[1] += centroids[t].y * area;
+			center[2] += centroids[t].z * area;
+			totalArea += area;
+		}
+		if (totalArea > 0)
+		{
+			center[0] /= totalArea;
+			center[1] /= totalArea;
+			center[2] /= totalArea;
+		}
+
+		//̌ƈʒuAOĂx߂
+		struct Cluster
+		{
+			size_t begin;
+			size_t end;
+			float key;
+		};
+		std::vector<Cluster> sorted;
+		sorted.reserve(softClusters.size() - 1);
+		for (size_t c = 0; c + 1 < softClusters.size(); ++c)
+		{
+			Cluster cluster = { softClusters[c], softClusters[c + 1], 0 };
+			double n[3] = { 0, 0, 0 };
+			double p[3] = { 0, 0, 0 };
+			double area = 0;
+			for (size_t t = cluster.begin; t < cluster.end; ++t)
+			{
+				n[0] += normals[t].x;
+				n[1] += normals[t].y;
+				n[2] += normals[t].z;
+				p[0] += centroids[t].x * areas[t];
+				p[1] += centroids[t].y * areas[t];
+				p[2] += centroids[t].z * areas[t];
+				area += areas[t];
+			}
+			const double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length > 0 && area > 0)
+			{
+				cluster.key = (float)(
+					(p[0] / area - center[0]) * n[0] / length +
+					(p[1] / area - center[1]) * n[1] / length +
+					(p[2] / area - center[2]) * n[2] / length);
+			}
+			sorted.push_back(cluster);
+		}
+		std::stable_sort(sorted.begin(), sorted.end(),
+			[](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+		std::vector<GLuint> result;
+		result.reserve(indices.size());
+		for (const Cluster& e : sorted)
+		{
+			result.insert(result.end(),
+				indices.begin() + e.begin * 3, indices.begin() + e.end * 3);
+		}
+		indices.swap(result);
+	}
+
+/**
+* _g鏇ɕבւ. gĂȂ_͎菜
+*
+* @param vertices בւ钸_z
+* @param indices  _zwCfbNXz. בւ̔ԍɏ
+*/
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<GLuint>& indices)
+	{
+		const GLuint unused = ~0U;
+		std::vector<GLuint> remap(vertices.size(), unused);
+		std::vector<Vertex> result;
+		result.reserve(vertices.size());
+		for (GLuint& i : indices)
+		{
+			if (remap[i] == unused)
+			{
+				remap[i] = (GLuint)result.size();
+				result.push_back(vertices[i]);
+			}
+			i = remap[i];
+		}
+		vertices.swap(result);
+	}
+
+/**
+* 񎟌덷s(Ώ4x4s̏Op)
+*/
+	struct Quadric
+	{
+		double xx, xy, xz, xw, yy, yz, yw, zz, zw, ww;
+
+		//(ax+by+cz+d=0)̋2
+		void AddPlane(double a, double b, double c, double d)
+		{
+			xx += a * a; xy += a * b; xz += a * c; xw += a * d;
+			yy += b * b; yz += b * c; yw += b * d;
+			zz += c * c; zw += c * d;
+			ww += d * d;
+		}
+
+		//̍s
+		void Add(const Quadric& q)
+		{
+			xx += q.xx; xy += q.xy; xz += q.xz; xw += q.xw;
+			yy += q.yy; yz += q.yz; yw += q.yw;
+			zz += q.zz; zw += q.zw;
+			ww += q.ww;
+		}
+
+		//Wpɂ덷vZ
+		double Evaluate(const Vector3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double e = xx * x * x + 2 * xy * x * y + 2 * xz * x * z + 2 * xw * x +
+				yy * y * y + 2 * yz * y * z + 2 * yw * y +
+				zz * z * z + 2 * zw * z + ww;
+			return e > 0 ? e : 0;
+		}
+	};
+
+/**
+* Op`̖@(KȂ)vZ
+*/
+	Vector3 TriangleNormal(const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		const Vector3 ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+		const Vector3 ac = { c.x - a.x, c.y - a.y, c.z - a.z };
+		return {
+			ab.y * ac.z - ab.z * ac.y,
+			ab.z * ac.x - ab.x * ac.z,
+			ab.x * ac.y - ab.y * ac.x };
+	}
+
+/**
+* Op`̐炵CfbNXz
+*
+* @param vertices         CfbNXw_z
+* @param indices          ̃CfbNXz
+* @param targetIndexCount ڕWƂCfbNX
+* @param result           쐬CfbNXz̊i[
+*
+* @return ̌`Ƃ̌덷(fWnł̋)
+*
+* Garland, Heckbert, "Surface Simplification Using Quadric Error Metrics"
+* ӂ̏kA̒_ւ̏kɌ肵čs. ̂ߒ_z͌̂̂
+* ̂܂܋Lł. eNX`W@̐؂ڂɂ钸_ƁẢɂ钸_
+* Ȃ
+*/
+	float Simplify(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices,
+		size_t targetIndexCount, std::vector<GLuint>& result)
+	{
+		result = indices;
+		const size_t vertexCount = vertices.size();
+		if (result.size() <= targetIndexCount || vertexCount == 0)
+		{
+			return 0;
+		}
+
+		//W̒_ɋʂ̔ԍt
+		struct PositionHash
+		{
+			size_t operator()(const Vector3& p) const
+			{
+				uint32_t h[3];
+				memcpy(h, &p, sizeof(h));
+				return (size_t)(h[0] * 73856093u ^ h[1] * 19349663u ^ h[2] * 83492791u);
+			}
+		};
+		struct PositionEqual
+		{
+			bool operator()(const Vector3& a, const Vector3& b) const
+			{
+				return a.x == b.x && a.y == b.y && a.z == b.z;
+			}
+		};
+		std::unordered_map<Vector3, GLuint, PositionHash, PositionEqual> positionMap;
+		positionMap.reserve(vertexCount);
+		std::vector<GLuint> positionId(vertexCount);
+		std::vector<GLuint> wedgeCount;
+		wedgeCount.reserve(vertexCount);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			const auto itr =
+				positionMap.emplace(vertices[v].position, (GLuint)wedgeCount.size());
+			if (itr.second)
+			{
+				wedgeCount.push_back(0);
+			}
+			positionId[v] = itr.first->second;
+			++wedgeCount[positionId[v]];
+		}
+
+		//̐؂ڂɂ钸_͏k񂷂ƌڂ̂ŌŒ肷
+		std::vector<bool> locked(vertexCount, false);
+		for (size_t v = 0; v < vertexCount; ++v)
+		{
+			locked[v] = wedgeCount[positionId[v]] > 1;
+		}
+
+		//t̕ӂȂӂ͌̉Ȃ̂ŁA̗[̒_Œ肷
+		{
+			std::unordered_set<uint64_t> edges;
+			edges.reserve(result.size());
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const uint64_t a = result[i + k];
+					const uint64_t b = result[i + (k + 1) % 3];
+					edges.insert((a << 32) | b);
+				}
+			}
+			for (const uint64_t e : edges)
+			{
+				const uint64_t a = e >> 32;
+				const uint64_t b = e & 0xffffffff;
+				if (!edges.count((b << 32) | a))
+				{
+					locked[a] = true;
+					locked[b] = true;
+				}
+			}
+		}
+
+		//WƂɁA͂̎Op`̕ʂȂ񎟌덷s
+		std::vector<Quadric> quadrics(wedgeCount.size(), Quadric());
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			const Vector3& a = vertices[result[i]].position;
+			const Vector3& b = vertices[result[i + 1]].position;
+			const Vector3& c = vertices[result[i + 2]].position;
+			const Vector3 n = TriangleNormal(a, b, c);
+			const double length = sqrt((double)n.x * n.x + (double)n.y * n.y + (double)n.z * n.z);
+			if (length <= 0)
+			{
+				continue;
+			}
+			const double nx = n.x / length, ny = n.y / length, nz = n.z / length;
+			const double d = -(nx * a.x + ny * a.y + nz * a.z);
+			for (int k = 0; k < 3; ++k)
+			{
+				quadrics[positionId[result[i + k]]].AddPlane(nx, ny, nz, d);
+			}
+		}
+
+		struct Collapse
+		{
+			GLuint from;
+			GLuint to;
+			double cost;
+		};
+		std::vector<Collapse> collapses;
+		std::vector<GLuint> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+		std::vector<GLuint> offsets(vertexCount + 1);
+		std::vector<GLuint> adjacency;
+		double maxError = 0;
+
+		//Ɨȕӂ܂Ƃ߂ďk񂷂鏈AڕW̐ɂȂ܂ŌJԂ
+		while (result.size() > targetIndexCount)
+		{
+			const size_t triangleCount = result.size() / 3;
+
+			//_Op`߂̕\
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (GLuint v : result)
+			{
+				++offsets[v + 1];
+			}
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				offsets[v + 1] += offsets[v];
+			}
+			adjacency.resize(result.size());
+			{
+				std::vector<GLuint> fill(offsets.begin(), offsets.end() - 1);
+				for (size_t i = 0; i < result.size(); ++i)
+				{
+					adjacency[fill[result[i]]++] = (GLuint)(i / 3);
+				}
+			}
+
+			//ǩ덷̏ɕׂ
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (int k = 0; k < 3; ++k)
+				{
+					const GLuint a = result[i + k];
+					const GLuint b = result[i + (k + 1) % 3];
+					if (positionId[a] == positionId[b])
+					{
+						continue;
+					}
+					if (!locked[a])
+					{
+						Quadric q = quadrics[positionId[a]];
+						q.Add(quadrics[positionId[b]]);
+						collapses.push_back({ a, b, q.Evaluate(vertices[b].position) });
+					}
+					if (!locked[b])
+					{
+						Quadric q = quadrics[positionId[b]];
+						q.Add(quadrics[positionId[a]]);
+						collapses.push_back({ b, a, q.Evaluate(vertices[a].position) });
+					}
+				}
+			}
+			std::sort(collapses.begin(), collapses.end(),
+				[](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+			//݂ɉeȂӂk񂷂
+			for (size_t v = 0; v < vertexCount; ++v)
+			{
+				remap[v] = (GLuint)v;
+			}
+			std::fill(touched.begin(), touched.end(), false);
+			const size_t removeTarget = (result.size() - targetIndexCount) / 3;
+			size_t removeCount = 0;
+			size_t collapseCount = 0;
+			for (const Collapse& e : collapses)
+			{
+				if (removeCount >= removeTarget)
+				{
+					break;
+				}
+				if (touched[e.from] || touched[e.to])
+				{
+					continue;
+				}
+
+				//Op`ԂA܂͌60xȏς悤ȏk͂Ȃ
+				bool isFlipped = false;
+				size_t sharedCount = 0;
+				for (GLuint i = offsets[e.from]; i < offsets[e.from + 1]; ++i)
+				{
+					const GLuint* tri = &result[adjacency[i] * 3];
+					if (tri[0] == e.to || tri[1] == e.to || tri[2] == e.to)
+					{
+						++sharedCount;
+						continue;
+					}
+					Vector3 p[3];
+					for (int k = 0; k < 3; ++k)
+					{
+						p[k] = vertices[tri[k]].position;
+					}
+					const Vector3 before = TriangleNormal(p[0], p[1], p[2]);
+					for (int k = 0; k < 3; ++k)
+					{
+						if (tri[k] == e.from)
+						{
+							p[k] = vertices[e.to].position;
+						}
+					}
+					const Vector3 after = TriangleNormal(p[0], p[1], p[2]);
+					const float dot = before.x * after.x + before.y * after.y + before.z * after.z;
+					const float lengthSq =
+						(before.x * before.x + before.y * before.y + before.z * before.z) *
+						(after.x * after.x + after.y * after.y + after.z * after.z);
+					if (dot <= 0 || dot * dot < 0.25f * lengthSq)
+					{
+						isFlipped = true;
+						break;
+					}
+				}
+				if (isFlipped)
+				{
+					continue;
+				}
+
+				//k񂵁A͂̒_͂̉ł͓Ȃ悤ɂ
+				remap[e.from] = e.to;
+				quadrics[positionId[e.to]].Add(quadrics[positionId[e.from]]);
+				for (GLuint i = offsets[e.from]; i < offsets[e.from + 1]; ++i)
+				{
+					const GLuint* tri = &result[adjacency[i] * 3];
+					touched[tri[0]] = true;
+					touched[tri[1]] = true;
+					touched[tri[2]] = true;
+				}
+				removeCount += sharedCount;
+				++collapseCount;
+				maxError = std::max(maxError, e.cost);
+			}
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			//k񂵂_uAׂꂽOp`菜
+			size_t n = 0;
+			for (size_t t = 0; t < triangleCount; ++t)
+			{
+				const GLuint a = remap[result[t * 3]];
+				const GLuint b = remap[result[t * 3 + 1]];
+				const GLuint c = remap[result[t * 3 + 2]];
+				if (a == b || b == c || c == a)
+				{
+					continue;
+				}
+				result[n++] = a;
+				result[n++] = b;
+				result[n++] = c;
+			}
+			result.resize(n);
+		}
+		return (float)sqrt(maxError);
+	}
+
+}//namespace MeshOptimizer
@@ -0,0 +1,35 @@
+/**
+* @file MeshOptimizer.h
+*/
+#ifndef MESHOPTIMIZER_H_INCLUDED
+#define MESHOPTIMIZER_H_INCLUDED
+#include <GL/glew.h>
+#include "Geometry.h"
+#include <vector>
+
+//bV̕`グ邽߂̊֐i[閼O
+namespace MeshOptimizer {
+
+/**
+* _LbV̌
+*/
+	struct CacheStatistics
+	{
+		float acmr;//Op`1̒_VF[_[s(0.5`3.0, قǗǂ)
+		float atvr;//_1̒_VF[_[s(1.0ȏ, قǗǂ)
+	};
+
+	CacheStatistics AnalyzeVertexCache(const std::vector<GLuint>& indices,
+		size_t vertexCount, size_t cacheSize = 16);
+	size_t RemoveDegenerateTriangles(std::vector<GLuint>& indices,
+		const std::vector<Vertex>& vertices);
+	size_t RemoveDuplicateTriangles(std::vector<GLuint>& indices);
+	void OptimizeVertexCache(std::vector<GLuint>& indices, size_t vertexCount);
+	void OptimizeOverdraw(std::vector<GLuint>& indices,
+		const std::vector<Vertex>& vertices, float threshold = 1.05f);
+	void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<GLuint>& indices);
+	float Simplify(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices,
+		size_t targetIndexCount, std::vector<GLuint>& result);
+
+}//namespace MeshOptimizer
+#endif //MESHOPTIMIZER_H_INCLUDED
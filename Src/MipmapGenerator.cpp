@@ -0,0 +1,432 @@
+/**
+* @file MipmapGenerator.cpp
+*/
+#include "MipmapGenerator.h"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define MIPMAPGENERATOR_USE_SSE
+#include <emmintrin.h>
+#endif
+
+//CPUŃ~bv}bv쐬֐i[閼O
+namespace MipmapGenerator {
+
+	//`Ԃ̒lsRGB֕ϊ\̗vf
+	const int linearTableSize = 16384;
+
+/**
+* FԂ̕ϊ\
+*/
+	struct ColorTable
+	{
+		float srgbToLinear[256];//sRGB8rbgl -> `Ԃ̒l
+		float unormToFloat[256];//8rbgl -> 0.0`1.0(At@ȂǐFłȂlp)
+		uint8_t linearToSrgb[linearTableSize];//`Ԃ̒l -> sRGB8rbgl
+	};
+
+/**
+* FԂ̕ϊ\쐬
+*
+* @return 쐬ϊ\
+*/
+	ColorTable MakeColorTable()
+	{
+		ColorTable table;
+		for (int i = 0; i < 256; ++i)
+		{
+			const float c = i / 255.0f;
+			table.srgbToLinear[i] =
+				c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+			table.unormToFloat[i] = c;
+		}
+		for (int i = 0; i < linearTableSize; ++i)
+		{
+			const float l = i / static_cast<float>(linearTableSize - 1);
+			const float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+			table.linearToSrgb[i] = static_cast<uint8_t>(std::min(c * 255.0f + 0.5f, 255.0f));
+		}
+		return table;
+	}
+
+/**
+* FԂ̕ϊ\擾
+*
+* @return ϊ\
+*
+* ŏɌĂ΂ꂽƂɍ쐬(̃XbhĂł1񂾂쐬)
+*/
+	const ColorTable& GetColorTable()
+	{
+		static const ColorTable table = MakeColorTable();
+		return table;
+	}
+
+/**
+* k1fQƂkỎfƏd
+*
+* kȎ傫̏ꍇAk1fkỎf3܂ŕƂ
+*/
+	struct Tap
+	{
+		int first;//ŏ̉f̔ԍ
+		int count;//QƂf(1`3)
+		float weights[3];//ef̏d(ʐς̊)
+	};
+
+/**
+* 1̏kɎgQƉf̈ꗗ쐬
+*
+* @param srcSize kỎf
+* @param dstSize k̉f
+*
+* @return k̉fƂ̎QƉf
+*
+* k̉f͈͂ƏkỎf̏dȂd݂Ƃ(ʐϕς̃{bNX tB^).
+* kȎ傫ȂAP2f̕ςɂȂ
+*/
+	std::vector<Tap> MakeTaps(int srcSize, int dstSize)
+	{
+		std::vector<Tap> taps(dstSize);
+		const double ratio = static_cast<double>(srcSize) / dstSize;
+		for (int i = 0; i < dstSize; ++i)
+		{
+			const double begin = i * ratio;
+			const double end = (i + 1) * ratio;
+			Tap& tap = taps[i];
+			tap.first = static_cast<int>(begin);
+			const int last = std::min(srcSize - 1, static_cast<int>(ceil(end)) - 1);
+			tap.count = std::min(last - tap.first + 1, 3);
+			for (int k = 0; k < 3; ++k)
+			{
+				tap.weights[k] = 0;
+			}
+			for (int k = 0; k < tap.count; ++k)
+			{
+				const double overlap = std::min(end, tap.first + k + 1.0) - std::max(begin, tap.first + k + 0.0);
+				tap.weights[k] = static_cast<float>(overlap / ratio);
+			}
+		}
+		return taps;
+	}
+
+/**
+* zɕʂ̔z̒萔{Z
+*
+* @param dst    Z
+* @param src    Zl
+* @param weight {
+* @param count  vf
+*/
+	void AddScaled(float* dst, const float* src, float weight, size_t count)
+	{
+		size_t i = 0;
+#if defined(MIPMAPGENERATOR_USE_SSE)
+		const __m128 w = _mm_set1_ps(weight);
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128 d = _mm_loadu_ps(dst + i);
+			const __m128 s = _mm_loadu_ps(src + i);
+			_mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, w)));
+		}
+#endif
+		for (; i < count; ++i)
+		{
+			dst[i] += src[i] * weight;
+		}
+	}
+
+/**
+* 1s̉fɏk
+*
+* @param src      kO̍s(`)
+* @param dst      k̍s̊i[
+* @param taps     k̉fƂ̎QƉf
+* @param channels 1f̗vf(1܂4)
+*/
+	void FilterRow(const float* src, float* dst, const std::vector<Tap>& taps, int channels)
+	{
+#if defined(MIPMAPGENERATOR_USE_SSE)
+		if (channels == 4)
+		{
+			//RGBA4vf܂Ƃ߂ČvZ
+			for (const Tap& tap : taps)
+			{
+				const float* s = src + tap.first * 4;
+				__m128 sum = _mm_mul_ps(_mm_loadu_ps(s), _mm_set1_ps(tap.weights[0]));
+				for (int k = 1; k < tap.count; ++k)
+				{
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s + k * 4), _mm_set1_ps(tap.weights[k])));
+				}
+				_mm_storeu_ps(dst, sum);
+				dst += 4;
+			}
+			return;
+		}
+#endif
+		for (const Tap& tap : taps)
+		{
+			for (int c = 0; c < channels; ++c)
+			{
+				float sum = 0;
+				for (int k = 0; k < tap.count; ++k)
+				{
+					sum += src[(tap.first + k) * channels + c] * tap.weights[k];
+				}
+				*dst++ = sum;
+			}
+		}
+	}
+
+/**
+* ~bv}bv̒i߂
+*
+* @param width  ł傫i̕
+* @param height ł傫i̍
+*
+* @return 1x1ɂȂ܂ł̒i(ł傫i܂)
+*/
+	GLsizei GetLevelCount(GLsizei width, GLsizei height)
+	{
+		GLsizei size = std::max(width, height);
+		GLsizei count = 1;
+		while (size > 1)
+		{
+			size /= 2;
+			++count;
+		}
+		return count;
+	}
+
+/**
+* 摜c1/2ɏk
+*
+* @param src    k摜
+* @param dst    k摜̊i[
+* @param isSrgb FsRGBƂĈȂtrue(At@͏ɐ`ƂĈ)
+*
+* @retval true  k
+* @retval false ΉĂȂf`
+*
+* sRGB̉摜͐`Ԃɖ߂Ă畽ς邱ƂŁAkɈÂȂ邱Ƃh.
+* 傫̏ꍇ͖ʐςŏdݕtāA摜Ȃ悤ɂ.
+* OpenGL̊֐gȂ̂ŁAGPUȂœmFł
+*/
+	bool Downsample(const Texture::ImageData& src, Texture::ImageData& dst, bool isSrgb)
+	{
+		if (src.type != GL_UNSIGNED_BYTE || (src.format != GL_RGBA && src.format != GL_RED) ||
+			src.width <= 0 || src.height <= 0)
+		{
+			return false;
+		}
+		const int channels = src.format == GL_RGBA ? 4 : 1;
+		const ColorTable& table = GetColorTable();
+
+		dst.width = std::max(1, src.width / 2);
+		dst.height = std::max(1, src.height / 2);
+		dst.format = src.format;
+		dst.type = src.type;
+		dst.data.resize(static_cast<size_t>(dst.width) * dst.height * channels);
+
+		//vfƂ̕ϊ\(RGBAA͏ɐ`ƂĈ)
+		const float* toFloat[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			toFloat[c] = isSrgb && c < 3 ? table.srgbToLinear : table.unormToFloat;
+		}
+
+		const std::vector<Tap> xTaps = MakeTaps(src.width, dst.width);
+		const std::vector<Tap> yTaps = MakeTaps(src.height, dst.height);
+		const size_t srcLineCount = static_cast<size_t>(src.width) * channels;
+		const size_t dstLineCount = static_cast<size_t>(dst.width) * channels;
+		std::vector<float> srcLine(srcLineCount);
+		std::vector<float> column(srcLineCount);
+		std::vector<float> dstLine(dstLineCount);
+
+		uint8_t* out = dst.data.data();
+		for (const Tap& yTap : yTaps)
+		{
+			//cɏkĂAɏk
+			std::fill(column.begin(), column.end(), 0.0f);
+			for (int k = 0; k < yTap.count; ++k)
+			{
+				const uint8_t* line = src.data.data() + (yTap.first + k) * srcLineCount;
+				for (size_t i = 0; i < srcLineCount; i += channels)
+				{
+					for (int c = 0; c < channels; ++c)
+					{
+						srcLine[i + c] = toFloat[c][line[i + c]];
+					}
+				}
+				AddScaled(column.data(), srcLine.data(), yTap.weights[k], srcLineCount);
+			}
+			FilterRow(column.data(), dstLine.data(), xTaps, channels);
+
+			//8rbglɖ߂
+			size_t i = 0;
+#if defined(MIPMAPGENERATOR_USE_SSE)
+			if (channels == 4)
+			{
+				//RGB͕ϊ\̔ԍAA8rbgl4vf܂Ƃ߂ċ߂
+				const float maxIndex = static_cast<float>(linearTableSize - 1);
+				const __m128 scale = isSrgb ?
+					_mm_setr_ps(maxIndex, maxIndex, maxIndex, 255.0f) : _mm_set1_ps(255.0f);
+				const __m128 upper = _mm_setr_ps(
+					isSrgb ? maxIndex : 255.0f, isSrgb ? maxIndex : 255.0f, isSrgb ? maxIndex : 255.0f, 255.0f);
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 half = _mm_set1_ps(0.5f);
+				for (; i < dstLineCount; i += 4, out += 4)
+				{
+					__m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&dstLine[i]), scale), half);
+					v = _mm_min_ps(_mm_max_ps(v, zero), upper);
+					alignas(16) int32_t n[4];
+					_mm_store_si128(reinterpret_cast<__m128i*>(n), _mm_cvttps_epi32(v));
+					for (int c = 0; c < 3; ++c)
+					{
+						out[c] = isSrgb ? table.linearToSrgb[n[c]] : static_cast<uint8_t>(n[c]);
+					}
+					out[3] = static_cast<uint8_t>(n[3]);
+				}
+			}
+#endif
+			for (; i < dstLineCount; ++i, ++out)
+			{
+				const float v = std::min(std::max(dstLine[i], 0.0f), 1.0f);
+				if (isSrgb && (i % channels) < 3)
+				{
+					*out = table.linearToSrgb[static_cast<int>(v * (linearTableSize - 1) + 0.5f)];
+				}
+				else
+				{
+					*out = static_cast<uint8_t>(v * 255.0f + 0.5f);
+				}
+			}
+		}
+		return true;
+	}
+
+/**
+* 1x1ɂȂ܂ł̃~bv}bv쐬
+*
+* @param image     ł傫ỉ摜
+* @param mipLevels 쐬~bv}bv̊i[(2iڈȍ~)
+* @param isSrgb    FsRGBƂĈȂtrue
+*
+* @retval true  쐬
+* @retval false ΉĂȂf`
+*
+* ei1̒ikč쐬
+*/
+	bool Generate(const Texture::ImageData& image,
+		std::vector<Texture::ImageData>& mipLevels, bool isSrgb)
+	{
+		const GLsizei levelCount = GetLevelCount(image.width, image.height);
+		mipLevels.resize(levelCount - 1);
+		const Texture::ImageData* src = &image;
+		for (Texture::ImageData& dst : mipLevels)
+		{
+			if (!Downsample(*src, dst, isSrgb))
+			{
+				mipLevels.clear();
+				return false;
+			}
+			src = &dst;
+		}
+		return true;
+	}
+
+/**
+* 摜Cӂ̑傫ɊgEk
+*
+* @param src    ̉摜
+* @param width  ύX̕
+* @param height ύX̍
+* @param dst    ύX摜̊i[
+* @param isSrgb FsRGBƂĈȂtrue
+*
+* @retval true  ύX
+* @retval false ΉĂȂf`
+*
+* o`Ԃő傫ς. 1/2ȉɏkꍇ́A
+* ܂ԂGhߐDownsampleŋ߂傫܂ŏkĂ
+*/
+	bool Resize(const Texture::ImageData& src, GLsizei width, GLsizei height,
+		Texture::ImageData& dst, bool isSrgb)
+	{
+		if (src.type != GL_UNSIGNED_BYTE || (src.format != GL_RGBA && src.format != GL_RED) ||
+			src.width <= 0 || src.height <= 0 || width <= 0 || height <= 0)
+		{
+			return false;
+		}
+		Texture::ImageData reduced;
+		const Texture::ImageData* image = &src;
+		while (image->width >= width * 2 && image->height >= height * 2)
+		{
+			Texture::ImageData tmp;
+			if (!Downsample(*image, tmp, isSrgb))
+			{
+				return false;
+			}
+			reduced = std::move(tmp);
+			image = &reduced;
+		}
+
+		const int channels = src.format == GL_RGBA ? 4 : 1;
+		const ColorTable& table = GetColorTable();
+		const auto isColor = [isSrgb](int c) { return isSrgb && c < 3; };
+
+		//1̕ԂɎg2fƏd݂߂
+		struct Sample
+		{
+			int i0;
+			int i1;
+			float t;
+		};
+		const auto makeSamples = [](int srcSize, int dstSize) {
+			std::vector<Sample> samples(dstSize);
+			const float ratio = static_cast<float>(srcSize) / dstSize;
+			for (int i = 0; i < dstSize; ++i)
+			{
+				const float s = std::min(std::max((i + 0.5f) * ratio - 0.5f, 0.0f),
+					static_cast<float>(srcSize - 1));
+				samples[i].i0 = static_cast<int>(s);
+				samples[i].i1 = std::min(samples[i].i0 + 1, srcSize - 1);
+				samples[i].t = s - samples[i].i0;
+			}
+			return samples;
+		};
+		const std::vector<Sample> xSamples = makeSamples(image->width, width);
+		const std::vector<Sample> ySamples = makeSamples(image->height, height);
+
+		dst.width = width;
+		dst.height = height;
+		dst.format = src.format;
+		dst.type = src.type;
+		dst.data.resize(static_cast<size_t>(width) * height * channels);
+		uint8_t* out = dst.data.data();
+		for (const Sample& ys : ySamples)
+		{
+			const uint8_t* line0 = image->data.data() + static_cast<size_t>(ys.i0) * image->width * channels;
+			const uint8_t* line1 = image->data.data() + static_cast<size_t>(ys.i1) * image->width * channels;
+			for (const Sample& xs : xSamples)
+			{
+				for (int c = 0; c < channels; ++c, ++out)
+				{
+					const float* toFloat = isColor(c) ? table.srgbToLinear : table.unormToFloat;
+					const float top = toFloat[line0[xs.i0 * channels + c]] * (1 - xs.t) +
+						toFloat[line0[xs.i1 * channels + c]] * xs.t;
+					const float bottom = toFloat[line1[xs.i0 * channels + c]] * (1 - xs.t) +
+						toFloat[line1[xs.i1 * channels + c]] * xs.t;
+					const float v = std::min(std::max(top * (1 - ys.t) + bottom * ys.t, 0.0f), 1.0f);
+					*out = isColor(c) ?
+						table.linearToSrgb[static_cast<int>(v * (linearTableSize - 1) + 0.5f)] :
+						static_cast<uint8_t>(v * 255.0f + 0.5f);
+				}
+			}
+		}
+		return true;
+	}
+
+}//namespace MipmapGenerator
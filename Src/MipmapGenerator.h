@@ -0,0 +1,20 @@
+/**
+* @file MipmapGenerator.h
+*/
+#ifndef MIPMAPGENERATOR_H_INCLUDED
+#define MIPMAPGENERATOR_H_INCLUDED
+#include "Texture.h"
+#include <vector>
+
+//CPUŃ~bv}bv쐬֐i[閼O
+namespace MipmapGenerator {
+
+	GLsizei GetLevelCount(GLsizei width, GLsizei height);
+	bool Downsample(const Texture::ImageData& src, Texture::ImageData& dst, bool isSrgb);
+	bool Generate(const Texture::ImageData& image,
+		std::vector<Texture::ImageData>& mipLevels, bool isSrgb = true);
+	bool Resize(const Texture::ImageData& src, GLsizei width, GLsizei height,
+		Texture::ImageData& dst, bool isSrgb = true);
+
+}//namespace MipmapGenerator
+#endif //MIPMAPGENERATOR_H_INCLUDED
@@ -0,0 +1,697 @@
+/**
+* @file OcclusionCuller.cpp
+*/
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <iostream>
+#include <float.h>
+#include <math.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define OCCLUSIONCULLER_USE_SSE
+#include <emmintrin.h>
+#endif
+
+//Օ`Xbh̍ő吔(Ȑ[xobt@Ȃ̂ŁAĂȂȂ)
+const int occlusionMaxThreadCount = 4;
+
+//肷{bNX̐[xOɂ炷.
+//Օ̐[x͕ʂ̎狁߂̂ŁAʂłۂߌ덷Œ_̐[xOɂȂ邱Ƃ
+const float occlusionDepthBias = 1.0e-5f;
+
+//E{bNX̎Op`(8_̔ԍ. rbg0xArbg1yArbg2z̍ő呤\).
+//O猩Ĕv
+const uint32_t occluderBoxIndices[] = {
+	0, 4, 6, 0, 6, 2, 1, 3, 7, 1, 7, 5,
+	0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3,
+	0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6,
+};
+
+/**
+* fXgN^
+*/
+OcclusionCuller::~OcclusionCuller()
+{
+	Destroy();
+}
+
+/**
+* SIMD߂ŕ`Ɣ邩ǂ擾
+*
+* @retval true  4sNZSSE߂ŏ
+* @retval false SIMD߂gȂ
+*/
+bool OcclusionCuller::IsSimdEnabled()
+{
+#if defined(OCCLUSIONCULLER_USE_SSE)
+	return true;
+#else
+	return false;
+#endif
+}
+
+/**
+* [xobt@쐬A[J[XbhN
+*
+* @param width       [xobt@̕(blockSize̔{)
+* @param height      [xobt@̍(blockSize̔{)
+* @param threadCount `ɎgXbh(ĂяõXbh܂. 0Ȃ玩)
+*
+* @retval true  
+* @retval false 傫s
+*/
+bool OcclusionCuller::Init(int width, int height, int threadCount)
+{
+	Destroy();
+	if (width <= 0 || height <= 0 || width % blockSize != 0 || height % blockSize != 0)
+	{
+		std::cerr << "ERROR: Օ̐[xobt@̑傫(" << width << "x" << height <<
+			")" << blockSize << "̔{łȂ΂Ȃ܂\n";
+		return false;
+	}
+	this->width = width;
+	this->height = height;
+	blockCountX = width / blockSize;
+	blockCountY = height / blockSize;
+	depthBuffer.assign(width * height, 1.0f);
+	blockDepths.assign(blockCountX * blockCountY, 1.0f);
+
+	if (threadCount <= 0)
+	{
+		threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	}
+	threadCount = std::max(1, std::min({ threadCount, occlusionMaxThreadCount, blockCountY }));
+
+	//т̋EubN̋Eƈv悤ɁAт̍̓ubN̍̔{ɂ
+	const int blockRowsPerBand = (blockCountY + threadCount - 1) / threadCount;
+	bandHeight = blockRowsPerBand * blockSize;
+	bandCount = (blockCountY + blockRowsPerBand - 1) / blockRowsPerBand;
+
+	//擪̑т͌ĂяõXbhŕ`
+	isStopping = false;
+	jobSerial = 0;
+	for (int i = 1; i < bandCount; ++i)
+	{
+		workers.emplace_back(&OcclusionCuller::WorkerMain, this, i);
+	}
+	isRasterized = false;
+	return true;
+}
+
+/**
+* [J[Xbh~A[xobt@j
+*/
+void OcclusionCuller::Destroy()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	cvStart.notify_all();
+	for (auto& e : workers)
+	{
+		e.join();
+	}
+	workers.clear();
+	depthBuffer.clear();
+	blockDepths.clear();
+	triangles.clear();
+	width = height = 0;
+	blockCountX = blockCountY = 0;
+	bandCount = bandHeight = 0;
+	isRasterized = false;
+}
+
+/**
+* Vt[Jn
+*
+* @param matVP r[ vWFNVs
+*
+* Õt[̎Օ͍폜. Wvt[̌ʂ́AGetFrameStatisticsŎ擾ł悤ɂȂ
+*/
+void OcclusionCuller::BeginFrame(const glm::mat4& matVP)
+{
+	this->matVP = matVP;
+	triangles.clear();
+	isRasterized = false;
+
+	lastFrame = frame;
+	lastFrame.frameCount = 1;
+	++total.frameCount;
+	frame = {};
+}
+
+/**
+* Օǉ
+*
+* @param positions     _W̔z
+* @param indices       Op`Ƃ3̒_ԍׂz
+* @param triangleCount Op`̐
+* @param matModel      fs
+*
+* Օ͌Ă镔Sċl܂Ă邱(Ԃ┼̕Ă͂ȂȂ).
+* _W̐indices̍ől+1ȏł邱. ʂ͕`Ȃ
+*/
+void OcclusionCuller::AddOccluder(const glm::vec3* positions, const uint32_t* indices,
+	size_t triangleCount, const glm::mat4& matModel)
+{
+	if (depthBuffer.empty() || triangleCount == 0)
+	{
+		return;
+	}
+	uint32_t vertexCount = 0;
+	for (size_t i = 0; i < triangleCount * 3; ++i)
+	{
+		vertexCount = std::max(vertexCount, indices[i] + 1);
+	}
+	const glm::mat4 matMVP = matVP * matModel;
+	clipPositions.resize(vertexCount);
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		clipPositions[i] = matMVP * glm::vec4(positions[i], 1);
+	}
+	for (size_t i = 0; i < triangleCount; ++i)
+	{
+		AddClipTriangle(clipPositions[indices[i * 3]],
+			clipPositions[indices[i * 3 + 1]], clipPositions[indices[i * 3 + 2]]);
+	}
+}
+
+/**
+* ̂̎Օǉ
+*
+* @param min [hWn̍ŏW
+* @param max [hWn̍őW
+*
+* g̋l܂ǂ⌚̂悤ȁAE{bNXƂقړ`̂̕Ɏg
+*/
+void OcclusionCuller::AddOccluderBox(const glm::vec3& min, const glm::vec3& max)
+{
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; ++i)
+	{
+		corners[i] = glm::vec3(i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z);
+	}
+	AddOccluder(corners, occluderBoxIndices,
+		sizeof(occluderBoxIndices) / sizeof(occluderBoxIndices[0]) / 3, glm::mat4(1));
+}
+
+/**
+* NbvWn̎Op`A߃NbvʂŐ؂Ăǉ
+*
+* @param a _1
+* @param b _2
+* @param c _3
+*
+* ߃NbvʂO̒_w0ȉɂȂ蓾̂ŁAʍWnɕϊOɐ؂.
+* ؂p`͍ő4_ɂȂ̂ŁA2̎Op`ɕ
+*/
+void OcclusionCuller::AddClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+	const glm::vec4 input[3] = { a, b, c };
+	glm::vec4 polygon[4];
+	int count = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		//߃Nbvʂ z = -w. ł z + w >= 0 ɂȂ
+		const glm::vec4& p = input[i];
+		const glm::vec4& q = input[(i + 1) % 3];
+		const float dp = p.z + p.w;
+		const float dq = q.z + q.w;
+		if (dp >= 0)
+		{
+			polygon[count++] = p;
+		}
+		if ((dp >= 0) != (dq >= 0))
+		{
+			const float t = dp / (dp - dq);
+			polygon[count++] = p + (q - p) * t;
+		}
+	}
+	if (count < 3)
+	{
+		return;
+	}
+
+	glm::vec3 screen[4];
+	for (int i = 0; i < count; ++i)
+	{
+		const glm::vec4& p = polygon[i];
+		if (!(p.w > 0))
+		{
+			return;//߃Nbvʏ w=0 ɂȂ鐳ˉeȊO̍sɂ͑ΉȂ
+		}
+		const float invW = 1.0f / p.w;
+		screen[i] = glm::vec3((p.x * invW * 0.5f + 0.5f) * width,
+			(p.y * invW * 0.5f + 0.5f) * height, p.z * invW * 0.5f + 0.5f);
+	}
+	AddScreenTriangle(screen[0], screen[1], screen[2]);
+	if (count == 4)
+	{
+		AddScreenTriangle(screen[0], screen[2], screen[3]);
+	}
+}
+
+/**
+* ʍWn̎Op`̕ӂƐ[x̎߂Ēǉ
+*
+* @param a _1(x, y=sNZW, z=[x)
+* @param b _2
+* @param c _3
+*
+* (v)̎Op`ƁAʐς0̎Op`͒ǉȂ
+*/
+void OcclusionCuller::AddScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+	const float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+	if (!(area > 0))
+	{
+		return;
+	}
+	const float minX = std::min({ a.x, b.x, c.x });
+	const float maxX = std::max({ a.x, b.x, c.x });
+	const float minY = std::min({ a.y, b.y, c.y });
+	const float maxY = std::max({ a.y, b.y, c.y });
+	if (maxX < 0 || maxY < 0 || minX > width || minY > height)
+	{
+		return;
+	}
+
+	//ӂ̎́Ae_̌̕ӂɂċ߂. 3̒l̘a͖ʐςɂȂ
+	Triangle tri;
+	const glm::vec3* v[3] = { &a, &b, &c };
+	float depthA = 0, depthB = 0, depthC = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const glm::vec3& p = *v[(i + 1) % 3];
+		const glm::vec3& q = *v[(i + 2) % 3];
+		tri.edgeA[i] = p.y - q.y;
+		tri.edgeB[i] = q.x - p.x;
+		tri.edgeC[i] = p.x * q.y - p.y * q.x;
+		depthA += tri.edgeA[i] * v[i]->z;
+		depthB += tri.edgeB[i] * v[i]->z;
+		depthC += tri.edgeC[i] * v[i]->z;
+	}
+	tri.depthA = depthA / area;
+	tri.depthB = depthB / area;
+	tri.depthC = depthC / area;
+	tri.minX = std::max(0, static_cast<int>(floorf(minX)));
+	tri.maxX = std::min(width - 1, static_cast<int>(ceilf(maxX)));
+	tri.minY = std::max(0, static_cast<int>(floorf(minY)));
+	tri.maxY = std::min(height - 1, static_cast<int>(ceilf(maxY)));
+	triangles.push_back(tri);
+	++frame.occluderTriangleCount;
+	++total.occluderTriangleCount;
+}
+
+/**
+* ǉՕ[xobt@ɕ`
+*
+* тƂɃ[J[Xbhŕ`ASĂ̑тI܂ő҂
+*/
+void OcclusionCuller::Rasterize()
+{
+	RunBands(true);
+}
+
+/**
+* ǉՕASIMD߂g킸ɐ[xobt@ɕ`
+*
+* ʂRasterizeƊSɈv
+*/
+void OcclusionCuller::RasterizeScalar()
+{
+	RunBands(false);
+}
+
+/**
+* SĂ̑т`
+*
+* @param useSimd SIMD߂gǂ
+*/
+void OcclusionCuller::RunBands(bool useSimd)
+{
+	if (depthBuffer.empty())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isJobSimd = useSimd;
+		finishedCount = 0;
+		++jobSerial;
+	}
+	cvStart.notify_all();
+	RasterizeBand(0, useSimd);
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		cvFinished.wait(lock, [this] { return finishedCount == static_cast<int>(workers.size()); });
+	}
+	isRasterized = true;
+}
+
+/**
+* [J[Xbh̏
+*
+* @param band Sт̔ԍ
+*/
+void OcclusionCuller::WorkerMain(int band)
+{
+	uint64_t doneSerial = 0;
+	for (;;)
+	{
+		bool useSimd;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cvStart.wait(lock, [this, doneSerial] { return isStopping || jobSerial != doneSerial; });
+			if (isStopping)
+			{
+				return;
+			}
+			doneSerial = jobSerial;
+			useSimd = isJobSimd;
+		}
+		RasterizeBand(band, useSimd);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			++finishedCount;
+		}
+		cvFinished.notify_one();
+	}
+}
+
+/**
+* 1̑тɎՕ`AubNƂ̍ł̐[x߂
+*
+* @param band    т̔ԍ
+* @param useSimd SIMD߂gǂ
+*
+* sNZ̒SOp`̓(ӏ܂)ɂ΁AO̐[xŏ㏑.
+* 4sNZPʂŏ̂ŁASIMDłƃXJ[ł͓sNZɓvZ
+*/
+void OcclusionCuller::RasterizeBand(int band, bool useSimd)
+{
+	const int bandMinY = band * bandHeight;
+	const int bandMaxY = std::min(height, bandMinY + bandHeight) - 1;
+	std::fill(depthBuffer.begin() + bandMinY * width,
+		depthBuffer.begin() + (bandMaxY + 1) * width, 1.0f);
+
+	for (const Triangle& tri : triangles)
+	{
+		const int minY = std::max(tri.minY, bandMinY);
+		const int maxY = std::min(tri.maxY, bandMaxY);
+		const int minX = tri.minX & ~3;
+		for (int y = minY; y <= maxY; ++y)
+		{
+			const float fy = static_cast<float>(y) + 0.5f;
+			float rowEdge[3];
+			for (int i = 0; i < 3; ++i)
+			{
+				rowEdge[i] = tri.edgeB[i] * fy + tri.edgeC[i];
+			}
+			const float rowDepth = tri.depthB * fy + tri.depthC;
+			float* row = &depthBuffer[y * width];
+#if defined(OCCLUSIONCULLER_USE_SSE)
+			if (useSimd)
+			{
+				const __m128 offset = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 edgeA0 = _mm_set1_ps(tri.edgeA[0]);
+				const __m128 edgeA1 = _mm_set1_ps(tri.edgeA[1]);
+				const __m128 edgeA2 = _mm_set1_ps(tri.edgeA[2]);
+				const __m128 rowEdge0 = _mm_set1_ps(rowEdge[0]);
+				const __m128 rowEdge1 = _mm_set1_ps(rowEdge[1]);
+				const __m128 rowEdge2 = _mm_set1_ps(rowEdge[2]);
+				const __m128 depthA = _mm_set1_ps(tri.depthA);
+				const __m128 rowDepth4 = _mm_set1_ps(rowDepth);
+				for (int x = minX; x <= tri.maxX; x += 4)
+				{
+					const __m128 fx = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offset);
+					const __m128 e0 = _mm_add_ps(_mm_mul_ps(edgeA0, fx), rowEdge0);
+					const __m128 e1 = _mm_add_ps(_mm_mul_ps(edgeA1, fx), rowEdge1);
+					const __m128 e2 = _mm_add_ps(_mm_mul_ps(edgeA2, fx), rowEdge2);
+					const __m128 inside = _mm_and_ps(_mm_and_ps(
+						_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+					if (_mm_movemask_ps(inside) == 0)
+					{
+						continue;
+					}
+					const __m128 depth = _mm_add_ps(_mm_mul_ps(depthA, fx), rowDepth4);
+					const __m128 old = _mm_loadu_ps(row + x);
+					const __m128 nearer = _mm_min_ps(depth, old);//std::min(old, depth)ƓIѕ
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+				}
+				continue;
+			}
+#endif
+			for (int x = minX; x <= tri.maxX; x += 4)
+			{
+				for (int k = 0; k < 4; ++k)
+				{
+					const float fx = static_cast<float>(x) + (static_cast<float>(k) + 0.5f);
+					if (tri.edgeA[0] * fx + rowEdge[0] >= 0 && tri.edgeA[1] * fx + rowEdge[1] >= 0 &&
+						tri.edgeA[2] * fx + rowEdge[2] >= 0)
+					{
+						const float depth = tri.depthA * fx + rowDepth;
+						row[x + k] = std::min(row[x + k], depth);
+					}
+				}
+			}
+		}
+	}
+
+	//ubNƂɍł̐[x߂
+	for (int by = bandMinY / blockSize; by <= bandMaxY / blockSize; ++by)
+	{
+		for (int bx = 0; bx < blockCountX; ++bx)
+		{
+			const float* p = &depthBuffer[by * blockSize * width + bx * blockSize];
+			float farthest = 0;
+#if defined(OCCLUSIONCULLER_USE_SSE)
+			if (useSimd)
+			{
+				__m128 m = _mm_setzero_ps();
+				for (int y = 0; y < blockSize; ++y, p += width)
+				{
+					m = _mm_max_ps(m, _mm_max_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 4)));
+				}
+				m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+				m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+				blockDepths[by * blockCountX + bx] = _mm_cvtss_f32(m);
+				continue;
+			}
+#endif
+			for (int y = 0; y < blockSize; ++y, p += width)
+			{
+				for (int x = 0; x < blockSize; ++x)
+				{
+					farthest = std::max(farthest, p[x]);
+				}
+			}
+			blockDepths[by * blockCountX + bx] = farthest;
+		}
+	}
+}
+
+/**
+* E{bNX\邩ׂ
+*
+* @param min [hWn̍ŏW
+* @param max [hWn̍őW
+*
+* @retval true  \
+* @retval false ՕɊSɉBĂA܂͉ʊOɂ
+*
+* {bNX̍łO̐[xƁAʏŃ{bNX͂ޔ͈͂̐[xׂ.
+* ܂ubNƂ̍ł̐[xŔׁA܂ȂubNsNZƂɔׂ
+*/
+bool OcclusionCuller::IsBoxVisible(const glm::vec3& min, const glm::vec3& max) const
+{
+	if (!isRasterized)
+	{
+		return true;
+	}
+
+	//8_ʍWnɕϊ. ߃NbvʂO̒_΁ABĂƂ͌Ȃ
+	float minX = FLT_MAX, maxX = -FLT_MAX, minY = FLT_MAX, maxY = -FLT_MAX;
+	float nearest = FLT_MAX;
+	for (int i = 0; i < 8; ++i)
+	{
+		const glm::vec4 p = matVP * glm::vec4(i & 1 ? max.x : min.x,
+			i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1);
+		if (!(p.z + p.w > 0) || !(p.w > 0))
+		{
+			return true;
+		}
+		const float invW = 1.0f / p.w;
+		const float x = (p.x * invW * 0.5f + 0.5f) * width;
+		const float y = (p.y * invW * 0.5f + 0.5f) * height;
+		minX = std::min(minX, x);
+		maxX = std::max(maxX, x);
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+		nearest = std::min(nearest, p.z * invW * 0.5f + 0.5f);
+	}
+	nearest -= occlusionDepthBias;
+	if (maxX < 0 || maxY < 0 || minX >= width || minY >= height)
+	{
+		return false;
+	}
+
+	//Օ̓sNZ̒Sŕ`̂ŁAsNZ̒[ł͍ő0.5sNZLǂČ.
+	//{bNX͈̔͂͂1sNZLƁAǂĂȂ܂ރsNZKׂ
+	const int x0 = std::max(0, static_cast<int>(floorf(minX)) - 1);
+	const int x1 = std::min(width - 1, static_cast<int>(floorf(maxX)) + 1);
+	const int y0 = std::max(0, static_cast<int>(floorf(minY)) - 1);
+	const int y1 = std::min(height - 1, static_cast<int>(floorf(maxY)) + 1);
+
+	for (int by = y0 / blockSize; by <= y1 / blockSize; ++by)
+	{
+		for (int bx = x0 / blockSize; bx <= x1 / blockSize; ++bx)
+		{
+			if (blockDepths[by * blockCountX + bx] < nearest)
+			{
+				continue;//ubNŜ{bNXOōǂĂ
+			}
+
+			//ubNƃ{bNXdȂ͈͂̃sNZ𒲂ׂ
+			const int px0 = std::max(x0, bx * blockSize);
+			const int px1 = std::min(x1, bx * blockSize + blockSize - 1);
+			const int py0 = std::max(y0, by * blockSize);
+			const int py1 = std::min(y1, by * blockSize + blockSize - 1);
+#if defined(OCCLUSIONCULLER_USE_SSE)
+			//ubN8sNZ4sNZׁA͈͊ÕsNZ̓}XNŏ
+			const int blockX = bx * blockSize;
+			const __m128 nearest4 = _mm_set1_ps(nearest);
+			const __m128i lane = _mm_set_epi32(3, 2, 1, 0);
+			const __m128i rangeMin = _mm_set1_epi32(px0 - blockX - 1);
+			const __m128i rangeMax = _mm_set1_epi32(px1 - blockX + 1);
+			const __m128i lane4 = _mm_add_epi32(lane, _mm_set1_epi32(4));
+			const __m128 mask0 = _mm_castsi128_ps(_mm_and_si128(
+				_mm_cmpgt_epi32(lane, rangeMin), _mm_cmplt_epi32(lane, rangeMax)));
+			const __m128 mask1 = _mm_castsi128_ps(_mm_and_si128(
+				_mm_cmpgt_epi32(lane4, rangeMin), _mm_cmplt_epi32(lane4, rangeMax)));
+			for (int y = py0; y <= py1; ++y)
+			{
+				const float* row = &depthBuffer[y * width + blockX];
+				const __m128 visible0 = _mm_and_ps(mask0, _mm_cmpge_ps(_mm_loadu_ps(row), nearest4));
+				const __m128 visible1 = _mm_and_ps(mask1, _mm_cmpge_ps(_mm_loadu_ps(row + 4), nearest4));
+				if (_mm_movemask_ps(_mm_or_ps(visible0, visible1)))
+				{
+					return true;
+				}
+			}
+#else
+			for (int y = py0; y <= py1; ++y)
+			{
+				for (int x = px0; x <= px1; ++x)
+				{
+					if (depthBuffer[y * width + x] >= nearest)
+					{
+						return true;
+					}
+				}
+			}
+#endif
+		}
+	}
+	return false;
+}
+
+/**
+* E{bNX\邩ׂ
+*
+* @param min [hWn̍ŏW
+* @param max [hWn̍őW
+*
+* @retval true  \
+* @retval false ՕɊSɉBĂA܂͉ʊOɂ
+*
+* RasterizeĂԑÓAtrueԂ
+*/
+bool OcclusionCuller::TestBox(const glm::vec3& min, const glm::vec3& max)
+{
+	const bool isVisible = IsBoxVisible(min, max);
+	++frame.testedCount;
+	++total.testedCount;
+	if (!isVisible)
+	{
+		++frame.culledCount;
+		++total.culledCount;
+	}
+	return isVisible;
+}
+
+/**
+* ̂̔ԍ̔z񂩂ABĂ镨̂
+*
+* @param boxes          [hWn̋E{bNX̔z
+* @param visibleIndices 肷boxes̔ԍ̔z. \̂̂c
+*
+* @return \̂镨̂̐
+*
+* JǑʂnƂz肵Ă̂ŁAԂ͕ςȂ
+*/
+size_t OcclusionCuller::Cull(const std::vector<Aabb>& boxes, std::vector<uint32_t>& visibleIndices)
+{
+	const size_t testedCount = visibleIndices.size();
+	visibleIndices.erase(std::remove_if(visibleIndices.begin(), visibleIndices.end(),
+		[this, &boxes](uint32_t i) { return !IsBoxVisible(boxes[i].min, boxes[i].max); }),
+		visibleIndices.end());
+	const size_t culledCount = testedCount - visibleIndices.size();
+	frame.testedCount += testedCount;
+	frame.culledCount += culledCount;
+	total.testedCount += testedCount;
+	total.culledCount += culledCount;
+	return visibleIndices.size();
+}
+
+/**
+* [xobt@̕擾
+*
+* @return [xobt@̕(sNZ)
+*/
+int OcclusionCuller::Width() const
+{
+	return width;
+}
+
+/**
+* [xobt@̍擾
+*
+* @return [xobt@̍(sNZ)
+*/
+int OcclusionCuller::Height() const
+{
+	return height;
+}
+
+/**
+* [xobt@擾
+*
+* @return sNZƂ̐[x̔z(0=O, 1=. ̍s珇)
+*/
+const std::vector<float>& OcclusionCuller::DepthBuffer() const
+{
+	return depthBuffer;
+}
+
+/**
+* Õt[̔萔擾
+*
+* @return Õt[Ŕ肵̂̐
+*/
+OcclusionCuller::Statistics OcclusionCuller::GetFrameStatistics() const
+{
+	return lastFrame;
+}
+
+/**
+* ܂ł̔萔̍v擾
+*
+* @return 肵̂̐̍v
+*/
+OcclusionCuller::Statistics OcclusionCuller::GetTotalStatistics() const
+{
+	return total;
+}
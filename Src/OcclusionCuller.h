@@ -0,0 +1,115 @@
+/**
+* @file OcclusionCuller.h
+*/
+#ifndef OCCLUSIONCULLER_H_INCLUDED
+#define OCCLUSIONCULLER_H_INCLUDED
+#include "Bvh.h"
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+* CPUŕ`[xobt@gāAÔ̕ɉB镨̂`Ώۂ珜NX
+*
+* ՕɎw肵̂Ȑ[xobt@ɕ`A8x8sNZƂ̍ł̐[x߂Ă.
+* 肷镨̂̋E{bNXAʏŏdȂSẴsNZ̐[x艜ɂΉBĂ.
+* [xobt@͉̑тɕAтƂɃ[J[Xbhŕ`.
+* Օm̊ԂɂA[xobt@1sNZׂԂ͍ǂĂ̂Ƃ݂Ȃ
+*
+* g:
+* 1. t[BeginFrameŃr[ vWFNVsݒ肷
+* 2. AddOccluder܂AddOccluderBoxŎՕǉ
+* 3. RasterizeŎՕ[xobt@ɕ`
+* 4. Cull܂TestBoxŕ̂邩ׂ
+*/
+class OcclusionCuller
+{
+public:
+	//肵̂̐
+	struct Statistics
+	{
+		size_t occluderTriangleCount;//[xobt@ɕ`Op`̐
+		size_t testedCount;//肵
+		size_t culledCount;//BĂ̂ŏ
+		size_t frameCount;//Wvt[
+	};
+
+	static const int blockSize = 8;//ł̐[x߂ubN̕ƍ(sNZ)
+
+	OcclusionCuller() = default;
+	~OcclusionCuller();
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	static bool IsSimdEnabled();
+
+	bool Init(int width, int height, int threadCount = 0);
+	void Destroy();
+
+	void BeginFrame(const glm::mat4& matVP);
+	void AddOccluder(const glm::vec3* positions, const uint32_t* indices, size_t triangleCount,
+		const glm::mat4& matModel);
+	void AddOccluderBox(const glm::vec3& min, const glm::vec3& max);
+	void Rasterize();
+	void RasterizeScalar();
+
+	bool TestBox(const glm::vec3& min, const glm::vec3& max);
+	size_t Cull(const std::vector<Aabb>& boxes, std::vector<uint32_t>& visibleIndices);
+
+	int Width() const;
+	int Height() const;
+	const std::vector<float>& DepthBuffer() const;
+	Statistics GetFrameStatistics() const;
+	Statistics GetTotalStatistics() const;
+
+private:
+	//`̏Op`(ʍWnł̕ӂ̎Ɛ[x̕ʂ̎)
+	struct Triangle
+	{
+		float edgeA[3], edgeB[3], edgeC[3];//ӂ̓ A*x + B*y + C >= 0 ɂȂ
+		float depthA, depthB, depthC;//[x = A*x + B*y + C
+		int minX, maxX, minY, maxY;//`͈(sNZ)
+	};
+
+	void AddClipTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+	void AddScreenTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+	void RunBands(bool useSimd);
+	void RasterizeBand(int band, bool useSimd);
+	bool IsBoxVisible(const glm::vec3& min, const glm::vec3& max) const;
+	void WorkerMain(int band);
+
+	int width = 0;
+	int height = 0;
+	int blockCountX = 0;
+	int blockCountY = 0;
+	int bandCount = 0;//[xobt@𕪊т̐(=`悷Xbh̐)
+	int bandHeight = 0;//т̍(blockSize̔{)
+	glm::mat4 matVP = glm::mat4(1);
+	std::vector<float> depthBuffer;//sNZƂ̐[x(0=O, 1=. ̍s珇)
+	std::vector<float> blockDepths;//ubNƂ̍ł̐[x
+	std::vector<Triangle> triangles;//̃t[̎Օ̎Op`
+	std::vector<glm::vec4> clipPositions;//_NbvWnɕϊƗp̔z
+	bool isRasterized = false;//̃t[̎Օ[xobt@ɕ`ǂ
+
+	//[J[Xbh̏
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable cvStart;//т̕`Jn邱Ƃʒm
+	std::condition_variable cvFinished;//т̕`悪IƂʒm
+	uint64_t jobSerial = 0;//`v邽тɑ₷ԍ
+	int finishedCount = 0;//`̏I[J[Xbh̐
+	bool isJobSimd = true;//v`SIMD߂gǂ
+	bool isStopping = false;
+
+	Statistics frame = {};//Wṽt[
+	Statistics lastFrame = {};//Õt[
+	Statistics total = {};//܂ł̍v
+};
+
+#endif //OCCLUSIONCULLER_H_INCLUDED
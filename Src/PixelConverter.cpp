@@ -0,0 +1,250 @@
+/**
+* @file PixelConverter.cpp
+*/
+#include "PixelConverter.h"
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define PIXELCONVERTER_USE_SSE
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_SSSE3
+#else
+#include <cpuid.h>
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+
+//f̌`RGBA8ɕϊ֐i[閼O
+namespace PixelConverter {
+
+/**
+* CPUSSSE3߂ɑΉĂ邩ׂ
+*
+* @retval true  ΉĂ
+* @retval false ΉĂȂ
+*/
+	bool HasSsse3()
+	{
+#if defined(PIXELCONVERTER_USE_SSE)
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 9)) != 0;
+#else
+		unsigned int eax, ebx, ecx, edx;
+		return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 9));
+#endif
+#else
+		return false;
+#endif
+	}
+
+	//SSSE3g邩ǂ(N1񂾂ׂ)
+	const bool hasSsse3 = HasSsse3();
+
+/**
+* SIMD߂ŕϊ邩ǂ擾
+*
+* @retval true  SIMD߂g
+* @retval false SIMD߂gȂ
+*/
+	bool IsSimdEnabled()
+	{
+		return hasSsse3;
+	}
+
+/**
+* 1f3oCgBGRRGBA8ɕϊ
+*
+* @param src   ϊ̉f
+* @param dst   ϊ(count * 4oCg)
+* @param count f
+*/
+	void BgrToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i, src += 3, dst += 4)
+		{
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = 255;
+		}
+	}
+
+/**
+* 1f4oCgBGRARGBA8ɕϊ
+*
+* @param src   ϊ̉f
+* @param dst   ϊ(count * 4oCg). srcƓł悢
+* @param count f
+*/
+	void BgraToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i, src += 4, dst += 4)
+		{
+			const uint8_t b = src[0];
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = b;
+			dst[3] = src[3];
+		}
+	}
+
+/**
+* 1f2oCgA1R5G5B5(gGfBA)RGBA8ɕϊ
+*
+* @param src      ϊ̉f
+* @param dst      ϊ(count * 4oCg)
+* @param count    f
+* @param hasAlpha ŏʃrbgAt@ƂĎgȂtrue. falseȂsɂ
+*/
+	void Bgra5551ToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count, bool hasAlpha)
+	{
+		for (size_t i = 0; i < count; ++i, src += 2, dst += 4)
+		{
+			const unsigned int c = src[0] | (src[1] << 8);
+			const unsigned int r = (c >> 10) & 0x1f;
+			const unsigned int g = (c >> 5) & 0x1f;
+			const unsigned int b = c & 0x1f;
+			//5rbg8rbgɍLƂ͏ʃrbgʂɕ
+			dst[0] = (uint8_t)((r << 3) | (r >> 2));
+			dst[1] = (uint8_t)((g << 3) | (g >> 2));
+			dst[2] = (uint8_t)((b << 3) | (b >> 2));
+			dst[3] = (!hasAlpha || (c & 0x8000)) ? 255 : 0;
+		}
+	}
+
+#if defined(PIXELCONVERTER_USE_SSE)
+/**
+* BgrToRgbaSSSE3(16f)
+*/
+	TARGET_SSSE3 size_t BgrToRgbaSsse3(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		//3oCg~4f4oCg~4fɕבւ. -1̈ʒu0ɂȂ
+		const __m128i shuffle = _mm_setr_epi8(
+			2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+		const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+		size_t i = 0;
+		for (; i + 16 <= count; i += 16, src += 48, dst += 64)
+		{
+			const __m128i a = _mm_loadu_si128((const __m128i*)(src + 0));
+			const __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+			const __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+			const __m128i p0 = a;
+			const __m128i p1 = _mm_alignr_epi8(b, a, 12);
+			const __m128i p2 = _mm_alignr_epi8(c, b, 8);
+			const __m128i p3 = _mm_srli_si128(c, 4);
+			_mm_storeu_si128((__m128i*)(dst + 0), _mm_or_si128(_mm_shuffle_epi8(p0, shuffle), alpha));
+			_mm_storeu_si128((__m128i*)(dst + 16), _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), alpha));
+			_mm_storeu_si128((__m128i*)(dst + 32), _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), alpha));
+			_mm_storeu_si128((__m128i*)(dst + 48), _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), alpha));
+		}
+		return i;
+	}
+
+/**
+* BgraToRgbaSSSE3(4f)
+*/
+	TARGET_SSSE3 size_t BgraToRgbaSsse3(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		const __m128i shuffle = _mm_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4, src += 16, dst += 16)
+		{
+			const __m128i p = _mm_loadu_si128((const __m128i*)src);
+			_mm_storeu_si128((__m128i*)dst, _mm_shuffle_epi8(p, shuffle));
+		}
+		return i;
+	}
+
+/**
+* Bgra5551ToRgbaSSE2(8f)
+*/
+	size_t Bgra5551ToRgbaSse2(const uint8_t* src, uint8_t* dst, size_t count, bool hasAlpha)
+	{
+		const __m128i mask5 = _mm_set1_epi16(0x1f);
+		const __m128i opaque = _mm_set1_epi16(hasAlpha ? 0 : -1);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8, src += 16, dst += 32)
+		{
+			const __m128i c = _mm_loadu_si128((const __m128i*)src);
+			__m128i r = _mm_and_si128(_mm_srli_epi16(c, 10), mask5);
+			__m128i g = _mm_and_si128(_mm_srli_epi16(c, 5), mask5);
+			__m128i b = _mm_and_si128(c, mask5);
+			r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+			g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+			b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+			//ŏʃrbgZpVtgőSrbgɍLA8rbgAt@ɂ
+			__m128i a = _mm_or_si128(_mm_srai_epi16(c, 15), opaque);
+			a = _mm_srli_epi16(a, 8);
+
+			//16rbg~8f̊e`l8rbgRGBAɋl߂
+			const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+			const __m128i ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+			_mm_storeu_si128((__m128i*)(dst + 0), _mm_unpacklo_epi16(rg, ba));
+			_mm_storeu_si128((__m128i*)(dst + 16), _mm_unpackhi_epi16(rg, ba));
+		}
+		return i;
+	}
+#endif
+
+/**
+* 1f3oCgBGRRGBA8ɕϊ
+*
+* @param src   ϊ̉f
+* @param dst   ϊ(count * 4oCg)
+* @param count f
+*/
+	void BgrToRgba(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		size_t i = 0;
+#if defined(PIXELCONVERTER_USE_SSE)
+		if (hasSsse3)
+		{
+			i = BgrToRgbaSsse3(src, dst, count);
+		}
+#endif
+		BgrToRgbaScalar(src + i * 3, dst + i * 4, count - i);
+	}
+
+/**
+* 1f4oCgBGRARGBA8ɕϊ
+*
+* @param src   ϊ̉f
+* @param dst   ϊ(count * 4oCg). srcƓł悢
+* @param count f
+*/
+	void BgraToRgba(const uint8_t* src, uint8_t* dst, size_t count)
+	{
+		size_t i = 0;
+#if defined(PIXELCONVERTER_USE_SSE)
+		if (hasSsse3)
+		{
+			i = BgraToRgbaSsse3(src, dst, count);
+		}
+#endif
+		BgraToRgbaScalar(src + i * 4, dst + i * 4, count - i);
+	}
+
+/**
+* 1f2oCgA1R5G5B5(gGfBA)RGBA8ɕϊ
+*
+* @param src      ϊ̉f
+* @param dst      ϊ(count * 4oCg)
+* @param count    f
+* @param hasAlpha ŏʃrbgAt@ƂĎgȂtrue. falseȂsɂ
+*/
+	void Bgra5551ToRgba(const uint8_t* src, uint8_t* dst, size_t count, bool hasAlpha)
+	{
+		size_t i = 0;
+#if defined(PIXELCONVERTER_USE_SSE)
+		i = Bgra5551ToRgbaSse2(src, dst, count, hasAlpha);
+#endif
+		Bgra5551ToRgbaScalar(src + i * 2, dst + i * 4, count - i, hasAlpha);
+	}
+
+}//namespace PixelConverter
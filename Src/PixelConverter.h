@@ -0,0 +1,23 @@
+/**
+* @file PixelConverter.h
+*/
+#ifndef PIXELCONVERTER_H_INCLUDED
+#define PIXELCONVERTER_H_INCLUDED
+#include <stddef.h>
+#include <stdint.h>
+
+//f̌`RGBA8ɕϊ֐i[閼O
+namespace PixelConverter {
+
+	bool IsSimdEnabled();
+	void BgrToRgba(const uint8_t* src, uint8_t* dst, size_t count);
+	void BgraToRgba(const uint8_t* src, uint8_t* dst, size_t count);
+	void Bgra5551ToRgba(const uint8_t* src, uint8_t* dst, size_t count, bool hasAlpha);
+
+	//SIMDgȂ(ʂ̊mFƑx̔rp)
+	void BgrToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count);
+	void BgraToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count);
+	void Bgra5551ToRgbaScalar(const uint8_t* src, uint8_t* dst, size_t count, bool hasAlpha);
+
+}//namespace PixelConverter
+#endif //PIXELCONVERTER_H_INCLUDED
@@ -0,0 +1,557 @@
+/**
+* @file RenderQueue.cpp
+*/
+#include "RenderQueue.h"
+#include <algorithm>
+#include <iostream>
+#include <string.h>
+
+//בւL[̊eڂ̃rbg(ʂ`pXAvOAeNX`AbVA[x)
+const int passBits = 4;
+const int programBits = 8;
+const int textureBits = 12;
+const int meshBits = 16;
+const int depthBits = 24;
+static_assert(passBits + programBits + textureBits + meshBits + depthBits == 64,
+	"בւL[64rbg傤ǂłȂ΂ȂȂ");
+
+/**
+* CX^XƂ̒_ACX^X obt@̎wʒuɑΉt
+*
+* @param buffer CX^X obt@
+* @param offset ŏ̃CX^X̃f[^̈ʒu(oCg)
+*
+* _̐ݒVAOɋL^̂ŁAVAOĂ
+*/
+void SetInstanceAttributes(GLuint buffer, size_t offset)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	for (GLuint i = 0; i < 4; ++i)
+	{
+		const GLuint index = instanceAttributeFirst + i;
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+			(const GLvoid*)(offset + offsetof(InstanceData, matModel) + sizeof(glm::vec4) * i));
+		glVertexAttribDivisor(index, 1);
+	}
+	for (GLuint i = 0; i < 3; ++i)
+	{
+		const GLuint index = instanceAttributeFirst + 4 + i;
+		glEnableVertexAttribArray(index);
+		glVertexAttribPointer(index, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+			(const GLvoid*)(offset + offsetof(InstanceData, matNormal) + sizeof(glm::vec3) * i));
+		glVertexAttribDivisor(index, 1);
+	}
+	const GLuint layerIndex = instanceAttributeFirst + 7;
+	glEnableVertexAttribArray(layerIndex);
+	glVertexAttribIPointer(layerIndex, 1, GL_INT, sizeof(InstanceData),
+		(const GLvoid*)(offset + offsetof(InstanceData, textureLayer)));
+	glVertexAttribDivisor(layerIndex, 1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+* CX^X obt@ɏރf[^쐬
+*
+* @param mesh         `悷郁bV
+* @param matModel     fs(]EgkEsړ܂ނ)
+* @param textureLayer eNX`z̑wԍ
+*
+* @return CX^X̃f[^
+*/
+InstanceData MakeInstanceData(const Mesh& mesh, const glm::mat4& matModel, GLint textureLayer)
+{
+	InstanceData data;
+	MakeMeshMatrices(mesh, matModel, data.matModel, data.matNormal);
+	data.textureLayer = textureLayer;
+	return data;
+}
+
+/**
+* CfbNX̌^A1CfbNX̃oCg߂
+*
+* @param indexType CfbNX̌^
+*
+* @return 1CfbNX̃oCg
+*/
+GLuint IndexSize(GLenum indexType)
+{
+	switch (indexType)
+	{
+	case GL_UNSIGNED_BYTE: return 1;
+	case GL_UNSIGNED_SHORT: return 2;
+	default: return 4;
+	}
+}
+
+/**
+* בւL[쐬
+*
+* @param pass    `pX
+* @param program vO̔ԍ
+* @param texture eNX`̔ԍ
+* @param mesh    bVԍƏڍדx킹l
+* @param depth   _̋
+*
+* @return בւL[
+*
+* eڂ̓rbgɎ܂Ȃ؂̂Ă. L[͕я߂邾ŁA
+* Ԃ̐؂ւBuildۂ̒lׂĔ肷̂ŁA؂̂ĂĂ`͐.
+* [x͐̕_̃rbg񂪑召֌WۂƂgāA24rbgi[.
+* spXł͏Ԃ̐؂ւ悤ɐ[xŉʂɒuAO牜֕`悷.
+* pXł͐悤ɐ[x𔽓]ĕ`pX̎ɒuAO֕`悷
+*/
+uint64_t RenderQueue::MakeKey(RenderPass pass, uint32_t program, uint32_t texture,
+	uint32_t mesh, float depth)
+{
+	uint32_t depthKey = 0;
+	if (depth > 0)
+	{
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		depthKey = bits >> (31 - depthBits);
+	}
+	const auto field = [](uint32_t value, int bits) {
+		return static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1);
+	};
+	uint64_t state = field(program, programBits);
+	state = (state << textureBits) | field(texture, textureBits);
+	state = (state << meshBits) | field(mesh, meshBits);
+
+	const uint64_t passKey = field(static_cast<uint32_t>(pass), passBits) << (64 - passBits);
+	if (pass == RenderPass::Transparent)
+	{
+		depthKey = ((1U << depthBits) - 1) - depthKey;
+		return passKey | (field(depthKey, depthBits) << (programBits + textureBits + meshBits)) |
+			state;
+	}
+	return passKey | (state << depthBits) | field(depthKey, depthBits);
+}
+
+/**
+* `ǉ
+*
+* @param pass         `pX
+* @param program      `ɎgvO
+* @param texture      `ɎgeNX`
+* @param target       eNX`̎(GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY)
+* @param mesh         `悷郁bV
+* @param meshIndex    bVXg̃bV̔ԍ(בւɎg)
+* @param lod          `悷ڍדx(0=̌`. ͈͊O̒l͍ł߂ڍדxɂȂ)
+* @param matModel     fs(]EgkEsړ܂ނ)
+* @param textureLayer eNX`z̑wԍ
+* @param depth        _̋
+*
+* ۂ̕`Flushōs. meshFlushŎgbVXĝ̂ł邱
+*/
+void RenderQueue::Submit(RenderPass pass, Shader::Program& program, GLuint texture,
+	GLenum target, const Mesh& mesh, size_t meshIndex, int lod, const glm::mat4& matModel,
+	GLint textureLayer, float depth)
+{
+	lod = std::min(std::max(lod, 0), mesh.lodCount - 1);
+	const MeshLod& range = mesh.lods[lod];
+
+	Packet packet;
+	packet.program = FindProgram(&program);
+	packet.texture = FindTexture(texture, target);
+	packet.mode = mesh.mode;
+	packet.indexType = mesh.indexType;
+	packet.count = range.count;
+	packet.firstIndex = static_cast<GLuint>(
+		reinterpret_cast<uintptr_t>(range.indices) / IndexSize(mesh.indexType));
+	packet.baseVertex = mesh.baseVertex;
+
+	//CfbNX̌^ႤƓ܂Ƃ܂ɂłȂ̂ŁAbVɌ^ŕ
+	uint32_t meshKey = static_cast<uint32_t>(meshIndex * maxMeshLodCount + lod);
+	if (mesh.indexType == GL_UNSIGNED_INT)
+	{
+		meshKey |= 1U << (meshBits - 1);
+	}
+	keys.push_back(MakeKey(pass, packet.program, packet.texture, meshKey, depth));
+	packets.push_back(packet);
+	instances.push_back(MakeInstanceData(mesh, matModel, textureLayer));
+	isSorted = false;
+	isBuilt = false;
+}
+
+/**
+* ߂`L[̏ɕבւ
+*
+* 8rbg8̊\[g(LSD)s. SĂ̗vfœlɂȂ錅͔΂̂ŁA
+* gĂȂʃrbgASēvȌꍇ͕בւ̉񐔂.
+* L[`͒ǉԂۂ
+*/
+void RenderQueue::Sort()
+{
+	const size_t n = keys.size();
+	order.resize(n);
+	sortedKeys.assign(keys.begin(), keys.end());
+	for (size_t i = 0; i < n; ++i)
+	{
+		order[i] = static_cast<uint32_t>(i);
+	}
+
+	//SĂ̌̃qXgO1̑ŋ߂
+	const int digitCount = 8;
+	std::vector<size_t> histogram(digitCount * 256, 0);
+	for (const uint64_t key : sortedKeys)
+	{
+		for (int d = 0; d < digitCount; ++d)
+		{
+			++histogram[d * 256 + ((key >> (d * 8)) & 0xff)];
+		}
+	}
+
+	tmpKeys.resize(n);
+	tmpOrder.resize(n);
+	for (int d = 0; d < digitCount; ++d)
+	{
+		size_t* const count = &histogram[d * 256];
+		const uint64_t firstDigit = n ? (sortedKeys[0] >> (d * 8)) & 0xff : 0;
+		if (count[firstDigit] == n)
+		{
+			continue;//SēlȂ̂ŕя͕ςȂ
+		}
+		size_t offset = 0;
+		for (int i = 0; i < 256; ++i)
+		{
+			const size_t c = count[i];
+			count[i] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < n; ++i)
+		{
+			const size_t dst = count[(sortedKeys[i] >> (d * 8)) & 0xff]++;
+			tmpKeys[dst] = sortedKeys[i];
+			tmpOrder[dst] = order[i];
+		}
+		sortedKeys.swap(tmpKeys);
+		order.swap(tmpOrder);
+	}
+	isSorted = true;
+	isBuilt = false;
+}
+
+/**
+* בւ`悩A`施߂Ƃ܂Ƃ܂쐬
+*
+* vOAeNX`Av~eBu̎ށACfbNX̌^͈͂1̂܂Ƃ܂ɂ.
+* bVAꍇ́A1̕`施߂̃CX^X𑝂₷
+*/
+void RenderQueue::Build()
+{
+	if (!isSorted)
+	{
+		Sort();
+	}
+	const size_t n = order.size();
+	commands.clear();
+	batches.clear();
+	sortedInstances.resize(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		const uint32_t src = order[i];
+		const Packet& p = packets[src];
+		sortedInstances[i] = instances[src];
+
+		Shader::Program* const program = programs[p.program];
+		const TextureSlot& texture = textures[p.texture];
+		if (batches.empty() || batches.back().program != program ||
+			batches.back().texture != texture.texture || batches.back().target != texture.target ||
+			batches.back().mode != p.mode || batches.back().indexType != p.indexType)
+		{
+			batches.push_back({ program, texture.texture, texture.target,
+				p.mode, p.indexType, commands.size(), 0 });
+		}
+		Batch& batch = batches.back();
+
+		if (batch.commandCount > 0)
+		{
+			DrawElementsIndirectCommand& prev = commands.back();
+			if (prev.count == p.count && prev.firstIndex == p.firstIndex &&
+				prev.baseVertex == p.baseVertex && prev.instanceCount < maxInstancesPerCommand)
+			{
+				++prev.instanceCount;
+				continue;
+			}
+		}
+		commands.push_back({ p.count, 1, p.firstIndex, p.baseVertex, static_cast<GLuint>(i) });
+		++batch.commandCount;
+	}
+	isBuilt = true;
+}
+
+/**
+* ߂`܂Ƃ߂Ďs
+*
+* @param meshList SubmitɓnbVǗĂ郁bVXg
+* @param buffer   CX^X̃f[^A`施߁At[̃f[^̏ݐ
+*
+* `施߂ƃCX^X̃f[^̓obt@̔Ɏ܂ʂ݁A
+* ܂Ƃ܂育ƂglMultiDrawElementsIndirect1Ăяo.
+* glMultiDrawElementsIndirectgȂł́A`施߂Ƃɕ`悷.
+* x[XCX^XgȂ(GL 4.1)ł́A`施߂ƂɃCX^X̒_ݒ肵
+*/
+void RenderQueue::Flush(MeshList& meshList, UniformRingBuffer& buffer)
+{
+	statistics = {};
+	if (keys.empty())
+	{
+		return;
+	}
+	//obt@̊蓖Ĉʒu𑵂邽߂̗]
+	const size_t alignmentSlack = 256 * 3;
+	const size_t chunkBytes = buffer.Capacity() / 2;
+	const size_t maxCommandBytes = sizeof(InstanceData) * maxInstancesPerCommand +
+		sizeof(DrawElementsIndirectCommand) + alignmentSlack;
+	if (chunkBytes < maxCommandBytes)
+	{
+		std::cerr << "ERROR: `施߂̃obt@邽ߕ`ł܂\n";
+		Clear();
+		return;
+	}
+	if (!isBuilt)
+	{
+		Build();
+	}
+	statistics.packetCount = keys.size();
+	statistics.commandCount = commands.size();
+	statistics.batchCount = batches.size();
+
+	const bool hasMultiDraw = GLEW_ARB_multi_draw_indirect != 0;
+	const bool hasBaseInstance = GLEW_ARB_base_instance != 0;
+	Shader::Program* prevProgram = nullptr;
+	TextureSlot prevTexture = { 0, GL_NONE };
+	size_t batchIndex = 0;
+	size_t first = 0;
+	while (first < commands.size())
+	{
+		//obt@̔Ɏ܂͈͂̕`施߂I
+		size_t last = first;
+		size_t instanceCount = 0;
+		while (last < commands.size())
+		{
+			const size_t bytes = sizeof(InstanceData) * (instanceCount + commands[last].instanceCount) +
+				sizeof(DrawElementsIndirectCommand) * (last - first + 1) + alignmentSlack;
+			if (bytes > chunkBytes)
+			{
+				break;
+			}
+			instanceCount += commands[last].instanceCount;
+			++last;
+		}
+
+		//CX^X̃f[^ƕ`施߂.
+		//CX^Ẍʒu͏񂾗̈̐擪̔ԍɒ
+		const GLuint firstInstance = commands[first].baseInstance;
+		const size_t instanceOffset = buffer.Allocate(sizeof(InstanceData) * instanceCount);
+		const size_t commandOffset =
+			buffer.Allocate(sizeof(DrawElementsIndirectCommand) * (last - first));
+		if (instanceOffset >= buffer.Capacity() || commandOffset >= buffer.Capacity())
+		{
+			break;
+		}
+		memcpy(buffer.Data(instanceOffset), sortedInstances.data() + firstInstance,
+			sizeof(InstanceData) * instanceCount);
+		DrawElementsIndirectCommand* const chunkCommands =
+			static_cast<DrawElementsIndirectCommand*>(buffer.Data(commandOffset));
+		for (size_t i = first; i < last; ++i)
+		{
+			chunkCommands[i - first] = commands[i];
+			chunkCommands[i - first].baseInstance -= firstInstance;
+		}
+		buffer.Flush();
+
+		meshList.BindInstancedVertexArray();
+		SetInstanceAttributes(buffer.Id(), instanceOffset);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer.Id());
+
+		//t[̃f[^͈ď㏑Ă邩Ȃ̂ŁÄ悲Ƃɏݒ
+		Shader::Program* chunkProgram = nullptr;
+		for (; batchIndex < batches.size(); ++batchIndex)
+		{
+			const Batch& batch = batches[batchIndex];
+			const size_t batchEnd = batch.firstCommand + batch.commandCount;
+			const size_t segmentFirst = std::max(batch.firstCommand, first);
+			const size_t segmentLast = std::min(batchEnd, last);
+			if (segmentFirst >= segmentLast)
+			{
+				break;
+			}
+			if (!batch.program->IsNull())
+			{
+				if (batch.program != chunkProgram)
+				{
+					batch.program->Use();
+					batch.program->BindFrameUniform(buffer);
+					if (batch.program != prevProgram)
+					{
+						++statistics.programChangeCount;
+					}
+					chunkProgram = prevProgram = batch.program;
+				}
+				if (prevTexture.texture != batch.texture || prevTexture.target != batch.target)
+				{
+					batch.program->BindTexture(0, batch.texture, batch.target);
+					prevTexture = { batch.texture, batch.target };
+					++statistics.textureChangeCount;
+				}
+
+				if (hasMultiDraw)
+				{
+					glMultiDrawElementsIndirect(batch.mode, batch.indexType,
+						reinterpret_cast<const GLvoid*>(
+							commandOffset + sizeof(DrawElementsIndirectCommand) * (segmentFirst - first)),
+						static_cast<GLsizei>(segmentLast - segmentFirst), 0);
+					++statistics.drawCallCount;
+				}
+				else
+				{
+					//x[XCX^XgȂ΁ACX^X̒_`施߂Ƃɐݒ肵
+					const GLuint indexSize = IndexSize(batch.indexType);
+					for (size_t i = segmentFirst; i < segmentLast; ++i)
+					{
+						const DrawElementsIndirectCommand& c = chunkCommands[i - first];
+						const GLvoid* const indices = reinterpret_cast<const GLvoid*>(
+							static_cast<uintptr_t>(c.firstIndex) * indexSize);
+						if (hasBaseInstance)
+						{
+							glDrawElementsInstancedBaseVertexBaseInstance(batch.mode, c.count,
+								batch.indexType, indices, c.instanceCount, c.baseVertex, c.baseInstance);
+						}
+						else
+						{
+							SetInstanceAttributes(buffer.Id(),
+								instanceOffset + c.baseInstance * sizeof(InstanceData));
+							glDrawElementsInstancedBaseVertex(batch.mode, c.count,
+								batch.indexType, indices, c.instanceCount, c.baseVertex);
+						}
+						++statistics.drawCallCount;
+					}
+				}
+			}
+			if (segmentLast < batchEnd)
+			{
+				break;//܂Ƃ܂̎c͎̗̈ŕ`悷
+			}
+		}
+
+		//̊蓖ĂĂ̗̈ɖ߂ĂƂɁA`̊҂Ă悤ɂ
+		buffer.Fence();
+		first = last;
+	}
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	Clear();
+}
+
+/**
+* ߂`j
+*/
+void RenderQueue::Clear()
+{
+	keys.clear();
+	packets.clear();
+	instances.clear();
+	programs.clear();
+	textures.clear();
+	order.clear();
+	sortedKeys.clear();
+	commands.clear();
+	sortedInstances.clear();
+	batches.clear();
+	isSorted = false;
+	isBuilt = false;
+}
+
+/**
+* ߂Ă`̐擾
+*
+* @return SubmitĂ܂`悵ĂȂ̂̐
+*/
+size_t RenderQueue::PacketCount() const
+{
+	return keys.size();
+}
+
+/**
+* בւL[擾
+*
+* @return SortŕבւL[̔z
+*/
+const std::vector<uint64_t>& RenderQueue::SortedKeys() const
+{
+	return sortedKeys;
+}
+
+/**
+* `施߂擾
+*
+* @return Buildō쐬`施߂̔z
+*/
+const std::vector<DrawElementsIndirectCommand>& RenderQueue::Commands() const
+{
+	return commands;
+}
+
+/**
+* `̂܂Ƃ܂擾
+*
+* @return Buildō쐬܂Ƃ܂̔z
+*/
+const std::vector<RenderQueue::Batch>& RenderQueue::Batches() const
+{
+	return batches;
+}
+
+/**
+* ŌFlush̓v擾
+*
+* @return v
+*/
+RenderQueue::Statistics RenderQueue::GetStatistics() const
+{
+	return statistics;
+}
+
+/**
+* vO̔ԍ擾
+*
+* @param program ԍ𒲂ׂvO
+*
+* @return vO̔ԍ. ߂ĎgvOȂVԍ蓖Ă
+*
+* vO̎ނ͏Ȃ̂ŁA`Tŏ\
+*/
+uint32_t RenderQueue::FindProgram(Shader::Program* program)
+{
+	for (size_t i = programs.size(); i > 0; --i)
+	{
+		if (programs[i - 1] == program)
+		{
+			return static_cast<uint32_t>(i - 1);
+		}
+	}
+	programs.push_back(program);
+	return static_cast<uint32_t>(programs.size() - 1);
+}
+
+/**
+* eNX`̔ԍ擾
+*
+* @param texture ԍ𒲂ׂeNX`
+* @param target  eNX`̎
+*
+* @return eNX`̔ԍ. ߂ĎgeNX`ȂVԍ蓖Ă
+*/
+uint32_t RenderQueue::FindTexture(GLuint texture, GLenum target)
+{
+	for (size_t i = textures.size(); i > 0; --i)
+	{
+		if (textures[i - 1].texture == texture && textures[i - 1].target == target)
+		{
+			return static_cast<uint32_t>(i - 1);
+		}
+	}
+	textures.push_back({ texture, target });
+	return static_cast<uint32_t>(textures.size() - 1);
+}
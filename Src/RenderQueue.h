@@ -0,0 +1,155 @@
+/**
+* @file RenderQueue.h
+*/
+#ifndef RENDERQUEUE_H_INCLUDED
+#define RENDERQUEUE_H_INCLUDED
+#include <GL/glew.h>
+#include "Shader.h"
+#include "MeshList.h"
+#include "UniformBuffer.h"
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+* `pX(בւL[̍ŏ. ɕ`悷)
+*/
+enum class RenderPass
+{
+	Opaque,//sȕ(O牜֕`悷)
+	Transparent,//ȕ(O֕`悷)
+};
+
+//CX^XƂ̃f[^ǂݎ钸_̍ŏ̔ԍ.
+//fs4A@s3Awԍ1A킹6`13Ԃg
+const GLuint instanceAttributeFirst = 6;
+
+/**
+* CX^X`Œ_ƂēǂݎÂƂ̃f[^
+*/
+struct InstanceData
+{
+	glm::mat4 matModel;//fs(kꂽ_W߂ϊ܂)
+	glm::vec3 matNormal[3];//@̕ϊs̊e
+	GLint textureLayer;//eNX`z̑wԍ
+};
+static_assert(sizeof(InstanceData) == 104, "InstanceDataɗ]vȋlߕĂ͂ȂȂ");
+
+InstanceData MakeInstanceData(const Mesh& mesh, const glm::mat4& matModel, GLint textureLayer);
+void SetInstanceAttributes(GLuint buffer, size_t offset);
+
+//1̕`施߂ɂ܂Ƃ߂őCX^X
+const GLuint maxInstancesPerCommand = 1024;
+
+/**
+* glMultiDrawElementsIndirectɓn`施
+*/
+struct DrawElementsIndirectCommand
+{
+	GLuint count;//`悷CfbNX
+	GLuint instanceCount;//CX^X
+	GLuint firstIndex;//ŏ̃CfbNẌʒu(oCgł͂ȂCfbNXP)
+	GLint baseVertex;//CfbNX0ԂƂ݂Ȃ钸_z̈ʒu
+	GLuint baseInstance;//CX^X obt@̍ŏ̃CX^Ẍʒu
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "`施߂20oCgłȂ΂ȂȂ");
+
+/**
+* `L[ŕבւĂA܂Ƃ߂ĕ`悷NX
+*
+* Submitŕ`pXAvOAeNX`AbVA[x64rbg̃L[ɋl߂ė߂ĂA
+* FlushŊ\[gĂAԂςȂ͈͂glMultiDrawElementsIndirect1ŕ`悷.
+* bVA`́A1̕`施߂̃CX^Xɂ܂Ƃ߂.
+* vOɂFragmentLightingInstanced.vert̂悤ȁACX^XǂރVF[_[g
+*/
+class RenderQueue
+{
+public:
+	//Ԃ؂ւɕ`ł܂Ƃ܂(glMultiDrawElementsIndirect1)
+	struct Batch
+	{
+		Shader::Program* program;
+		GLuint texture;
+		GLenum target;
+		GLenum mode;
+		GLenum indexType;
+		size_t firstCommand;//commands̒̍ŏ̕`施
+		size_t commandCount;//`施߂̐
+	};
+
+	//ŌFlush̓v
+	struct Statistics
+	{
+		size_t packetCount;//`悵̂̐
+		size_t commandCount;//`施߂̐
+		size_t batchCount;//܂Ƃ܂̐
+		size_t drawCallCount;//s`֐̐
+		size_t programChangeCount;//vO؂ւ
+		size_t textureChangeCount;//eNX`؂ւ
+	};
+
+	void Submit(RenderPass pass, Shader::Program& program, GLuint texture, GLenum target,
+		const Mesh& mesh, size_t meshIndex, int lod, const glm::mat4& matModel,
+		GLint textureLayer, float depth);
+	void Sort();
+	void Build();
+	void Flush(MeshList& meshList, UniformRingBuffer& buffer);
+	void Clear();
+	size_t PacketCount() const;
+	const std::vector<uint64_t>& SortedKeys() const;
+	const std::vector<DrawElementsIndirectCommand>& Commands() const;
+	const std::vector<Batch>& Batches() const;
+	Statistics GetStatistics() const;
+
+	static uint64_t MakeKey(RenderPass pass, uint32_t program, uint32_t texture,
+		uint32_t mesh, float depth);
+
+private:
+	uint32_t FindProgram(Shader::Program* program);
+	uint32_t FindTexture(GLuint texture, GLenum target);
+
+	//`1񕪂̃f[^
+	struct Packet
+	{
+		uint32_t program;//programs̔ԍ
+		uint32_t texture;//textures̔ԍ
+		GLenum mode;
+		GLenum indexType;
+		GLuint count;
+		GLuint firstIndex;
+		GLint baseVertex;
+	};
+
+	//eNX`̎ނID
+	struct TextureSlot
+	{
+		GLuint texture;
+		GLenum target;
+	};
+
+	//Submitŗ߂f[^(keys, packets, instances͓)
+	std::vector<uint64_t> keys;
+	std::vector<Packet> packets;
+	std::vector<InstanceData> instances;
+	std::vector<Shader::Program*> programs;
+	std::vector<TextureSlot> textures;
+
+	//Sortōf[^
+	std::vector<uint32_t> order;//בւ
+	std::vector<uint64_t> sortedKeys;
+	std::vector<uint64_t> tmpKeys;
+	std::vector<uint32_t> tmpOrder;
+	bool isSorted = false;
+
+	//Buildōf[^
+	std::vector<DrawElementsIndirectCommand> commands;
+	std::vector<InstanceData> sortedInstances;//`施߂baseInstancew
+	std::vector<Batch> batches;
+	bool isBuilt = false;
+
+	Statistics statistics = {};
+};
+
+#endif //RENDERQUEUE_H_INCLUDED
@@ -3,10 +3,18 @@
 */
 #include "Shader.h"
 #include "Geometry.h"
+#include "MeshList.h"
+#include "AssetPack.h"
+#include "GLStateCache.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
-#include <fstream>
+#include <string>
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
 
 /**
 * VF[_[Ɋւ@\i[閼O
@@ -74,6 +82,11 @@ namespace Shader{
 			return 0;
 		}
 		GLuint program = glCreateProgram();
+		if (GLEW_ARB_get_program_binary)
+		{
+			//NʂLbVɕۑł悤ɂ
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 		glAttachShader(program, fs);
 		glDeleteShader(fs);
 		glAttachShader(program, vs);
@@ -95,7 +108,7 @@ namespace Shader{
 					std::cerr << "ERROR: VF[_[̃NɎs\n" << buf.data() << std::endl;
 				}
 			}
-			glDeleteProgram(program);
+			GLStateCache::Instance().DeleteProgram(program);
 			return 0;
 		}
 		return program;
@@ -107,21 +120,19 @@ namespace Shader{
 * @param path ǂݍރt@C
 *
 * @retun ǂݍ񂾃f[^
+*
+* AZbg pbNɂ΃pbNǂݍ
 */
 	std::vector<GLchar> ReadFile(const char* path)
 	{
-		std::basic_ifstream<GLchar> ifs;
-		ifs.open(path, std::ios_base::binary);
-		if (!ifs.is_open())
+		AssetFile file(path);
+		if (file.IsNull())
 		{
 			std::cerr << "ERROR:" << path << "J܂\n";
 			return {};
 		}
-		ifs.seekg(0, std::ios_base::end);
-		const size_t length = (size_t)ifs.tellg();
-		ifs.seekg(0, std::ios_base::beg);
-		std::vector<GLchar>buf(length);
-		ifs.read(buf.data(), length);
+		const GLchar* const begin = reinterpret_cast<const GLchar*>(file.Data());
+		std::vector<GLchar> buf(begin, begin + file.Size());
 		buf.push_back('\0');
 
 		return buf;
@@ -134,13 +145,248 @@ namespace Shader{
 * @param fsPath tOgVF[_[ t@C
 *
 * @return 쐬vO IuWFNg
+*
+* Nς݂̃oCiLbVɂ΁ARpCɂg
 */
 	GLuint BuildFromFile(const char* vsPath, const char* fsPath)
 	{
 		const std::vector<GLchar> vsCode = ReadFile(vsPath);
 		const std::vector<GLchar> fsCode = ReadFile(fsPath);
 
-		return Build(vsCode.data(), fsCode.data());
+		return BuildWithCache(vsCode.data(), fsCode.data());
+	}
+
+	//vO LbV t@C̎ʎqƃo[W
+	const char programCacheMagic[4] = { 'G', 'P', 'R', 'B' };
+	const uint32_t programCacheVersion = 2;
+
+	//vO LbV t@C̃wb_(̌ɃoCi)
+	struct ProgramCacheHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t key;//\[XƃhCo[̃nbVl
+		uint64_t sourceSize;//\[X̃oCg(nbVlRv\[X)
+		uint32_t binaryFormat;//glGetProgramBinaryԂ`
+		uint32_t binarySize;//oCĩoCg
+	};
+
+/**
+* nbVlɕ(FNV-1a)
+*
+* @param hash   ÕnbVl
+* @param string 镶. nullptrȂ󕶎ƂĈ
+*
+* @return nbVl
+*
+* ̋؂肪悤ɁAI['\0'
+*/
+	uint64_t HashString(uint64_t hash, const char* string)
+	{
+		if (string)
+		{
+			for (const char* p = string; *p; ++p)
+			{
+				hash = (hash ^ static_cast<uint8_t>(*p)) * 1099511628211ULL;
+			}
+		}
+		return hash * 1099511628211ULL;
+	}
+
+/**
+* VF[_[̃\[XnbVl߂
+*
+* @param vsCode _VF[_[ vOւ̃|C^
+* @param fsCode tOgVF[_[ vOւ̃|C^
+*
+* @return nbVl. \[X̑gݍ킹Ȃ瓯lɂȂ
+*/
+	uint64_t HashSource(const GLchar* vsCode, const GLchar* fsCode)
+	{
+		return HashString(HashString(14695981039346656037ULL, vsCode), fsCode);
+	}
+
+/**
+* vO LbṼL[߂
+*
+* @param sourceHash HashSourceŋ߂nbVl
+*
+* @return \[XƃhCo[̑gݍ킹\L[
+*
+* hCo[ςƃoCi͎gȂ̂ŁAhCo[̏L[Ɋ܂߂
+*/
+	uint64_t GetProgramCacheKey(uint64_t sourceHash)
+	{
+		const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+		uint64_t key = sourceHash;
+		for (GLenum name : names)
+		{
+			key = HashString(key, reinterpret_cast<const char*>(glGetString(name)));
+		}
+		return key;
+	}
+
+/**
+* vO LbṼt@C쐬
+*
+* @param key GetProgramCacheKeyŋ߂L[
+*
+* @return LbṼt@C
+*/
+	std::string GetProgramCachePath(uint64_t key)
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+		return std::string("Res/Program_") + name + ".cache";
+	}
+
+/**
+* LbVvO IuWFNg쐬
+*
+* @param path       LbṼt@C
+* @param key        GetProgramCacheKeyŋ߂L[
+* @param sourceSize VF[_[̃\[X̃oCg
+*
+* @retval 0傫 쐬vO IuWFNg
+* @retval 0 LbVAĂA܂̓hCo[󂯕tȂ
+*/
+	GLuint LoadProgramBinary(const char* path, uint64_t key, uint64_t sourceSize)
+	{
+		std::ifstream ifs(path, std::ios_base::binary);
+		if (!ifs.is_open())
+		{
+			return 0;
+		}
+		ProgramCacheHeader header = {};
+		ifs.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!ifs || memcmp(header.magic, programCacheMagic, sizeof(header.magic)) != 0 ||
+			header.version != programCacheVersion || header.key != key ||
+			header.sourceSize != sourceSize || header.binarySize == 0)
+		{
+			return 0;
+		}
+		std::vector<char> binary(header.binarySize);
+		ifs.read(binary.data(), binary.size());
+		if (!ifs)
+		{
+			return 0;
+		}
+
+		GLuint program = glCreateProgram();
+		glProgramBinary(program, header.binaryFormat, binary.data(), header.binarySize);
+		GLint linkStatus = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+		if (linkStatus != GL_TRUE)
+		{
+			std::cerr << "WARNING: " << path << "݂͌̃hCo[ŎgȂ̂ŁARpC܂\n";
+			GLStateCache::Instance().DeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+/**
+* vO IuWFNg̃oCiLbVɕۑ
+*
+* @param path       LbṼt@C
+* @param key        GetProgramCacheKeyŋ߂L[
+* @param sourceSize VF[_[̃\[X̃oCg
+* @param program    ۑvO IuWFNg
+*
+* @retval true  ۑ
+* @retval false ۑs
+*/
+	bool SaveProgramBinary(const char* path, uint64_t key, uint64_t sourceSize, GLuint program)
+	{
+		GLint size = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+		if (size <= 0)
+		{
+			return false;
+		}
+		std::vector<char> binary(size);
+		GLenum format = 0;
+		glGetProgramBinary(program, size, &size, &format, binary.data());
+		if (size <= 0)
+		{
+			return false;
+		}
+
+		std::ofstream ofs(path, std::ios_base::binary | std::ios_base::trunc);
+		if (!ofs.is_open())
+		{
+			std::cerr << "WARNING: " << path << "쐬ł܂\n";
+			return false;
+		}
+		ProgramCacheHeader header = {};
+		memcpy(header.magic, programCacheMagic, sizeof(header.magic));
+		header.version = programCacheVersion;
+		header.key = key;
+		header.sourceSize = sourceSize;
+		header.binaryFormat = format;
+		header.binarySize = static_cast<uint32_t>(size);
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		ofs.write(binary.data(), size);
+		if (!ofs)
+		{
+			std::cerr << "WARNING: " << path << "݂̏Ɏs\n";
+			ofs.close();
+			remove(path);
+			return false;
+		}
+		return true;
+	}
+
+/**
+* LbVgăvO IuWFNg쐬
+*
+* @param vsCode _VF[_[ vOւ̃|C^
+* @param fsCode tOgVF[_[ vOւ̃|C^
+*
+* @retval 0傫 쐬vO IuWFNg
+* @retval 0 vO IuWFNg̍쐬Ɏs
+*
+* ŐNŃNoCi΁ARpCɂǂݍ.
+* oCigȂꍇ̓RpCAʂLbVɕۑ
+*/
+	GLuint BuildWithCache(const GLchar* vsCode, const GLchar* fsCode)
+	{
+		if (!vsCode || !fsCode)
+		{
+			return 0;
+		}
+		GLint formatCount = 0;
+		if (GLEW_ARB_get_program_binary)
+		{
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		}
+		if (formatCount <= 0)
+		{
+			return Build(vsCode, fsCode);
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		const uint64_t key = GetProgramCacheKey(HashSource(vsCode, fsCode));
+		const uint64_t sourceSize = strlen(vsCode) + strlen(fsCode);
+		const std::string cachePath = GetProgramCachePath(key);
+		GLuint program = LoadProgramBinary(cachePath.c_str(), key, sourceSize);
+		const bool isCached = program != 0;
+		if (!program)
+		{
+			program = Build(vsCode, fsCode);
+			if (program)
+			{
+				SaveProgramBinary(cachePath.c_str(), key, sourceSize, program);
+			}
+		}
+		if (program)
+		{
+			const std::chrono::duration<double, std::milli> elapsed =
+				std::chrono::steady_clock::now() - start;
+			std::cout << "INFO: " << cachePath << (isCached ? "ǂݍ" : "쐬") <<
+				" [=" << elapsed.count() << "ms]\n";
+		}
+		return program;
 	}
 
 /**
@@ -180,10 +426,7 @@ namespace Shader{
 */
 	Program::~Program()
 	{
-		if (id)
-		{
-			glDeleteProgram(id);
-		}
+		GLStateCache::Instance().DeleteProgram(id);
 	}
 
 /**
@@ -192,7 +435,8 @@ namespace Shader{
 */
 	void Program::Reset(GLuint programId)
 	{
-		glDeleteProgram(id);
+		GLStateCache& cache = GLStateCache::Instance();
+		cache.DeleteProgram(id);
 		id = programId;
 		if (id == 0)
 		{
@@ -200,6 +444,8 @@ namespace Shader{
 			locDirLightDir = -1;
 			locDirLightCol = -1;
 			locAmbLightCol = -1;
+			locTextureLayer = -1;
+			hasObjectBlock = false;
 
 			return;
 		}
@@ -207,14 +453,23 @@ namespace Shader{
 		locDirLightDir = glGetUniformLocation(id, "directionalLight.direction");
 		locDirLightCol = glGetUniformLocation(id, "directionalLight.color");
 		locAmbLightCol = glGetUniformLocation(id, "ambientLight.color");
+		locTextureLayer = glGetUniformLocation(id, "textureLayer");
 
-		const GLint texColorLoc = glGetUniformLocation(id, "texColor");
-		if (texColorLoc <= 0)
+		//uniformubNoCfBO |CgɑΉt
+		const GLuint frameBlock = glGetUniformBlockIndex(id, "FrameData");
+		if (frameBlock != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(id, frameBlock, frameUniformBinding);
+		}
+		const GLuint objectBlock = glGetUniformBlockIndex(id, "ObjectData");
+		hasObjectBlock = objectBlock != GL_INVALID_INDEX;
+		if (hasObjectBlock)
 		{
-			glUseProgram(id);
-			glUniform1i(texColorLoc, 0);
-			glUseProgram(0);
+			glUniformBlockBinding(id, objectBlock, objectUniformBinding);
 		}
+
+		//gp̃vO؂ւɁATv[jbg0Ɋ蓖Ă
+		cache.SetUniform(id, glGetUniformLocation(id, "texColor"), 0);
 	}
 
 /*
@@ -235,7 +490,7 @@ namespace Shader{
 	{
 		if (id)
 		{
-			glUseProgram(id);
+			GLStateCache::Instance().UseProgram(id);
 		}
 	}
 
@@ -244,11 +499,25 @@ namespace Shader{
 *
 * @param unitNo ݒ肷eNX` C[Wjbg̔ԍ(0`)
 * @param texId ݒ肷eNX`ID
+* @param target eNX`̎(GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY)
+*/
+	void Program::BindTexture(GLuint unitNo, GLuint texId, GLenum target)
+	{
+		GLStateCache::Instance().BindTexture(unitNo, target, texId);
+	}
+
+/**
+* `ɎgpeNX`z̑wݒ肷
+*
+* @param layer eNX`z̑wԍ
+*
+* eNX`zgVF[_[ȂAeNX`ɉ摜؂ւ.
+* ObjectDataubNvOł́AȌDrawŗ߂`̑wԍɂȂ
 */
-	void Program::BindTexture(GLuint unitNo, GLuint texId)
+	void Program::SetTextureLayer(GLint layer)
 	{
-		glActiveTexture(GL_TEXTURE0 + unitNo);
-		glBindTexture(GL_TEXTURE_2D, texId);
+		textureLayer = layer;
+		GLStateCache::Instance().SetUniform(id, locTextureLayer, layer);
 	}
 
 /**
@@ -261,14 +530,9 @@ namespace Shader{
 		this->lights = lights;
 
 		//Cg̐FGPUɓ]
-		if (locAmbLightCol >= 0)
-		{
-			glUniform3fv(locAmbLightCol, 1, &lights.ambient.color.x);
-		}
-		if (locDirLightCol >= 0)
-		{
-			glUniform3fv(locDirLightCol, 1, &lights.directional.color.x);
-		}
+		GLStateCache& cache = GLStateCache::Instance();
+		cache.SetUniform(id, locAmbLightCol, lights.ambient.color);
+		cache.SetUniform(id, locDirLightCol, lights.directional.color);
 	}
 
 /**
@@ -281,6 +545,21 @@ namespace Shader{
 		this->matVP = matVP;
 	}
 
+/**
+* `Ɏgr[sƃvWFNVsݒ肷
+*
+* @param matView ݒ肷r[s
+* @param matProj ݒ肷vWFNVs
+*
+* FrameDataubNvOł́A̍s񂪃VF[_[ɓn
+*/
+	void Program::SetViewProjectionMatrix(const glm::mat4& matView, const glm::mat4& matProj)
+	{
+		this->matView = matView;
+		this->matProj = matProj;
+		matVP = matProj * matView;
+	}
+
 /**
 * bV`悷
 *
@@ -288,11 +567,14 @@ namespace Shader{
 * @param translate sړ
 * @param rotate ]px(WA)
 * @param scale gk(1={, 0.5=1/2{, 2.0=2{)
+* @param lod `悷ڍדx(0=̌`. ͈͊O̒l͍ł߂ڍדxɂȂ)
 *
-* ̊֐gOɁAUse֐sĂ
+* ̊֐gOɁAUse֐sĂ.
+* ObjectDataubNvOł͕`𗭂߂邾ŁAFlushDrawsł܂Ƃ߂ĕ`悷
 */
 	void Program::Draw(const Mesh& mesh,
-		const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale)
+		const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale,
+		int lod)
 	{
 		if (id == 0)
 		{
@@ -304,23 +586,224 @@ namespace Shader{
 		const glm::mat4 matRotateXZ = glm::rotate(matRotateZ, rotate.x, glm::vec3(1, 0, 0));
 		const glm::mat4 matRotateYXZ = glm::rotate(matRotateXZ, rotate.y, glm::vec3(0, 1, 0));
 		const glm::mat4 matTranslate = glm::translate(glm::mat4(1), translate);
-		const glm::mat4 matModel = matTranslate * matRotateYXZ * matScale;
+		Draw(mesh, matTranslate * matRotateYXZ * matScale, lod);
+	}
+
+/**
+* fsw肵ăbV`悷
+*
+* @param mesh     `悷郁bV
+* @param matModel fs(]EgkEsړ܂ނ)
+* @param lod      `悷ڍדx(0=̌`. ͈͊O̒l͍ł߂ڍדxɂȂ)
+*
+* ̊֐gOɁAUse֐sĂ
+*/
+	void Program::Draw(const Mesh& mesh, const glm::mat4& matModel, int lod)
+	{
+		if (id == 0)
+		{
+			return;
+		}
+
+		//kꂽ_W߂ϊ܂߂fsƁA@s߂
+		glm::mat4 matMesh;
+		glm::vec3 matNormal[3];
+		MakeMeshMatrices(mesh, matModel, matMesh, matNormal);
+
+		//uniformubNgvOł́Ẫf[^𗭂߂ĂĂ܂Ƃ߂ē]
+		if (hasObjectBlock)
+		{
+			const MeshLod& range = mesh.lods[std::min(std::max(lod, 0), mesh.lodCount - 1)];
+			ObjectUniform object = {};
+			object.matModel = matMesh;
+			for (int i = 0; i < 3; ++i)
+			{
+				object.matNormal[i] = glm::vec4(matNormal[i], 0);
+			}
+			object.textureLayer = textureLayer;
+			objectUniforms.push_back(object);
+			drawCommands.push_back(
+				{ mesh.mode, range.count, mesh.indexType, range.indices, mesh.baseVertex });
+			return;
+		}
+
+		//wCǧfWnɕϊ.
+		//]s̋ts͓]usȂ̂ŁAKeƂ̓ςɂȂ
+		//(@s̗͉]s̗ƓȂ̂ŁA𐳋KĎg)
+		const glm::vec3& direction = lights.directional.direction;
+		glm::vec3 dirLightDirOnModel;
+		for (int i = 0; i < 3; ++i)
+		{
+			const float length = glm::length(matNormal[i]);
+			dirLightDirOnModel[i] = length > 0 ? glm::dot(matNormal[i], direction) / length : 0;
+		}
+		Draw(mesh, matModel, matVP * matModel, dirLightDirOnModel, lod);
+	}
+
+/**
+* vZς݂̍WϊsƃCǧw肵ăbV`悷
+*
+* @param mesh           `悷郁bV
+* @param matModel       fs(]EgkEsړ܂ނ)
+* @param matMVP         f r[ vWFNVs
+* @param lightDirection fWn̎wCǧ
+* @param lod            `悷ڍדx(0=̌`. ͈͊O̒l͍ł߂ڍדxɂȂ)
+*
+* TransformBatchł܂Ƃ߂ČvZʂgƂ͂g.
+* ObjectDataubNvOłMVPsVF[_[ŋ߂̂ŁAmatModelg.
+* ̊֐gOɁAUse֐sĂ
+*/
+	void Program::Draw(const Mesh& mesh, const glm::mat4& matModel, const glm::mat4& matMVP,
+		const glm::vec3& lightDirection, int lod)
+	{
+		if (id == 0)
+		{
+			return;
+		}
+		if (hasObjectBlock)
+		{
+			Draw(mesh, matModel, lod);
+			return;
+		}
 
-		//f r[ vWFNVsvZAGPUɓ]
-		const glm::mat4 matMVP = matVP * matModel;
-		glUniformMatrix4fv(locMatMVP, 1, GL_FALSE, &matMVP[0][0]);
+		//kꂽ_W߂ϊ܂߂MVPsAGPUɓ]
+		GLStateCache& cache = GLStateCache::Instance();
+		cache.SetUniform(id, locMatMVP, matMVP * MakeDequantizeMatrix(mesh));
 
-		//wCǧfWnɕϊāAGPUɓ]
-		const glm::mat3 matInvRotate = glm::inverse(glm::mat3(matRotateYXZ));
+		//]Ȃ烉CǧȂ̂ŁAO̕`Ɠl͓]ȗ
 		if (locDirLightDir >= 0)
 		{
-			const glm::vec3 dirLightDirOnModel = matInvRotate * lights.directional.direction;
-			glUniform3fv(locDirLightDir, 1, &dirLightDirOnModel.x);
+			cache.SetUniform(id, locDirLightDir, lightDirection);
 		}
 
-		//bV`悷
+		//w肳ꂽڍדxŃbV`悷
+		const MeshLod& range = mesh.lods[std::min(std::max(lod, 0), mesh.lodCount - 1)];
 		glDrawElementsBaseVertex(
-			mesh.mode, mesh.count, GL_UNSIGNED_SHORT, mesh.indices, mesh.baseVertex);
+			mesh.mode, range.count, mesh.indexType, range.indices, mesh.baseVertex);
+	}
+
+/**
+* `Ɏgr[ vWFNVs擾
+*
+* @return SetViewProjectionMatrixŐݒ肵r[ vWFNVs
+*/
+	const glm::mat4& Program::GetViewProjectionMatrix() const
+	{
+		return matVP;
+	}
+
+/**
+* `Ɏg郉Cg擾
+*
+* @return SetLightListŐݒ肵Cg
+*/
+	const LightList& Program::GetLightList() const
+	{
+		return lights;
+	}
+
+/**
+* t[Pʂ̃f[^(FrameDataubN)݁AoCfBO |CgɊ蓖Ă
+*
+* @param buffer uniformf[^̏ݐ
+*
+* SetViewProjectionMatrixSetLightListŐݒ肵l.
+* FlushDrawsRenderQueue::Flush`̑OɌĂяo
+*/
+	void Program::BindFrameUniform(UniformRingBuffer& buffer)
+	{
+		const size_t offset = buffer.Allocate(sizeof(FrameUniform));
+		if (offset >= buffer.Capacity())
+		{
+			return;
+		}
+		FrameUniform& frame = *static_cast<FrameUniform*>(buffer.Data(offset));
+		frame.matView = matView;
+		frame.matProj = matProj;
+		frame.matViewProj = matVP;
+		frame.ambientLightColor = glm::vec4(lights.ambient.color, 0);
+		frame.directionalLightDirection = glm::vec4(lights.directional.direction, 0);
+		frame.directionalLightColor = glm::vec4(lights.directional.color, 0);
+		buffer.Flush();
+		buffer.BindRange(frameUniformBinding, offset, sizeof(FrameUniform));
+	}
+
+/**
+* Drawŗ߂`܂Ƃ߂Ďs
+*
+* @param buffer uniformf[^̏ݐ
+*
+* t[̃f[^ƑSĂ̂̃̕f[^xɏ݁AFrameDataubN1񂾂蓖Ă.
+* ObjectDataubNɂmaxObjectsPerBlock蓖āA`悲Ƃuniformݒ͍sȂ.
+* ̔ԍ̓x[XCX^XƂēnA_objectIndexAttributeœǂݎ.
+* x[XCX^XgȂ(GL 4.1)ł́A̔ԍ萔̒_ƂĐݒ肷
+*/
+	void Program::FlushDraws(UniformRingBuffer& buffer)
+	{
+		if (drawCommands.empty())
+		{
+			return;
+		}
+		const size_t blockBytes = sizeof(ObjectUniform) * maxObjectsPerBlock;
+		if (buffer.Capacity() < blockBytes * 2)
+		{
+			std::cerr << "ERROR: uniformobt@邽ߕ`ł܂\n";
+			drawCommands.clear();
+			objectUniforms.clear();
+			return;
+		}
+		GLStateCache::Instance().UseProgram(id);
+		const bool hasBaseInstance = GLEW_ARB_base_instance != 0;
+
+		//̂̃f[^Aobt@̔Ɏ܂ʂ܂Ƃ߂ď
+		const size_t blocksPerBatch = buffer.Capacity() / 2 / blockBytes;
+		size_t first = 0;
+		while (first < objectUniforms.size())
+		{
+			const size_t count = std::min(objectUniforms.size() - first,
+				blocksPerBatch * maxObjectsPerBlock);
+
+			//ObjectDataubN͏ɐ錾ǂ̑傫Ŋ蓖ĂKv̂ŁA
+			//Ō̃ubNɖȂ܂߂ăubNPʂŊmۂ
+			const size_t blockCount = (count + maxObjectsPerBlock - 1) / maxObjectsPerBlock;
+			const size_t offset = buffer.Allocate(blockBytes * blockCount);
+			if (offset >= buffer.Capacity())
+			{
+				break;
+			}
+			memcpy(buffer.Data(offset), objectUniforms.data() + first,
+				sizeof(ObjectUniform) * count);
+			buffer.Flush();
+
+			//Oɏt[̃f[^͈ď㏑Ă邩Ȃ̂ŁA񏑂
+			BindFrameUniform(buffer);
+			for (size_t block = 0; block < blockCount; ++block)
+			{
+				const size_t blockFirst = block * maxObjectsPerBlock;
+				const size_t objectCount = std::min<size_t>(count - blockFirst, maxObjectsPerBlock);
+				buffer.BindRange(objectUniformBinding, offset + blockBytes * block, blockBytes);
+				for (size_t i = 0; i < objectCount; ++i)
+				{
+					const DrawCommand& e = drawCommands[first + blockFirst + i];
+					if (hasBaseInstance)
+					{
+						glDrawElementsInstancedBaseVertexBaseInstance(e.mode, e.count, e.indexType,
+							e.indices, 1, e.baseVertex, static_cast<GLuint>(i));
+					}
+					else
+					{
+						glVertexAttribI1ui(objectIndexAttribute, static_cast<GLuint>(i));
+						glDrawElementsBaseVertex(e.mode, e.count, e.indexType, e.indices, e.baseVertex);
+					}
+				}
+			}
+
+			//̊蓖ĂĂ̗̈ɖ߂ĂƂɁA`̊҂Ă悤ɂ
+			buffer.Fence();
+			first += count;
+		}
+		drawCommands.clear();
+		objectUniforms.clear();
 	}
 
 }//shader namespace
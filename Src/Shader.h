@@ -4,8 +4,11 @@
 #ifndef SHADER_H_INCLUDED
 #define SHADER_H_INCLUDED
 #include <GL/glew.h>
+#include "UniformBuffer.h"
 #include <glm/vec3.hpp>
 #include <glm/mat4x4.hpp>
+#include <vector>
+#include <stdint.h>
 
 struct Mesh;//bV\̂̐s錾
 
@@ -13,6 +16,9 @@ namespace Shader{
 
 	GLuint Build(const GLchar* vsCode, const GLchar* fsCode);
 	GLuint BuildFromFile(const char* vsPath, const char* fsPath);
+	GLuint BuildWithCache(const GLchar* vsCode, const GLchar* fsCode);
+	uint64_t HashSource(const GLchar* vsCode, const GLchar* fsCode);
+	std::vector<GLchar> ReadFile(const char* path);
 
 /**
 * 
@@ -55,11 +61,21 @@ namespace Shader{
 		void Reset(GLuint programId);
 		bool IsNull() const;
 		void Use();
-		void BindTexture(GLuint, GLuint);
+		void BindTexture(GLuint, GLuint, GLenum target = GL_TEXTURE_2D);
+		void SetTextureLayer(GLint);
 		void SetLightList(const LightList&);
 		void SetViewProjectionMatrix(const glm::mat4&);
+		void SetViewProjectionMatrix(const glm::mat4& matView, const glm::mat4& matProj);
 		void Draw(const Mesh& mesh,
-			const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale);
+			const glm::vec3& translate, const glm::vec3& rotate, const glm::vec3& scale,
+			int lod = 0);
+		void Draw(const Mesh& mesh, const glm::mat4& matModel, int lod = 0);
+		void Draw(const Mesh& mesh, const glm::mat4& matModel, const glm::mat4& matMVP,
+			const glm::vec3& lightDirection, int lod = 0);
+		const glm::mat4& GetViewProjectionMatrix() const;
+		const LightList& GetLightList() const;
+		void BindFrameUniform(UniformRingBuffer& buffer);
+		void FlushDraws(UniformRingBuffer& buffer);
 
 	private:
 		GLuint id = 0;//vOID
@@ -69,9 +85,26 @@ namespace Shader{
 		GLint locDirLightDir = -1;
 		GLint locDirLightCol = -1;
 		GLint locAmbLightCol = -1;
+		GLint locTextureLayer = -1;
 
 		glm::mat4 matVP = glm::mat4(1);//r[vWFNVs
+		glm::mat4 matView = glm::mat4(1);//r[s
+		glm::mat4 matProj = glm::mat4(1);//vWFNVs
 		LightList lights;
+
+		//ObjectDataubNvOŁAFlushDraws܂ŗ߂Ă`
+		struct DrawCommand
+		{
+			GLenum mode;
+			GLsizei count;
+			GLenum indexType;
+			const GLvoid* indices;
+			GLint baseVertex;
+		};
+		bool hasObjectBlock = false;
+		GLint textureLayer = 0;
+		std::vector<DrawCommand> drawCommands;
+		std::vector<ObjectUniform> objectUniforms;
 	};
 }//shader namespace
 #endif //SHADER_H_INCLUDED
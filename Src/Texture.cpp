@@ -2,10 +2,16 @@
 * @file Texture.cpp
 */
 #include "Texture.h"
+#include "AssetPack.h"
+#include "GLStateCache.h"
+#include "PixelConverter.h"
+#include "MipmapGenerator.h"
 #include <stdint.h>
 #include <vector>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <string.h>
 
 //eNX`֘Å֐NXi[閼O
 namespace Texture{
@@ -13,39 +19,45 @@ namespace Texture{
 /**
 * 2DeNX`쐬
 *
-* @param width eNX`̕(sNZ)
-* @param height eNX`̍(sNZ)
-* @param data eNX`f[^ւ̃|C^
+* @param width      eNX`̕(sNZ)
+* @param height     eNX`̍(sNZ)
+* @param data       eNX`f[^ւ̃|C^(nullptrȂ̈̊mۂ̂)
+* @param format     f̌`
+* @param type       f̗vf̌^
+* @param levelCount ~bv}bv̒i(data͍ł傫îݓ])
+* @param sampler    eNX`̓ǂݎ@
 *
 * @retval 0ȊO 쐬eNX` IuWFNgID
 * @retval 0 eNX`̍쐬Ɏs
 */
 	GLuint CreateImage2D(GLsizei width, GLsizei height, const GLvoid* data,
-		GLenum format, GLenum type)
+		GLenum format, GLenum type, GLsizei levelCount, const SamplerState& sampler)
 	{
 		GLuint id;
 		glGenTextures(1, &id);
-		glBindTexture(GL_TEXTURE_2D, id);
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, id);
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
 			width, height, 0, format, type, data);
+		//2iڈȍ~͗̈悾mۂĂ
+		for (GLint level = 1; level < levelCount; ++level)
+		{
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, std::max(1, width >> level),
+				std::max(1, height >> level), 0, format, type, nullptr);
+		}
 		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 		const GLenum result = glGetError();
 		if (result != GL_NO_ERROR)//eNX`̍쐬
 		{
 			std::cerr << "ERROR: eNX`̍쐬Ɏs(0x" << std::hex << result << ")";
-			glBindTexture(GL_TEXTURE_2D, 0);
-			glDeleteTextures(1, &id);
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+			GLStateCache::Instance().DeleteTexture(id);
 			return 0;
 		}
 
 		//eNX`̃p[^ݒ肷
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(levelCount - 1, 0));
 
 		//1vf̉摜f[^̏ꍇA(R,R,R,1)Ƃēǂݎ悤ɂ
 		if (format == GL_RED)
@@ -53,7 +65,8 @@ namespace Texture{
 			const GLint swizzle[] = { GL_RED,GL_RED,GL_RED,GL_ONE };
 			glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 		}
-		glBindTexture(GL_TEXTURE_2D, 0);
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+		SetSamplerState(id, sampler);
 
 		return id;
 	}
@@ -61,85 +74,850 @@ namespace Texture{
 /**
 * t@C2DeNX`ǂݍ
 *
-* @param path 2DeNX`Ƃēǂݍރt@C
+* @param path    2DeNX`Ƃēǂݍރt@C
+* @param sampler eNX`̓ǂݎ@
 *
 * @retval 0ȊO 쐬eNX` IuWFNgID
 * @retval 0 eNX`̍쐬Ɏs
+*
+* ǂݎ@~bv}bvgꍇACPUŃ~bv}bv쐬1i].
+* gq.ktxȂubNkeNX`Ƃēǂݍ
 */
-	GLuint LoadImage2D(const char* path)
+	GLuint LoadImage2D(const char* path, const SamplerState& sampler)
 	{
-		//TGAwb_ǂݍ
-		std::basic_ifstream<uint8_t> ifs;
-		ifs.open(path, std::ios_base::binary);
-		std::vector <uint8_t> buf1(1000000);
-		ifs.rdbuf()->pubsetbuf(buf1.data(), buf1.size());
+		if (IsCompressedImagePath(path))
+		{
+			return LoadCompressed2D(path, sampler);
+		}
+		ImageData image;
+		if (!LoadImageData(path, image))
+		{
+			return 0;
+		}
+		std::vector<ImageData> mipLevels;
+		if (UsesMipmap(sampler))
+		{
+			MipmapGenerator::Generate(image, mipLevels);
+		}
 
-		uint8_t tgaHeader[18];
-		ifs.read(tgaHeader, 18);
+		//ǂݍ񂾉摜f[^eNX`쐬
+		const GLuint id = CreateImage2D(image.width, image.height, image.data.data(),
+			image.format, image.type, static_cast<GLsizei>(mipLevels.size() + 1), sampler);
+		if (id)
+		{
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, id);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			for (size_t i = 0; i < mipLevels.size(); ++i)
+			{
+				const ImageData& level = mipLevels[i];
+				glTexSubImage2D(GL_TEXTURE_2D, static_cast<GLint>(i + 1), 0, 0,
+					level.width, level.height, level.format, level.type, level.data.data());
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+		}
+		return id;
+	}
 
-		//C[WIDǂݔ΂
-		ifs.ignore(tgaHeader[0]);
+/**
+* ǂݎ@~bv}bvgׂ
+*
+* @param sampler ׂǂݎ@
+*
+* @retval true  ~bv}bvg
+* @retval false ~bv}bvgȂ
+*/
+	bool UsesMipmap(const SamplerState& sampler)
+	{
+		return sampler.minFilter != GL_NEAREST && sampler.minFilter != GL_LINEAR;
+	}
 
-		//J[}bvǂݔ΂
-		if (tgaHeader[1])
+/**
+* eNX`̓ǂݎ@ݒ肷
+*
+* @param texId   ݒ肷eNX` IuWFNgID
+* @param sampler ǂݎ@
+* @param target  eNX`̎(GL_TEXTURE_2D܂GL_TEXTURE_2D_ARRAY)
+*
+* ٕtB^͊g@\ɑΉĂꍇAGPȔɎ߂Đݒ肷
+*/
+	void SetSamplerState(GLuint texId, const SamplerState& sampler, GLenum target)
+	{
+		GLStateCache::Instance().BindTexture(0, target, texId);
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, sampler.minFilter);
+		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, sampler.magFilter);
+		glTexParameteri(target, GL_TEXTURE_WRAP_S, sampler.wrapS);
+		glTexParameteri(target, GL_TEXTURE_WRAP_T, sampler.wrapT);
+		if (GLEW_EXT_texture_filter_anisotropic)
+		{
+			GLfloat maxAnisotropy = 1.0f;
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+			glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+				std::min(std::max(sampler.maxAnisotropy, 1.0f), maxAnisotropy));
+		}
+		GLStateCache::Instance().BindTexture(0, target, 0);
+	}
+
+/**
+* 2DeNX`z쐬
+*
+* @param width      ew̕(sNZ)
+* @param height     ew̍(sNZ)
+* @param layerCount w̐
+* @param format     ]f̌`
+* @param type       ]f̗vf̌^
+* @param levelCount ~bv}bv̒i
+* @param sampler    eNX`̓ǂݎ@
+*
+* @retval 0ȊO 쐬eNX` IuWFNgID
+* @retval 0 eNX`̍쐬Ɏs
+*
+* ̈̊mۂs. ff[^UploadImage2DRowsőwƂɓ]邱
+*/
+	GLuint CreateImage2DArray(GLsizei width, GLsizei height, GLsizei layerCount,
+		GLenum format, GLenum type, GLsizei levelCount, const SamplerState& sampler)
+	{
+		GLuint id;
+		glGenTextures(1, &id);
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, id);
+		for (GLint level = 0; level < levelCount; ++level)
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, std::max(1, width >> level),
+				std::max(1, height >> level), layerCount, 0, format, type, nullptr);
+		}
+
+		const GLenum result = glGetError();
+		if (result != GL_NO_ERROR)
+		{
+			std::cerr << "ERROR: eNX`z̍쐬Ɏs(0x" << std::hex << result << std::dec << ")\n";
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+			GLStateCache::Instance().DeleteTexture(id);
+			return 0;
+		}
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, std::max(levelCount - 1, 0));
+		if (format == GL_RED)
+		{
+			const GLint swizzle[] = { GL_RED,GL_RED,GL_RED,GL_ONE };
+			glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+		SetSamplerState(id, sampler, GL_TEXTURE_2D_ARRAY);
+		return id;
+	}
+
+/**
+* ̉摜t@C𓯂傫̑wɂ낦ēǂݍ
+*
+* @param paths  摜t@C̔z
+* @param count  paths̗vf
+* @param layers ǂݍ񂾉摜̊i[(pathsƓ)
+*
+* @retval true  ǂݍݐ
+* @retval false ǂݍ߂Ȃt@C
+*
+* SĂ̑wł傫ƍɍ킹Ċg傷. SẲ摜RGBA8ɂ낦.
+* OpenGL̊֐gȂ̂ŁA[J[XbhĂяoƂł
+*/
+	bool LoadImageArrayData(const char* const* paths, size_t count, std::vector<ImageData>& layers)
+	{
+		layers.resize(count);
+		GLsizei width = 1;
+		GLsizei height = 1;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!LoadImageData(paths[i], layers[i]))
+			{
+				return false;
+			}
+			//摜RGBA8ɕϊ
+			if (layers[i].format == GL_RED)
+			{
+				std::vector<uint8_t> rgba(layers[i].data.size() * 4);
+				for (size_t p = 0; p < layers[i].data.size(); ++p)
+				{
+					rgba[p * 4 + 0] = rgba[p * 4 + 1] = rgba[p * 4 + 2] = layers[i].data[p];
+					rgba[p * 4 + 3] = 255;
+				}
+				layers[i].data.swap(rgba);
+				layers[i].format = GL_RGBA;
+			}
+			width = std::max(width, layers[i].width);
+			height = std::max(height, layers[i].height);
+		}
+		for (ImageData& layer : layers)
+		{
+			if (layer.width != width || layer.height != height)
+			{
+				ImageData resized;
+				MipmapGenerator::Resize(layer, width, height, resized);
+				layer = std::move(resized);
+			}
+		}
+		return true;
+	}
+
+/**
+* ̉摜t@C2DeNX`z쐬
+*
+* @param paths   摜t@C̔z(z̏Ԃw̔ԍɂȂ)
+* @param count   paths̗vf
+* @param sampler eNX`̓ǂݎ@
+*
+* @retval 0ȊO 쐬eNX` IuWFNgID
+* @retval 0 eNX`̍쐬Ɏs
+*
+* 1̃eNX`ɂ܂Ƃ߂邱ƂŁAeNX`؂ւɕ`ł悤ɂȂ
+*/
+	GLuint LoadImage2DArray(const char* const* paths, size_t count, const SamplerState& sampler)
+	{
+		std::vector<ImageData> layers;
+		if (count == 0 || !LoadImageArrayData(paths, count, layers))
+		{
+			return 0;
+		}
+		std::vector<std::vector<ImageData>> mipLevels(count);
+		if (UsesMipmap(sampler))
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				MipmapGenerator::Generate(layers[i], mipLevels[i]);
+			}
+		}
+
+		const ImageData& base = layers[0];
+		const GLuint id = CreateImage2DArray(base.width, base.height, static_cast<GLsizei>(count),
+			base.format, base.type, static_cast<GLsizei>(mipLevels[0].size() + 1), sampler);
+		if (id)
+		{
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, id);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			for (size_t i = 0; i < count; ++i)
+			{
+				for (size_t level = 0; level <= mipLevels[i].size(); ++level)
+				{
+					const ImageData& image = level == 0 ? layers[i] : mipLevels[i][level - 1];
+					glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level),
+						0, 0, static_cast<GLint>(i), image.width, image.height, 1,
+						image.format, image.type, image.data.data());
+				}
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D_ARRAY, 0);
+		}
+		return id;
+	}
+
+	//KTXt@C̎ʎq
+	const uint8_t ktxIdentifier[12] = {
+		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+	};
+
+/**
+* KTXt@C̃wb_
+*/
+	struct KtxHeader
+	{
+		uint8_t identifier[12];
+		uint32_t endianness;
+		uint32_t glType;//k`ł0
+		uint32_t glTypeSize;//k`ł1
+		uint32_t glFormat;//k`ł0
+		uint32_t glInternalFormat;
+		uint32_t glBaseInternalFormat;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t numberOfArrayElements;
+		uint32_t numberOfFaces;
+		uint32_t numberOfMipmapLevels;
+		uint32_t bytesOfKeyValueData;
+	};
+
+/**
+* ubNk`ɑΉĂ邩ׂ
+*
+* @param internalFormat k`
+*
+* @retval true  ΉĂ
+* @retval false ΉĂȂ
+*/
+	bool IsCompressedFormatSupported(GLenum internalFormat)
+	{
+		switch (internalFormat)
+		{
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			return GLEW_EXT_texture_compression_s3tc != 0;
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+			return GLEW_ARB_texture_compression_bptc != 0;
+		default:
+			return false;
+		}
+	}
+
+/**
+* ubNk`1ubN(4x4f)̃oCg擾
+*
+* @param internalFormat k`
+*
+* @return 1ubÑoCg. ΉĂȂ`Ȃ0
+*/
+	size_t CompressedBlockBytes(GLenum internalFormat)
+	{
+		switch (internalFormat)
 		{
-			const int colorMapLength = tgaHeader[5] + tgaHeader[6] * 0x100;
-			const int colorMapEntrySize = tgaHeader[7];
-			const int colorMapSize = colorMapLength * colorMapEntrySize / 8;
-			ifs.ignore(colorMapSize);
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+			return 8;
+		case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+/**
+* ubNkꂽ2DeNX`쐬
+*
+* @param image   eNX`ɂ鈳kf[^
+* @param sampler eNX`̓ǂݎ@
+*
+* @retval 0ȊO 쐬eNX` IuWFNgID
+* @retval 0 eNX`̍쐬Ɏs
+*
+* kf[^CPUœWJÂ܂GPUɓ]
+*/
+	GLuint CreateCompressedImage2D(const CompressedImage& image, const SamplerState& sampler)
+	{
+		if (image.levels.empty())
+		{
+			return 0;
+		}
+		if (!IsCompressedFormatSupported(image.internalFormat))
+		{
+			std::cerr << "ERROR: k`(0x" << std::hex << image.internalFormat << std::dec <<
+				")ɑΉĂ܂\n";
+			return 0;
 		}
 
-		//摜f[^ǂݍ
+		GLuint id;
+		glGenTextures(1, &id);
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, id);
+		for (size_t i = 0; i < image.levels.size(); ++i)
+		{
+			const CompressedImage::Level& level = image.levels[i];
+			glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), image.internalFormat,
+				level.width, level.height, 0, level.size, level.data);
+		}
+
+		const GLenum result = glGetError();
+		if (result != GL_NO_ERROR)
+		{
+			std::cerr << "ERROR: keNX`̍쐬Ɏs(0x" << std::hex << result << std::dec << ")\n";
+			GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+			GLStateCache::Instance().DeleteTexture(id);
+			return 0;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+			static_cast<GLint>(image.levels.size() - 1));
+		GLStateCache::Instance().BindTexture(0, GL_TEXTURE_2D, 0);
+		SetSamplerState(id, sampler);
+		return id;
+	}
+
+/**
+* ubNkeNX` t@C2DeNX`ǂݍ
+*
+* @param path    KTXt@C
+* @param sampler eNX`̓ǂݎ@
+*
+* @retval 0ȊO 쐬eNX` IuWFNgID
+* @retval 0 eNX`̍쐬Ɏs
+*
+* t@CɃ}bvARs[glCompressedTexImage2D֓n.
+* ~bv}bv̓t@CɊi[Ă̂g
+*/
+	GLuint LoadCompressed2D(const char* path, const SamplerState& sampler)
+	{
+		AssetFile file(path);
+		if (file.IsNull())
+		{
+			std::cerr << "ERROR:" << path << "J܂\n";
+			return 0;
+		}
+		CompressedImage image;
+		if (!ParseCompressedImage(file.Data(), file.Size(), image))
+		{
+			std::cerr << "ERROR:" << path << "͑ΉĂȂ`ł\n";
+			return 0;
+		}
+		return CreateCompressedImage2D(image, sampler);
+	}
+
+/**
+* t@CubNkeNX` t@Cׂ
+*
+* @param path t@C
+*
+* @retval true  gq.ktx
+* @retval false ȊO
+*/
+	bool IsCompressedImagePath(const char* path)
+	{
+		const size_t length = strlen(path);
+		return length >= 4 && strcmp(path + length - 4, ".ktx") == 0;
+	}
+
+/**
+* KTXt@C̓e͂
+*
+* @param data  t@C̓e
+* @param size  t@C̃oCg
+* @param image ͌ʂ̊i[(eĩf[^data̒w)
+*
+* @retval true  ͐
+* @retval false ΉĂȂ`A܂̓f[^sĂ
+*
+* ΉĂ̂̓gGfBAŁAk`2DeNX`1.
+* eĩoCǵA̒ȋ傫狁߂ubNƈvȂ΂ȂȂ.
+* 1x1f̃~bv}bvi͖
+*/
+	bool ParseCompressedImage(const uint8_t* data, size_t size, CompressedImage& image)
+	{
+		KtxHeader header;
+		if (size < sizeof(header))
+		{
+			return false;
+		}
+		memcpy(&header, data, sizeof(header));
+		if (memcmp(header.identifier, ktxIdentifier, sizeof(ktxIdentifier)) != 0 ||
+			header.endianness != 0x04030201 || header.glType != 0 ||
+			header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth > 1 ||
+			header.numberOfArrayElements > 1 || header.numberOfFaces != 1 ||
+			header.pixelWidth > INT32_MAX || header.pixelHeight > INT32_MAX)
+		{
+			return false;
+		}
+		const size_t blockBytes = CompressedBlockBytes(header.glInternalFormat);
+		if (blockBytes == 0)
+		{
+			return false;
+		}
+
+		image.internalFormat = header.glInternalFormat;
+		image.width = header.pixelWidth;
+		image.height = header.pixelHeight;
+		image.levels.clear();
+		size_t offset = sizeof(header) + header.bytesOfKeyValueData;
+		uint32_t maxLevelCount = 1;//1x1fɂȂ܂ł̒i(floor(log2(max(w, h))) + 1)
+		for (uint32_t w = std::max(header.pixelWidth, header.pixelHeight); w > 1; w >>= 1)
+		{
+			++maxLevelCount;
+		}
+		const uint32_t levelCount =
+			std::min(std::max<uint32_t>(header.numberOfMipmapLevels, 1), maxLevelCount);
+		for (uint32_t i = 0; i < levelCount; ++i)
+		{
+			uint32_t imageSize;
+			if (offset + sizeof(imageSize) > size)
+			{
+				return false;
+			}
+			memcpy(&imageSize, data + offset, sizeof(imageSize));
+			offset += sizeof(imageSize);
+			if (offset + imageSize > size)
+			{
+				return false;
+			}
+			const GLsizei width = std::max<GLsizei>(1, image.width >> i);
+			const GLsizei height = std::max<GLsizei>(1, image.height >> i);
+			const uint64_t levelBytes = static_cast<uint64_t>((width + 3) / 4) *
+				((height + 3) / 4) * blockBytes;
+			if (imageSize != levelBytes)
+			{
+				return false;
+			}
+			const CompressedImage::Level level = {
+				width, height, data + offset, static_cast<GLsizei>(imageSize)
+			};
+			image.levels.push_back(level);
+			offset += (imageSize + 3) & ~3u;
+		}
+		return true;
+	}
+
+/**
+* ubNkeNX`KTXt@Cɏo
+*
+* @param path  ot@C
+* @param image okf[^
+*
+* @retval true  o
+* @retval false os
+*/
+	bool SaveCompressedImage(const char* path, const CompressedImage& image)
+	{
+		std::ofstream ofs(path, std::ios_base::binary | std::ios_base::trunc);
+		if (!ofs.is_open())
+		{
+			std::cerr << "ERROR: " << path << "쐬ł܂\n";
+			return false;
+		}
+
+		KtxHeader header = {};
+		memcpy(header.identifier, ktxIdentifier, sizeof(ktxIdentifier));
+		header.endianness = 0x04030201;
+		header.glTypeSize = 1;
+		header.glInternalFormat = image.internalFormat;
+		header.glBaseInternalFormat =
+			image.internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? GL_RGB : GL_RGBA;
+		header.pixelWidth = image.width;
+		header.pixelHeight = image.height;
+		header.numberOfFaces = 1;
+		header.numberOfMipmapLevels = static_cast<uint32_t>(image.levels.size());
+		ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		//eĩoCgƃf[^A4oCgEɑďo
+		static const char padding[4] = {};
+		for (const CompressedImage::Level& level : image.levels)
+		{
+			const uint32_t imageSize = level.size;
+			ofs.write(reinterpret_cast<const char*>(&imageSize), sizeof(imageSize));
+			ofs.write(reinterpret_cast<const char*>(level.data), level.size);
+			ofs.write(padding, ((imageSize + 3) & ~3u) - imageSize);
+		}
+		return ofs.good();
+	}
+
+/**
+* RLEkꂽTGẢff[^WJ
+*
+* @param src           kf[^̐擪
+* @param srcEnd        kf[^̏I[
+* @param bytesPerPixel 1f̃oCg
+* @param pixelCount    WJf
+* @param dst           WJ(pixelCount * bytesPerPixeloCg)
+*
+* @retval true  WJ
+* @retval false f[^rŏIĂ
+*/
+	bool DecodeTgaRle(const uint8_t* src, const uint8_t* srcEnd,
+		size_t bytesPerPixel, size_t pixelCount, uint8_t* dst)
+	{
+		const uint8_t* const dstEnd = dst + pixelCount * bytesPerPixel;
+		while (dst < dstEnd)
+		{
+			if (src >= srcEnd)
+			{
+				return false;
+			}
+			//ŏʃrbg1Ȃ瓯f̌JԂA0Ȃ񈳏k̉f̕
+			const uint8_t packet = *src++;
+			const size_t count = std::min<size_t>((packet & 0x7f) + 1,
+				(dstEnd - dst) / bytesPerPixel);
+			if (packet & 0x80)
+			{
+				if (srcEnd - src < (ptrdiff_t)bytesPerPixel)
+				{
+					return false;
+				}
+				for (size_t i = 0; i < count; ++i, dst += bytesPerPixel)
+				{
+					memcpy(dst, src, bytesPerPixel);
+				}
+				src += bytesPerPixel;
+			}
+			else
+			{
+				const size_t size = count * bytesPerPixel;
+				if ((size_t)(srcEnd - src) < size)
+				{
+					return false;
+				}
+				memcpy(dst, src, size);
+				src += size;
+				dst += size;
+			}
+		}
+		return true;
+	}
+
+/**
+* TGẢfRGBA8ɕϊ
+*
+* @param src        ϊ̉f
+* @param pixelDepth 1f̃rbg(15, 16, 24, 32)
+* @param alphaBits  At@̃rbg(TGAwb_̑rbg)
+* @param dst        ϊ(count * 4oCg)
+* @param count      f
+*
+* @retval true  ϊ
+* @retval false ΉĂȂrbg
+*/
+	bool ConvertTgaPixels(const uint8_t* src, int pixelDepth, int alphaBits,
+		uint8_t* dst, size_t count)
+	{
+		switch (pixelDepth)
+		{
+		case 15:
+		case 16:
+			PixelConverter::Bgra5551ToRgba(src, dst, count, pixelDepth == 16 && alphaBits > 0);
+			return true;
+		case 24:
+			PixelConverter::BgrToRgba(src, dst, count);
+			return true;
+		case 32:
+			PixelConverter::BgraToRgba(src, dst, count);
+			return true;
+		default:
+			return false;
+		}
+	}
+
+/**
+* 摜̏Ŕ]
+*
+* @param image      ]摜
+* @param vertical   ㉺𔽓]Ȃtrue
+* @param horizontal E𔽓]Ȃtrue
+*/
+	void FlipImage(ImageData& image, bool vertical, bool horizontal)
+	{
+		const size_t pixelSize = GetBytesPerPixel(image.format, image.type);
+		const size_t lineSize = image.width * pixelSize;
+		uint8_t* const data = image.data.data();
+		if (vertical)
+		{
+			for (GLsizei y = 0; y < image.height / 2; ++y)
+			{
+				uint8_t* top = data + lineSize * y;
+				uint8_t* bottom = data + lineSize * (image.height - 1 - y);
+				std::swap_ranges(top, top + lineSize, bottom);
+			}
+		}
+		if (horizontal)
+		{
+			for (GLsizei y = 0; y < image.height; ++y)
+			{
+				uint8_t* left = data + lineSize * y;
+				uint8_t* right = left + lineSize - pixelSize;
+				for (; left < right; left += pixelSize, right -= pixelSize)
+				{
+					std::swap_ranges(left, left + pixelSize, right);
+				}
+			}
+		}
+	}
+
+/**
+* t@C摜f[^ǂݍ
+*
+* @param path  ǂݍރt@C
+* @param image ǂݍ񂾉摜f[^̊i[
+*
+* @retval true  ǂݍݐ
+* @retval false ǂݍݎs
+*
+* ΉĂ`TGA̎1,2,3(񈳏k)9,10,11(RLEk).
+* J[摜RGBA8A摜RED8ɕϊāA̍s珇Ɋi[.
+* OpenGL̊֐gȂ̂ŁA[J[XbhĂяoƂł
+*/
+	bool LoadImageData(const char* path, ImageData& image)
+	{
+		//t@CŜɃ}bvēǂݍ
+		AssetFile file(path);
+		if (file.IsNull() || file.Size() < 18)
+		{
+			std::cerr << "ERROR:" << path << "J܂\n";
+			return false;
+		}
+		const uint8_t* const tgaHeader = file.Data();
+		const uint8_t* const fileEnd = file.Data() + file.Size();
+
+		const int imageType = tgaHeader[2];
+		const bool isRle = imageType & 8;
+		const int colorType = imageType & ~8;//1=J[}bv, 2=tJ[, 3=
+		const int colorMapFirst = tgaHeader[3] + tgaHeader[4] * 0x100;
+		const int colorMapLength = tgaHeader[5] + tgaHeader[6] * 0x100;
+		const int colorMapEntrySize = tgaHeader[7];
 		const int width = tgaHeader[12] + tgaHeader[13] * 0x100;
 		const int height = tgaHeader[14] + tgaHeader[15] * 0x100;
 		const int pixelDepth = tgaHeader[16];
-		const int imageSize = width * height * pixelDepth / 8;
-		std::vector<uint8_t> buf(imageSize);
-		ifs.read(buf.data(), imageSize);
+		const int alphaBits = tgaHeader[17] & 0x0f;
+		const bool isRightToLeft = (tgaHeader[17] & 0x10) != 0;
+		const bool isTopToBottom = (tgaHeader[17] & 0x20) != 0;
+		const bool isSupported =
+			(colorType == 1 && pixelDepth == 8 && tgaHeader[1] == 1) ||
+			(colorType == 2 && (pixelDepth == 15 || pixelDepth == 16 ||
+				pixelDepth == 24 || pixelDepth == 32)) ||
+			(colorType == 3 && pixelDepth == 8);
+		if (!isSupported || width <= 0 || height <= 0)
+		{
+			std::cerr << "ERROR:" << path << "͑ΉĂȂ`ł(=" <<
+				imageType << " rbg=" << pixelDepth << ")\n";
+			return false;
+		}
+
+		//C[WIDƃJ[}bv̈ʒu߂
+		const uint8_t* colorMap = tgaHeader + 18 + tgaHeader[0];
+		const size_t colorMapEntryBytes = (colorMapEntrySize + 7) / 8;
+		const uint8_t* pixels = colorMap;
+		if (tgaHeader[1])
+		{
+			pixels += colorMapLength * colorMapEntryBytes;
+		}
+		if (pixels > fileEnd)
+		{
+			std::cerr << "ERROR:" << path << "̃f[^sĂ܂\n";
+			return false;
+		}
 
-		//摜f[^uォ牺vŊi[ĂꍇA㉺ւ
-		if (tgaHeader[17] & 0x20)
+		//RLEkĂΓWJ
+		const size_t pixelCount = (size_t)width * height;
+		const size_t pixelBytes = (pixelDepth + 7) / 8;
+		std::vector<uint8_t> decoded;
+		if (isRle)
 		{
-			const int lineSize = width * pixelDepth / 8;
-			std::vector<uint8_t> tmp(imageSize);
-			std::vector<uint8_t>::iterator source = buf.begin();
-			std::vector<uint8_t>::iterator destination = tmp.end();
-			for (int i = 0; i < height; i++)
+			decoded.resize(pixelCount * pixelBytes);
+			if (!DecodeTgaRle(pixels, fileEnd, pixelBytes, pixelCount, decoded.data()))
 			{
-				destination -= lineSize;
-				std::copy(source, source + lineSize, destination);
-				source += lineSize;
+				std::cerr << "ERROR:" << path << "RLEf[^Ă܂\n";
+				return false;
 			}
-			buf.swap(tmp);
+			pixels = decoded.data();
+		}
+		else if ((size_t)(fileEnd - pixels) < pixelCount * pixelBytes)
+		{
+			std::cerr << "ERROR:" << path << "̃f[^sĂ܂\n";
+			return false;
 		}
 
-		//ǂݍ񂾉摜f[^eNX`쐬
-		GLenum type = GL_UNSIGNED_BYTE;
-		GLenum format = GL_BGRA;
-		if (tgaHeader[2] == 3)//kȂ8rbg`Ȃ
+		image.width = width;
+		image.height = height;
+		image.type = GL_UNSIGNED_BYTE;
+		if (colorType == 3)
 		{
-			format = GL_RED;
+			//摜1vf̂܂܊i[
+			image.format = GL_RED;
+			image.data.assign(pixels, pixels + pixelCount);
 		}
-		if (tgaHeader[16] == 24)//kȂ24rbg`Ȃ
+		else if (colorType == 2)
 		{
-			format = GL_BGR;
+			image.format = GL_RGBA;
+			image.data.resize(pixelCount * 4);
+			ConvertTgaPixels(pixels, pixelDepth, alphaBits, image.data.data(), pixelCount);
 		}
-		else if (tgaHeader[16] == 16)//kȂ16rbg`Ȃ
+		else
 		{
-			type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+			//J[}bvRGBA8ɕϊĂAf̔ԍFɒu
+			std::vector<uint8_t> palette(256 * 4, 0);
+			const int first = std::min(colorMapFirst, 256);
+			const int count = std::min(colorMapLength, 256 - first);
+			if (!ConvertTgaPixels(colorMap, colorMapEntrySize, alphaBits,
+				palette.data() + first * 4, count))
+			{
+				std::cerr << "ERROR:" << path << "̃J[}bv͑ΉĂȂ`ł\n";
+				return false;
+			}
+			image.format = GL_RGBA;
+			image.data.resize(pixelCount * 4);
+			uint8_t* dst = image.data.data();
+			for (size_t i = 0; i < pixelCount; ++i, dst += 4)
+			{
+				memcpy(dst, palette.data() + pixels[i] * 4, 4);
+			}
 		}
-		//ǂݍ񂾉摜f[^eNX`쐬
-		return CreateImage2D(width, height, buf.data(),format,type);
+
+		//OpenGĹuvɊi[Ă邱Ƃ҂̂ŁAKvȂ甽]
+		FlipImage(image, isTopToBottom, isRightToLeft);
+		return true;
+	}
+
+/**
+* f̌`1f̃oCg߂
+*
+* @param format f̌`
+* @param type   f̗vf̌^
+*
+* @return 1f̃oCg
+*/
+	GLsizei GetBytesPerPixel(GLenum format, GLenum type)
+	{
+		if (type == GL_UNSIGNED_SHORT_1_5_5_5_REV)
+		{
+			return 2;
+		}
+		switch (format)
+		{
+		case GL_RED: return 1;
+		case GL_BGR:
+		case GL_RGB: return 3;
+		default: return 4;
+		}
+	}
+
+/**
+* 摜f[^̈ꕔ̍ssNZ obt@ IuWFNgoRŃeNX`ɓ]
+*
+* @param texId eNX` IuWFNgID(CreateImage2Dō쐬ς݂̂)
+* @param pbo   ]ɎgsNZ obt@ IuWFNgID
+* @param image ]摜f[^
+* @param y     ]Jns
+* @param rows  ]s
+* @param level ]̃~bv}bv̒i
+* @param layer ]̑w(-1Ȃ2DeNX`A0ȏȂ2DeNX`z)
+*
+* PBO͖mۂ̂ŁAO̓]҂ɏނƂł.
+* ۂ̓]glTexSubImage2D߂GPUŔ񓯊ɍs
+*/
+	void UploadImage2DRows(GLuint texId, GLuint pbo, const ImageData& image,
+		GLint y, GLsizei rows, GLint level, GLint layer)
+	{
+		const size_t lineSize =
+			(size_t)image.width * GetBytesPerPixel(image.format, image.type);
+		const size_t size = lineSize * rows;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+		void* p = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (p)
+		{
+			memcpy(p, image.data.data() + lineSize * y, size);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+			const GLenum target = layer < 0 ? GL_TEXTURE_2D : GL_TEXTURE_2D_ARRAY;
+			GLStateCache::Instance().BindTexture(0, target, texId);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			if (layer < 0)
+			{
+				glTexSubImage2D(GL_TEXTURE_2D, level, 0, y, image.width, rows,
+					image.format, image.type, nullptr);
+			}
+			else
+			{
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, y, layer, image.width, rows, 1,
+					image.format, image.type, nullptr);
+			}
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+			GLStateCache::Instance().BindTexture(0, target, 0);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 	}
 
 /**
 * RXgN^
 *
-* @param texId eNX` IuWFNgID
+* @param texId  eNX` IuWFNgID
+* @param target eNX`̎
 */
-	Image2D::Image2D(GLuint texId)
+	Image2D::Image2D(GLuint texId, GLenum target)
 	{
-		Reset(texId);
+		Reset(texId, target);
 	}
 
 /**
@@ -147,18 +925,33 @@ namespace Texture{
 */
 	Image2D::~Image2D()
 	{
-		glDeleteTextures(1, &id);
+		GLStateCache::Instance().DeleteTexture(id);
 	}
 
 /**
 * eNX` IuWFNgݒ肷
 *
-* @param texId eNX` IuWFNgID
+* @param texId  eNX` IuWFNgID
+* @param target eNX`̎
 */
-	void Image2D::Reset(GLuint texid)
+	void Image2D::Reset(GLuint texid, GLenum target)
 	{
-		glDeleteTextures(1, &id);
+		GLStateCache::Instance().DeleteTexture(id);
 		id = texid;
+		this->target = target;
+	}
+
+/**
+* eNX`̓ǂݎ@ݒ肷
+*
+* @param sampler ǂݎ@
+*/
+	void Image2D::SetSampler(const SamplerState& sampler)
+	{
+		if (id)
+		{
+			SetSamplerState(id, sampler, target);
+		}
 	}
 
 /**
@@ -181,4 +974,14 @@ namespace Texture{
 	{
 		return id;
 	}
+
+/**
+* eNX`̎ނ擾
+*
+* @return GL_TEXTURE_2D܂GL_TEXTURE_2D_ARRAY
+*/
+	GLenum Image2D::Target() const
+	{
+		return target;
+	}
 }//namespace Texture
\ No newline at end of file
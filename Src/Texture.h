@@ -4,28 +4,98 @@
 #ifndef TEXTURE_H_INCLUDED
 #define TEXTURE_H_INCLUDED
 #include <GL/glew.h>
+#include <stdint.h>
+#include <vector>
 
 namespace Texture{
+
+/**
+* t@Cǂݍ񂾉摜f[^
+*/
+	struct ImageData
+	{
+		GLsizei width = 0;
+		GLsizei height = 0;
+		GLenum format = GL_BGRA;//f̌`
+		GLenum type = GL_UNSIGNED_BYTE;//f̗vf̌^
+		std::vector<uint8_t> data;//ff[^(̍s珇Ɋi[)
+	};
+
+/**
+* ubNkꂽeNX` t@C̓e
+*
+* eĩf[^̓t@Cǂݍ񂾃𒼐ڎw
+*/
+	struct CompressedImage
+	{
+		struct Level
+		{
+			GLsizei width;
+			GLsizei height;
+			const uint8_t* data;
+			GLsizei size;//f[^̃oCg
+		};
+		GLenum internalFormat = 0;//GL_COMPRESSED_`
+		GLsizei width = 0;
+		GLsizei height = 0;
+		std::vector<Level> levels;//~bv}bv̊ei(傫)
+	};
+
+/**
+* eNX`̓ǂݎ@
+*/
+	struct SamplerState
+	{
+		GLenum minFilter = GL_LINEAR_MIPMAP_LINEAR;//k̃tB^
+		GLenum magFilter = GL_LINEAR;//g厞̃tB^
+		GLenum wrapS = GL_CLAMP_TO_EDGE;//͈̔͊Ö
+		GLenum wrapT = GL_CLAMP_TO_EDGE;//c͈̔͊Ö
+		float maxAnisotropy = 8.0f;//ٕtB^̍ő{(1ȂgȂ)
+	};
+
 	GLuint CreateImage2D(GLsizei width, GLsizei height, const GLvoid* data,
-		GLenum format, GLenum type);
-	GLuint LoadImage2D(const char* path);
+		GLenum format, GLenum type, GLsizei levelCount = 1,
+		const SamplerState& sampler = SamplerState());
+	GLuint LoadImage2D(const char* path, const SamplerState& sampler = SamplerState());
+	GLuint CreateCompressedImage2D(const CompressedImage& image,
+		const SamplerState& sampler = SamplerState());
+	GLuint LoadCompressed2D(const char* path, const SamplerState& sampler = SamplerState());
+	bool IsCompressedImagePath(const char* path);
+	bool ParseCompressedImage(const uint8_t* data, size_t size, CompressedImage& image);
+	bool SaveCompressedImage(const char* path, const CompressedImage& image);
+	bool UsesMipmap(const SamplerState& sampler);
+	void SetSamplerState(GLuint texId, const SamplerState& sampler,
+		GLenum target = GL_TEXTURE_2D);
+	GLuint CreateImage2DArray(GLsizei width, GLsizei height, GLsizei layerCount,
+		GLenum format, GLenum type, GLsizei levelCount = 1,
+		const SamplerState& sampler = SamplerState());
+	GLuint LoadImage2DArray(const char* const* paths, size_t count,
+		const SamplerState& sampler = SamplerState());
+	bool LoadImageArrayData(const char* const* paths, size_t count, std::vector<ImageData>& layers);
+	bool LoadImageData(const char* path, ImageData& image);
+	GLsizei GetBytesPerPixel(GLenum format, GLenum type);
+	void UploadImage2DRows(GLuint texId, GLuint pbo, const ImageData& image,
+		GLint y, GLsizei rows, GLint level = 0, GLint layer = -1);
 
 /**
-* 2DeNX`
+* 2DeNX`(܂2DeNX`z)
 */
 	class Image2D
 	{
 	public:
 		Image2D() = default;
-		explicit Image2D(GLuint texId);
+		explicit Image2D(GLuint texId, GLenum target = GL_TEXTURE_2D);
 		~Image2D();
 
-		void Reset(GLuint texId);
+		void Reset(GLuint texId, GLenum target = GL_TEXTURE_2D);
+		void SetSampler(const SamplerState& sampler);
 		bool IsNull() const;
 		GLuint Get() const;
+		GLenum Target() const;
 
 	private:
 		GLuint id = 0;
+		GLenum target = GL_TEXTURE_2D;//GL_TEXTURE_2D܂GL_TEXTURE_2D_ARRAY
 	};
 }//namespace Texture
 #endif //TEXTURE_H_INCLUDED
\ No newline at end of file
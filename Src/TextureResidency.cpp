@@ -0,0 +1,408 @@
+/**
+* @file TextureResidency.cpp
+*/
+#include "TextureResidency.h"
+#include <algorithm>
+#include <math.h>
+
+/**
+* RXgN^
+*
+* @param budget VRAM̗\Z(oCg)
+*/
+TextureResidency::TextureResidency(size_t budget) : budget(budget)
+{
+}
+
+/**
+* ʏ̑傫A`ɕKvȍł傫i߂
+*
+* @param baseSize   ł傫i̕܂͍(sNZ)
+* @param levelCount ~bv}bv̒i
+* @param screenSize eNX`ŜʏŐ߂镝(sNZ)
+*
+* @return `ɕKvȍł傫i̔ԍ
+*
+* 1eNZ1sNZȏɂȂiI. 傫i͏kČȂ̂ŕsv
+*/
+int TextureResidency::SelectLevel(int baseSize, int levelCount, float screenSize)
+{
+	if (levelCount <= 1)
+	{
+		return 0;
+	}
+	if (!(screenSize > 0))
+	{
+		return levelCount - 1;
+	}
+	const float level = floorf(log2f(static_cast<float>(baseSize) / screenSize));
+	return std::min(std::max(static_cast<int>(level), 0), levelCount - 1);
+}
+
+/**
+* VRAM̗\Zݒ肷
+*
+* @param budget VRAM̗\Z(oCg)
+*
+* \Z𒴂ĂꍇAUpdateŒǂo
+*/
+void TextureResidency::SetBudget(size_t budget)
+{
+	this->budget = budget;
+}
+
+/**
+* 1̍XVœǂݍލőoCgݒ肷
+*
+* @param bytesPerUpdate 1̍XVœǂݍލőoCg
+*
+* 1ił̒l𒴂ꍇA̒i͓ǂݍ
+*/
+void TextureResidency::SetUploadLimit(size_t bytesPerUpdate)
+{
+	uploadLimit = bytesPerUpdate;
+}
+
+/**
+* eNX`o^
+*
+* @param levelBytes eĩoCg̔z(傫i珇)
+* @param levelCount levelBytes̗vf
+* @param floorLevel ɏ풓ł傫i
+*
+* @return o^eNX`̔ԍ. snpos
+*
+* ŏfloorLevel菬i풓Ă
+*/
+size_t TextureResidency::Add(const size_t* levelBytes, int levelCount, int floorLevel)
+{
+	if (levelCount <= 0)
+	{
+		return npos;
+	}
+	size_t id;
+	if (freeIds.empty())
+	{
+		id = entries.size();
+		entries.emplace_back();
+	}
+	else
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+	Entry& e = entries[id];
+	e.levelBytes.assign(levelBytes, levelBytes + levelCount);
+	e.floorLevel = std::min(std::max(floorLevel, 0), levelCount - 1);
+	e.residentLevel = e.floorLevel;
+	e.requestedLevel = e.floorLevel;
+	e.reportedLevel = levelCount;
+	e.lastUsedFrame = frame;
+	for (int i = e.residentLevel; i < levelCount; ++i)
+	{
+		residentBytes += e.levelBytes[i];
+	}
+	return id;
+}
+
+/**
+* eNX`̓o^
+*
+* @param id AddŎ擾eNX`̔ԍ
+*/
+void TextureResidency::Remove(size_t id)
+{
+	if (id >= entries.size() || entries[id].levelBytes.empty())
+	{
+		return;
+	}
+	Entry& e = entries[id];
+	for (int i = e.residentLevel; i < LevelCount(e); ++i)
+	{
+		residentBytes -= e.levelBytes[i];
+	}
+	std::vector<size_t>().swap(e.levelBytes);
+	freeIds.push_back(id);
+}
+
+/**
+* `ŃeNX`gƂ񍐂
+*
+* @param id    AddŎ擾eNX`̔ԍ
+* @param level `ɕKvȍł傫i(SelectLevelŋ߂)
+*
+* Update܂łɕ񍐂ꂽꍇ́Ał傫i̗p
+*/
+void TextureResidency::ReportUsage(size_t id, int level)
+{
+	if (id >= entries.size() || entries[id].levelBytes.empty())
+	{
+		return;
+	}
+	Entry& e = entries[id];
+	e.reportedLevel = std::min(e.reportedLevel, std::max(level, 0));
+}
+
+/**
+* 񍐂ꂽgp󋵂A풓i߂
+*
+* @param changes 풓iύXeNX`̊i[
+*
+* `ŎgꂽeNX`̂AKvȒiƂ̍傫̂1iǂݍ.
+* \Z𒴂ꍇ́AłgĂȂeNX`A
+* Kvȏ̒i풓ĂeNX`傫iǂo.
+* gꂽeNX`̕KvȒi͒ǂoȂ̂ŁAǂݍ݂ƒǂoJԂȂ
+*/
+void TextureResidency::Update(std::vector<Change>& changes)
+{
+	changes.clear();
+	++frame;
+	std::vector<int> oldLevels(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		Entry& e = entries[i];
+		oldLevels[i] = e.residentLevel;
+		if (e.levelBytes.empty())
+		{
+			continue;
+		}
+		if (e.reportedLevel < LevelCount(e))
+		{
+			e.requestedLevel = e.reportedLevel;
+			e.lastUsedFrame = frame;
+		}
+		e.reportedLevel = LevelCount(e);
+	}
+
+	//\Z炳ĂA܂\ZɎ߂
+	Evict(0, npos);
+
+	//KvȒiȂeNX`ɁA1iǂݍ
+	std::vector<bool> isBlocked(entries.size(), false);
+	size_t uploadedBytes = 0;
+	for (;;)
+	{
+		size_t best = npos;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			const Entry& e = entries[i];
+			if (e.levelBytes.empty() || isBlocked[i] || e.lastUsedFrame != frame ||
+				e.residentLevel <= e.requestedLevel)
+			{
+				continue;
+			}
+			if (best == npos)
+			{
+				best = i;
+				continue;
+			}
+			const Entry& b = entries[best];
+			const int deficit = e.residentLevel - e.requestedLevel;
+			const int bestDeficit = b.residentLevel - b.requestedLevel;
+			if (deficit > bestDeficit || (deficit == bestDeficit &&
+				e.levelBytes[e.residentLevel - 1] < b.levelBytes[b.residentLevel - 1]))
+			{
+				best = i;
+			}
+		}
+		if (best == npos)
+		{
+			break;
+		}
+		Entry& e = entries[best];
+		const size_t bytes = e.levelBytes[e.residentLevel - 1];
+		if (uploadedBytes > 0 && uploadedBytes + bytes > uploadLimit)
+		{
+			break;
+		}
+		if (!Evict(bytes, best))
+		{
+			isBlocked[best] = true;//\ZɎ܂Ȃ̂ŁA͒߂
+			continue;
+		}
+		--e.residentLevel;
+		residentBytes += bytes;
+		loadedBytes += bytes;
+		uploadedBytes += bytes;
+	}
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		if (entries[i].residentLevel != oldLevels[i])
+		{
+			changes.push_back({ i, oldLevels[i], entries[i].residentLevel });
+		}
+	}
+}
+
+/**
+* 풓Ăł傫i擾
+*
+* @param id AddŎ擾eNX`̔ԍ
+*
+* @return 풓Ăł傫i̔ԍ. o^ĂȂ-1
+*/
+int TextureResidency::ResidentLevel(size_t id) const
+{
+	if (id >= entries.size() || entries[id].levelBytes.empty())
+	{
+		return -1;
+	}
+	return entries[id].residentLevel;
+}
+
+/**
+* `ɕKvȍł傫i擾
+*
+* @param id AddŎ擾eNX`̔ԍ
+*
+* @return ŌɎgꂽƂɕKvi̔ԍ. o^ĂȂ-1
+*/
+int TextureResidency::RequestedLevel(size_t id) const
+{
+	if (id >= entries.size() || entries[id].levelBytes.empty())
+	{
+		return -1;
+	}
+	return entries[id].requestedLevel;
+}
+
+/**
+* 풓󋵂̓v擾
+*
+* @return v
+*/
+TextureResidency::Statistics TextureResidency::GetStatistics() const
+{
+	Statistics stats = {};
+	stats.budget = budget;
+	stats.residentBytes = residentBytes;
+	stats.loadedBytes = loadedBytes;
+	stats.evictedBytes = evictedBytes;
+	for (const Entry& e : entries)
+	{
+		if (e.levelBytes.empty())
+		{
+			continue;
+		}
+		++stats.textureCount;
+		if (e.residentLevel > e.requestedLevel)
+		{
+			++stats.pendingCount;
+		}
+		for (int i = std::min(e.requestedLevel, e.floorLevel); i < LevelCount(e); ++i)
+		{
+			stats.requestedBytes += e.levelBytes[i];
+		}
+	}
+	return stats;
+}
+
+/**
+* eNX`̒i擾
+*
+* @param e ׂeNX`
+*
+* @return i
+*/
+int TextureResidency::LevelCount(const Entry& e) const
+{
+	return static_cast<int>(e.levelBytes.size());
+}
+
+/**
+* ǂoĂ悢x߂
+*
+* @param e ׂeNX`
+*
+* @return ̒i傫i͒ǂoĂ悢
+*
+* gꂽeNX`͕`ɕKvȒi܂ŁAgĂȂeNX`͏풓i܂
+*/
+int TextureResidency::EvictLimit(const Entry& e) const
+{
+	if (e.lastUsedFrame == frame)
+	{
+		return std::min(e.requestedLevel, e.floorLevel);
+	}
+	return e.floorLevel;
+}
+
+/**
+* \ZɎ܂܂ŁAgĂȂeNX`̑傫iǂo
+*
+* @param requiredBytes ꂩǂݍރoCg
+* @param protectedId   ǂoȂeNX`̔ԍ(ǂݍޑ̃eNX`)
+*
+* @retval true  \ZɎ܂
+* @retval false ǂoiȂĂ\ZɎ܂Ȃ
+*/
+bool TextureResidency::Evict(size_t requiredBytes, size_t protectedId)
+{
+	if (residentBytes + requiredBytes <= budget)
+	{
+		return true;
+	}
+
+	//SĒǂoĂ܂ȂȂAʂɒǂoȂ悤ɉȂ.
+	//\Z炳ꂽꍇ(requiredBytes=0)́Ał邾ǂo
+	if (requiredBytes > 0)
+	{
+		size_t evictableBytes = 0;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			const Entry& e = entries[i];
+			if (i == protectedId || e.levelBytes.empty())
+			{
+				continue;
+			}
+			for (int level = e.residentLevel; level < EvictLimit(e); ++level)
+			{
+				evictableBytes += e.levelBytes[level];
+			}
+		}
+		if (residentBytes + requiredBytes > budget + evictableBytes)
+		{
+			return false;
+		}
+	}
+
+	while (residentBytes + requiredBytes > budget)
+	{
+		//łgĂȂeNX`I. Ȃ傫iقI
+		Entry* victim = nullptr;
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			Entry& e = entries[i];
+			if (i == protectedId || e.levelBytes.empty() || e.residentLevel >= EvictLimit(e))
+			{
+				continue;
+			}
+			if (!victim || e.lastUsedFrame < victim->lastUsedFrame ||
+				(e.lastUsedFrame == victim->lastUsedFrame &&
+					e.levelBytes[e.residentLevel] > victim->levelBytes[victim->residentLevel]))
+			{
+				victim = &e;
+			}
+		}
+		if (!victim)
+		{
+			return false;
+		}
+		DropLevel(*victim);
+	}
+	return true;
+}
+
+/**
+* 풓Ăł傫iǂo
+*
+* @param e ǂoeNX`
+*/
+void TextureResidency::DropLevel(Entry& e)
+{
+	const size_t bytes = e.levelBytes[e.residentLevel];
+	++e.residentLevel;
+	residentBytes -= bytes;
+	evictedBytes += bytes;
+}
@@ -0,0 +1,90 @@
+/**
+* @file TextureResidency.h
+*/
+#ifndef TEXTURERESIDENCY_H_INCLUDED
+#define TEXTURERESIDENCY_H_INCLUDED
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+* eNX`̂ǂ̃~bv}bviVRAMɒu߂NX
+*
+* eNX`͎̂AeĩoCgƕ`ɕKvȒiǗ.
+* `ŎgꂽeNX`͑傫i1iǂݍ݁A\Z𒴂ꍇ
+* łgĂȂeNX`傫iǂo.
+* OpenGLgȂ̂ŁA`Ȃœm߂邱Ƃł.
+*/
+class TextureResidency
+{
+public:
+	//o^ɎsƂ̖߂l
+	static const size_t npos = static_cast<size_t>(-1);
+
+	/**
+	* 풓󋵂̓v
+	*/
+	struct Statistics
+	{
+		size_t budget;//VRAM̗\Z(oCg)
+		size_t residentBytes;//풓Ăi̍voCg
+		size_t requestedBytes;//`ɕKvȒiSď풓Ƃ̃oCg
+		size_t textureCount;//ǗĂeNX`̐
+		size_t pendingCount;//KvȒi܂풓ĂȂeNX`̐
+		size_t loadedBytes;//܂łɓǂݍ񂾒i̍voCg
+		size_t evictedBytes;//܂łɒǂoi̍voCg
+	};
+
+	/**
+	* 풓i̕ύX
+	*/
+	struct Change
+	{
+		size_t id;//eNX`̔ԍ
+		int oldLevel;//ύXOɏ풓Ăł傫i
+		int newLevel;//ύXɏ풓ł傫i
+	};
+
+	TextureResidency() = default;
+	explicit TextureResidency(size_t budget);
+
+	static int SelectLevel(int baseSize, int levelCount, float screenSize);
+
+	void SetBudget(size_t budget);
+	void SetUploadLimit(size_t bytesPerUpdate);
+	size_t Add(const size_t* levelBytes, int levelCount, int floorLevel);
+	void Remove(size_t id);
+	void ReportUsage(size_t id, int level);
+	void Update(std::vector<Change>& changes);
+	int ResidentLevel(size_t id) const;
+	int RequestedLevel(size_t id) const;
+	Statistics GetStatistics() const;
+
+private:
+	//ǗĂeNX`̏
+	struct Entry
+	{
+		std::vector<size_t> levelBytes;//eĩoCg(Ȃ疢gp̔ԍ)
+		int floorLevel = 0;//ɏ풓ł傫i(傫iǂo)
+		int residentLevel = 0;//풓Ăł傫i
+		int requestedLevel = 0;//`ɕKvȍł傫i
+		int reportedLevel = 0;//̍XV܂łɕ񍐂ꂽi(񍐂ȂΒiƓ)
+		uint64_t lastUsedFrame = 0;//Ōɕ`ŎgꂽXV̔ԍ
+	};
+
+	int LevelCount(const Entry& e) const;
+	int EvictLimit(const Entry& e) const;
+	bool Evict(size_t requiredBytes, size_t protectedId);
+	void DropLevel(Entry& e);
+
+	std::vector<Entry> entries;
+	std::vector<size_t> freeIds;//Removeŋ󂢂entries̔ԍ
+	size_t budget = 64 * 1024 * 1024;
+	size_t uploadLimit = 4 * 1024 * 1024;//1̍XVœǂݍލőoCg
+	size_t residentBytes = 0;
+	size_t loadedBytes = 0;
+	size_t evictedBytes = 0;
+	uint64_t frame = 0;//XV̔ԍ
+};
+
+#endif //TEXTURERESIDENCY_H_INCLUDED
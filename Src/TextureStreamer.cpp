@@ -0,0 +1,329 @@
+/**
+* @file TextureStreamer.cpp
+*/
+#include "TextureStreamer.h"
+#include "MipmapGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+//ŏɓ]ȋ傫(ƍ̑傫ق̃sNZ). 菬i͏ɏ풓
+const GLsizei streamingFloorSize = 64;
+
+/**
+* RXgN^
+*
+* @param budget VRAM̗\Z(oCg)
+*/
+TextureStreamer::TextureStreamer(size_t budget) : residency(budget)
+{
+}
+
+/**
+* fXgN^
+*/
+TextureStreamer::~TextureStreamer()
+{
+	Clear();
+}
+
+/**
+* 2DeNX`ǉ
+*
+* @param path    摜t@C
+* @param sampler eNX`̓ǂݎ@
+*
+* @return ǉeNX`̔ԍ
+*
+* ǂݍ݂I܂ł1x1̊DF̃eNX`ɂȂ
+*/
+size_t TextureStreamer::Add(const char* path, const Texture::SamplerState& sampler)
+{
+	return AddEntry({ path }, false, sampler);
+}
+
+/**
+* 2DeNX`zǉ
+*
+* @param paths   ew̉摜t@C̔z
+* @param count   paths̗vf
+* @param sampler eNX`̓ǂݎ@
+*
+* @return ǉeNX`z̔ԍ
+*
+* SĂ̑w܂Ƃ߂ďoꂷ. ǂݍ݂I܂ł1x1̊DF̃eNX`ɂȂ
+*/
+size_t TextureStreamer::AddArray(const char* const* paths, size_t count,
+	const Texture::SamplerState& sampler)
+{
+	return AddEntry(std::vector<std::string>(paths, paths + count), true, sampler);
+}
+
+/**
+* eNX`擾
+*
+* @param id Add֐Ŏ擾eNX`̔ԍ
+*
+* @return eNX`ւ̃|C^
+*
+* 풓iςƃeNX`IDς̂ŁA`̂тGetŎ擾Ȃ
+*/
+std::shared_ptr<Texture::Image2D> TextureStreamer::Get(size_t id) const
+{
+	if (id >= entries.size())
+	{
+		return nullptr;
+	}
+	return entries[id]->image;
+}
+
+/**
+* `ŃeNX`gƂ񍐂
+*
+* @param id         Add֐Ŏ擾eNX`̔ԍ
+* @param screenSize eNX`ŜʏŐ߂镝(sNZ)
+*
+* 񍐂ꂽ傫͎UpdateŎg
+*/
+void TextureStreamer::ReportUsage(size_t id, float screenSize)
+{
+	if (id >= entries.size() || entries[id]->residencyId == TextureResidency::npos)
+	{
+		return;
+	}
+	const Entry& e = *entries[id];
+	const Texture::ImageData& base = e.images[0][0];
+	residency.ReportUsage(e.residencyId, TextureResidency::SelectLevel(
+		std::max(base.width, base.height), static_cast<int>(e.images[0].size()), screenSize));
+}
+
+/**
+* ǂݍ݂IeNX`o^A풓iXV
+*
+* OpenGLReLXgXbhAt[`̑OɌĂяo
+*/
+void TextureStreamer::Update()
+{
+	for (std::unique_ptr<Entry>& e : entries)
+	{
+		if (!e->decoding.valid() ||
+			e->decoding.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			continue;
+		}
+		std::vector<std::vector<Texture::ImageData>> images = e->decoding.get();
+		if (!images.empty())
+		{
+			e->images.swap(images);
+			Register(*e);
+		}
+		else
+		{
+			std::cerr << "ERROR: " << e->name << "ǂݍ߂܂\n";
+		}
+	}
+
+	residency.Update(changes);
+	for (const TextureResidency::Change& c : changes)
+	{
+		Entry& e = *residencyToEntry[c.id];
+		Upload(e, c.newLevel);
+		const Texture::ImageData& top = e.images[0][c.newLevel];
+		std::cout << "INFO: " << e.name << "̏풓iύX [i=" << c.oldLevel << "->" <<
+			c.newLevel << " (" << top.width << "x" << top.height << ")]\n";
+	}
+	if (!changes.empty())
+	{
+		const TextureResidency::Statistics stats = residency.GetStatistics();
+		std::cout << "INFO: eNX`풓=" << stats.residentBytes / 1024 << "/" <<
+			stats.budget / 1024 << "KiB (Kv=" << stats.requestedBytes / 1024 <<
+			"KiB ҋ@=" << stats.pendingCount << ")\n";
+	}
+}
+
+/**
+* VRAM̗\Zݒ肷
+*
+* @param budget VRAM̗\Z(oCg)
+*/
+void TextureStreamer::SetBudget(size_t budget)
+{
+	residency.SetBudget(budget);
+}
+
+/**
+* 풓󋵂̓v擾
+*
+* @return v
+*/
+TextureResidency::Statistics TextureStreamer::GetStatistics() const
+{
+	return residency.GetStatistics();
+}
+
+/**
+* SẴeNX`폜
+*
+* ǂݍݒ̃eNX`΁Aǂݍ݂I܂ő҂
+*/
+void TextureStreamer::Clear()
+{
+	for (std::unique_ptr<Entry>& e : entries)
+	{
+		if (e->decoding.valid())
+		{
+			e->decoding.wait();
+		}
+		residency.Remove(e->residencyId);
+	}
+	entries.clear();
+	residencyToEntry.clear();
+	glDeleteBuffers(1, &uploadPbo);
+	uploadPbo = 0;
+}
+
+/**
+* eNX`ǉA[J[Xbhœǂݍ݂n߂
+*
+* @param paths   摜t@C̔z
+* @param isArray trueȂeNX`z
+* @param sampler eNX`̓ǂݎ@
+*
+* @return ǉeNX`̔ԍ
+*/
+size_t TextureStreamer::AddEntry(const std::vector<std::string>& paths, bool isArray,
+	const Texture::SamplerState& sampler)
+{
+	std::unique_ptr<Entry> e(new Entry);
+	e->name = paths.empty() ? "" : paths[0];
+	if (paths.size() > 1)
+	{
+		e->name += "ق" + std::to_string(paths.size() - 1) + "";
+	}
+	e->image = std::make_shared<Texture::Image2D>();
+	e->sampler = sampler;
+	e->isArray = isArray;
+
+	//ǂݍ݂I܂ŕ\DF̉摜
+	Texture::ImageData placeholder;
+	placeholder.width = 1;
+	placeholder.height = 1;
+	placeholder.format = GL_RGBA;
+	placeholder.data = { 128, 128, 128, 255 };
+	e->images.assign(std::max<size_t>(paths.size(), 1), { placeholder });
+	Upload(*e, 0);
+
+	//摜̓ǂݍ݂ƃ~bv}bv̍쐬̓[J[Xbhōs
+	e->decoding = std::async(std::launch::async, [paths, isArray]() {
+		std::vector<Texture::ImageData> layers;
+		if (isArray)
+		{
+			std::vector<const char*> p;
+			for (const std::string& path : paths)
+			{
+				p.push_back(path.c_str());
+			}
+			if (!Texture::LoadImageArrayData(p.data(), p.size(), layers))
+			{
+				return std::vector<std::vector<Texture::ImageData>>();
+			}
+		}
+		else
+		{
+			layers.resize(1);
+			if (paths.empty() || !Texture::LoadImageData(paths[0].c_str(), layers[0]))
+			{
+				return std::vector<std::vector<Texture::ImageData>>();
+			}
+		}
+		std::vector<std::vector<Texture::ImageData>> images(layers.size());
+		for (size_t i = 0; i < layers.size(); ++i)
+		{
+			std::vector<Texture::ImageData> mipLevels;
+			MipmapGenerator::Generate(layers[i], mipLevels);
+			images[i].push_back(std::move(layers[i]));
+			for (Texture::ImageData& level : mipLevels)
+			{
+				images[i].push_back(std::move(level));
+			}
+		}
+		return images;
+	});
+	entries.push_back(std::move(e));
+	return entries.size() - 1;
+}
+
+/**
+* ǂݍ݂IeNX`̏풓Ǘn߂
+*
+* @param e ǂݍ݂IeNX`
+*
+* i]A傫i͕`ŎgĂ]
+*/
+void TextureStreamer::Register(Entry& e)
+{
+	const std::vector<Texture::ImageData>& levels = e.images[0];
+	const int levelCount = static_cast<int>(levels.size());
+	std::vector<size_t> levelBytes(levelCount);
+	int floorLevel = levelCount - 1;
+	for (int level = levelCount - 1; level >= 0; --level)
+	{
+		const Texture::ImageData& image = levels[level];
+		levelBytes[level] = static_cast<size_t>(image.width) * image.height *
+			Texture::GetBytesPerPixel(image.format, image.type) * e.images.size();
+		if (std::max(image.width, image.height) <= streamingFloorSize)
+		{
+			floorLevel = level;
+		}
+	}
+	e.residencyId = residency.Add(levelBytes.data(), levelCount, floorLevel);
+	residencyToEntry[e.residencyId] = &e;
+	Upload(e, floorLevel);
+}
+
+/**
+* w肵iȉGPUɓ]
+*
+* @param e        ]eNX`
+* @param topLevel ]ł傫i
+*
+* @retval true  ]
+* @retval false eNX`̍쐬Ɏs
+*
+* KvȒieNX`蒼ƂŁAǂoiVRAM
+*/
+bool TextureStreamer::Upload(Entry& e, int topLevel)
+{
+	if (!uploadPbo)
+	{
+		glGenBuffers(1, &uploadPbo);
+	}
+	const Texture::ImageData& base = e.images[0][topLevel];
+	const GLsizei levelCount = static_cast<GLsizei>(e.images[0].size() - topLevel);
+	GLuint id;
+	if (e.isArray)
+	{
+		id = Texture::CreateImage2DArray(base.width, base.height,
+			static_cast<GLsizei>(e.images.size()), base.format, base.type, levelCount, e.sampler);
+	}
+	else
+	{
+		id = Texture::CreateImage2D(base.width, base.height, nullptr,
+			base.format, base.type, levelCount, e.sampler);
+	}
+	if (!id)
+	{
+		return false;
+	}
+	for (size_t layer = 0; layer < e.images.size(); ++layer)
+	{
+		for (GLint level = 0; level < levelCount; ++level)
+		{
+			const Texture::ImageData& image = e.images[layer][topLevel + level];
+			Texture::UploadImage2DRows(id, uploadPbo, image, 0, image.height, level,
+				e.isArray ? static_cast<GLint>(layer) : -1);
+		}
+	}
+	e.image->Reset(id, e.isArray ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D);
+	return true;
+}
@@ -0,0 +1,66 @@
+/**
+* @file TextureStreamer.h
+*/
+#ifndef TEXTURESTREAMER_H_INCLUDED
+#define TEXTURESTREAMER_H_INCLUDED
+#include <GL/glew.h>
+#include "Texture.h"
+#include "TextureResidency.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+* VRAM̗\ZŃ~bv}bvioꂷeNX`ǗNX
+*
+* 摜̓ǂݍ݂ƃ~bv}bv̍쐬̓[J[XbhōsAŏ͏i].
+* `摤񍐂ʏ̑傫ɉđ傫iǂݍ݁A
+* \Z𒴂łgĂȂeNX`傫iǂo.
+* ǂoiĂѓǂݍ߂悤ɁASĂ̒ỉ摜̓Cɕێ.
+*/
+class TextureStreamer
+{
+public:
+	explicit TextureStreamer(size_t budget = 64 * 1024 * 1024);
+	~TextureStreamer();
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	size_t Add(const char* path, const Texture::SamplerState& sampler = Texture::SamplerState());
+	size_t AddArray(const char* const* paths, size_t count,
+		const Texture::SamplerState& sampler = Texture::SamplerState());
+	std::shared_ptr<Texture::Image2D> Get(size_t id) const;
+	void ReportUsage(size_t id, float screenSize);
+	void Update();
+	void SetBudget(size_t budget);
+	TextureResidency::Statistics GetStatistics() const;
+	void Clear();
+
+private:
+	//ǗĂeNX`
+	struct Entry
+	{
+		std::string name;//Oɕ\閼O
+		std::shared_ptr<Texture::Image2D> image;
+		Texture::SamplerState sampler;
+		bool isArray = false;
+		std::vector<std::vector<Texture::ImageData>> images;//[w][~bv}bv̒i]̉摜
+		std::future<std::vector<std::vector<Texture::ImageData>>> decoding;//[J[Xbhł̓ǂݍ
+		size_t residencyId = TextureResidency::npos;
+	};
+
+	size_t AddEntry(const std::vector<std::string>& paths, bool isArray,
+		const Texture::SamplerState& sampler);
+	void Register(Entry& e);
+	bool Upload(Entry& e, int topLevel);
+
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::unordered_map<size_t, Entry*> residencyToEntry;
+	TextureResidency residency;
+	std::vector<TextureResidency::Change> changes;
+	GLuint uploadPbo = 0;
+};
+
+#endif //TEXTURESTREAMER_H_INCLUDED
@@ -9,15 +9,22 @@
 */
 bool TitleScene::Initialize()
 {
-	if (!meshList.Allcate())
+	//bV̓CQ[ʂƓ`œǂݍ݁Aʐ؂ւL
+	AssetManager& assets = AssetManager::Instance();
+	meshList = assets.GetMeshList(VertexFormat::Packed);
+	if (!meshList)
 	{
 		return false;
 	}
 
-	progSimple.Reset(Shader::BuildFromFile("Res/Simple.vert", "Res/Simple.frag"));
+	progSimple = assets.GetProgram("Res/Simple.vert", "Res/Simple.frag");
 
-	texLogo.Reset(Texture::LoadImage2D("Res/TitleLogo.tga"));
-	texBackGround.Reset(Texture::LoadImage2D("Res/TitleBack.tga"));
+	//ʂɂقړ{ŕ\̂ŁA~bv}bv͍Ȃ
+	Texture::SamplerState sampler;
+	sampler.minFilter = GL_LINEAR;
+	sampler.maxAnisotropy = 1.0f;
+	texLogo = assets.GetTexture("Res/TitleLogo.tga", sampler);
+	texBackGround = assets.GetTexture("Res/TitleBack.tga", sampler);
 
 	timer -= 1.0f;
 	isFinish = false;
@@ -34,7 +41,9 @@ void TitleScene::ProcessInput()
 
 	if (!isFinish && timer <= 0.0f)
 	{
-		if (window.IsKeyPressed(GLFW_KEY_ENTER))
+		//̉ʂ̃AZbgǂݍݏI܂ł͐؂ւȂ
+		if (window.IsKeyPressed(GLFW_KEY_ENTER) &&
+			!AssetManager::Instance().IsLoading())
 		{
 			isFinish = true;
 		}
@@ -69,23 +78,23 @@ void TitleScene::Render()
 	glClearColor(0.1f, 0.3f, 0.5f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	meshList.BindVertexArray();
+	meshList->BindVertexArray();
 
-	progSimple.Use();
+	progSimple->Use();
 
 	//ˉeŕ`悷悤ɍsݒ
 	const glm::mat4x4 matProj = glm::ortho(0.0f, 1000.0f, 0.0f, 600.0f, 1.0f, 500.0f);
 	const glm::mat4x4 matView =
 		glm::lookAt(glm::vec3(0, 0, 100), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
-	progSimple.SetViewProjectionMatrix(matProj * matView);
+	progSimple->SetViewProjectionMatrix(matProj * matView);
 
 	//wiƃSEBhE̒Sɕ`
-	progSimple.BindTexture(0, texBackGround.Get());
-	progSimple.Draw(meshList.Get(2),
+	progSimple->BindTexture(0, texBackGround->Get());
+	progSimple->Draw(meshList->Get(2),
 		glm::vec3(500, 300, -1), glm::vec3(0), glm::vec3(500, 300, 1));
 	
-	progSimple.BindTexture(0, texLogo.Get());
-	progSimple.Draw(meshList.Get(2),
+	progSimple->BindTexture(0, texLogo->Get());
+	progSimple->Draw(meshList->Get(2),
 		glm::vec3(500, 300, 0), glm::vec3(0), glm::vec3(500, 300, 1));
 }
 
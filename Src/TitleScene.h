@@ -7,6 +7,8 @@
 #include "Texture.h"
 #include "Shader.h"
 #include "MeshList.h"
+#include "AssetManager.h"
+#include <memory>
 
 /**
 * CQ[
@@ -26,12 +28,12 @@ public:
 	bool IsFinish() const;
 
 private:
-	MeshList meshList;
+	std::shared_ptr<MeshList> meshList;
 
-	Texture::Image2D texLogo;
-	Texture::Image2D texBackGround;
+	std::shared_ptr<Texture::Image2D> texLogo;
+	std::shared_ptr<Texture::Image2D> texBackGround;
 
-	Shader::Program progSimple;
+	std::shared_ptr<Shader::Program> progSimple;
 
 	float timer;
 	bool isFinish;
@@ -0,0 +1,575 @@
+/**
+* @file TransformBatch.cpp
+*/
+#include "TransformBatch.h"
+#include <math.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define TRANSFORMBATCH_USE_SSE
+#include <emmintrin.h>
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX
+#else
+#include <cpuid.h>
+#define TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+//̂̍̕Wϊs܂Ƃ߂ČvZ֐i[閼O
+namespace TransformBatch {
+
+/**
+* SĂ̂̕폜
+*/
+	void Arrays::Clear()
+	{
+		positionX.clear(); positionY.clear(); positionZ.clear();
+		rotationX.clear(); rotationY.clear(); rotationZ.clear();
+		scaleX.clear(); scaleY.clear(); scaleZ.clear();
+	}
+
+/**
+* ̂ǉ
+*
+* @param position ʒu
+* @param rotation ]px(WA)
+* @param scale    g嗦
+*/
+	void Arrays::Push(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale)
+	{
+		positionX.push_back(position.x);
+		positionY.push_back(position.y);
+		positionZ.push_back(position.z);
+		rotationX.push_back(rotation.x);
+		rotationY.push_back(rotation.y);
+		rotationZ.push_back(rotation.z);
+		scaleX.push_back(scale.x);
+		scaleY.push_back(scale.y);
+		scaleZ.push_back(scale.z);
+	}
+
+/**
+* ̂̐擾
+*
+* @return ̂̐
+*/
+	size_t Arrays::Size() const
+	{
+		return positionX.size();
+	}
+
+/**
+* CPUAVX߂ɑΉAOSAVXWX^ۑ邩ׂ
+*
+* @retval true  AVX߂g
+* @retval false AVX߂gȂ
+*/
+	bool HasAvx()
+	{
+#if defined(TRANSFORMBATCH_USE_SSE)
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		const bool hasOsxsaveAndAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28));
+		return hasOsxsaveAndAvx && (_xgetbv(0) & 6) == 6;
+#else
+		unsigned int eax, ebx, ecx, edx;
+		if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & (1 << 27)) || !(ecx & (1 << 28)))
+		{
+			return false;
+		}
+		unsigned int xcr0, xcr0High;
+		__asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+		return (xcr0 & 6) == 6;
+#endif
+#else
+		return false;
+#endif
+	}
+
+	//AVXg邩ǂ(N1񂾂ׂ)
+	const bool hasAvx = HasAvx();
+
+/**
+* SIMD߂ŌvZ邩ǂ擾
+*
+* @retval true  SSEȏSIMD߂g
+* @retval false SIMD߂gȂ
+*/
+	bool IsSimdEnabled()
+	{
+#if defined(TRANSFORMBATCH_USE_SSE)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+/**
+* AVX߂ŌvZ邩ǂ擾
+*
+* @retval true  8AVX߂ŌvZ
+* @retval false AVX߂gȂ
+*/
+	bool IsAvxEnabled()
+	{
+		return hasAvx;
+	}
+
+/**
+* w肵͈͂̂̕SIMDg킸ɌvZ
+*
+* @param input          ̂̈ʒuA]Ag嗦
+* @param first          vZŏ̂̔̕ԍ
+* @param last           vZŌ̂̔̕ԍ+1
+* @param matVP          r[ vWFNVs
+* @param lightDirection [hWñCǧ
+* @param output         vZʂ̊i[
+*
+* ]Z(t)AXAY̏ɍ(Program::DrawƓ)
+*/
+	void ComputeScalarRange(const Arrays& input, size_t first, size_t last,
+		const glm::mat4& matVP, const glm::vec3& lightDirection, const Output& output)
+	{
+		for (size_t i = first; i < last; ++i)
+		{
+			const float sa = sinf(input.rotationZ[i]), ca = cosf(input.rotationZ[i]);
+			const float sb = sinf(input.rotationX[i]), cb = cosf(input.rotationX[i]);
+			const float sg = sinf(input.rotationY[i]), cg = cosf(input.rotationY[i]);
+
+			//]s̗
+			const glm::vec3 r0(ca * cg + sa * sb * sg, -sa * cg + ca * sb * sg, -cb * sg);
+			const glm::vec3 r1(sa * cb, ca * cb, sb);
+			const glm::vec3 r2(ca * sg - sa * sb * cg, -sa * sg - ca * sb * cg, cb * cg);
+
+			if (output.matModel || output.matMVP)
+			{
+				glm::mat4 m;
+				m[0] = glm::vec4(r0 * input.scaleX[i], 0);
+				m[1] = glm::vec4(r1 * input.scaleY[i], 0);
+				m[2] = glm::vec4(r2 * input.scaleZ[i], 0);
+				m[3] = glm::vec4(input.positionX[i], input.positionY[i], input.positionZ[i], 1);
+				if (output.matModel)
+				{
+					output.matModel[i] = m;
+				}
+				if (output.matMVP)
+				{
+					output.matMVP[i] = matVP * m;
+				}
+			}
+			if (output.lightDirection)
+			{
+				//]s̋ts͓]usȂ̂ŁAeƂ̓ςɂȂ
+				output.lightDirection[i] = glm::vec3(glm::dot(r0, lightDirection),
+					glm::dot(r1, lightDirection), glm::dot(r2, lightDirection));
+			}
+		}
+	}
+
+/**
+* SĂ̂̍̕WϊsSIMDg킸ɌvZ
+*
+* @param input          ̂̈ʒuA]Ag嗦
+* @param matVP          r[ vWFNVs
+* @param lightDirection [hWñCǧ
+* @param output         vZʂ̊i[(ꂼinput.Size()̗vfKv)
+*/
+	void ComputeScalar(const Arrays& input, const glm::mat4& matVP,
+		const glm::vec3& lightDirection, const Output& output)
+	{
+		ComputeScalarRange(input, 0, input.Size(), matVP, lightDirection, output);
+	}
+
+#if defined(TRANSFORMBATCH_USE_SSE)
+
+	//sin, cošvZɎg萔(Cephes̒PxłƓ)
+	const float twoOverPi = 0.636619772367581343f;
+	const float halfPi1 = 1.5703125f;///23ɕl(덷炷)
+	const float halfPi2 = 4.837512969970703125e-4f;
+	const float halfPi3 = 7.54978995489188216e-8f;
+	const float sinCoef1 = -1.9515295891e-4f;
+	const float sinCoef2 = 8.3321608736e-3f;
+	const float sinCoef3 = -1.6666654611e-1f;
+	const float cosCoef1 = 2.443315711809948e-5f;
+	const float cosCoef2 = -1.388731625493765e-3f;
+	const float cosCoef3 = 4.166664568298827e-2f;
+
+/**
+* 4̊pxsincos𓯎ɋ߂
+*
+* @param x px(WA)
+* @param s sin̊i[
+* @param c cos̊i[
+*
+* /2Pʂ-/4`/4ɏk߂Ă瑽ŋߎAیɉēւƕ]
+*/
+	inline void SinCos4(__m128 x, __m128& s, __m128& c)
+	{
+		const __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(twoOverPi)));
+		const __m128 q = _mm_cvtepi32_ps(quadrant);
+		__m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(halfPi1)));
+		r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPi2)));
+		r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPi3)));
+		const __m128 z = _mm_mul_ps(r, r);
+
+		__m128 sinPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sinCoef1), z), _mm_set1_ps(sinCoef2));
+		sinPoly = _mm_add_ps(_mm_mul_ps(sinPoly, z), _mm_set1_ps(sinCoef3));
+		sinPoly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sinPoly, z), r), r);
+		__m128 cosPoly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(cosCoef1), z), _mm_set1_ps(cosCoef2));
+		cosPoly = _mm_add_ps(_mm_mul_ps(cosPoly, z), _mm_set1_ps(cosCoef3));
+		cosPoly = _mm_mul_ps(_mm_mul_ps(cosPoly, z), z);
+		cosPoly = _mm_add_ps(_mm_sub_ps(cosPoly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1));
+
+		//یłsincosւ
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+		const __m128 sinValue = _mm_or_ps(_mm_and_ps(swap, cosPoly), _mm_andnot_ps(swap, sinPoly));
+		const __m128 cosValue = _mm_or_ps(_mm_and_ps(swap, sinPoly), _mm_andnot_ps(swap, cosPoly));
+
+		//sin͑2,3یAcos͑1,2یŕɂȂ
+		const __m128i two = _mm_set1_epi32(2);
+		const __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+		const __m128 cosSign = _mm_castsi128_ps(
+			_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+		s = _mm_xor_ps(sinValue, sinSign);
+		c = _mm_xor_ps(cosValue, cosSign);
+	}
+
+/**
+* 4̂̍̕s1
+*
+* @param dst ŏ̂̍̕s
+* @param column ޗ
+* @param x, y, z, w 4̗̂̊̕e
+*/
+	inline void StoreColumn4(glm::mat4* dst, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&dst[0][column][0], x);
+		_mm_storeu_ps(&dst[1][column][0], y);
+		_mm_storeu_ps(&dst[2][column][0], z);
+		_mm_storeu_ps(&dst[3][column][0], w);
+	}
+
+/**
+* SSE4vZ
+*
+* @param input          ̂̈ʒuA]Ag嗦
+* @param first          vZŏ̂̔̕ԍ
+* @param last           vZŌ̂̔̕ԍ+1
+* @param matVP          r[ vWFNVs
+* @param lightDirection [hWñCǧ
+* @param output         vZʂ̊i[
+*
+* @return vZȂŏ̂̔̕ԍ(c4)
+*/
+	size_t ComputeSse(const Arrays& input, size_t first, size_t last,
+		const glm::mat4& matVP, const glm::vec3& lightDirection, const Output& output)
+	{
+		__m128 vp[4][4];
+		for (int col = 0; col < 4; ++col)
+		{
+			for (int row = 0; row < 4; ++row)
+			{
+				vp[col][row] = _mm_set1_ps(matVP[col][row]);
+			}
+		}
+		const __m128 lx = _mm_set1_ps(lightDirection.x);
+		const __m128 ly = _mm_set1_ps(lightDirection.y);
+		const __m128 lz = _mm_set1_ps(lightDirection.z);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1);
+
+		size_t i = first;
+		for (; i + 4 <= last; i += 4)
+		{
+			__m128 sa, ca, sb, cb, sg, cg;
+			SinCos4(_mm_loadu_ps(&input.rotationZ[i]), sa, ca);
+			SinCos4(_mm_loadu_ps(&input.rotationX[i]), sb, cb);
+			SinCos4(_mm_loadu_ps(&input.rotationY[i]), sg, cg);
+
+			//]s̊evf(rCR͗C, sR)
+			const __m128 sasb = _mm_mul_ps(sa, sb);
+			const __m128 casb = _mm_mul_ps(ca, sb);
+			const __m128 r00 = _mm_add_ps(_mm_mul_ps(ca, cg), _mm_mul_ps(sasb, sg));
+			const __m128 r01 = _mm_sub_ps(_mm_mul_ps(casb, sg), _mm_mul_ps(sa, cg));
+			const __m128 r02 = _mm_sub_ps(zero, _mm_mul_ps(cb, sg));
+			const __m128 r10 = _mm_mul_ps(sa, cb);
+			const __m128 r11 = _mm_mul_ps(ca, cb);
+			const __m128 r12 = sb;
+			const __m128 r20 = _mm_sub_ps(_mm_mul_ps(ca, sg), _mm_mul_ps(sasb, cg));
+			const __m128 r21 = _mm_sub_ps(zero, _mm_add_ps(_mm_mul_ps(sa, sg), _mm_mul_ps(casb, cg)));
+			const __m128 r22 = _mm_mul_ps(cb, cg);
+
+			if (output.matModel || output.matMVP)
+			{
+				const __m128 sx = _mm_loadu_ps(&input.scaleX[i]);
+				const __m128 sy = _mm_loadu_ps(&input.scaleY[i]);
+				const __m128 sz = _mm_loadu_ps(&input.scaleZ[i]);
+				const __m128 m[4][3] = {
+					{ _mm_mul_ps(r00, sx), _mm_mul_ps(r01, sx), _mm_mul_ps(r02, sx) },
+					{ _mm_mul_ps(r10, sy), _mm_mul_ps(r11, sy), _mm_mul_ps(r12, sy) },
+					{ _mm_mul_ps(r20, sz), _mm_mul_ps(r21, sz), _mm_mul_ps(r22, sz) },
+					{ _mm_loadu_ps(&input.positionX[i]), _mm_loadu_ps(&input.positionY[i]),
+						_mm_loadu_ps(&input.positionZ[i]) },
+				};
+				if (output.matModel)
+				{
+					for (int col = 0; col < 4; ++col)
+					{
+						StoreColumn4(output.matModel + i, col,
+							m[col][0], m[col][1], m[col][2], col < 3 ? zero : one);
+					}
+				}
+				if (output.matMVP)
+				{
+					for (int col = 0; col < 4; ++col)
+					{
+						__m128 v[4];
+						for (int row = 0; row < 4; ++row)
+						{
+							v[row] = _mm_add_ps(_mm_add_ps(
+								_mm_mul_ps(vp[0][row], m[col][0]), _mm_mul_ps(vp[1][row], m[col][1])),
+								_mm_mul_ps(vp[2][row], m[col][2]));
+							if (col == 3)
+							{
+								v[row] = _mm_add_ps(v[row], vp[3][row]);
+							}
+						}
+						StoreColumn4(output.matMVP + i, col, v[0], v[1], v[2], v[3]);
+					}
+				}
+			}
+			if (output.lightDirection)
+			{
+				float x[4], y[4], z[4];
+				_mm_storeu_ps(x, _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(r00, lx), _mm_mul_ps(r01, ly)), _mm_mul_ps(r02, lz)));
+				_mm_storeu_ps(y, _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(r10, lx), _mm_mul_ps(r11, ly)), _mm_mul_ps(r12, lz)));
+				_mm_storeu_ps(z, _mm_add_ps(_mm_add_ps(
+					_mm_mul_ps(r20, lx), _mm_mul_ps(r21, ly)), _mm_mul_ps(r22, lz)));
+				for (int k = 0; k < 4; ++k)
+				{
+					output.lightDirection[i + k] = glm::vec3(x[k], y[k], z[k]);
+				}
+			}
+		}
+		return i;
+	}
+
+/**
+* 8̊pxsincos𓯎ɋ߂
+*
+* @param x px(WA)
+* @param s sin̊i[
+* @param c cos̊i[
+*
+* AVXɂ͐ẐŁAی͕̔_ōs
+*/
+	TARGET_AVX inline void SinCos8(__m256 x, __m256& s, __m256& c)
+	{
+		const __m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(twoOverPi)),
+			_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(halfPi1)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(halfPi2)));
+		r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(halfPi3)));
+		const __m256 z = _mm256_mul_ps(r, r);
+
+		__m256 sinPoly = _mm256_add_ps(
+			_mm256_mul_ps(_mm256_set1_ps(sinCoef1), z), _mm256_set1_ps(sinCoef2));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(sinPoly, z), _mm256_set1_ps(sinCoef3));
+		sinPoly = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(sinPoly, z), r), r);
+		__m256 cosPoly = _mm256_add_ps(
+			_mm256_mul_ps(_mm256_set1_ps(cosCoef1), z), _mm256_set1_ps(cosCoef2));
+		cosPoly = _mm256_add_ps(_mm256_mul_ps(cosPoly, z), _mm256_set1_ps(cosCoef3));
+		cosPoly = _mm256_mul_ps(_mm256_mul_ps(cosPoly, z), z);
+		cosPoly = _mm256_add_ps(
+			_mm256_sub_ps(cosPoly, _mm256_mul_ps(z, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1));
+
+		//ی(0`3)
+		const __m256 quadrant = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_set1_ps(4),
+			_mm256_floor_ps(_mm256_mul_ps(q, _mm256_set1_ps(0.25f)))));
+		const __m256 isOne = _mm256_cmp_ps(quadrant, _mm256_set1_ps(1), _CMP_EQ_OQ);
+		const __m256 isTwo = _mm256_cmp_ps(quadrant, _mm256_set1_ps(2), _CMP_EQ_OQ);
+		const __m256 isThree = _mm256_cmp_ps(quadrant, _mm256_set1_ps(3), _CMP_EQ_OQ);
+		const __m256 swap = _mm256_or_ps(isOne, isThree);
+		const __m256 sinValue = _mm256_blendv_ps(sinPoly, cosPoly, swap);
+		const __m256 cosValue = _mm256_blendv_ps(cosPoly, sinPoly, swap);
+		const __m256 signBit = _mm256_set1_ps(-0.0f);
+		s = _mm256_xor_ps(sinValue, _mm256_and_ps(_mm256_or_ps(isTwo, isThree), signBit));
+		c = _mm256_xor_ps(cosValue, _mm256_and_ps(_mm256_or_ps(isOne, isTwo), signBit));
+	}
+
+/**
+* 8̂̍̕s1
+*
+* @param dst ŏ̂̍̕s
+* @param column ޗ
+* @param x, y, z, w 8̗̂̊̕e
+*
+* 128rbgƂ4x4̓]usAʂ𕨑0`3Aʂ𕨑4`7ɏ
+*/
+	TARGET_AVX inline void StoreColumn8(glm::mat4* dst, int column,
+		__m256 x, __m256 y, __m256 z, __m256 w)
+	{
+		const __m256 t0 = _mm256_unpacklo_ps(x, y);
+		const __m256 t1 = _mm256_unpackhi_ps(x, y);
+		const __m256 t2 = _mm256_unpacklo_ps(z, w);
+		const __m256 t3 = _mm256_unpackhi_ps(z, w);
+		const __m256 c0 = _mm256_shuffle_ps(t0, t2, 0x44);
+		const __m256 c1 = _mm256_shuffle_ps(t0, t2, 0xee);
+		const __m256 c2 = _mm256_shuffle_ps(t1, t3, 0x44);
+		const __m256 c3 = _mm256_shuffle_ps(t1, t3, 0xee);
+		_mm_storeu_ps(&dst[0][column][0], _mm256_castps256_ps128(c0));
+		_mm_storeu_ps(&dst[1][column][0], _mm256_castps256_ps128(c1));
+		_mm_storeu_ps(&dst[2][column][0], _mm256_castps256_ps128(c2));
+		_mm_storeu_ps(&dst[3][column][0], _mm256_castps256_ps128(c3));
+		_mm_storeu_ps(&dst[4][column][0], _mm256_extractf128_ps(c0, 1));
+		_mm_storeu_ps(&dst[5][column][0], _mm256_extractf128_ps(c1, 1));
+		_mm_storeu_ps(&dst[6][column][0], _mm256_extractf128_ps(c2, 1));
+		_mm_storeu_ps(&dst[7][column][0], _mm256_extractf128_ps(c3, 1));
+	}
+
+/**
+* AVX8vZ
+*
+* @param input          ̂̈ʒuA]Ag嗦
+* @param first          vZŏ̂̔̕ԍ
+* @param last           vZŌ̂̔̕ԍ+1
+* @param matVP          r[ vWFNVs
+* @param lightDirection [hWñCǧ
+* @param output         vZʂ̊i[
+*
+* @return vZȂŏ̂̔̕ԍ(c8)
+*/
+	TARGET_AVX size_t ComputeAvx(const Arrays& input, size_t first, size_t last,
+		const glm::mat4& matVP, const glm::vec3& lightDirection, const Output& output)
+	{
+		__m256 vp[4][4];
+		for (int col = 0; col < 4; ++col)
+		{
+			for (int row = 0; row < 4; ++row)
+			{
+				vp[col][row] = _mm256_set1_ps(matVP[col][row]);
+			}
+		}
+		const __m256 lx = _mm256_set1_ps(lightDirection.x);
+		const __m256 ly = _mm256_set1_ps(lightDirection.y);
+		const __m256 lz = _mm256_set1_ps(lightDirection.z);
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 one = _mm256_set1_ps(1);
+
+		size_t i = first;
+		for (; i + 8 <= last; i += 8)
+		{
+			__m256 sa, ca, sb, cb, sg, cg;
+			SinCos8(_mm256_loadu_ps(&input.rotationZ[i]), sa, ca);
+			SinCos8(_mm256_loadu_ps(&input.rotationX[i]), sb, cb);
+			SinCos8(_mm256_loadu_ps(&input.rotationY[i]), sg, cg);
+
+			//]s̊evf(rCR͗C, sR)
+			const __m256 sasb = _mm256_mul_ps(sa, sb);
+			const __m256 casb = _mm256_mul_ps(ca, sb);
+			const __m256 r00 = _mm256_add_ps(_mm256_mul_ps(ca, cg), _mm256_mul_ps(sasb, sg));
+			const __m256 r01 = _mm256_sub_ps(_mm256_mul_ps(casb, sg), _mm256_mul_ps(sa, cg));
+			const __m256 r02 = _mm256_sub_ps(zero, _mm256_mul_ps(cb, sg));
+			const __m256 r10 = _mm256_mul_ps(sa, cb);
+			const __m256 r11 = _mm256_mul_ps(ca, cb);
+			const __m256 r12 = sb;
+			const __m256 r20 = _mm256_sub_ps(_mm256_mul_ps(ca, sg), _mm256_mul_ps(sasb, cg));
+			const __m256 r21 = _mm256_sub_ps(zero,
+				_mm256_add_ps(_mm256_mul_ps(sa, sg), _mm256_mul_ps(casb, cg)));
+			const __m256 r22 = _mm256_mul_ps(cb, cg);
+
+			if (output.matModel || output.matMVP)
+			{
+				const __m256 sx = _mm256_loadu_ps(&input.scaleX[i]);
+				const __m256 sy = _mm256_loadu_ps(&input.scaleY[i]);
+				const __m256 sz = _mm256_loadu_ps(&input.scaleZ[i]);
+				const __m256 m[4][3] = {
+					{ _mm256_mul_ps(r00, sx), _mm256_mul_ps(r01, sx), _mm256_mul_ps(r02, sx) },
+					{ _mm256_mul_ps(r10, sy), _mm256_mul_ps(r11, sy), _mm256_mul_ps(r12, sy) },
+					{ _mm256_mul_ps(r20, sz), _mm256_mul_ps(r21, sz), _mm256_mul_ps(r22, sz) },
+					{ _mm256_loadu_ps(&input.positionX[i]), _mm256_loadu_ps(&input.positionY[i]),
+						_mm256_loadu_ps(&input.positionZ[i]) },
+				};
+				if (output.matModel)
+				{
+					for (int col = 0; col < 4; ++col)
+					{
+						StoreColumn8(output.matModel + i, col,
+							m[col][0], m[col][1], m[col][2], col < 3 ? zero : one);
+					}
+				}
+				if (output.matMVP)
+				{
+					for (int col = 0; col < 4; ++col)
+					{
+						__m256 v[4];
+						for (int row = 0; row < 4; ++row)
+						{
+							v[row] = _mm256_add_ps(_mm256_add_ps(
+								_mm256_mul_ps(vp[0][row], m[col][0]),
+								_mm256_mul_ps(vp[1][row], m[col][1])),
+								_mm256_mul_ps(vp[2][row], m[col][2]));
+							if (col == 3)
+							{
+								v[row] = _mm256_add_ps(v[row], vp[3][row]);
+							}
+						}
+						StoreColumn8(output.matMVP + i, col, v[0], v[1], v[2], v[3]);
+					}
+				}
+			}
+			if (output.lightDirection)
+			{
+				float x[8], y[8], z[8];
+				_mm256_storeu_ps(x, _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(r00, lx), _mm256_mul_ps(r01, ly)), _mm256_mul_ps(r02, lz)));
+				_mm256_storeu_ps(y, _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(r10, lx), _mm256_mul_ps(r11, ly)), _mm256_mul_ps(r12, lz)));
+				_mm256_storeu_ps(z, _mm256_add_ps(_mm256_add_ps(
+					_mm256_mul_ps(r20, lx), _mm256_mul_ps(r21, ly)), _mm256_mul_ps(r22, lz)));
+				for (int k = 0; k < 8; ++k)
+				{
+					output.lightDirection[i + k] = glm::vec3(x[k], y[k], z[k]);
+				}
+			}
+		}
+		_mm256_zeroupper();
+		return i;
+	}
+
+#endif //TRANSFORMBATCH_USE_SSE
+
+/**
+* SĂ̂̍̕Wϊs܂Ƃ߂ČvZ
+*
+* @param input          ̂̈ʒuA]Ag嗦
+* @param matVP          r[ vWFNVs
+* @param lightDirection [hWñCǧ
+* @param output         vZʂ̊i[(ꂼinput.Size()̗vfKv)
+*
+* AVXg8AgȂSSE4vZA[SIMDg킸ɌvZ.
+* sin, cos͑ŋߎ̂ŁAComputeScalarƂ1e-6x̌덷
+*/
+	void Compute(const Arrays& input, const glm::mat4& matVP, const glm::vec3& lightDirection,
+		const Output& output)
+	{
+		const size_t count = input.Size();
+		size_t i = 0;
+#if defined(TRANSFORMBATCH_USE_SSE)
+		if (hasAvx)
+		{
+			i = ComputeAvx(input, i, count, matVP, lightDirection, output);
+		}
+		i = ComputeSse(input, i, count, matVP, lightDirection, output);
+#endif
+		ComputeScalarRange(input, i, count, matVP, lightDirection, output);
+	}
+
+}//namespace TransformBatch
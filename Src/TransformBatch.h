@@ -0,0 +1,52 @@
+/**
+* @file TransformBatch.h
+*/
+#ifndef TRANSFORMBATCH_H_INCLUDED
+#define TRANSFORMBATCH_H_INCLUDED
+#include <glm/vec3.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <vector>
+
+//̂̍̕Wϊs܂Ƃ߂ČvZ֐i[閼O
+namespace TransformBatch {
+
+/**
+* ̂̈ʒuA]Ag嗦𐬕Ƃ̔zɂ܂Ƃ߂
+*
+* SIMD߂ŕ̂̕𓯎ɌvZł悤ɁAx, y, zʁX̔zɊi[
+*/
+	struct Arrays
+	{
+		std::vector<float> positionX, positionY, positionZ;
+		std::vector<float> rotationX, rotationY, rotationZ;//]px(WA)
+		std::vector<float> scaleX, scaleY, scaleZ;
+
+		void Clear();
+		void Push(const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale);
+		size_t Size() const;
+	};
+
+/**
+* vZʂ̊i[
+*
+* svȌʂnullptrɂƌvZȗ
+*/
+	struct Output
+	{
+		glm::mat4* matModel = nullptr;//fs
+		glm::mat4* matMVP = nullptr;//f r[ vWFNVs
+		glm::vec3* lightDirection = nullptr;//fWnɕϊCǧ
+	};
+
+	bool IsSimdEnabled();
+	bool IsAvxEnabled();
+	void Compute(const Arrays& input, const glm::mat4& matVP, const glm::vec3& lightDirection,
+		const Output& output);
+
+	//SIMDgȂ(ʂ̊mFƑx̔rp)
+	void ComputeScalar(const Arrays& input, const glm::mat4& matVP,
+		const glm::vec3& lightDirection, const Output& output);
+
+}//namespace TransformBatch
+#endif //TRANSFORMBATCH_H_INCLUDED
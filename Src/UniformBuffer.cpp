@@ -0,0 +1,244 @@
+/**
+* @file UniformBuffer.cpp
+*/
+#include "UniformBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+/**
+* fXgN^
+*/
+UniformRingBuffer::~UniformRingBuffer()
+{
+	Destroy();
+}
+
+/**
+* obt@쐬
+*
+* @param capacity obt@̃oCg. t[̑傫w肷邱
+*
+* @retval true  쐬
+* @retval false 쐬s
+*/
+bool UniformRingBuffer::Init(size_t capacity)
+{
+	Destroy();
+	GLint offsetAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	alignment = offsetAlignment > 0 ? static_cast<size_t>(offsetAlignment) : 256;
+	this->capacity = (capacity + alignment - 1) / alignment * alignment;
+
+	glGenBuffers(1, &id);
+	if (!id)
+	{
+		return false;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, id);
+	if (GLEW_ARB_buffer_storage)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_UNIFORM_BUFFER, this->capacity, nullptr,
+			flags | GL_DYNAMIC_STORAGE_BIT);
+		mapped = static_cast<uint8_t*>(
+			glMapBufferRange(GL_UNIFORM_BUFFER, 0, this->capacity, flags));
+	}
+	else
+	{
+		glBufferData(GL_UNIFORM_BUFFER, this->capacity, nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	if (!mapped)
+	{
+		staging.resize(this->capacity);
+	}
+	return true;
+}
+
+/**
+* obt@j
+*/
+void UniformRingBuffer::Destroy()
+{
+	for (const FenceRange& e : fences)
+	{
+		glDeleteSync(e.sync);
+	}
+	fences.clear();
+	if (mapped)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, id);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		mapped = nullptr;
+	}
+	glDeleteBuffers(1, &id);
+	id = 0;
+	std::vector<uint8_t>().swap(staging);
+	capacity = 0;
+	head = flushed = fenced = completed = 0;
+}
+
+/**
+* ޗ̈蓖Ă
+*
+* @param size 蓖ĂoCg. eʈȉł邱
+*
+* @return 蓖Ă̈̐擪ʒu(uniformobt@̃ItZbg̋EɑĂ).
+*         蓖ĂȂΗeʂƓl
+*
+* eʂāAGPU܂ǂł̈ɖ߂Ăꍇ͓ǂݏI܂ő҂.
+* ҂Ă̂Fenceuʒu܂łȂ̂ŁA`𖽗߂FenceĂсA
+* tFXuɗeʂ𒴂Ċ蓖ĂȂ.
+* i}bvłȂł́AFlush܂łɗeʂ𒴂Ċ蓖ĂȂ
+*/
+size_t UniformRingBuffer::Allocate(size_t size)
+{
+	if (!id || size == 0 || size > capacity)
+	{
+		return capacity;
+	}
+	uint64_t begin = (head + alignment - 1) / alignment * alignment;
+	if (begin % capacity + size > capacity)
+	{
+		begin = (begin / capacity + 1) * capacity;//Ɏ܂Ȃ̂Ő擪ɖ߂
+	}
+	const uint64_t end = begin + size;
+
+	//㏑ʒuÕf[^AGPUǂݏI܂ő҂.
+	//tFXuĂȂ̈́A܂`𖽗߂ĂȂȂ̂ŏ㏑łȂ
+	if (mapped && end > capacity)
+	{
+		const uint64_t limit = std::min(end - capacity, head);
+		if (fenced < limit)
+		{
+			std::cerr << "ERROR: tFXuĂȂuniformobt@̗͍̈ėpł܂\n";
+			return capacity;
+		}
+		while (completed < limit && !fences.empty())
+		{
+			WaitFence();
+		}
+	}
+	head = end;
+	return static_cast<size_t>(begin % capacity);
+}
+
+/**
+* 蓖Ă̈̏ݐ擾
+*
+* @param offset AllocateԂʒu
+*
+* @return ݐ̃AhX
+*/
+void* UniformRingBuffer::Data(size_t offset)
+{
+	return mapped ? mapped + offset : staging.data() + offset;
+}
+
+/**
+* 񂾃f[^GPU猩悤ɂ
+*
+* i}bvĂꍇ͉Ȃ.
+* łȂ΁AOFlushȍ~Ɋ蓖Ă͈͂܂Ƃ߂ē]
+*/
+void UniformRingBuffer::Flush()
+{
+	if (mapped)
+	{
+		flushed = head;
+		return;
+	}
+	while (flushed < head)
+	{
+		const uint64_t wrapEnd = (flushed / capacity + 1) * capacity;
+		const uint64_t end = std::min(head, wrapEnd);
+		Upload(static_cast<size_t>(flushed % capacity), static_cast<size_t>(end - flushed));
+		flushed = end;
+	}
+}
+
+/**
+* ܂łɊ蓖Ă̈g`̌ɁAtFXu
+*
+* 蓖Ă̈g`𖽗߂I邽тɌĂяo.
+* `̑OɌĂԂƁAGPUǂޑÖ̗ǂݏÎƂ݂ȂĂ܂
+*/
+void UniformRingBuffer::Fence()
+{
+	if (!mapped || fenced == head)
+	{
+		return;
+	}
+	const GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	fences.push_back({ sync, head });
+	fenced = head;
+}
+
+/**
+* 蓖Ă̈uniformubÑoCfBO |CgɊ蓖Ă
+*
+* @param binding oCfBO |Cg
+* @param offset  AllocateԂʒu
+* @param size    蓖ĂoCg
+*/
+void UniformRingBuffer::BindRange(GLuint binding, size_t offset, size_t size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, id, offset, size);
+}
+
+/**
+* obt@ID擾
+*
+* @return obt@ID
+*/
+GLuint UniformRingBuffer::Id() const
+{
+	return id;
+}
+
+/**
+* obt@̗eʂ擾
+*
+* @return obt@̃oCg
+*/
+size_t UniformRingBuffer::Capacity() const
+{
+	return capacity;
+}
+
+/**
+* CPÜ̗obt@ɓ]
+*
+* @param begin ]͈͂̐擪ʒu
+* @param size  ]oCg
+*/
+void UniformRingBuffer::Upload(size_t begin, size_t size)
+{
+	glBindBuffer(GL_UNIFORM_BUFFER, id);
+	glBufferSubData(GL_UNIFORM_BUFFER, begin, size, staging.data() + begin);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/**
+* łÂtFX܂ő҂
+*/
+void UniformRingBuffer::WaitFence()
+{
+	const FenceRange e = fences.front();
+	fences.pop_front();
+	for (;;)
+	{
+		const GLenum result = glClientWaitSync(e.sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		if (result != GL_TIMEOUT_EXPIRED)
+		{
+			if (result == GL_WAIT_FAILED)
+			{
+				std::cerr << "WARNING: uniformobt@̃tFX̑ҋ@Ɏs\n";
+			}
+			break;
+		}
+	}
+	glDeleteSync(e.sync);
+	completed = e.end;
+}
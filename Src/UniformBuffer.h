@@ -0,0 +1,99 @@
+/**
+* @file UniformBuffer.h
+*/
+#ifndef UNIFORMBUFFER_H_INCLUDED
+#define UNIFORMBUFFER_H_INCLUDED
+#include <GL/glew.h>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+//uniformubÑoCfBO |Cg
+const GLuint frameUniformBinding = 0;//t[Pʂ̃f[^(FrameData)
+const GLuint objectUniformBinding = 1;//̒Pʂ̃f[^(ObjectData)
+
+//ObjectDataubN1ɓ镨̂̐(VF[_[̔z̑傫Ɠlɂ邱).
+//OpenGLۏ؂uniformubN̍ŏTCY16KBɎ܂鐔ɂĂ
+const GLuint maxObjectsPerBlock = 128;
+
+//̔ԍǂݎ钸_̔ԍ
+const GLuint objectIndexAttribute = 5;
+
+/**
+* FrameDataubNstd140CAEg
+*/
+struct FrameUniform
+{
+	glm::mat4 matView;
+	glm::mat4 matProj;
+	glm::mat4 matViewProj;
+	glm::vec4 ambientLightColor;//xyz=̐F
+	glm::vec4 directionalLightDirection;//xyz=wCǧ([hWn)
+	glm::vec4 directionalLightColor;//xyz=wCg̐F
+};
+static_assert(sizeof(FrameUniform) == 240, "FrameUniformstd140Ɠ傫łȂ΂ȂȂ");
+
+/**
+* ObjectDataubN̔zvfstd140CAEg
+*/
+struct ObjectUniform
+{
+	glm::mat4 matModel;//fs(kꂽ_W߂ϊ܂)
+	glm::vec4 matNormal[3];//@̕ϊs(mat3̊e16oCgEɑ)
+	GLint textureLayer;//eNX`z̑wԍ
+	GLint padding[3];
+};
+static_assert(sizeof(ObjectUniform) == 128, "ObjectUniformstd140Ɠ傫łȂ΂ȂȂ");
+
+/**
+* t[uniformobt@AOobt@ƂĊ蓖ĂNX
+*
+* i}bvłł́Aobt@}bv܂ܒڏ.
+* łȂł́ACPÜ̗ɏFlushł܂Ƃ߂ē].
+* GPUǂݏIĂȂ̈́AtFXŊ҂Ăėp
+*/
+class UniformRingBuffer
+{
+public:
+	UniformRingBuffer() = default;
+	~UniformRingBuffer();
+	UniformRingBuffer(const UniformRingBuffer&) = delete;
+	UniformRingBuffer& operator=(const UniformRingBuffer&) = delete;
+
+	bool Init(size_t capacity);
+	void Destroy();
+	size_t Allocate(size_t size);
+	void* Data(size_t offset);
+	void Flush();
+	void Fence();
+	void BindRange(GLuint binding, size_t offset, size_t size) const;
+	GLuint Id() const;
+	size_t Capacity() const;
+
+private:
+	void Upload(size_t begin, size_t size);
+	void WaitFence();
+
+	//tFXƁA܂łɊ蓖Ăʒu(蓖Ăʂŕ\)
+	struct FenceRange
+	{
+		GLsync sync;
+		uint64_t end;
+	};
+
+	GLuint id = 0;
+	uint8_t* mapped = nullptr;//i}bvAhX(}bvłȂnullptr)
+	std::vector<uint8_t> staging;//i}bvłȂꍇ̏ݐ
+	size_t capacity = 0;
+	size_t alignment = 256;
+	uint64_t head = 0;//Ɋ蓖Ăʒu(蓖Ă. ۂ̈ʒucapacityŊ])
+	uint64_t flushed = 0;//]ς݂̈ʒu
+	uint64_t fenced = 0;//tFXuʒu
+	uint64_t completed = 0;//GPUǂݏIʒu
+	std::deque<FenceRange> fences;
+};
+
+#endif //UNIFORMBUFFER_H_INCLUDED
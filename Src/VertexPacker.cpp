@@ -0,0 +1,284 @@
+/**
+* @file VertexPacker.cpp
+*/
+#include "VertexPacker.h"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+//_f[^kE֐i[閼O
+namespace VertexPacker {
+
+/**
+* Px_𔼐x_ɕϊ
+*
+* @param f ϊl
+*
+* @return ϊl(ŋߐڋۂ)
+*/
+	GLushort FloatToHalf(float f)
+	{
+		uint32_t x;
+		memcpy(&x, &f, sizeof(x));
+		const uint32_t sign = (x >> 16) & 0x8000;
+		const uint32_t absx = x & 0x7fffffff;
+
+		//Ɣ
+		if (absx >= 0x7f800000)
+		{
+			return (GLushort)(sign | 0x7c00 | (absx > 0x7f800000 ? 0x200 : 0));
+		}
+		//ۂ߂65520ȏɂȂl͖
+		if (absx >= 0x477ff000)
+		{
+			return (GLushort)(sign | 0x7c00);
+		}
+		//xł͔񐳋KɂȂl
+		if (absx < 0x38800000)
+		{
+			if (absx < 0x33000000)
+			{
+				return (GLushort)sign;
+			}
+			const uint32_t exponent = absx >> 23;
+			const uint32_t mantissa = (absx & 0x7fffff) | 0x800000;
+			const uint32_t shift = 126 - exponent;
+			uint32_t h = mantissa >> shift;
+			const uint32_t rest = mantissa & ((1u << shift) - 1);
+			const uint32_t halfway = 1u << (shift - 1);
+			if (rest > halfway || (rest == halfway && (h & 1)))
+			{
+				++h;
+			}
+			return (GLushort)(sign | h);
+		}
+
+		//w̃oCAXtւA13rbg؂l߂
+		uint32_t h = (absx - 0x38000000) >> 13;
+		const uint32_t rest = absx & 0x1fff;
+		if (rest > 0x1000 || (rest == 0x1000 && (h & 1)))
+		{
+			++h;
+		}
+		return (GLushort)(sign | h);
+	}
+
+/**
+* x_Px_ɕϊ
+*
+* @param h ϊl
+*
+* @return ϊl
+*/
+	float HalfToFloat(GLushort h)
+	{
+		const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+		const uint32_t exponent = (h >> 10) & 0x1f;
+		const uint32_t mantissa = h & 0x3ff;
+		uint32_t x;
+		if (exponent == 0)
+		{
+			const float f = mantissa * (1.0f / 16777216.0f);
+			return sign ? -f : f;
+		}
+		else if (exponent == 31)
+		{
+			x = sign | 0x7f800000 | (mantissa << 13);
+		}
+		else
+		{
+			x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		}
+		float f;
+		memcpy(&f, &x, sizeof(f));
+		return f;
+	}
+
+/**
+* @𔪖ʑ̎ʑ2ɕϊ
+*
+* @param normal  ϊ@(Kς)
+* @param encoded ϊʂ̊i[(2vf)
+*/
+	void EncodeOctahedral(const Vector3& normal, GLshort* encoded)
+	{
+		const float l1 = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+		float x = 0;
+		float y = 0;
+		if (l1 > 0)
+		{
+			x = normal.x / l1;
+			y = normal.y / l1;
+			//͊O̎Op`ɐ܂Ԃ
+			if (normal.z < 0)
+			{
+				const float ox = (1.0f - fabsf(y)) * (x >= 0 ? 1.0f : -1.0f);
+				const float oy = (1.0f - fabsf(x)) * (y >= 0 ? 1.0f : -1.0f);
+				x = ox;
+				y = oy;
+			}
+		}
+		encoded[0] = (GLshort)roundf(std::min(std::max(x, -1.0f), 1.0f) * 32767.0f);
+		encoded[1] = (GLshort)roundf(std::min(std::max(y, -1.0f), 1.0f) * 32767.0f);
+	}
+
+/**
+* ʑ̎ʑ2ɂ@𕜌
+*
+* @param encoded l(2vf)
+*
+* @return @
+*
+* _VF[_[DecodeOctahedralƓvZs
+*/
+	Vector3 DecodeOctahedral(const GLshort* encoded)
+	{
+		const float x = std::max(encoded[0] / 32767.0f, -1.0f);
+		const float y = std::max(encoded[1] / 32767.0f, -1.0f);
+		Vector3 n = { x, y, 1.0f - fabsf(x) - fabsf(y) };
+		if (n.z < 0)
+		{
+			n.x = (1.0f - fabsf(y)) * (x >= 0 ? 1.0f : -1.0f);
+			n.y = (1.0f - fabsf(x)) * (y >= 0 ? 1.0f : -1.0f);
+		}
+		const float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+		n.x /= length;
+		n.y /= length;
+		n.z /= length;
+		return n;
+	}
+
+/**
+* _f[^k
+*
+* @param begin  k钸_f[^z̐擪
+* @param end    k钸_f[^z̏I[
+* @param out    k_f[^̊i[(end - beginvf)
+* @param offset W𕜌邽߂̕sړʂ̊i[
+* @param scale  W𕜌邽߂̊g嗦̊i[
+*
+* W͒_f[^Ŝ͂ޔ̒16rbgɗʎq.
+* ʂ̂悤ɕ0̎łg嗦0ɂȂȂ悤ɁA̕ɂ͍ŏl݂
+*/
+	void Pack(const Vertex* begin, const Vertex* end, PackedVertex* out,
+		Vector3& offset, Vector3& scale)
+	{
+		if (begin == end)
+		{
+			offset = { 0, 0, 0 };
+			scale = { 1, 1, 1 };
+			return;
+		}
+
+		//W͈̔͂߂
+		Vector3 minPos = begin->position;
+		Vector3 maxPos = begin->position;
+		for (const Vertex* v = begin; v != end; ++v)
+		{
+			minPos.x = std::min(minPos.x, v->position.x);
+			minPos.y = std::min(minPos.y, v->position.y);
+			minPos.z = std::min(minPos.z, v->position.z);
+			maxPos.x = std::max(maxPos.x, v->position.x);
+			maxPos.y = std::max(maxPos.y, v->position.y);
+			maxPos.z = std::max(maxPos.z, v->position.z);
+		}
+		//g嗦0ƕs񂪋tsȂȂ̂ŁAŏ݂̕
+		const float minExtent = 1.0e-4f;
+		offset = minPos;
+		scale = { std::max(maxPos.x - minPos.x, minExtent),
+			std::max(maxPos.y - minPos.y, minExtent), std::max(maxPos.z - minPos.z, minExtent) };
+
+		const auto quantizeUnorm16 = [](float value, float min, float range) {
+			if (range <= 0)
+			{
+				return (GLushort)0;
+			}
+			const float t = std::min(std::max((value - min) / range, 0.0f), 1.0f);
+			return (GLushort)roundf(t * 65535.0f);
+		};
+		const auto quantizeUnorm8 = [](float value) {
+			return (GLubyte)roundf(std::min(std::max(value, 0.0f), 1.0f) * 255.0f);
+		};
+
+		for (const Vertex* v = begin; v != end; ++v, ++out)
+		{
+			out->position[0] = quantizeUnorm16(v->position.x, offset.x, scale.x);
+			out->position[1] = quantizeUnorm16(v->position.y, offset.y, scale.y);
+			out->position[2] = quantizeUnorm16(v->position.z, offset.z, scale.z);
+			out->padding = 0;
+			out->texCoord[0] = FloatToHalf(v->texCoord.x);
+			out->texCoord[1] = FloatToHalf(v->texCoord.y);
+			EncodeOctahedral(v->normal, out->normal);
+			out->color[0] = quantizeUnorm8(v->color.r);
+			out->color[1] = quantizeUnorm8(v->color.g);
+			out->color[2] = quantizeUnorm8(v->color.b);
+			out->color[3] = quantizeUnorm8(v->color.a);
+		}
+	}
+
+/**
+* k_f[^𕜌
+*
+* @param packed 钸_f[^
+* @param offset W𕜌邽߂̕sړ
+* @param scale  W𕜌邽߂̊g嗦
+*
+* @return _f[^
+*/
+	Vertex Unpack(const PackedVertex& packed, const Vector3& offset, const Vector3& scale)
+	{
+		Vertex v;
+		v.position.x = offset.x + packed.position[0] / 65535.0f * scale.x;
+		v.position.y = offset.y + packed.position[1] / 65535.0f * scale.y;
+		v.position.z = offset.z + packed.position[2] / 65535.0f * scale.z;
+		v.color.r = packed.color[0] / 255.0f;
+		v.color.g = packed.color[1] / 255.0f;
+		v.color.b = packed.color[2] / 255.0f;
+		v.color.a = packed.color[3] / 255.0f;
+		v.texCoord.x = HalfToFloat(packed.texCoord[0]);
+		v.texCoord.y = HalfToFloat(packed.texCoord[1]);
+		v.normal = DecodeOctahedral(packed.normal);
+		return v;
+	}
+
+/**
+* kƕɂ덷vZ
+*
+* @param begin  ̒_f[^z̐擪
+* @param end    ̒_f[^z̏I[
+* @param packed k_f[^z
+* @param offset W𕜌邽߂̕sړ
+* @param scale  W𕜌邽߂̊g嗦
+*
+* @return evf̍ő덷
+*/
+	PackingError MeasureError(const Vertex* begin, const Vertex* end,
+		const PackedVertex* packed, const Vector3& offset, const Vector3& scale)
+	{
+		PackingError error = { 0, 0, 0, 0 };
+		for (const Vertex* v = begin; v != end; ++v, ++packed)
+		{
+			const Vertex u = Unpack(*packed, offset, scale);
+			error.position = std::max({ error.position,
+				fabsf(u.position.x - v->position.x),
+				fabsf(u.position.y - v->position.y),
+				fabsf(u.position.z - v->position.z) });
+			error.texCoord = std::max({ error.texCoord,
+				fabsf(u.texCoord.x - v->texCoord.x),
+				fabsf(u.texCoord.y - v->texCoord.y) });
+			error.color = std::max({ error.color,
+				fabsf(u.color.r - v->color.r), fabsf(u.color.g - v->color.g),
+				fabsf(u.color.b - v->color.b), fabsf(u.color.a - v->color.a) });
+
+			//@͊px̍Ŕׂ
+			const float cosTheta = u.normal.x * v->normal.x +
+				u.normal.y * v->normal.y + u.normal.z * v->normal.z;
+			const float degrees =
+				acosf(std::min(std::max(cosTheta, -1.0f), 1.0f)) * 57.2957795f;
+			error.normal = std::max(error.normal, degrees);
+		}
+		return error;
+	}
+
+}//namespace VertexPacker
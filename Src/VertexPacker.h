@@ -0,0 +1,35 @@
+/**
+* @file VertexPacker.h
+*/
+#ifndef VERTEXPACKER_H_INCLUDED
+#define VERTEXPACKER_H_INCLUDED
+#include <GL/glew.h>
+#include "Geometry.h"
+
+//_f[^kE֐i[閼O
+namespace VertexPacker {
+
+/**
+* kɂ덷
+*/
+	struct PackingError
+	{
+		float position;//W̍ő덷
+		float texCoord;//eNX`W̍ő덷
+		float normal;//@̍ő덷(x)
+		float color;//_F̍ő덷
+	};
+
+	GLushort FloatToHalf(float);
+	float HalfToFloat(GLushort);
+	void EncodeOctahedral(const Vector3& normal, GLshort* encoded);
+	Vector3 DecodeOctahedral(const GLshort* encoded);
+
+	void Pack(const Vertex* begin, const Vertex* end, PackedVertex* out,
+		Vector3& offset, Vector3& scale);
+	Vertex Unpack(const PackedVertex&, const Vector3& offset, const Vector3& scale);
+	PackingError MeasureError(const Vertex* begin, const Vertex* end,
+		const PackedVertex* packed, const Vector3& offset, const Vector3& scale);
+
+}//namespace VertexPacker
+#endif //VERTEXPACKER_H_INCLUDED